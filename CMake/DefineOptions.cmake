@@ -34,6 +34,10 @@ option(
 option(WITH_LOGGING_TIMING_DATA
        "Build with logging all Add and Erase Segment calls." OFF)
 
+# Turn this option on to store note data in sorted arrays instead of maps.
+option(WITH_FLAT_NOTEDATA
+       "Build with the flat, array-based NoteData track storage." OFF)
+
 if(NOT MSVC)
   # Change this number to utilize a different number of jobs for building
   # FFMPEG.
@@ -241,6 +241,21 @@ bool BitmapText::LoadFromTextureAndChars( const RString& sTexturePath, const RSt
 	return true;
 }
 
+static void MakeGlyphQuad( RageSpriteVertex *v, const glyph &g, int iX, int iY )
+{
+	// set vertex positions
+	v[0].p = RageVector3( iX+g.m_fHshift,			iY+g.m_pPage->m_fVshift,		0 );	// top left
+	v[1].p = RageVector3( iX+g.m_fHshift,			iY+g.m_pPage->m_fVshift+g.m_fHeight,	0 );	// bottom left
+	v[2].p = RageVector3( iX+g.m_fHshift+g.m_fWidth,	iY+g.m_pPage->m_fVshift+g.m_fHeight,	0 );	// bottom right
+	v[3].p = RageVector3( iX+g.m_fHshift+g.m_fWidth,	iY+g.m_pPage->m_fVshift,		0 );	// top right
+
+	// set texture coordinates
+	v[0].t = RageVector2( g.m_TexRect.left,	g.m_TexRect.top );
+	v[1].t = RageVector2( g.m_TexRect.left,	g.m_TexRect.bottom );
+	v[2].t = RageVector2( g.m_TexRect.right,	g.m_TexRect.bottom );
+	v[3].t = RageVector2( g.m_TexRect.right,	g.m_TexRect.top );
+}
+
 void BitmapText::BuildChars()
 {
 	// If we don't have a font yet, we'll do this when it loads.
@@ -300,22 +315,12 @@ void BitmapText::BuildChars()
 			if( m_pFont->IsRightToLeft() )
 				iX -= g.m_iHadvance;
 
-			// set vertex positions
-			v[0].p = RageVector3( iX+g.m_fHshift,			iY+g.m_pPage->m_fVshift,		0 );	// top left
-			v[1].p = RageVector3( iX+g.m_fHshift,			iY+g.m_pPage->m_fVshift+g.m_fHeight,	0 );	// bottom left
-			v[2].p = RageVector3( iX+g.m_fHshift+g.m_fWidth,	iY+g.m_pPage->m_fVshift+g.m_fHeight,	0 );	// bottom right
-			v[3].p = RageVector3( iX+g.m_fHshift+g.m_fWidth,	iY+g.m_pPage->m_fVshift,		0 );	// top right
+			MakeGlyphQuad( v, g, iX, iY );
 
 			// Advance the cursor.
 			if( !m_pFont->IsRightToLeft() )
 				iX += g.m_iHadvance;
 
-			// set texture coordinates
-			v[0].t = RageVector2( g.m_TexRect.left,	g.m_TexRect.top );
-			v[1].t = RageVector2( g.m_TexRect.left,	g.m_TexRect.bottom );
-			v[2].t = RageVector2( g.m_TexRect.right,	g.m_TexRect.bottom );
-			v[3].t = RageVector2( g.m_TexRect.right,	g.m_TexRect.top );
-
 			m_aVertices.insert( m_aVertices.end(), &v[0], &v[4] );
 			m_vpFontPageTextures.push_back( g.GetFontPageTextures() );
 		}
@@ -341,6 +346,83 @@ void BitmapText::BuildChars()
 	}
 }
 
+/* Update m_aVertices for new text, given the lines that were last built.
+ * This is for text that changes every frame, like score counters and timers:
+ * if the new text has the same line lengths and line widths as the old, every
+ * quad stays where it was, and only the quads for characters that changed (or
+ * that were moved by them) are rebuilt.  Returns false if the text has to be
+ * rebuilt with BuildChars. */
+bool BitmapText::BuildChangedChars( const vector<wstring> &wOldLines )
+{
+	if( m_pFont == nullptr || m_bUsingDistortion )
+		return false;
+	if( wOldLines.size() != m_wTextLines.size() || m_iLineWidths.size() != m_wTextLines.size() || m_wTextLines.empty() )
+		return false;
+
+	size_t iNumGlyphs = 0;
+	for( unsigned l = 0; l < m_wTextLines.size(); ++l )
+	{
+		if( m_wTextLines[l].size() != wOldLines[l].size() )
+			return false;
+		if( m_pFont->GetLineWidthInSourcePixels(m_wTextLines[l]) != m_iLineWidths[l] )
+			return false;
+		iNumGlyphs += m_wTextLines[l].size();
+	}
+	if( m_aVertices.size() != iNumGlyphs*4 )
+		return false;
+
+	// This follows the layout in BuildChars.
+	int iPadding = m_pFont->GetLineSpacing() - m_pFont->GetHeight();
+	iPadding += m_iVertSpacing;
+	int iY = lrintf(-m_size.y/2.0f);
+	size_t iGlyph = 0;
+
+	for( unsigned i=0; i<m_wTextLines.size(); i++ ) // foreach line
+	{
+		iY += m_pFont->GetHeight();
+
+		wstring sLine = m_wTextLines[i];
+		wstring sOldLine = wOldLines[i];
+		if( m_pFont->IsRightToLeft() )
+		{
+			reverse( sLine.begin(), sLine.end() );
+			reverse( sOldLine.begin(), sOldLine.end() );
+		}
+
+		float fX = SCALE( m_fHorizAlign, 0.0f, 1.0f, -m_size.x/2.0f, +m_size.x/2.0f - m_iLineWidths[i] );
+		int iX = lrintf( fX );
+		int iOldX = iX;
+
+		for( unsigned j = 0; j < sLine.size(); ++j, ++iGlyph )
+		{
+			const glyph &g = m_pFont->GetGlyph( sLine[j] );
+			const glyph &old = m_pFont->GetGlyph( sOldLine[j] );
+
+			if( m_pFont->IsRightToLeft() )
+			{
+				iX -= g.m_iHadvance;
+				iOldX -= old.m_iHadvance;
+			}
+
+			if( &g != &old || iX != iOldX )
+			{
+				MakeGlyphQuad( &m_aVertices[iGlyph*4], g, iX, iY );
+				m_vpFontPageTextures[iGlyph] = g.GetFontPageTextures();
+			}
+
+			if( !m_pFont->IsRightToLeft() )
+			{
+				iX += g.m_iHadvance;
+				iOldX += old.m_iHadvance;
+			}
+		}
+
+		iY += iPadding;
+	}
+
+	return true;
+}
+
 void BitmapText::DrawChars( bool bUseStrokeTexture )
 {
 	// bail if cropped all the way
@@ -479,7 +561,8 @@ void BitmapText::SetTextInternal()
 {
 	// Break the string into lines.
 
-	m_wTextLines.clear();
+	vector<wstring> wOldLines;
+	wOldLines.swap( m_wTextLines );
 
 	if( m_iWrapWidthPixels == -1 )
 	{
@@ -535,7 +618,8 @@ void BitmapText::SetTextInternal()
 		}
 	}
 
-	BuildChars();
+	if( !BuildChangedChars(wOldLines) )
+		BuildChars();
 	UpdateBaseZoom();
 }
 
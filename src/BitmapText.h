@@ -136,6 +136,7 @@ protected:
 
 	// recalculate the items in SetText()
 	void BuildChars();
+	bool BuildChangedChars( const vector<wstring> &wOldLines );
 	void DrawChars( bool bUseStrokeTexture );
 	void UpdateBaseZoom();
 
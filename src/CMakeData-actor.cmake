@@ -134,6 +134,7 @@ list(APPEND SMDATA_ACTOR_MENU_SRC
             "ModIconRow.cpp"
             "MusicWheel.cpp"
             "MusicWheelItem.cpp"
+            "MusicWheelPrefetch.cpp"
             "OptionRow.cpp"
             "OptionsCursor.cpp"
             "OptionsList.cpp"
@@ -164,6 +165,7 @@ list(APPEND SMDATA_ACTOR_MENU_HPP
             "ModIconRow.h"
             "MusicWheel.h"
             "MusicWheelItem.h"
+            "MusicWheelPrefetch.h"
             "OptionRow.h"
             "OptionsCursor.h"
             "OptionsList.h"
@@ -55,6 +55,7 @@ list(APPEND SM_DATA_NOTEDATA_SRC
             "NoteDataWithScoring.cpp")
 
 list(APPEND SM_DATA_NOTEDATA_HPP
+            "FlatTrackMap.h"
             "NoteData.h"
             "NoteDataUtil.h"
             "NoteDataWithScoring.h")
@@ -126,6 +127,7 @@ source_group("Data Structures\\\\Score Keepers"
 list(APPEND SM_DATA_SONG_SRC
             "Song.cpp"
             "SongCacheIndex.cpp"
+            "SongCachePack.cpp"
             "SongOptions.cpp"
             "SongPosition.cpp"
             "SongUtil.cpp")
@@ -133,6 +135,7 @@ list(APPEND SM_DATA_SONG_SRC
 list(APPEND SM_DATA_SONG_HPP
             "Song.h"
             "SongCacheIndex.h"
+            "SongCachePack.h"
             "SongOptions.h"
             "SongPosition.h"
             "SongUtil.h")
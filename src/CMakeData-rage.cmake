@@ -5,6 +5,7 @@ list(APPEND SMDATA_RAGE_UTILS_SRC
             "RageUtil_BackgroundLoader.cpp"
             "RageUtil_CharConversions.cpp"
             "RageUtil_FileDB.cpp"
+            "RageUtil_MappedFile.cpp"
             "RageUtil_WorkerThread.cpp")
 
 list(APPEND SMDATA_RAGE_UTILS_HPP
@@ -15,6 +16,7 @@ list(APPEND SMDATA_RAGE_UTILS_HPP
             "RageUtil_CharConversions.h"
             "RageUtil_CircularBuffer.h"
             "RageUtil_FileDB.h"
+            "RageUtil_MappedFile.h"
             "RageUtil_WorkerThread.h")
 
 source_group("Rage\\\\Utils"
@@ -155,6 +157,7 @@ list(APPEND SMDATA_RAGE_SOUND_SRC
             "RageSound.cpp"
             "RageSoundManager.cpp"
             "RageSoundMixBuffer.cpp"
+            "RageSoundMixKernels.cpp"
             "RageSoundPosMap.cpp"
             "RageSoundReader.cpp"
             "RageSoundReader_Chain.cpp"
@@ -166,6 +169,7 @@ list(APPEND SMDATA_RAGE_SOUND_SRC
             "RageSoundReader_Pan.cpp"
             "RageSoundReader_PitchChange.cpp"
             "RageSoundReader_PostBuffering.cpp"
+            "RageSoundReader_Prefetch.cpp"
             "RageSoundReader_Preload.cpp"
             "RageSoundReader_Resample_Good.cpp"
             "RageSoundReader_SpeedChange.cpp"
@@ -178,6 +182,7 @@ list(APPEND SMDATA_RAGE_SOUND_HPP
             "RageSound.h"
             "RageSoundManager.h"
             "RageSoundMixBuffer.h"
+            "RageSoundMixKernels.h"
             "RageSoundPosMap.h"
             "RageSoundReader.h"
             "RageSoundReader_Chain.h"
@@ -190,6 +195,7 @@ list(APPEND SMDATA_RAGE_SOUND_HPP
             "RageSoundReader_Pan.h"
             "RageSoundReader_PitchChange.h"
             "RageSoundReader_PostBuffering.h"
+            "RageSoundReader_Prefetch.h"
             "RageSoundReader_Preload.h"
             "RageSoundReader_Resample_Good.h"
             "RageSoundReader_SpeedChange.h"
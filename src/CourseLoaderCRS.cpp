@@ -95,11 +95,11 @@ bool CourseLoaderCRS::LoadFromMsd( const RString &sPath, const MsdFile &msd, Cou
 		}
 		else if( sValueName.EqualsNoCase("METER") )
 		{
-			if( sParams.params.size() == 2 )
+			if( sParams.GetNumParams() == 2 )
 			{
 				out.m_iCustomMeter[Difficulty_Medium] = max( StringToInt(sParams[1]), 0 ); /* compat */
 			}
-			else if( sParams.params.size() == 3 )
+			else if( sParams.GetNumParams() == 3 )
 			{
 				const CourseDifficulty cd = CRSStringToDifficulty( sParams[1] );
 				if( cd == Difficulty_Invalid )
@@ -115,7 +115,7 @@ bool CourseLoaderCRS::LoadFromMsd( const RString &sPath, const MsdFile &msd, Cou
 		{
 			Attack attack;
 			float end = -9999;
-			for( unsigned j = 1; j < sParams.params.size(); ++j )
+			for( unsigned j = 1; j < sParams.GetNumParams(); ++j )
 			{
 				vector<RString> sBits;
 				split( sParams[j], "=", sBits, false );
@@ -44,6 +44,15 @@ void FadingBanner::UpdateInternal( float fDeltaTime )
 	// ActorFrame::UpdateInternal( fDeltaTime );
 	Actor::UpdateInternal( fDeltaTime );
 
+	if( !m_PendingBanner.IsEmpty() && m_PendingBanner.IsReady() )
+	{
+		/* Hold on to the texture until the banner has its own reference, or
+		 * it might be freed and loaded again. */
+		RageTexturePreloader loaded;
+		loaded.Swap( m_PendingBanner );
+		Load( m_PendingBannerID );
+	}
+
 	if( !m_bSkipNextBannerUpdate )
 	{
 		for( int i = 0; i < NUM_BANNERS; ++i )
@@ -94,6 +103,9 @@ void FadingBanner::Load( RageTextureID ID, bool bLowResToHighRes )
  * corresponding high-res banner. */
 void FadingBanner::BeforeChange( bool bLowResToHighRes )
 {
+	/* Whatever was loading in the background isn't wanted any more. */
+	m_PendingBanner.UnloadAll();
+
 	RString sCommand;
 	if( bLowResToHighRes )
 		sCommand = "FadeFromCached";
@@ -111,6 +123,17 @@ void FadingBanner::BeforeChange( bool bLowResToHighRes )
 	m_bSkipNextBannerUpdate = true;
 }
 
+void FadingBanner::LoadInBackground( const RageTextureID &ID )
+{
+	m_PendingBanner.UnloadAll();
+	m_PendingBannerID = ID;
+
+	/* As in Banner::Load, don't complain about the dimensions of song graphics. */
+	TEXTUREMAN->DisableOddDimensionWarning();
+	m_PendingBanner.LoadAsync( ID );
+	TEXTUREMAN->EnableOddDimensionWarning();
+}
+
 /* If this returns true, a low-resolution banner was loaded, and the full-res
  * banner should be loaded later. */
 bool FadingBanner::LoadFromCachedBanner( const RString &path )
@@ -140,7 +163,11 @@ bool FadingBanner::LoadFromCachedBanner( const RString &path )
 		ID = IMAGECACHE->LoadCachedImage( "Banner", path );
 	}
 
-	if( !TEXTUREMAN->IsTextureRegistered(ID) )
+	/* We're already loading this banner in the background. */
+	if( !m_PendingBanner.IsEmpty() && m_PendingBannerID.filename == path )
+		return false;
+
+	if( !TEXTUREMAN->IsTextureRegistered(ID) || TEXTUREMAN->IsTextureLoading(ID) )
 	{
 		/* Oops. We couldn't load a banner quickly. We can load the actual
 		 * banner, but that's slow, so we don't want to do that when we're moving
@@ -151,8 +178,10 @@ bool FadingBanner::LoadFromCachedBanner( const RString &path )
 		if( m_bMovingFast )
 			return false;
 
+		/* Keep the banner that's there until the real one has been loaded
+		 * in the background; it fades in from UpdateInternal. */
 		if( IsAFile(path) )
-			Load( path );
+			LoadInBackground( Sprite::SongBannerTexture(path) );
 		else
 			LoadFallback();
 
@@ -6,6 +6,7 @@
 #include "Banner.h"
 #include "ActorFrame.h"
 #include "RageTimer.h"
+#include "RageTexturePreloader.h"
 
 class FadingBanner : public ActorFrame
 {
@@ -45,6 +46,7 @@ public:
 
 protected:
 	void BeforeChange( bool bLowResToHighRes=false );
+	void LoadInBackground( const RageTextureID &ID );
 
 	static const int NUM_BANNERS = 5;
 	Banner	m_Banner[NUM_BANNERS];
@@ -52,6 +54,10 @@ protected:
 
 	bool	m_bMovingFast;
 	bool	m_bSkipNextBannerUpdate;
+
+	/* A banner being loaded in the background, to be faded in once it's ready. */
+	RageTexturePreloader	m_PendingBanner;
+	RageTextureID	m_PendingBannerID;
 };
 
 #endif
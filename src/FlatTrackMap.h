@@ -0,0 +1,137 @@
+/* FlatTrackMap - A sorted-array replacement for map<int,TapNote>. */
+
+#ifndef FLAT_TRACK_MAP_H
+#define FLAT_TRACK_MAP_H
+
+#include "NoteTypes.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One track of NoteData, stored as an array of notes sorted by row.
+ *
+ * This has the subset of the map<int,TapNote> interface that NoteData and
+ * its users need, so it can be dropped in as NoteData::TrackMap.  Lookups
+ * are binary searches and iteration walks contiguous memory, and there's no
+ * per-note allocation.
+ *
+ * Unlike map, inserting or erasing a note invalidates iterators to the notes
+ * after it.  Use the iterator returned by erase() to keep iterating.
+ */
+class FlatTrackMap
+{
+public:
+	typedef int key_type;
+	typedef TapNote mapped_type;
+	typedef std::pair<int, TapNote> value_type;
+	typedef std::vector<value_type> container_type;
+	typedef container_type::size_type size_type;
+	typedef container_type::iterator iterator;
+	typedef container_type::const_iterator const_iterator;
+	typedef container_type::reverse_iterator reverse_iterator;
+	typedef container_type::const_reverse_iterator const_reverse_iterator;
+
+	iterator begin()				{ return m_Notes.begin(); }
+	const_iterator begin() const			{ return m_Notes.begin(); }
+	iterator end()					{ return m_Notes.end(); }
+	const_iterator end() const			{ return m_Notes.end(); }
+	reverse_iterator rbegin()			{ return m_Notes.rbegin(); }
+	const_reverse_iterator rbegin() const		{ return m_Notes.rbegin(); }
+	reverse_iterator rend()				{ return m_Notes.rend(); }
+	const_reverse_iterator rend() const		{ return m_Notes.rend(); }
+
+	bool empty() const				{ return m_Notes.empty(); }
+	size_type size() const				{ return m_Notes.size(); }
+	void clear()					{ container_type().swap( m_Notes ); }
+	void swap( FlatTrackMap &other )		{ m_Notes.swap( other.m_Notes ); }
+
+	iterator lower_bound( int iRow )		{ return std::lower_bound( m_Notes.begin(), m_Notes.end(), iRow, RowLess() ); }
+	const_iterator lower_bound( int iRow ) const	{ return std::lower_bound( m_Notes.begin(), m_Notes.end(), iRow, RowLess() ); }
+	iterator upper_bound( int iRow )		{ return std::upper_bound( m_Notes.begin(), m_Notes.end(), iRow, RowLess() ); }
+	const_iterator upper_bound( int iRow ) const	{ return std::upper_bound( m_Notes.begin(), m_Notes.end(), iRow, RowLess() ); }
+
+	iterator find( int iRow )
+	{
+		iterator it = lower_bound( iRow );
+		return (it != m_Notes.end() && it->first == iRow)? it: m_Notes.end();
+	}
+	const_iterator find( int iRow ) const
+	{
+		const_iterator it = lower_bound( iRow );
+		return (it != m_Notes.end() && it->first == iRow)? it: m_Notes.end();
+	}
+	size_type count( int iRow ) const		{ return find( iRow ) != m_Notes.end()? 1:0; }
+
+	TapNote &operator[]( int iRow )
+	{
+		/* Notes are usually added in order, so check the end first. */
+		if( m_Notes.empty() || m_Notes.back().first < iRow )
+		{
+			m_Notes.push_back( value_type(iRow, TapNote()) );
+			return m_Notes.back().second;
+		}
+		iterator it = lower_bound( iRow );
+		if( it == m_Notes.end() || it->first != iRow )
+			it = m_Notes.insert( it, value_type(iRow, TapNote()) );
+		return it->second;
+	}
+
+	std::pair<iterator, bool> insert( const value_type &v )
+	{
+		iterator it = lower_bound( v.first );
+		if( it != m_Notes.end() && it->first == v.first )
+			return std::make_pair( it, false );
+		return std::make_pair( m_Notes.insert(it, v), true );
+	}
+
+	iterator erase( iterator it )			{ return m_Notes.erase( it ); }
+	iterator erase( iterator first, iterator last )	{ return m_Notes.erase( first, last ); }
+	size_type erase( int iRow )
+	{
+		iterator it = find( iRow );
+		if( it == m_Notes.end() )
+			return 0;
+		m_Notes.erase( it );
+		return 1;
+	}
+
+	bool operator==( const FlatTrackMap &other ) const	{ return m_Notes == other.m_Notes; }
+	bool operator!=( const FlatTrackMap &other ) const	{ return m_Notes != other.m_Notes; }
+
+private:
+	struct RowLess
+	{
+		bool operator()( const value_type &a, int iRow ) const { return a.first < iRow; }
+		bool operator()( int iRow, const value_type &b ) const { return iRow < b.first; }
+	};
+
+	container_type m_Notes;
+};
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
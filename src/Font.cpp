@@ -272,7 +272,7 @@ int Font::GetGlyphsThatFit(const wstring& line, int* width) const
 }
 
 Font::Font(): m_iRefCount(1), path(""), m_apPages(), m_pDefault(nullptr),
-	m_iCharToGlyph(), m_bRightToLeft(false), m_bDistanceField(false),
+	m_iCharToGlyph(), m_ExtraGlyphs(), m_pDefaultGlyph(nullptr), m_bRightToLeft(false), m_bDistanceField(false),
 	// strokes aren't shown by default, hence the Color.
 	m_DefaultStrokeColor(RageColor(0,0,0,0)), m_sChars("") {}
 Font::~Font()
@@ -288,6 +288,10 @@ void Font::Unload()
 	m_apPages.clear();
 
 	m_iCharToGlyph.clear();
+	for( unsigned i = 0; i < ARRAYLEN(m_apGlyphBlocks); ++i )
+		m_apGlyphBlocks[i].clear();
+	m_ExtraGlyphs.clear();
+	m_pDefaultGlyph = nullptr;
 	m_pDefault = nullptr;
 
 	/* Don't clear the refcount. We've unloaded, but that doesn't mean things
@@ -350,34 +354,63 @@ const glyph &Font::GetGlyph( wchar_t c ) const
 	if (c < 0 || c > 0xFFFFFF)
 		c = 1;
 
-	// Fast path:
-	if( c < (int) ARRAYLEN(m_iCharToGlyphCache) && m_iCharToGlyphCache[c] )
-		return *m_iCharToGlyphCache[c];
-
-	// Try the regular character.
-	map<wchar_t,glyph*>::const_iterator it = m_iCharToGlyph.find(c);
+	if( c <= 0xFFFF )
+	{
+		const vector<glyph*> &block = m_apGlyphBlocks[c >> 8];
+		if( !block.empty() && block[c & 0xFF] != nullptr )
+			return *block[c & 0xFF];
+	}
+	else
+	{
+		unordered_map<wchar_t,glyph*>::const_iterator it = m_ExtraGlyphs.find(c);
+		if( it != m_ExtraGlyphs.end() )
+			return *it->second;
+	}
 
 	// If that's missing, use the default glyph.
-	if(it == m_iCharToGlyph.end()) 
-		it = m_iCharToGlyph.find(FONT_DEFAULT_GLYPH);
-
-	if(it == m_iCharToGlyph.end()) 
+	if( m_pDefaultGlyph == nullptr )
 		RageException::Throw( "The default glyph is missing from the font \"%s\".", path.c_str() );
 
-	return *it->second;
+	return *m_pDefaultGlyph;
+}
+
+void Font::BuildGlyphTable()
+{
+	for( unsigned i = 0; i < ARRAYLEN(m_apGlyphBlocks); ++i )
+		m_apGlyphBlocks[i].clear();
+	m_ExtraGlyphs.clear();
+
+	map<wchar_t,glyph*>::const_iterator it = m_iCharToGlyph.find( FONT_DEFAULT_GLYPH );
+	m_pDefaultGlyph = it == m_iCharToGlyph.end()? nullptr:it->second;
+
+	for( it = m_iCharToGlyph.begin(); it != m_iCharToGlyph.end(); ++it )
+	{
+		const wchar_t c = it->first;
+		if( c < 0 || c > 0xFFFFFF )
+			continue;
+		if( c > 0xFFFF )
+		{
+			m_ExtraGlyphs[c] = it->second;
+			continue;
+		}
+
+		vector<glyph*> &block = m_apGlyphBlocks[c >> 8];
+		if( block.empty() )
+			block.resize( 256, m_pDefaultGlyph );
+		block[c & 0xFF] = it->second;
+	}
 }
 
 bool Font::FontCompleteForString( const wstring &str ) const
 {
-	map<wchar_t,glyph*>::const_iterator mapDefault = m_iCharToGlyph.find( FONT_DEFAULT_GLYPH );
-	if( mapDefault == m_iCharToGlyph.end() )
+	if( m_pDefaultGlyph == nullptr )
 		RageException::Throw( "The default glyph is missing from the font \"%s\".", path.c_str() );
 
 	for( unsigned i = 0; i < str.size(); ++i )
 	{
 		// If the glyph for this character is the default glyph, we're incomplete.
 		const glyph &g = GetGlyph( str[i] );
-		if( &g == mapDefault->second )
+		if( &g == m_pDefaultGlyph )
 			return false;
 	}
 	return true;
@@ -889,14 +922,7 @@ void Font::Load( const RString &sIniPath, RString sChars )
 	LoadStack.pop_back();
 
 	if( LoadStack.empty() )
-	{
-		// Cache ASCII glyphs.
-		ZERO( m_iCharToGlyphCache );
-		map<wchar_t,glyph*>::iterator it;
-		for( it = m_iCharToGlyph.begin(); it != m_iCharToGlyph.end(); ++it )
-			if( it->first < (int) ARRAYLEN(m_iCharToGlyphCache) )
-				m_iCharToGlyphCache[it->first] = it->second;
-	}
+		BuildGlyphTable();
 }
 
 /*
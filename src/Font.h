@@ -7,6 +7,7 @@
 #include "RageUtil.h"
 #include "RageTypes.h"
 #include <map>
+#include <unordered_map>
 
 class FontPage;
 class RageTexture;
@@ -199,8 +200,20 @@ private:
 
 	/** @brief Map from characters to glyphs. */
 	map<wchar_t,glyph*> m_iCharToGlyph;
-	/** @brief Each glyph is part of one of the pages[]. */
-	glyph *m_iCharToGlyphCache[128];
+
+	/**
+	 * @brief Direct lookup table for the BMP, built from m_iCharToGlyph by
+	 * BuildGlyphTable() once the font is loaded.
+	 *
+	 * Characters are split into blocks of 256, and a block is only allocated
+	 * if the font has a glyph in it.  Characters missing from an allocated
+	 * block map to the default glyph. */
+	vector<glyph*> m_apGlyphBlocks[256];
+	/** @brief Characters outside the BMP. */
+	unordered_map<wchar_t,glyph*> m_ExtraGlyphs;
+	glyph *m_pDefaultGlyph;
+
+	void BuildGlyphTable();
 
 	/**
 	 * @brief True for Hebrew, Arabic, Urdu fonts.
@@ -110,7 +110,6 @@ static Preference<Premium> g_Premium( "Premium", Premium_DoubleFor1Credit );
 Preference<bool> GameState::m_bAutoJoin( "AutoJoin", false );
 
 GameState::GameState() :
-	processedTiming(nullptr),
 	m_pCurGame(				Message_CurrentGameChanged ),
 	m_pCurStyle(			Message_CurrentStyleChanged ),
 	m_PlayMode(				Message_PlayModeChanged ),
@@ -199,7 +198,6 @@ GameState::~GameState()
 
 	SAFE_DELETE( m_Environment );
 	SAFE_DELETE( g_pImpl );
-	SAFE_DELETE( processedTiming );
 }
 
 PlayerNumber GameState::GetMasterPlayerNumber() const
@@ -212,14 +210,19 @@ void GameState::SetMasterPlayerNumber(const PlayerNumber p)
 	this->masterPlayerNumber = p;
 }
 
+/* The TimingData that is used for processing certain functions.  This is
+ * thread local because SongManager may load songs on several threads at once,
+ * and each of them needs its own timing data while calculating radar values. */
+static thread_local TimingData *g_pProcessedTiming = nullptr;
+
 TimingData * GameState::GetProcessedTimingData() const
 {
-	return this->processedTiming;
+	return g_pProcessedTiming;
 }
 
 void GameState::SetProcessedTimingData(TimingData * t)
 {
-	this->processedTiming = t;
+	g_pProcessedTiming = t;
 }
 
 void GameState::ApplyGameCommand( const RString &sCommand, PlayerNumber pn )
@@ -788,6 +791,9 @@ void GameState::CommitStageStats()
 
 	STATSMAN->CommitStatsToProfiles( &STATSMAN->m_CurStageStats );
 
+	// The new points and passed steps may have unlocked something.
+	UNLOCKMAN->UpdateLockedState();
+
 	// Update TotalPlaySeconds.
 	int iPlaySeconds = max( 0, (int) m_timeGameStarted.GetDeltaTime() );
 
@@ -2338,6 +2344,15 @@ void GameState::StoreRankingName( PlayerNumber pn, RString sName )
 
 	Profile *pProfile = PROFILEMAN->GetMachineProfile();
 
+	/* The names were filled in place, so the score journals don't know which
+	 * lists changed. */
+	if( !aFeats.empty() )
+	{
+		pProfile->RequireStatsSnapshot();
+		if( PROFILEMAN->IsPersistentProfile(pn) )
+			PROFILEMAN->GetProfile(pn)->RequireStatsSnapshot();
+	}
+
 	if( !PREFSMAN->m_bAllowMultipleHighScoreWithSameName )
 	{
 		// erase all but the highest score for each name
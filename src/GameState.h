@@ -39,8 +39,6 @@ class GameState
 {
 	/** @brief The player number used with Styles where one player controls both sides. */
 	PlayerNumber	masterPlayerNumber;
-	/** @brief The TimingData that is used for processing certain functions. */
-	TimingData * processedTiming;
 public:
 	/** @brief Set up the GameState with initial values. */
 	GameState();
@@ -170,6 +168,9 @@ public:
 
 	/**
 	 * @brief Retrieve the present timing data being processed.
+	 *
+	 * This is tracked per thread, so that songs loaded on worker threads can
+	 * calculate radar values without stepping on each other.
 	 * @return the timing data pointer. */
 	TimingData * GetProcessedTimingData() const;
 
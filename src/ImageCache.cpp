@@ -62,6 +62,7 @@ RString ImageCache::GetImageCachePath( RString sImageDir ,RString sImagePath )
  * by CacheImage or LoadImage on startup. */
 void ImageCache::Demand( RString sImageDir )
 {
+	LockMut( m_Mutex );
 	++g_iDemandRefcount;
 	if( g_iDemandRefcount > 1 )
 		return;
@@ -90,6 +91,7 @@ void ImageCache::Demand( RString sImageDir )
 /* Release images loaded on demand. */
 void ImageCache::Undemand( RString sImageDir )
 {
+	LockMut( m_Mutex );
 	--g_iDemandRefcount;
 	if( g_iDemandRefcount != 0 )
 		return;
@@ -106,6 +108,7 @@ void ImageCache::Undemand( RString sImageDir )
  * not be updated if the original file changes, for efficiency. */
 void ImageCache::LoadImage( RString sImageDir, RString sImagePath )
 {
+	LockMut( m_Mutex );
 	if( sImagePath == "" )
 		return; // nothing to do
 	if( PREFSMAN->m_ImageCache != IMGCACHE_LOW_RES_PRELOAD &&
@@ -148,6 +151,7 @@ void ImageCache::LoadImage( RString sImageDir, RString sImagePath )
 
 void ImageCache::OutputStats() const
 {
+	LockMut( m_Mutex );
 	int iTotalSize = 0;
 	for (auto const &it : g_ImagePathToImage)
 	{
@@ -169,7 +173,7 @@ void ImageCache::UnloadAllImages()
 }
 
 ImageCache::ImageCache()
-	: delay_save_cache(false)
+	: delay_save_cache(false), m_Mutex("ImageCache")
 {
 	ReadFromDisk();
 }
@@ -181,6 +185,7 @@ ImageCache::~ImageCache()
 
 void ImageCache::ReadFromDisk()
 {
+	LockMut( m_Mutex );
 	ImageData.ReadFile( IMAGE_CACHE_INDEX );	// don't care if this fails
 }
 
@@ -269,6 +274,7 @@ struct ImageTexture: public RageTexture
 /* If a image is cached, get its ID for use. */
 RageTextureID ImageCache::LoadCachedImage( RString sImageDir, RString sImagePath )
 {
+	LockMut( m_Mutex );
 	RageTextureID ID( GetImageCachePath(sImageDir,sImagePath) );
 
 	size_t Found = sImagePath.find("_blank");
@@ -334,6 +340,7 @@ static inline int closest( int num, int n1, int n2 )
  * load the cache file, too.  (This is done at startup.) */
 void ImageCache::CacheImage( RString sImageDir, RString sImagePath )
 {
+	LockMut( m_Mutex );
 	if( PREFSMAN->m_ImageCache != IMGCACHE_LOW_RES_PRELOAD &&
 	    PREFSMAN->m_ImageCache != IMGCACHE_LOW_RES_LOAD_ON_DEMAND )
 		return;
@@ -464,6 +471,7 @@ void ImageCache::CacheImageInternal( RString sImageDir, RString sImagePath )
 
 void ImageCache::WriteToDisk()
 {
+	LockMut( m_Mutex );
 	ImageData.WriteFile(IMAGE_CACHE_INDEX);
 }
 
@@ -2,6 +2,7 @@
 #define IMAGE_CACHE_H
 
 #include "IniFile.h"
+#include "RageThreads.h"
 
 #include "RageTexture.h"
 
@@ -32,6 +33,9 @@ private:
 	void CacheImageInternal( RString sImageDir, RString sImagePath );
 
 	IniFile ImageData;
+	/* Songs may be loaded on several threads at once; this protects
+	 * ImageData and the loaded images. */
+	mutable RageMutex m_Mutex;
 };
 
 extern ImageCache *IMAGECACHE; // global and accessible from anywhere in our program
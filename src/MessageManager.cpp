@@ -5,8 +5,9 @@
 #include "EnumHelper.h"
 #include "LuaManager.h"
 #include "RageLog.h"
+#include "arch/ArchHooks/ArchHooks.h"
 
-#include <set>
+#include <atomic>
 #include <map>
 
 MessageManager*	MESSAGEMAN = nullptr;	// global and accessible from anywhere in our program
@@ -90,14 +91,95 @@ static const char *MessageIDNames[] = {
 };
 XToString( MessageID );
 
+/* Every message name is interned to an index into the channel table the first
+ * time it's seen, with the MessageID names taking the first NUM_MessageID slots,
+ * so Broadcast never has to look anything up by string.
+ *
+ * The table is owned by the main thread, which is where subscriptions are made
+ * and nearly everything is broadcast.  Changes to it are made with g_Mutex held,
+ * so other threads can read it safely under the lock; the main thread reads it
+ * without locking.  Other threads never add names; a message created on another
+ * thread with an unknown name is resolved when it's broadcast, and if nobody has
+ * subscribed to it by then, there's nobody to deliver it to. */
 static RageMutex g_Mutex( "MessageManager" );
+static thread_local bool g_bIsMainThread = false;
 
-typedef set<IMessageSubscriber*> SubscribersSet;
-static map<RString,SubscribersSet> g_MessageToSubscribers;
+struct MessageChannel
+{
+	MessageChannel( const RString &sName ): m_sName(sName), m_iDispatchDepth(0),
+		m_bHasRemoved(false), m_iBroadcasts(0), m_iMicroseconds(0) { }
+
+	RString m_sName;
+	vector<IMessageSubscriber*> m_vSubscribers;
+
+	/* While the main thread is dispatching this message, unsubscribing leaves
+	 * a null entry behind instead of moving the rest of the list around. */
+	int m_iDispatchDepth;
+	bool m_bHasRemoved;
+
+	std::atomic<uint64_t> m_iBroadcasts;
+	std::atomic<uint64_t> m_iMicroseconds;
+};
+
+struct MessageTable
+{
+	MessageTable()
+	{
+		FOREACH_ENUM( MessageID, m )
+			Add( MessageIDToString(m) );
+	}
+
+	int Add( const RString &sName )
+	{
+		int iID = m_vChannels.size();
+		m_vChannels.push_back( new MessageChannel(sName) );
+		m_NameToID[sName] = iID;
+		return iID;
+	}
+
+	int Find( const RString &sName ) const
+	{
+		map<RString,int>::const_iterator it = m_NameToID.find( sName );
+		return it == m_NameToID.end()? -1:it->second;
+	}
+
+	vector<MessageChannel*> m_vChannels;
+	map<RString,int> m_NameToID;
+};
+
+static MessageTable &GetMessageTable()
+{
+	static MessageTable table;
+	return table;
+}
+
+/* Return the channel index for sName, adding it if bCreate is set and this is
+ * the main thread.  Returns -1 if it isn't known. */
+static int InternMessageName( const RString &sName, bool bCreate )
+{
+	MessageTable &table = GetMessageTable();
+	if( g_bIsMainThread )
+	{
+		int iID = table.Find( sName );
+		if( iID != -1 || !bCreate )
+			return iID;
+		LockMut( g_Mutex );
+		return table.Add( sName );
+	}
+
+	LockMut( g_Mutex );
+	int iID = table.Find( sName );
+	/* Before MessageManager exists there's no main thread yet; allow names to
+	 * be added during startup. */
+	if( iID == -1 && bCreate && MESSAGEMAN == nullptr )
+		iID = table.Add( sName );
+	return iID;
+}
 
 Message::Message( const RString &s )
 {
 	m_sName = s;
+	m_iID = InternMessageName( s, true );
 	m_pParams = new LuaTable;
 	m_bBroadcast = false;
 }
@@ -105,6 +187,7 @@ Message::Message( const RString &s )
 Message::Message(const MessageID id)
 {
 	m_sName= MessageIDToString(id);
+	m_iID = id;
 	m_pParams = new LuaTable;
 	m_bBroadcast = false;
 }
@@ -112,6 +195,7 @@ Message::Message(const MessageID id)
 Message::Message( const RString &s, const LuaReference &params )
 {
 	m_sName = s;
+	m_iID = InternMessageName( s, true );
 	m_bBroadcast = false;
 	Lua *L = LUA->Get();
 	m_pParams = new LuaTable; // XXX: creates an extra table
@@ -126,6 +210,12 @@ Message::~Message()
 	delete m_pParams;
 }
 
+void Message::SetName( const RString &sName )
+{
+	m_sName = sName;
+	m_iID = InternMessageName( sName, true );
+}
+
 void Message::PushParamTable( lua_State *L )
 {
 	m_pParams->PushSelf( L );
@@ -157,6 +247,10 @@ void Message::SetParamFromStack( lua_State *L, const RString &sName )
 MessageManager::MessageManager()
 {
 	m_Logging= false;
+	m_bProfiling = false;
+	g_bIsMainThread = true;
+	GetMessageTable();
+
 	// Register with Lua.
 	{
 		Lua *L = LUA->Get();
@@ -175,34 +269,56 @@ MessageManager::~MessageManager()
 
 void MessageManager::Subscribe( IMessageSubscriber* pSubscriber, const RString& sMessage )
 {
-	LockMut(g_Mutex);
-
-	SubscribersSet& subs = g_MessageToSubscribers[sMessage];
-#ifdef DEBUG
-	SubscribersSet::iterator iter = subs.find(pSubscriber);
-	ASSERT_M( iter == subs.end(), ssprintf("already subscribed to '%s'",sMessage.c_str()) );
-#endif
-	subs.insert( pSubscriber );
+	SubscribeByID( pSubscriber, InternMessageName(sMessage, true) );
 }
 
 void MessageManager::Subscribe( IMessageSubscriber* pSubscriber, MessageID m )
 {
-	Subscribe( pSubscriber, MessageIDToString(m) );
+	SubscribeByID( pSubscriber, m );
 }
 
-void MessageManager::Unsubscribe( IMessageSubscriber* pSubscriber, const RString& sMessage )
+void MessageManager::SubscribeByID( IMessageSubscriber* pSubscriber, int iID )
 {
+	ASSERT_M( iID != -1, "subscribing to a new message from outside the main thread" );
 	LockMut(g_Mutex);
 
-	SubscribersSet& subs = g_MessageToSubscribers[sMessage];
-	SubscribersSet::iterator iter = subs.find(pSubscriber);
-	ASSERT( iter != subs.end() );
-	subs.erase( iter );
+	MessageChannel *pChannel = GetMessageTable().m_vChannels[iID];
+	vector<IMessageSubscriber*> &subs = pChannel->m_vSubscribers;
+#ifdef DEBUG
+	ASSERT_M( find(subs.begin(), subs.end(), pSubscriber) == subs.end(),
+		ssprintf("already subscribed to '%s'",pChannel->m_sName.c_str()) );
+#endif
+	subs.push_back( pSubscriber );
+}
+
+void MessageManager::Unsubscribe( IMessageSubscriber* pSubscriber, const RString& sMessage )
+{
+	UnsubscribeByID( pSubscriber, InternMessageName(sMessage, false) );
 }
 
 void MessageManager::Unsubscribe( IMessageSubscriber* pSubscriber, MessageID m )
 {
-	Unsubscribe( pSubscriber, MessageIDToString(m) );
+	UnsubscribeByID( pSubscriber, m );
+}
+
+void MessageManager::UnsubscribeByID( IMessageSubscriber* pSubscriber, int iID )
+{
+	ASSERT( iID != -1 );
+	LockMut(g_Mutex);
+
+	MessageChannel *pChannel = GetMessageTable().m_vChannels[iID];
+	vector<IMessageSubscriber*> &subs = pChannel->m_vSubscribers;
+	vector<IMessageSubscriber*>::iterator iter = find( subs.begin(), subs.end(), pSubscriber );
+	ASSERT( iter != subs.end() );
+	if( pChannel->m_iDispatchDepth > 0 )
+	{
+		*iter = nullptr;
+		pChannel->m_bHasRemoved = true;
+	}
+	else
+	{
+		subs.erase( iter );
+	}
 }
 
 void MessageManager::Broadcast( Message &msg ) const
@@ -213,15 +329,59 @@ void MessageManager::Broadcast( Message &msg ) const
 	}
 	msg.SetBroadcast(true);
 
-	LockMut(g_Mutex);
+	const int64_t iStartTime = m_bProfiling? ArchHooks::GetMicrosecondsSinceStart(true):0;
+	MessageChannel *pChannel = nullptr;
 
-	map<RString,SubscribersSet>::const_iterator iter = g_MessageToSubscribers.find( msg.GetName() );
-	if( iter == g_MessageToSubscribers.end() )
-		return;
+	if( g_bIsMainThread )
+	{
+		/* Index the list each time rather than iterating it: handlers may
+		 * subscribe, which can reallocate it.  Anything subscribed during
+		 * dispatch doesn't get this message. */
+		int iID = msg.GetID();
+		if( iID == -1 )
+			iID = InternMessageName( msg.GetName(), true );
+		pChannel = GetMessageTable().m_vChannels[iID];
+		vector<IMessageSubscriber*> &subs = pChannel->m_vSubscribers;
+		++pChannel->m_iDispatchDepth;
+		for( size_t i = 0, iCount = subs.size(); i < iCount; ++i )
+		{
+			IMessageSubscriber *pSubscriber = subs[i];
+			if( pSubscriber != nullptr )
+				pSubscriber->HandleMessage( msg );
+		}
+
+		if( --pChannel->m_iDispatchDepth == 0 && pChannel->m_bHasRemoved )
+		{
+			LockMut(g_Mutex);
+			subs.erase( remove(subs.begin(), subs.end(), (IMessageSubscriber *) nullptr), subs.end() );
+			pChannel->m_bHasRemoved = false;
+		}
+	}
+	else
+	{
+		LockMut(g_Mutex);
+
+		MessageTable &table = GetMessageTable();
+		const int iID = msg.GetID() != -1? msg.GetID():table.Find( msg.GetName() );
+		if( iID == -1 )
+			return;
+		pChannel = table.m_vChannels[iID];
+
+		/* Dispatch from a copy, so the main thread's removal bookkeeping is
+		 * left alone. */
+		const vector<IMessageSubscriber*> subs = pChannel->m_vSubscribers;
+		for (IMessageSubscriber *subscriber : subs)
+		{
+			if( subscriber != nullptr )
+				subscriber->HandleMessage( msg );
+		}
+	}
 
-	for (IMessageSubscriber *subscriber : iter->second)
+	pChannel->m_iBroadcasts.fetch_add( 1, std::memory_order_relaxed );
+	if( m_bProfiling )
 	{
-		subscriber->HandleMessage( msg );
+		const int64_t iTime = ArchHooks::GetMicrosecondsSinceStart(true) - iStartTime;
+		pChannel->m_iMicroseconds.fetch_add( iTime, std::memory_order_relaxed );
 	}
 }
 
@@ -234,14 +394,55 @@ void MessageManager::Broadcast( const RString& sMessage ) const
 
 void MessageManager::Broadcast( MessageID m ) const
 {
-	Broadcast( MessageIDToString(m) );
+	Message msg(m);
+	Broadcast( msg );
 }
 
 bool MessageManager::IsSubscribedToMessage( IMessageSubscriber* pSubscriber, const RString &sMessage ) const
 {
-	SubscribersSet& subs = g_MessageToSubscribers[sMessage];
-	return subs.find( pSubscriber ) != subs.end();
-}	
+	return IsSubscribedToMessage( pSubscriber, InternMessageName(sMessage, false) );
+}
+
+bool MessageManager::IsSubscribedToMessage( IMessageSubscriber* pSubscriber, MessageID message ) const
+{
+	return IsSubscribedToMessage( pSubscriber, (int) message );
+}
+
+bool MessageManager::IsSubscribedToMessage( IMessageSubscriber* pSubscriber, int iID ) const
+{
+	if( iID == -1 )
+		return false;
+	LockMut(g_Mutex);
+	const vector<IMessageSubscriber*> &subs = GetMessageTable().m_vChannels[iID]->m_vSubscribers;
+	return find( subs.begin(), subs.end(), pSubscriber ) != subs.end();
+}
+
+void MessageManager::GetBroadcastStats( vector<BroadcastStats> &vOut ) const
+{
+	LockMut(g_Mutex);
+	for (MessageChannel const *pChannel : GetMessageTable().m_vChannels)
+	{
+		BroadcastStats stats;
+		stats.sName = pChannel->m_sName;
+		stats.iBroadcasts = pChannel->m_iBroadcasts.load( std::memory_order_relaxed );
+		stats.fSeconds = pChannel->m_iMicroseconds.load( std::memory_order_relaxed ) / 1000000.0f;
+		stats.iSubscribers = 0;
+		for (IMessageSubscriber const *pSubscriber : pChannel->m_vSubscribers)
+			if( pSubscriber != nullptr )
+				++stats.iSubscribers;
+		vOut.push_back( stats );
+	}
+}
+
+void MessageManager::ResetBroadcastStats()
+{
+	LockMut(g_Mutex);
+	for (MessageChannel *pChannel : GetMessageTable().m_vChannels)
+	{
+		pChannel->m_iBroadcasts.store( 0, std::memory_order_relaxed );
+		pChannel->m_iMicroseconds.store( 0, std::memory_order_relaxed );
+	}
+}
 
 void IMessageSubscriber::ClearMessages( const RString sMessage )
 {
@@ -250,8 +451,8 @@ void IMessageSubscriber::ClearMessages( const RString sMessage )
 MessageSubscriber::MessageSubscriber( const MessageSubscriber &cpy ):
 	IMessageSubscriber(cpy)
 {
-	for (RString const &msg : cpy.m_vsSubscribedTo)
-		this->SubscribeToMessage( msg );
+	for (int iID : cpy.m_viSubscribedTo)
+		this->SubscribeToMessageID( iID );
 }
 
 MessageSubscriber &MessageSubscriber::operator=(const MessageSubscriber &cpy)
@@ -261,29 +462,33 @@ MessageSubscriber &MessageSubscriber::operator=(const MessageSubscriber &cpy)
 
 	UnsubscribeAll();
 
-	for (RString const &msg : cpy.m_vsSubscribedTo)
-		this->SubscribeToMessage( msg );
+	for (int iID : cpy.m_viSubscribedTo)
+		this->SubscribeToMessageID( iID );
 
 	return *this;
 }
 
 void MessageSubscriber::SubscribeToMessage( const RString &sMessageName )
 {
-	MESSAGEMAN->Subscribe( this, sMessageName );
-	m_vsSubscribedTo.push_back( sMessageName );
+	SubscribeToMessageID( InternMessageName(sMessageName, true) );
 }
 
 void MessageSubscriber::SubscribeToMessage( MessageID message )
 {
-	MESSAGEMAN->Subscribe( this, message );
-	m_vsSubscribedTo.push_back( MessageIDToString(message) );
+	SubscribeToMessageID( message );
+}
+
+void MessageSubscriber::SubscribeToMessageID( int iID )
+{
+	MESSAGEMAN->SubscribeByID( this, iID );
+	m_viSubscribedTo.push_back( iID );
 }
 
 void MessageSubscriber::UnsubscribeAll()
 {
-	for (RString const &s : m_vsSubscribedTo)
-		MESSAGEMAN->Unsubscribe( this, s );
-	m_vsSubscribedTo.clear();
+	for (int iID : m_viSubscribedTo)
+		MESSAGEMAN->UnsubscribeByID( this, iID );
+	m_viSubscribedTo.clear();
 }
 
 
@@ -312,11 +517,45 @@ public:
 		p->SetLogging(lua_toboolean(L, -1));
 		COMMON_RETURN_SELF;
 	}
+	static int SetProfiling( T* p, lua_State *L )
+	{
+		p->SetProfiling( BArg(1) );
+		COMMON_RETURN_SELF;
+	}
+	static int GetBroadcastStats( T* p, lua_State *L )
+	{
+		vector<MessageManager::BroadcastStats> vStats;
+		p->GetBroadcastStats( vStats );
+
+		lua_newtable( L );
+		for (MessageManager::BroadcastStats const &stats : vStats)
+		{
+			if( stats.iBroadcasts == 0 )
+				continue;
+			lua_newtable( L );
+			lua_pushnumber( L, (lua_Number) stats.iBroadcasts );
+			lua_setfield( L, -2, "Count" );
+			lua_pushnumber( L, stats.fSeconds );
+			lua_setfield( L, -2, "Seconds" );
+			lua_pushnumber( L, stats.iSubscribers );
+			lua_setfield( L, -2, "Subscribers" );
+			lua_setfield( L, -2, stats.sName.c_str() );
+		}
+		return 1;
+	}
+	static int ResetBroadcastStats( T* p, lua_State *L )
+	{
+		p->ResetBroadcastStats();
+		COMMON_RETURN_SELF;
+	}
 
 	LunaMessageManager()
 	{
 		ADD_METHOD( Broadcast );
 		ADD_METHOD( SetLogging );
+		ADD_METHOD( SetProfiling );
+		ADD_METHOD( GetBroadcastStats );
+		ADD_METHOD( ResetBroadcastStats );
 	}
 };
 
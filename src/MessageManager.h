@@ -95,8 +95,11 @@ struct Message
 	Message( const RString &s, const LuaReference &params );
 	~Message();
 
-	void SetName( const RString &sName ) { m_sName = sName; }
+	void SetName( const RString &sName );
 	RString GetName() const { return m_sName; }
+	/** @brief The interned index of this message's name, or -1 if it wasn't
+	 * known when this message was created outside of the main thread. */
+	int GetID() const { return m_iID; }
 
 	bool IsBroadcast() const { return m_bBroadcast; }
 	void SetBroadcast( bool b ) { m_bBroadcast = b; }
@@ -137,10 +140,11 @@ struct Message
 	}
 
 	bool operator==( const RString &s ) const { return m_sName == s; }
-	bool operator==( MessageID id ) const { return MessageIDToString(id) == m_sName; }
+	bool operator==( MessageID id ) const { return m_iID == id; }
 
 private:
 	RString m_sName;
+	int m_iID;
 	LuaTable *m_pParams;
 	bool m_bBroadcast;
 
@@ -167,7 +171,7 @@ private:
 class MessageSubscriber : public IMessageSubscriber
 {
 public:
-	MessageSubscriber(): m_vsSubscribedTo() {}
+	MessageSubscriber(): m_viSubscribedTo() {}
 	MessageSubscriber( const MessageSubscriber &cpy );
 	MessageSubscriber &operator=(const MessageSubscriber &cpy);
 
@@ -180,7 +184,9 @@ public:
 	void UnsubscribeAll();
 
 private:
-	vector<RString> m_vsSubscribedTo;
+	void SubscribeToMessageID( int iID );
+
+	vector<int> m_viSubscribedTo;
 };
 
 /** @brief Deliver messages to any part of the program as needed. */
@@ -198,13 +204,35 @@ public:
 	void Broadcast( const RString& sMessage ) const;
 	void Broadcast( MessageID m ) const;
 	bool IsSubscribedToMessage( IMessageSubscriber* pSubscriber, const RString &sMessage ) const;
-	inline bool IsSubscribedToMessage( IMessageSubscriber* pSubscriber, MessageID message ) const { return IsSubscribedToMessage( pSubscriber, MessageIDToString(message) ); }
+	bool IsSubscribedToMessage( IMessageSubscriber* pSubscriber, MessageID message ) const;
 
 	void SetLogging(bool set) { m_Logging= set; }
 	bool m_Logging;
 
+	/** @brief Per-message broadcast statistics, for profiling. */
+	struct BroadcastStats
+	{
+		RString sName;
+		uint64_t iBroadcasts;
+		/** @brief Time spent in handlers; only counted while profiling is on.
+		 * This includes any broadcasts made by the handlers. */
+		float fSeconds;
+		int iSubscribers;
+	};
+	void SetProfiling( bool b ) { m_bProfiling = b; }
+	void GetBroadcastStats( vector<BroadcastStats> &vOut ) const;
+	void ResetBroadcastStats();
+
 	// Lua
 	void PushSelf( lua_State *L );
+
+private:
+	friend class MessageSubscriber;
+	void SubscribeByID( IMessageSubscriber* pSubscriber, int iID );
+	void UnsubscribeByID( IMessageSubscriber* pSubscriber, int iID );
+	bool IsSubscribedToMessage( IMessageSubscriber* pSubscriber, int iID ) const;
+
+	bool m_bProfiling;
 };
 
 extern MessageManager*	MESSAGEMAN;	// global and accessible from anywhere in our program
@@ -219,7 +247,7 @@ private:
 public:
 	explicit BroadcastOnChange( MessageID m ) { mSendWhenChanged = m; }
 	const T Get() const { return val; }
-	void Set( T t ) { val = t; MESSAGEMAN->Broadcast( MessageIDToString(mSendWhenChanged) ); }
+	void Set( T t ) { val = t; MESSAGEMAN->Broadcast( mSendWhenChanged ); }
 	operator T () const { return val; }
 	bool operator == ( const T &other ) const { return val == other; }
 	bool operator != ( const T &other ) const { return val != other; }
@@ -259,7 +287,7 @@ private:
 public:
 	explicit BroadcastOnChangePtr( MessageID m ) { mSendWhenChanged = m; val = nullptr; }
 	T* Get() const { return val; }
-	void Set( T* t ) { val = t; if(MESSAGEMAN) MESSAGEMAN->Broadcast( MessageIDToString(mSendWhenChanged) ); }
+	void Set( T* t ) { val = t; if(MESSAGEMAN) MESSAGEMAN->Broadcast( mSendWhenChanged ); }
 	/* This is only intended to be used for setting temporary values; always
 	 * restore the original value when finished, so listeners don't get confused
 	 * due to missing a message. */
@@ -14,29 +14,96 @@
 
 #include "global.h"
 #include "MsdFile.h"
-#include "RageFile.h"
 #include "RageLog.h"
 #include "RageUtil.h"
 
-void MsdFile::AddParam( const char *buf, int len )
+static inline bool IsTrailingSpace( char c )
 {
-	values.back().params.push_back( RString(buf, len) );
+	return c == '\r' || c == '\n' || c == ' ' || c == '\t';
+}
+
+/* Apply the same comment and escape rules as ReadBuf, to a parameter that
+ * needs them.  The parameter always ends at a control character or at the
+ * end of the file, so a comment or escape can't straddle its end. */
+RString MsdFile::param_t::GetString() const
+{
+	if( !m_bNeedsProcessing )
+		return RString( m_pData, m_iSize );
+
+	RString sRet;
+	sRet.reserve( m_iSize );
+	const char *p = m_pData;
+	const char *pEnd = m_pData + m_iSize;
+	while( p < pEnd )
+	{
+		if( p+1 < pEnd && p[0] == '/' && p[1] == '/' )
+		{
+			do
+			{
+				++p;
+			} while( p < pEnd && *p != '\n' );
+			continue;
+		}
+
+		if( m_bUnescape && *p == '\\' )
+			++p;
+		if( p < pEnd )
+			sRet += *p++;
+	}
+
+	if( m_bTrimEnd )
+	{
+		size_t iLen = sRet.size();
+		while( iLen > 0 && IsTrailingSpace(sRet[iLen-1]) )
+			--iLen;
+		sRet.erase( iLen );
+	}
+	return sRet;
+}
+
+void MsdFile::AddParam( const char *buf, unsigned len, bool bNeedsProcessing, bool bTrimEnd, bool bUnescape )
+{
+	/* Without comments or escapes, the text is already what we'd return, so
+	 * trim it now. */
+	if( bTrimEnd && !bNeedsProcessing )
+	{
+		while( len > 0 && IsTrailingSpace(buf[len-1]) )
+			--len;
+		bTrimEnd = false;
+	}
+
+	param_t param;
+	param.m_pData = buf;
+	param.m_iSize = len;
+	param.m_bNeedsProcessing = bNeedsProcessing;
+	param.m_bUnescape = bUnescape;
+	param.m_bTrimEnd = bTrimEnd;
+	m_Params.push_back( param );
+	++m_Values.back().m_iNumParams;
 }
 
 void MsdFile::AddValue() /* (no extra charge) */
 {
-	values.push_back( value_t() );
-	values.back().params.reserve( 32 );
+	m_Values.push_back( value_t() );
+	m_Values.back().m_iFirstParam = m_Params.size();
 }
 
-void MsdFile::ReadBuf( const char *buf, int len, bool bUnescape )
+void MsdFile::ReadBuf( const char *buf, unsigned len, bool bUnescape )
 {
-	values.reserve( 64 );
+	m_Values.clear();
+	m_Params.clear();
+	m_Values.reserve( 64 );
+	m_Params.reserve( 256 );
 
 	bool ReadingValue=false;
-	int i = 0;
-	char *cProcessed = new char[len];
-	int iProcessedLen = -1;
+	unsigned i = 0;
+	/* Where the current param starts, and whether it has anything in it that
+	 * GetString will have to remove. */
+	unsigned iParamStart = 0;
+	bool bNeedsProcessing = false;
+	/* Whether the param's text since its last newline is all whitespace, after
+	 * comments and escapes are removed. */
+	bool bLineBlank = true;
 	while( i < len )
 	{
 		if( i+1 < len && buf[i] == '/' && buf[i+1] == '/' )
@@ -47,6 +114,7 @@ void MsdFile::ReadBuf( const char *buf, int len, bool bUnescape )
 				i++;
 			} while( i < len && buf[i] != '\n' );
 
+			bNeedsProcessing = true;
 			continue;
 		}
 
@@ -56,36 +124,15 @@ void MsdFile::ReadBuf( const char *buf, int len, bool bUnescape )
 			 * If we get a # when we thought we were inside a value, assume we
 			 * missed the ;.  Back up and end the value. */
 			// Make sure this # is the first non-whitespace character on the line.
-			bool FirstChar = true;
-			int j = iProcessedLen;
-			while( j > 0 && cProcessed[j - 1] != '\r' && cProcessed[j - 1] != '\n' )
-			{
-				if( cProcessed[j - 1] == ' ' || cProcessed[j - 1] == '\t' )
-				{
-					--j;
-					continue;
-				}
-
-				FirstChar = false;
-				break;
-			}
-
-			if( !FirstChar )
+			if( !bLineBlank )
 			{
 				/* We're not the first char on a line.  Treat it as if it were a normal character. */
-				cProcessed[iProcessedLen++] = buf[i++];
+				++i;
 				continue;
 			}
 
 			/* Skip newlines and whitespace before adding the value. */
-			iProcessedLen = j;
-			while( iProcessedLen > 0 &&
-			       ( cProcessed[iProcessedLen - 1] == '\r' || cProcessed[iProcessedLen - 1] == '\n' ||
-			         cProcessed[iProcessedLen - 1] == ' ' || cProcessed[iProcessedLen - 1] == '\t' ) )
-				--iProcessedLen;
-
-			AddParam( cProcessed, iProcessedLen );
-			iProcessedLen = 0;
+			AddParam( buf+iParamStart, i-iParamStart, bNeedsProcessing, true, bUnescape );
 			ReadingValue=false;
 		}
 
@@ -105,15 +152,17 @@ void MsdFile::ReadBuf( const char *buf, int len, bool bUnescape )
 			continue; /* nothing else is meaningful outside of a value */
 		}
 
-		/* : and ; end the current param, if any. */
-		if( iProcessedLen != -1 && (buf[i] == ':' || buf[i] == ';') )
-			AddParam( cProcessed, iProcessedLen );
+		/* : and ; end the current param. */
+		if( buf[i] == ':' || buf[i] == ';' )
+			AddParam( buf+iParamStart, i-iParamStart, bNeedsProcessing, false, bUnescape );
 
 		/* # and : begin new params. */
 		if( buf[i] == '#' || buf[i] == ':' )
 		{
 			++i;
-			iProcessedLen = 0;
+			iParamStart = i;
+			bNeedsProcessing = false;
+			bLineBlank = true;
 			continue;
 		}
 
@@ -128,52 +177,51 @@ void MsdFile::ReadBuf( const char *buf, int len, bool bUnescape )
 		/* We've gone through all the control characters.  All that is left is either an escaped character, 
 		 * ie \#, \\, \:, etc., or a regular character. */
 		if( bUnescape && i < len && buf[i] == '\\' )
+		{
 			++i;
+			bNeedsProcessing = true;
+		}
 		if( i < len )
 		{
-			cProcessed[iProcessedLen++] = buf[i++];
+			const char c = buf[i++];
+			if( c == '\r' || c == '\n' )
+				bLineBlank = true;
+			else if( c != ' ' && c != '\t' )
+				bLineBlank = false;
 		}
 	}
 
 	/* Add any unterminated value at the very end. */
 	if( ReadingValue )
-		AddParam( cProcessed, iProcessedLen );
+		AddParam( buf+iParamStart, len-iParamStart, bNeedsProcessing, false, bUnescape );
 
-	delete [] cProcessed;
+	/* m_Params won't move from here on. */
+	for( unsigned v = 0; v < m_Values.size(); ++v )
+		m_Values[v].m_pParams = m_Params.data() + m_Values[v].m_iFirstParam;
 }
 
 // returns true if successful, false otherwise
 bool MsdFile::ReadFile( RString sNewPath, bool bUnescape )
 {
 	error = "";
+	m_sBuffer = RString();
+	m_Values.clear();
+	m_Params.clear();
 
-	RageFile f;
-	/* Open a file. */
-	if( !f.Open( sNewPath ) )
-	{
-		error = f.GetError();
-		return false;
-	}
-
-	// allocate a string to hold the file
-	RString FileString;
-	FileString.reserve( f.GetFileSize() );
-
-	int iBytesRead = f.Read( FileString );
-	if( iBytesRead == -1 )
-	{
-		error = f.GetError();
+	/* Map the file, or read it into one buffer if it can't be mapped. */
+	if( !m_File.Open(sNewPath, error) )
 		return false;
-	}
 
-	ReadBuf( FileString.c_str(), iBytesRead, bUnescape );
+	ReadBuf( m_File.GetData(), m_File.GetSize(), bUnescape );
 
 	return true;
 }
 
 void MsdFile::ReadFromString( const RString &sString, bool bUnescape )
 {
-	ReadBuf( sString.c_str(), sString.size(), bUnescape );
+	m_File.Close();
+	m_sBuffer = sString;
+	ReadBuf( m_sBuffer.data(), m_sBuffer.size(), bUnescape );
 }
 
 RString MsdFile::GetParam(unsigned val, unsigned par) const
@@ -181,7 +229,7 @@ RString MsdFile::GetParam(unsigned val, unsigned par) const
 	if( val >= GetNumValues() || par >= GetNumParams(val) )
 		return RString();
 
-	return values[val].params[par];
+	return m_Values[val].GetParamView(par).GetString();
 }
 
 /*
@@ -1,36 +1,82 @@
 #ifndef MSDFILE_H
 #define MSDFILE_H
 
-/** @brief The class that reads the various .SSC, .SM, .SMA, .DWI, and .MSD files. */
+#include "RageUtil_MappedFile.h"
+
+/**
+ * @brief The class that reads the various .SSC, .SM, .SMA, .DWI, and .MSD files.
+ *
+ * The file is kept in one buffer (mapped, when possible), and parameters are
+ * views into it.  A parameter is only copied out when it's asked for, and any
+ * comments or escapes in it are stripped at that point. */
 class MsdFile  
 {
 public:
+	/** @brief One parameter, as it appears in the file. */
+	struct param_t
+	{
+		/** @brief The start of the parameter in the file buffer. */
+		const char *m_pData;
+		/** @brief The length of the parameter in the file buffer. */
+		unsigned m_iSize;
+		/** @brief Set if the parameter contains comments or escapes that have to be removed. */
+		bool m_bNeedsProcessing;
+		/** @brief Set if backslashes escape the next character. */
+		bool m_bUnescape;
+		/** @brief Set if trailing whitespace has to be trimmed once processed. */
+		bool m_bTrimEnd;
+
+		/**
+		 * @brief Get the size of the parameter in the file.
+		 *
+		 * This is exact unless m_bNeedsProcessing is set, in which case it's an
+		 * upper bound. */
+		unsigned GetRawSize() const { return m_iSize; }
+		/** @brief Copy out the parameter, with comments and escapes removed. */
+		RString GetString() const;
+	};
+
 	/**
 	 * @brief The list of params found in the files.
 	 *
 	 * Note that &#35;param:param:param:param; is one whole value. */
 	struct value_t
 	{
-		/** @brief The list of parameters. */
-		vector<RString> params;
 		/** @brief Set up the parameters with default values. */
-		value_t(): params() {}
-		
+		value_t(): m_pParams(nullptr), m_iFirstParam(0), m_iNumParams(0) {}
+
+		/** @brief Retrieve the number of parameters in this value. */
+		unsigned GetNumParams() const { return m_iNumParams; }
+		/**
+		 * @brief Access a parameter without copying it.
+		 * @param i the index, which must be in range.
+		 * @return the parameter.
+		 */
+		const param_t &GetParamView( unsigned i ) const { ASSERT( i < m_iNumParams ); return m_pParams[i]; }
+
 		/**
 		 * @brief Access the proper parameter.
 		 * @param i the index.
 		 * @return the proper parameter.
 		 */
-		RString operator[]( unsigned i ) const { if( i >= params.size() ) return RString(); return params[i]; }
+		RString operator[]( unsigned i ) const { if( i >= m_iNumParams ) return RString(); return m_pParams[i].GetString(); }
+
+	private:
+		friend class MsdFile;
+		const param_t *m_pParams;
+		unsigned m_iFirstParam;
+		unsigned m_iNumParams;
 	};
 	
-	MsdFile(): values(), error("") {}
+	MsdFile(): m_Values(), m_Params(), error("") {}
 
 	/** @brief Remove the MSDFile. */
 	virtual ~MsdFile() { }
 
 	/**
 	 * @brief Attempt to read an MSD file.
+	 *
+	 * Any values read before are discarded.
 	 * @param sFilePath the path to the file.
 	 * @param bUnescape a flag to see if we need to unescape values.
 	 * @return its success or failure.
@@ -38,6 +84,8 @@ public:
 	bool ReadFile( RString sFilePath, bool bUnescape );
 	/**
 	 * @brief Attempt to read an MSD file.
+	 *
+	 * Any values read before are discarded.
 	 * @param sString the path to the file.
 	 * @param bUnescape a flag to see if we need to unescape values.
 	 * @return its success or failure.
@@ -52,19 +100,19 @@ public:
 	/**
 	 * @brief Retrieve the number of values for each tag.
 	 * @return the nmber of values. */
-	unsigned GetNumValues() const { return values.size(); }
+	unsigned GetNumValues() const { return m_Values.size(); }
 	/**
 	 * @brief Get the number of parameters for the current index.
 	 * @param val the current value index.
 	 * @return the number of params.
 	 */
-	unsigned GetNumParams( unsigned val ) const { if( val >= GetNumValues() ) return 0; return values[val].params.size(); }
+	unsigned GetNumParams( unsigned val ) const { if( val >= GetNumValues() ) return 0; return m_Values[val].GetNumParams(); }
 	/**
 	 * @brief Get the specified value.
 	 * @param val the current value index.
 	 * @return The specified value.
 	 */
-	const value_t &GetValue( unsigned val ) const { ASSERT(val < GetNumValues()); return values[val]; }
+	const value_t &GetValue( unsigned val ) const { ASSERT(val < GetNumValues()); return m_Values[val]; }
 	/**
 	 * @brief Retrieve the specified parameter.
 	 * @param val the current value index.
@@ -76,27 +124,42 @@ public:
 
 private:
 	/**
-	 * @brief Attempt to read an MSD file from the buffer.
+	 * @brief Find the values and parameters in the buffer.
+	 *
+	 * The buffer must stay alive as long as the values do.
 	 * @param buf the buffer containing the MSD file.
 	 * @param len the length of the buffer.
 	 * @param bUnescape a flag to see if we need to unescape values.
 	 */
-	void ReadBuf( const char *buf, int len, bool bUnescape );
+	void ReadBuf( const char *buf, unsigned len, bool bUnescape );
 	/**
 	 * @brief Add a new parameter.
 	 * @param buf the new parameter.
 	 * @param len the length of the new parameter.
+	 * @param bNeedsProcessing set if the parameter has comments or escapes.
+	 * @param bTrimEnd set if trailing whitespace should be removed.
+	 * @param bUnescape a flag to see if we need to unescape values.
 	 */
-	void AddParam( const char *buf, int len );
+	void AddParam( const char *buf, unsigned len, bool bNeedsProcessing, bool bTrimEnd, bool bUnescape );
 	/**
 	 * @brief Add a new value.
 	 */
 	void AddValue();
 
+	/** @brief The file read by ReadFile. */
+	RageFileMapping m_File;
+	/** @brief The string read by ReadFromString. */
+	RString m_sBuffer;
 	/** @brief The list of values. */
-	vector<value_t> values;
+	vector<value_t> m_Values;
+	/** @brief Every parameter of every value, in order. */
+	vector<param_t> m_Params;
 	/** @brief The error string. */
 	RString error;
+
+	// The values point into our own buffers, so copying isn't allowed.
+	MsdFile& operator=(const MsdFile& rhs);
+	MsdFile(const MsdFile& rhs);
 };
 
 #endif
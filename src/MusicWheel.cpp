@@ -26,6 +26,19 @@
 static Preference<bool> g_bMoveRandomToEnd( "MoveRandomToEnd", false );
 static Preference<bool> g_bPrecacheAllSorts( "PreCacheAllWheelSorts", false);
 
+/* Every song a sort order can show, already sorted.  Sorting is the slow part
+ * of building the wheel on a large library, and it only changes when the
+ * songs do, so this is shared by every wheel and rebuilt only when the key
+ * changes; GetSongList's filtering is then one pass over it. */
+struct SortedSongList
+{
+	RString sKey;
+	vector<Song*> vpSongs;
+	/* Each song's section name, if the sort uses sections. */
+	vector<RString> vsSections;
+};
+static SortedSongList g_SortedSongs[NUM_SortOrder];
+
 #define NUM_WHEEL_ITEMS		((int)ceil(NUM_WHEEL_ITEMS_TO_DRAW+2))
 #define WHEEL_TEXT(s)		THEME->GetString( "MusicWheel", ssprintf("%sText",s.c_str()) );
 #define CUSTOM_ITEM_WHEEL_TEXT(s)		THEME->GetString( "MusicWheel", ssprintf("CustomItem%sText",s.c_str()) );
@@ -125,6 +138,8 @@ void MusicWheel::Load( RString sType )
 	FOREACH_ENUM( SortOrder, so ) {
 		m_WheelItemDatasStatus[so]=INVALID;
 	}
+
+	m_pLastSettledSong = nullptr;
 }
 
 void MusicWheel::BeginScreen()
@@ -262,6 +277,10 @@ MusicWheel::~MusicWheel()
 
 void MusicWheel::ReloadSongList()
 {
+	// The songs we were prefetching may be gone.
+	m_Prefetch.Clear();
+	m_pLastSettledSong = nullptr;
+
 	int songIdxToPreserve = m_iSelection;
 	// Remove the song from any sorting caches:
 	FOREACH_ENUM( SortOrder, so ) {
@@ -408,9 +427,8 @@ bool MusicWheel::SelectModeMenuItem()
 
 // bool MusicWheel::SelectCustomItem()
 
-void MusicWheel::GetSongList( vector<Song*> &arraySongs, SortOrder so )
+void MusicWheel::GetAllSongsForSort( vector<Song*> &apAllSongs, SortOrder so ) const
 {
-	vector<Song*> apAllSongs;
 	switch( so )
 	{
 	case SORT_PREFERRED:
@@ -432,79 +450,300 @@ void MusicWheel::GetSongList( vector<Song*> &arraySongs, SortOrder so )
 		apAllSongs = SONGMAN->GetAllSongs();
 		break;
 	}
+}
 
+static bool AnyProfileSongs()
+{
 	FOREACH_PlayerNumber(pn)
 	{
-		if(GAMESTATE->IsPlayerEnabled(pn))
-		{
-			Profile* prof= PROFILEMAN->GetProfile(pn);
-			for(size_t i= 0; i < prof->m_songs.size(); ++i)
-			{
-				apAllSongs.push_back(prof->m_songs[i]);
-			}
-		}
+		if( GAMESTATE->IsPlayerEnabled(pn) && !PROFILEMAN->GetProfile(pn)->m_songs.empty() )
+			return true;
 	}
+	return false;
+}
 
+/* Copy the songs from apAllSongs that can be shown on the wheel right now,
+ * keeping their order.  If pvsSections is set, the matching section names are
+ * copied along with them.  Returns false if the extra stage song isn't in
+ * apAllSongs. */
+bool MusicWheel::FilterSongList( const vector<Song*> &apAllSongs, const vector<RString> *pvsSections,
+	vector<Song*> &arraySongs, vector<RString> *pvsSectionsOut, SortOrder so ) const
+{
 	// filter songs that we don't have enough stages to play
+	SongCriteria sc;
+	sc.m_iMaxStagesForSong = GAMESTATE->GetSmallestNumStagesLeftForAnyHumanPlayer();
+
+	/* Hack: Keep the extra stage item even if it would be eliminated for any
+	 * reason (eg. it's a long song). */
+	Song *pExtraStageSong = nullptr;
+	if( GAMESTATE->IsAnExtraStage() )
 	{
-		vector<Song*> vTempSongs;
-		SongCriteria sc;
-		sc.m_iMaxStagesForSong = GAMESTATE->GetSmallestNumStagesLeftForAnyHumanPlayer();
-		SongUtil::FilterSongs( sc, apAllSongs, vTempSongs );
-		apAllSongs = vTempSongs;
+		Steps* pSteps;
+		SONGMAN->GetExtraStageInfo( GAMESTATE->IsExtraStage2(), GAMESTATE->GetCurrentStyle(PLAYER_INVALID), pExtraStageSong, pSteps );
 	}
+	bool bFoundExtraStageSong = false;
+
+	const StepsType st = GAMESTATE->GetCurrentStyle(PLAYER_INVALID)->m_StepsType;
+	const Difficulty dc = GAMESTATE->m_PreferredDifficulty[GAMESTATE->GetFirstHumanPlayer()];
 
 	// copy only songs that have at least one Steps for the current GameMode
 	for( unsigned i=0; i<apAllSongs.size(); i++ )
 	{
 		Song* pSong = apAllSongs[i];
 
-		int iLocked = UNLOCKMAN->SongIsLocked( pSong );
-		if( iLocked & LOCKED_DISABLED )
-			continue;
-
-		// If we're on an extra stage, and this song is selected, ignore #SELECTABLE.
-		if( pSong != GAMESTATE->m_pCurSong || !GAMESTATE->IsAnExtraStage() )
+		if( pSong == pExtraStageSong )
+		{
+			bFoundExtraStageSong = true;
+		}
+		else
 		{
-			// Hide songs that asked to be hidden via #SELECTABLE.
-			if( iLocked & LOCKED_SELECTABLE )
+			if( !sc.Matches(pSong) )
 				continue;
-			if( so != SORT_ROULETTE && iLocked & LOCKED_ROULETTE )
+
+			int iLocked = UNLOCKMAN->SongIsLocked( pSong );
+			if( iLocked & LOCKED_DISABLED )
 				continue;
-		}
 
-		/* Hide locked songs. If RANDOM_PICKS_LOCKED_SONGS, hide in Roulette
-		 * and Random, too. */
-		if( (so!=SORT_ROULETTE || !RANDOM_PICKS_LOCKED_SONGS) && iLocked )
-			continue;
+			// If we're on an extra stage, and this song is selected, ignore #SELECTABLE.
+			if( pSong != GAMESTATE->m_pCurSong || !GAMESTATE->IsAnExtraStage() )
+			{
+				// Hide songs that asked to be hidden via #SELECTABLE.
+				if( iLocked & LOCKED_SELECTABLE )
+					continue;
+				if( so != SORT_ROULETTE && iLocked & LOCKED_ROULETTE )
+					continue;
+			}
 
-		if( PREFSMAN->m_bOnlyPreferredDifficulties )
-		{
-			// if the song has steps that fit the preferred difficulty of the default player
-			if( pSong->HasStepsTypeAndDifficulty( GAMESTATE->GetCurrentStyle(PLAYER_INVALID)->m_StepsType,GAMESTATE->m_PreferredDifficulty[GAMESTATE->GetFirstHumanPlayer()] ) )
-				arraySongs.push_back( pSong );
+			/* Hide locked songs. If RANDOM_PICKS_LOCKED_SONGS, hide in Roulette
+			 * and Random, too. */
+			if( (so!=SORT_ROULETTE || !RANDOM_PICKS_LOCKED_SONGS) && iLocked )
+				continue;
+
+			if( PREFSMAN->m_bOnlyPreferredDifficulties )
+			{
+				// if the song has steps that fit the preferred difficulty of the default player
+				if( !pSong->HasStepsTypeAndDifficulty(st, dc) )
+					continue;
+			}
+			else
+			{
+				// If the song has at least one steps, add it.
+				if( !pSong->HasStepsType(st) )
+					continue;
+			}
 		}
-		else
+
+		arraySongs.push_back( pSong );
+		if( pvsSectionsOut != nullptr )
+			pvsSectionsOut->push_back( (*pvsSections)[i] );
+	}
+
+	return pExtraStageSong == nullptr || bFoundExtraStageSong;
+}
+
+void MusicWheel::GetSongList( vector<Song*> &arraySongs, SortOrder so )
+{
+	vector<Song*> apAllSongs;
+	GetAllSongsForSort( apAllSongs, so );
+
+	FOREACH_PlayerNumber(pn)
+	{
+		if(GAMESTATE->IsPlayerEnabled(pn))
 		{
-			// If the song has at least one steps, add it.
-			if( pSong->HasStepsType(GAMESTATE->GetCurrentStyle(PLAYER_INVALID)->m_StepsType) )
-				arraySongs.push_back( pSong );
+			Profile* prof= PROFILEMAN->GetProfile(pn);
+			for(size_t i= 0; i < prof->m_songs.size(); ++i)
+			{
+				apAllSongs.push_back(prof->m_songs[i]);
+			}
 		}
 	}
 
-	/* Hack: Add extra stage item if it was eliminated for any reason
-	 * (eg. it's a long song). */
-	if( GAMESTATE->IsAnExtraStage() )
+	if( !FilterSongList(apAllSongs, nullptr, arraySongs, nullptr, so) )
 	{
 		Song* pSong;
 		Steps* pSteps;
 		SONGMAN->GetExtraStageInfo( GAMESTATE->IsExtraStage2(), GAMESTATE->GetCurrentStyle(PLAYER_INVALID), pSong, pSteps );
+		arraySongs.push_back( pSong );
+	}
+}
 
-		if( find( arraySongs.begin(), arraySongs.end(), pSong ) == arraySongs.end() )
-			arraySongs.push_back( pSong );
+void MusicWheel::SortSongList( vector<Song*> &arraySongs, SortOrder so ) const
+{
+	switch( so )
+	{
+		case SORT_PREFERRED:
+			// obey order specified by the preferred sort list
+			break;
+		case SORT_ROULETTE:
+		{
+			StepsType st;
+			Difficulty dc;
+			SongUtil::GetStepsTypeAndDifficultyFromSortOrder( SORT_EASY_METER, st, dc );
+			SongUtil::SortSongPointerArrayByStepsTypeAndMeter( arraySongs, st, dc );
+			if( (bool)PREFSMAN->m_bPreferredSortUsesGroups )
+				stable_sort( arraySongs.begin(), arraySongs.end(), SongUtil::CompareSongPointersByGroup );
+			break;
+		}
+		case SORT_GROUP:
+			SongUtil::SortSongPointerArrayByGroupAndTitle( arraySongs );
+			break;
+		case SORT_TITLE:
+			SongUtil::SortSongPointerArrayByTitle( arraySongs );
+			break;
+		case SORT_BPM:
+			SongUtil::SortSongPointerArrayByBPM( arraySongs );
+			break;
+		case SORT_POPULARITY:
+			if( (int) arraySongs.size() > MOST_PLAYED_SONGS_TO_SHOW )
+				arraySongs.erase( arraySongs.begin()+MOST_PLAYED_SONGS_TO_SHOW, arraySongs.end() );
+			break;
+		case SORT_TOP_GRADES:
+			SongUtil::SortSongPointerArrayByGrades( arraySongs, true );
+			break;
+		case SORT_ARTIST:
+			SongUtil::SortSongPointerArrayByArtist( arraySongs );
+			break;
+		case SORT_GENRE:
+			SongUtil::SortSongPointerArrayByGenre( arraySongs );
+			break;
+		case SORT_LENGTH:
+			SongUtil::SortSongPointerArrayByLength( arraySongs );
+			break;
+		case SORT_RECENT:
+			SongUtil::SortByMostRecentlyPlayedForMachine( arraySongs );
+			if( (int) arraySongs.size() > RECENT_SONGS_TO_SHOW )
+				arraySongs.erase( arraySongs.begin()+RECENT_SONGS_TO_SHOW, arraySongs.end() );
+			break;
+		case SORT_BEGINNER_METER:
+		case SORT_EASY_METER:
+		case SORT_MEDIUM_METER:
+		case SORT_HARD_METER:
+		case SORT_CHALLENGE_METER:
+		case SORT_DOUBLE_EASY_METER:
+		case SORT_DOUBLE_MEDIUM_METER:
+		case SORT_DOUBLE_HARD_METER:
+		case SORT_DOUBLE_CHALLENGE_METER:
+		{
+			StepsType st;
+			Difficulty dc;
+			SongUtil::GetStepsTypeAndDifficultyFromSortOrder( so, st, dc );
+			SongUtil::SortSongPointerArrayByStepsTypeAndMeter( arraySongs, st, dc );
+			break;
+		}
+		default:
+			FAIL_M("Unhandled sort order! Aborting...");
+	}
+}
+
+static void SortSongListBySection( vector<Song*> &arraySongs, vector<RString> &vsSections, SortOrder so )
+{
+	vsSections.resize( arraySongs.size() );
+	for( unsigned i=0; i < arraySongs.size(); i++ )
+		vsSections[i] = SongUtil::GetSectionNameFromSongAndSort( arraySongs[i], so );
+
+	// Sorting twice isn't necessary. Instead, modify the compatator
+	// functions in Song.cpp to have the desired effect. -Chris
+	/* Keeping groups together with the sorts is tricky and brittle; we
+	 * keep getting OTHER split up without this. However, it puts the 
+	 * Grade and BPM sorts in the wrong order, and they're already correct,
+	 * so don't re-sort for them. */
+	/* We're using sections, so use the section name as the top-level sort. */
+	switch( so )
+	{
+		case SORT_PREFERRED:
+		case SORT_TOP_GRADES:
+		case SORT_BPM:
+		case SORT_LENGTH:
+			break;	// don't sort by section
+		default:
+			SongUtil::SortSongPointerArrayBySectionName( arraySongs, vsSections );
+			break;
 	}
 }
 
+bool MusicWheel::SortUsesSections( SortOrder so ) const
+{
+	switch( so )
+	{
+		case SORT_ROULETTE:
+		case SORT_POPULARITY:
+		case SORT_RECENT:
+			return false;
+		case SORT_GROUP:
+			if( !USE_SECTIONS_WITH_PREFERRED_GROUP && GAMESTATE->m_sPreferredSongGroup != GROUP_ALL )
+				return false;
+			break;
+		default:
+			break;
+	}
+
+	switch( PREFSMAN->m_MusicWheelUsesSections )
+	{
+		case MusicWheelUsesSections_NEVER:
+			return false;
+		case MusicWheelUsesSections_ABC_ONLY:
+			return so == SORT_TITLE || so == SORT_GROUP;
+		default:
+			return true;
+	}
+}
+
+bool MusicWheel::GetSortedSongList( vector<Song*> &arraySongs, vector<RString> &vsSections, SortOrder so, bool bUseSections )
+{
+	switch( so )
+	{
+		/* These have no sort worth caching, or sort by play counts and
+		 * grades that change every stage. */
+		case SORT_PREFERRED:
+		case SORT_POPULARITY:
+		case SORT_TOP_GRADES:
+		case SORT_RECENT:
+			return false;
+		default:
+			break;
+	}
+
+	/* Profile songs come and go with the profiles that own them; leave them
+	 * to the uncached path. */
+	if( AnyProfileSongs() )
+		return false;
+
+	/* Everything the sorted order and section names depend on. */
+	RString sKey = ssprintf( "%d %d %d %d %d %d|%s|%s",
+		SONGMAN->GetSongListRevision(), int(bUseSections),
+		int(GAMESTATE->GetCurrentStyle(GAMESTATE->GetMasterPlayerNumber())->m_StepsType),
+		int(PREFSMAN->m_bSubSortByNumSteps.Get()), int(PREFSMAN->m_bPreferredSortUsesGroups.Get()),
+		int(so == SORT_GROUP && !USE_SECTIONS_WITH_PREFERRED_GROUP),
+		THEME->GetCurThemeName().c_str(), THEME->GetCurLanguage().c_str() );
+	if( so == SORT_GROUP && !USE_SECTIONS_WITH_PREFERRED_GROUP )
+		sKey += "|" + GAMESTATE->m_sPreferredSongGroup.Get();
+
+	SortedSongList &cache = g_SortedSongs[so];
+	if( cache.sKey != sKey )
+	{
+		cache.sKey = RString();
+		cache.vpSongs.clear();
+		cache.vsSections.clear();
+		GetAllSongsForSort( cache.vpSongs, so );
+		SortSongList( cache.vpSongs, so );
+		if( bUseSections )
+			SortSongListBySection( cache.vpSongs, cache.vsSections, so );
+		cache.sKey = sKey;
+	}
+
+	arraySongs.clear();
+	vsSections.clear();
+	if( !FilterSongList(cache.vpSongs, bUseSections? &cache.vsSections:nullptr, arraySongs, bUseSections? &vsSections:nullptr, so) )
+	{
+		/* The extra stage song isn't one this sort would show at all; sort
+		 * it in the slow way. */
+		arraySongs.clear();
+		vsSections.clear();
+		return false;
+	}
+	return true;
+}
+
 void MusicWheel::BuildWheelItemDatas( vector<MusicWheelItemData *> &arrayWheelItemDatas, SortOrder so )
 {
 	switch( so )
@@ -552,120 +791,20 @@ void MusicWheel::BuildWheelItemDatas( vector<MusicWheelItemData *> &arrayWheelIt
 		{
 			// Make an array of Song*, then sort them
 			vector<Song*> arraySongs;
-			GetSongList( arraySongs, so );
-
-			bool bUseSections = true;
-
-			// sort the songs
-			switch( so )
+			vector<RString> vsSections;
+			const bool bUseSections = SortUsesSections( so );
+			if( !GetSortedSongList(arraySongs, vsSections, so, bUseSections) )
 			{
-				case SORT_PREFERRED:
-					// obey order specified by the preferred sort list
-					break;
-				case SORT_ROULETTE:
-				{
-					StepsType st;
-					Difficulty dc;
-					SongUtil::GetStepsTypeAndDifficultyFromSortOrder( SORT_EASY_METER, st, dc );
-					SongUtil::SortSongPointerArrayByStepsTypeAndMeter( arraySongs, st, dc );
-					if( (bool)PREFSMAN->m_bPreferredSortUsesGroups )
-						stable_sort( arraySongs.begin(), arraySongs.end(), SongUtil::CompareSongPointersByGroup );
-					bUseSections = false;
-					break;
-				}
-				case SORT_GROUP:
-					SongUtil::SortSongPointerArrayByGroupAndTitle( arraySongs );
-					if(USE_SECTIONS_WITH_PREFERRED_GROUP)
-						bUseSections = true;
-					else
-						bUseSections = GAMESTATE->m_sPreferredSongGroup == GROUP_ALL;
-					break;
-				case SORT_TITLE:
-					SongUtil::SortSongPointerArrayByTitle( arraySongs );
-					break;
-				case SORT_BPM:
-					SongUtil::SortSongPointerArrayByBPM( arraySongs );
-					break;
-				case SORT_POPULARITY:
-					if( (int) arraySongs.size() > MOST_PLAYED_SONGS_TO_SHOW )
-						arraySongs.erase( arraySongs.begin()+MOST_PLAYED_SONGS_TO_SHOW, arraySongs.end() );
-					bUseSections = false;
-					break;
-				case SORT_TOP_GRADES:
-					SongUtil::SortSongPointerArrayByGrades( arraySongs, true );
-					break;
-				case SORT_ARTIST:
-					SongUtil::SortSongPointerArrayByArtist( arraySongs );
-					break;
-				case SORT_GENRE:
-					SongUtil::SortSongPointerArrayByGenre( arraySongs );
-					break;
-				case SORT_LENGTH:
-					SongUtil::SortSongPointerArrayByLength( arraySongs );
-					break;
-				case SORT_RECENT:
-					SongUtil::SortByMostRecentlyPlayedForMachine( arraySongs );
-					if( (int) arraySongs.size() > RECENT_SONGS_TO_SHOW )
-						arraySongs.erase( arraySongs.begin()+RECENT_SONGS_TO_SHOW, arraySongs.end() );
-					bUseSections = false;
-					break;
-				case SORT_BEGINNER_METER:
-				case SORT_EASY_METER:
-				case SORT_MEDIUM_METER:
-				case SORT_HARD_METER:
-				case SORT_CHALLENGE_METER:
-				case SORT_DOUBLE_EASY_METER:
-				case SORT_DOUBLE_MEDIUM_METER:
-				case SORT_DOUBLE_HARD_METER:
-				case SORT_DOUBLE_CHALLENGE_METER:
-					StepsType st;
-					Difficulty dc;
-					SongUtil::GetStepsTypeAndDifficultyFromSortOrder( so, st, dc );
-					SongUtil::SortSongPointerArrayByStepsTypeAndMeter( arraySongs, st, dc );
-					break;
-				default:
-					FAIL_M("Unhandled sort order! Aborting...");
+				GetSongList( arraySongs, so );
+				SortSongList( arraySongs, so );
+				if( bUseSections )
+					SortSongListBySection( arraySongs, vsSections, so );
 			}
 
 			// Build an array of WheelItemDatas from the sorted list of Song*'s
 			arrayWheelItemDatas.clear();	// clear out the previous wheel items 
 			arrayWheelItemDatas.reserve( arraySongs.size() );
 
-			switch( PREFSMAN->m_MusicWheelUsesSections )
-			{
-				case MusicWheelUsesSections_NEVER:
-					bUseSections = false;
-					break;
-				case MusicWheelUsesSections_ABC_ONLY:
-					if( so != SORT_TITLE && so != SORT_GROUP )
-						bUseSections = false;
-					break;
-				default:
-					break;
-			}
-
-			if( bUseSections )
-			{
-				// Sorting twice isn't necessary. Instead, modify the compatator
-				// functions in Song.cpp to have the desired effect. -Chris
-				/* Keeping groups together with the sorts is tricky and brittle; we
-				 * keep getting OTHER split up without this. However, it puts the 
-				 * Grade and BPM sorts in the wrong order, and they're already correct,
-				 * so don't re-sort for them. */
-				/* We're using sections, so use the section name as the top-level sort. */
-				switch( so )
-				{
-					case SORT_PREFERRED:
-					case SORT_TOP_GRADES:
-					case SORT_BPM:
-					case SORT_LENGTH:
-						break;	// don't sort by section
-					default:
-						SongUtil::SortSongPointerArrayBySectionName(arraySongs, so);
-						break;
-				}
-			}
-
 			// make WheelItemDatas with sections
 			RString sLastSection = "";
 			int iSectionColorIndex = 0;
@@ -674,7 +813,7 @@ void MusicWheel::BuildWheelItemDatas( vector<MusicWheelItemData *> &arrayWheelIt
 				Song* pSong = arraySongs[i];
 				if( bUseSections )
 				{
-					RString sThisSection = SongUtil::GetSectionNameFromSongAndSort( pSong, so );
+					const RString &sThisSection = vsSections[i];
 
 					if( sThisSection != sLastSection )
 					{
@@ -683,7 +822,7 @@ void MusicWheel::BuildWheelItemDatas( vector<MusicWheelItemData *> &arrayWheelIt
 						unsigned j;
 						for( j=i; j < arraySongs.size(); j++ )
 						{
-							if( SongUtil::GetSectionNameFromSongAndSort( arraySongs[j], so ) != sThisSection )
+							if( vsSections[j] != sThisSection )
 								break;
 						}
 						iSectionCount = j-i;
@@ -1180,6 +1319,8 @@ void MusicWheel::ChangeMusic( int iDist )
 	RebuildWheelItems( iDist );
 
 	m_fPositionOffsetFromSelection += iDist;
+	m_Prefetch.Moved( iDist );
+	m_pLastSettledSong = nullptr;
 
 	SCREENMAN->PostMessageToTopScreen( SM_SongChanged, 0 );
 
@@ -1189,6 +1330,45 @@ void MusicWheel::ChangeMusic( int iDist )
 }
 
 
+void MusicWheel::Update( float fDeltaTime )
+{
+	WheelBase::Update( fDeltaTime );
+	UpdatePrefetch( fDeltaTime );
+}
+
+void MusicWheel::UpdatePrefetch( float fDeltaTime )
+{
+	/* Warm up the selection, the songs ahead of it in the direction we're
+	 * moving, and the one just behind it, in case we turn around. */
+	vector<Song *> vpSongs;
+	const int iNumItems = m_CurWheelItemData.size();
+	const int iLookahead = min( m_Prefetch.GetLookahead(), iNumItems-1 );
+	if( iLookahead > 0 )
+	{
+		const int iDirection = m_Prefetch.GetDirection();
+		for( int i = 0; i <= iLookahead+1; ++i )
+		{
+			int iItem = m_iSelection + (i <= iLookahead? i:-1) * iDirection;
+			wrap( iItem, iNumItems );
+
+			const MusicWheelItemData *pData = GetCurWheelItemData( iItem );
+			if( pData->m_Type != WheelItemDataType_Song || pData->m_pSong == nullptr )
+				continue;
+			if( find(vpSongs.begin(), vpSongs.end(), pData->m_pSong) == vpSongs.end() )
+				vpSongs.push_back( pData->m_pSong );
+		}
+	}
+	m_Prefetch.Update( fDeltaTime, vpSongs );
+
+	if( IsSettled() && iNumItems > 0 )
+	{
+		const Song *pSong = GetCurWheelItemData( m_iSelection )->m_pSong;
+		if( pSong != nullptr && pSong != m_pLastSettledSong )
+			m_Prefetch.Settled( pSong );
+		m_pLastSettledSong = pSong;
+	}
+}
+
 bool MusicWheel::ChangeSort( SortOrder new_so, bool allowSameSort )	// return true if change successful
 {
 	ASSERT( new_so < NUM_SortOrder );
@@ -6,6 +6,7 @@
 #include "RageSound.h"
 #include "GameConstantsAndTypes.h"
 #include "MusicWheelItem.h"
+#include "MusicWheelPrefetch.h"
 #include "ThemeMetric.h"
 #include "WheelBase.h"
 
@@ -22,6 +23,7 @@ public:
 	virtual ~MusicWheel();
 	virtual void Load( RString sType );
 	void BeginScreen();
+	virtual void Update( float fDeltaTime );
 
 	bool ChangeSort( SortOrder new_so, bool allowSameSort = false );	// return true if change successful
 	bool NextSort();						// return true if change successful
@@ -60,6 +62,14 @@ protected:
 	MusicWheelItem *MakeItem();
 
 	void GetSongList( vector<Song*> &arraySongs, SortOrder so );
+	void GetAllSongsForSort( vector<Song*> &apAllSongs, SortOrder so ) const;
+	bool FilterSongList( const vector<Song*> &apAllSongs, const vector<RString> *pvsSections,
+		vector<Song*> &arraySongs, vector<RString> *pvsSectionsOut, SortOrder so ) const;
+	void SortSongList( vector<Song*> &arraySongs, SortOrder so ) const;
+	bool SortUsesSections( SortOrder so ) const;
+	/* Get the sorted song list from the cache shared by all wheels.  Returns
+	 * false if the sort isn't cached, and the caller should build it itself. */
+	bool GetSortedSongList( vector<Song*> &arraySongs, vector<RString> &vsSections, SortOrder so, bool bUseSections );
 	bool SelectSongOrCourse();
 	bool SelectModeMenuItem();
 
@@ -74,6 +84,10 @@ protected:
 
 	bool WheelItemIsVisible(int n);
 
+	void UpdatePrefetch( float fDeltaTime );
+	MusicWheelPrefetch		m_Prefetch;
+	const Song			*m_pLastSettledSong;
+
 	ThemeMetric<float>		ROULETTE_SWITCH_SECONDS;
 	ThemeMetric<int>		ROULETTE_SLOW_DOWN_SWITCHES;
 	ThemeMetric<int>		NUM_SECTION_COLORS;
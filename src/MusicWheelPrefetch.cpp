@@ -0,0 +1,435 @@
+#include "global.h"
+#include "MusicWheelPrefetch.h"
+#include "ActorUtil.h"
+#include "PrefsManager.h"
+#include "Preference.h"
+#include "RageLog.h"
+#include "RageSoundManager.h"
+#include "RageSoundReader_Prefetch.h"
+#include "RageTexture.h"
+#include "RageTextureManager.h"
+#include "RageThreads.h"
+#include "Song.h"
+#include "Sprite.h"
+
+/* How many items ahead of the wheel to prefetch, at most.  0 disables
+ * prefetching. */
+static Preference<int> g_iWheelPrefetchItems( "WheelPrefetchItems", 6 );
+/* How much memory the prefetched textures and previews may use. */
+static Preference<int> g_iWheelPrefetchMegabytes( "WheelPrefetchMegabytes", 64 );
+/* How much of each preview to decode ahead of time. */
+static Preference<float> g_fWheelPrefetchPreviewSeconds( "WheelPrefetchPreviewSeconds", 3.0f );
+
+/* Reach far enough ahead to cover this much time at the current speed. */
+static const float LOOKAHEAD_SECONDS = 0.5f;
+/* How quickly the measured speed follows the wheel. */
+static const float VELOCITY_SMOOTHING_SECONDS = 0.25f;
+
+struct PrefetchAudioJob
+{
+	PrefetchAudioJob(): fStartSeconds(0), iDistance(0), pResult(nullptr), bCancelled(false) { }
+	RString sPath;
+	float fStartSeconds;
+	int iDistance;
+
+	/* Set by the thread; nullptr if the file couldn't be prefetched. */
+	RageSoundReader_Prefetch *pResult;
+	bool bCancelled;
+};
+
+/* Decode previews on a thread, nearest to the selection first. */
+class PrefetchAudioQueue
+{
+public:
+	PrefetchAudioQueue(): m_Event("PrefetchAudioQueue"), m_pThread(nullptr), m_bShutdown(false) { }
+	~PrefetchAudioQueue()
+	{
+		if( m_pThread != nullptr )
+		{
+			m_Event.Lock();
+			m_bShutdown = true;
+			m_Event.Broadcast();
+			m_Event.Unlock();
+			m_pThread->Wait();
+			delete m_pThread;
+		}
+
+		for (PrefetchAudioJob *pJob : m_Queue)
+			delete pJob;
+		for (PrefetchAudioJob *pJob : m_Done)
+		{
+			delete pJob->pResult;
+			delete pJob;
+		}
+	}
+
+	void Add( PrefetchAudioJob *pJob )
+	{
+		if( m_pThread == nullptr )
+		{
+			m_pThread = new RageThread;
+			m_pThread->SetName( "Wheel prefetch thread" );
+			m_pThread->Create( PrefetchThread_start, this );
+		}
+
+		m_Event.Lock();
+		m_Queue.push_back( pJob );
+		m_Event.Signal();
+		m_Event.Unlock();
+	}
+
+	/* Forget about pJob.  If the thread has it, it'll be deleted when it
+	 * comes back from PopDone. */
+	void Cancel( PrefetchAudioJob *pJob )
+	{
+		LockMut( m_Event );
+		vector<PrefetchAudioJob *>::iterator it = find( m_Queue.begin(), m_Queue.end(), pJob );
+		if( it == m_Queue.end() )
+		{
+			pJob->bCancelled = true;
+			return;
+		}
+
+		m_Queue.erase( it );
+		delete pJob;
+	}
+
+	void SetDistance( PrefetchAudioJob *pJob, int iDistance )
+	{
+		LockMut( m_Event );
+		pJob->iDistance = iDistance;
+	}
+
+	PrefetchAudioJob *PopDone()
+	{
+		LockMut( m_Event );
+		if( m_Done.empty() )
+			return nullptr;
+		PrefetchAudioJob *pJob = m_Done.back();
+		m_Done.pop_back();
+		return pJob;
+	}
+
+private:
+	static int PrefetchThread_start( void *p ) { ((PrefetchAudioQueue *) p)->PrefetchThread(); return 0; }
+	void PrefetchThread()
+	{
+		m_Event.Lock();
+		for(;;)
+		{
+			while( m_Queue.empty() && !m_bShutdown )
+				m_Event.Wait();
+			if( m_bShutdown )
+				break;
+
+			vector<PrefetchAudioJob *>::iterator it = m_Queue.begin();
+			for( vector<PrefetchAudioJob *>::iterator j = m_Queue.begin(); j != m_Queue.end(); ++j )
+				if( (*j)->iDistance < (*it)->iDistance )
+					it = j;
+			PrefetchAudioJob *pJob = *it;
+			m_Queue.erase( it );
+			const RString sPath = pJob->sPath;
+			const float fStartSeconds = pJob->fStartSeconds;
+			m_Event.Unlock();
+
+			RString sError;
+			RageSoundReader_Prefetch *pResult = RageSoundReader_Prefetch::Prefetch( sPath, fStartSeconds,
+				g_fWheelPrefetchPreviewSeconds.Get(), sError );
+			if( pResult == nullptr )
+				LOG->Trace( "Couldn't prefetch \"%s\": %s", sPath.c_str(), sError.c_str() );
+
+			m_Event.Lock();
+			pJob->pResult = pResult;
+			m_Done.push_back( pJob );
+		}
+		m_Event.Unlock();
+	}
+
+	RageEvent m_Event;
+	vector<PrefetchAudioJob *> m_Queue;
+	vector<PrefetchAudioJob *> m_Done;
+	RageThread *m_pThread;
+	bool m_bShutdown;
+};
+
+MusicWheelPrefetch::Entry::Entry():
+	iDistance(0), pBanner(nullptr), pBackground(nullptr),
+	pAudioJob(nullptr), bPreviewReady(false), iPreviewBytes(0)
+{
+}
+
+MusicWheelPrefetch::MusicWheelPrefetch():
+	m_pAudioQueue(new PrefetchAudioQueue),
+	m_iDirection(+1), m_iItemsMoved(0), m_fVelocity(0),
+	m_iBannerHits(0), m_iBannerMisses(0),
+	m_iPreviewHits(0), m_iPreviewMisses(0)
+{
+}
+
+MusicWheelPrefetch::~MusicWheelPrefetch()
+{
+	Clear();
+	delete m_pAudioQueue;
+
+	if( m_iBannerHits + m_iBannerMisses + m_iPreviewHits + m_iPreviewMisses > 0 )
+		LOG->Trace( "MusicWheel prefetch: banners %i hit, %i missed; previews %i hit, %i missed",
+			m_iBannerHits, m_iBannerMisses, m_iPreviewHits, m_iPreviewMisses );
+}
+
+void MusicWheelPrefetch::Moved( int iDist )
+{
+	if( iDist == 0 )
+		return;
+	m_iDirection = iDist > 0? +1:-1;
+	m_iItemsMoved += abs( iDist );
+}
+
+int MusicWheelPrefetch::GetLookahead() const
+{
+	const int iMax = g_iWheelPrefetchItems.Get();
+	if( iMax <= 0 )
+		return 0;
+	return clamp( 1 + lrintf(m_fVelocity * LOOKAHEAD_SECONDS), 1, iMax );
+}
+
+void MusicWheelPrefetch::Update( float fDeltaTime, const vector<Song *> &vpSongs )
+{
+	if( fDeltaTime > 0 )
+	{
+		const float fVelocity = m_iItemsMoved / fDeltaTime;
+		m_fVelocity += (fVelocity - m_fVelocity) * min( fDeltaTime / VELOCITY_SMOOTHING_SECONDS, 1.0f );
+		m_iItemsMoved = 0;
+	}
+
+	CollectAudio();
+
+	if( vpSongs != m_vpLastSongs )
+	{
+		m_vpLastSongs = vpSongs;
+
+		for (auto &e : m_Entries)
+			e.second.iDistance = -1;
+
+		size_t iBudget = size_t(max(g_iWheelPrefetchMegabytes.Get(), 0)) * 1024 * 1024;
+		size_t iUsed = 0;
+		for (auto const &e : m_Entries)
+			iUsed += GetMemoryUsage( e.second );
+
+		for( unsigned i = 0; i < vpSongs.size(); ++i )
+		{
+			map<Song *, Entry>::iterator it = m_Entries.find( vpSongs[i] );
+			if( it != m_Entries.end() )
+			{
+				it->second.iDistance = i;
+				continue;
+			}
+
+			/* Don't start anything new once we're over budget.  The
+			 * selection itself is always loaded. */
+			if( i > 0 && iUsed >= iBudget )
+				continue;
+
+			Entry &e = m_Entries[vpSongs[i]];
+			e.iDistance = i;
+			Start( vpSongs[i], e );
+		}
+
+		for( map<Song *, Entry>::iterator it = m_Entries.begin(); it != m_Entries.end(); )
+		{
+			Entry &e = it->second;
+			if( e.iDistance == -1 )
+			{
+				Drop( e );
+				m_Entries.erase( it++ );
+				continue;
+			}
+
+			/* The preview was used when the wheel stopped here last; fetch it
+			 * again now that we're approaching it again. */
+			if( e.bPreviewReady && e.iDistance > 0 && !SOUNDMAN->IsSoundPrefetched(e.sPreviewPath) )
+			{
+				e.bPreviewReady = false;
+				e.iPreviewBytes = 0;
+				Start( it->first, e );
+			}
+
+			if( e.pAudioJob != nullptr )
+				m_pAudioQueue->SetDistance( e.pAudioJob, e.iDistance );
+			++it;
+		}
+	}
+
+	EnforceBudget();
+}
+
+void MusicWheelPrefetch::Start( Song *pSong, Entry &e )
+{
+	if( e.pBanner == nullptr && PREFSMAN->m_bShowBanners && pSong->HasBanner() )
+		e.pBanner = TEXTUREMAN->LoadTextureAsync( Sprite::SongBannerTexture(pSong->GetBannerPath()) );
+	if( e.pBackground == nullptr && pSong->HasBackground() )
+		e.pBackground = TEXTUREMAN->LoadTextureAsync( Sprite::SongBGTexture(pSong->GetBackgroundPath()) );
+
+	if( e.pAudioJob != nullptr || e.bPreviewReady )
+		return;
+
+	e.sPreviewPath = pSong->GetPreviewMusicPath();
+	if( e.sPreviewPath.empty() || ActorUtil::GetFileType(e.sPreviewPath) != FT_Sound )
+		return;
+
+	/* Another song with the same music already has it. */
+	if( SOUNDMAN->IsSoundPrefetched(e.sPreviewPath) )
+		return;
+
+	e.pAudioJob = new PrefetchAudioJob;
+	e.pAudioJob->sPath = e.sPreviewPath;
+	e.pAudioJob->fStartSeconds = pSong->GetPreviewStartSeconds();
+	e.pAudioJob->iDistance = e.iDistance;
+	m_pAudioQueue->Add( e.pAudioJob );
+}
+
+void MusicWheelPrefetch::Drop( Entry &e )
+{
+	if( e.pBanner != nullptr )
+		TEXTUREMAN->UnloadTexture( e.pBanner );
+	if( e.pBackground != nullptr )
+		TEXTUREMAN->UnloadTexture( e.pBackground );
+	e.pBanner = e.pBackground = nullptr;
+
+	if( e.pAudioJob != nullptr )
+		m_pAudioQueue->Cancel( e.pAudioJob );
+	e.pAudioJob = nullptr;
+
+	/* If the preview was already played, this does nothing. */
+	if( e.bPreviewReady )
+		SOUNDMAN->DeletePrefetchedSound( e.sPreviewPath );
+	e.bPreviewReady = false;
+	e.iPreviewBytes = 0;
+}
+
+size_t MusicWheelPrefetch::GetMemoryUsage( const Entry &e ) const
+{
+	size_t iBytes = e.iPreviewBytes;
+
+	/* We don't know what format textures ended up in; assume 32-bit. */
+	const RageTexture *apTextures[] = { e.pBanner, e.pBackground };
+	for (const RageTexture *pTexture : apTextures)
+	{
+		if( pTexture != nullptr && TEXTUREMAN->IsTextureReady(pTexture) )
+			iBytes += size_t(pTexture->GetTextureWidth()) * pTexture->GetTextureHeight() * 4;
+	}
+	return iBytes;
+}
+
+void MusicWheelPrefetch::CollectAudio()
+{
+	PrefetchAudioJob *pJob;
+	while( (pJob = m_pAudioQueue->PopDone()) != nullptr )
+	{
+		if( pJob->bCancelled )
+		{
+			delete pJob->pResult;
+			delete pJob;
+			continue;
+		}
+
+		for (auto &it : m_Entries)
+		{
+			Entry &e = it.second;
+			if( e.pAudioJob != pJob )
+				continue;
+
+			e.pAudioJob = nullptr;
+			if( pJob->pResult != nullptr )
+			{
+				e.iPreviewBytes = pJob->pResult->GetMemoryUsage();
+				e.bPreviewReady = true;
+				SOUNDMAN->AddPrefetchedSound( pJob->sPath, pJob->pResult );
+			}
+			break;
+		}
+		delete pJob;
+	}
+}
+
+void MusicWheelPrefetch::EnforceBudget()
+{
+	const size_t iBudget = size_t(max(g_iWheelPrefetchMegabytes.Get(), 0)) * 1024 * 1024;
+	size_t iUsed = 0;
+	for (auto const &e : m_Entries)
+		iUsed += GetMemoryUsage( e.second );
+
+	/* Drop the songs furthest from the selection first, but never the
+	 * selection itself. */
+	while( iUsed > iBudget )
+	{
+		map<Song *, Entry>::iterator furthest = m_Entries.end();
+		for( map<Song *, Entry>::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+			if( furthest == m_Entries.end() || it->second.iDistance > furthest->second.iDistance )
+				furthest = it;
+		if( furthest == m_Entries.end() || furthest->second.iDistance == 0 )
+			break;
+
+		iUsed -= GetMemoryUsage( furthest->second );
+		Drop( furthest->second );
+		m_Entries.erase( furthest );
+	}
+}
+
+void MusicWheelPrefetch::Settled( const Song *pSong )
+{
+	if( pSong == nullptr )
+		return;
+
+	map<Song *, Entry>::const_iterator it = m_Entries.find( const_cast<Song *>(pSong) );
+	const Entry *pEntry = it == m_Entries.end()? nullptr: &it->second;
+
+	if( PREFSMAN->m_bShowBanners && pSong->HasBanner() )
+	{
+		if( pEntry != nullptr && pEntry->pBanner != nullptr && TEXTUREMAN->IsTextureReady(pEntry->pBanner) )
+			++m_iBannerHits;
+		else
+			++m_iBannerMisses;
+	}
+
+	const RString sPreviewPath = pSong->GetPreviewMusicPath();
+	if( !sPreviewPath.empty() && ActorUtil::GetFileType(sPreviewPath) == FT_Sound )
+	{
+		if( pEntry != nullptr && pEntry->bPreviewReady && SOUNDMAN->IsSoundPrefetched(sPreviewPath) )
+			++m_iPreviewHits;
+		else
+			++m_iPreviewMisses;
+	}
+}
+
+void MusicWheelPrefetch::Clear()
+{
+	for (auto &e : m_Entries)
+		Drop( e.second );
+	m_Entries.clear();
+	m_vpLastSongs.clear();
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
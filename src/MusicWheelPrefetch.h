@@ -0,0 +1,117 @@
+/* MusicWheelPrefetch - Warm up songs ahead of the music wheel. */
+
+#ifndef MUSIC_WHEEL_PREFETCH_H
+#define MUSIC_WHEEL_PREFETCH_H
+
+#include <map>
+
+class RageTexture;
+class Song;
+struct PrefetchAudioJob;
+class PrefetchAudioQueue;
+
+/**
+ * @brief Load the banner, background and preview music of the songs the
+ * music wheel is about to reach.
+ *
+ * The wheel reports each move, and the prefetcher keeps track of how fast
+ * and in which direction it's going.  The faster it moves, the further
+ * ahead GetLookahead() reaches.  Textures are loaded with
+ * TEXTUREMAN->LoadTextureAsync, and the first seconds of each preview are
+ * decoded on a thread and handed to SOUNDMAN, so they're there when
+ * ScreenSelectMusic starts the sample music.
+ *
+ * Everything that's held counts against WheelPrefetchMegabytes; the songs
+ * furthest from the selection are dropped first.
+ */
+class MusicWheelPrefetch
+{
+public:
+	MusicWheelPrefetch();
+	~MusicWheelPrefetch();
+
+	/* The wheel moved iDist items. */
+	void Moved( int iDist );
+
+	/* How many items ahead of the selection to prefetch, and in which
+	 * direction (+1 or -1). */
+	int GetLookahead() const;
+	int GetDirection() const { return m_iDirection; }
+
+	/* vpSongs are the songs to keep warm, nearest to the selection first.
+	 * The first one is never dropped to stay under budget. */
+	void Update( float fDeltaTime, const vector<Song *> &vpSongs );
+
+	/* The wheel stopped on pSong.  Count whether it was ready. */
+	void Settled( const Song *pSong );
+
+	/* Drop everything. */
+	void Clear();
+
+	int GetBannerHits() const { return m_iBannerHits; }
+	int GetBannerMisses() const { return m_iBannerMisses; }
+	int GetPreviewHits() const { return m_iPreviewHits; }
+	int GetPreviewMisses() const { return m_iPreviewMisses; }
+
+private:
+	struct Entry
+	{
+		Entry();
+		int iDistance;
+		RageTexture *pBanner;
+		RageTexture *pBackground;
+
+		RString sPreviewPath;
+		PrefetchAudioJob *pAudioJob;
+		bool bPreviewReady;
+		size_t iPreviewBytes;
+	};
+
+	void Start( Song *pSong, Entry &e );
+	void Drop( Entry &e );
+	size_t GetMemoryUsage( const Entry &e ) const;
+	void CollectAudio();
+	void EnforceBudget();
+
+	map<Song *, Entry> m_Entries;
+	vector<Song *> m_vpLastSongs;
+	PrefetchAudioQueue *m_pAudioQueue;
+
+	int m_iDirection;
+	int m_iItemsMoved;
+	float m_fVelocity;
+
+	int m_iBannerHits, m_iBannerMisses;
+	int m_iPreviewHits, m_iPreviewMisses;
+
+	// Swallow up warnings. If they must be used, define them.
+	MusicWheelPrefetch& operator=(const MusicWheelPrefetch& rhs);
+	MusicWheelPrefetch(const MusicWheelPrefetch& rhs);
+};
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -331,15 +331,7 @@ void NoteData::AddHoldNote( int iTrack, int iStartRow, int iEndRow, TapNote tn )
 	tn.iDuration = iEndRow - iStartRow;
 
 	// Remove everything in the range.
-	while( lBegin != lEnd )
-	{
-		iterator next = lBegin;
-		++next;
-
-		RemoveTapNote( iTrack, lBegin );
-
-		lBegin = next;
-	}
+	m_TapNotes[iTrack].erase( lBegin, lEnd );
 
 	/* Additionally, if there's a tap note lying at the end of our range,
 	 * remove it too. */
@@ -248,19 +248,17 @@ static void LoadFromSMNoteDataStringWithPlayer( NoteData& out, const RString &sS
 	for( int t=0; t<out.GetNumTracks(); t++ )
 	{
 		NoteData::iterator begin = out.begin( t );
-		NoteData::iterator lEnd = out.end( t );
-		while( begin != lEnd )
+		while( begin != out.end(t) )
 		{
-			NoteData::iterator next = Increment( begin );
 			const TapNote &tn = begin->second;
 			if( tn.type == TapNoteType_HoldHead && tn.iDuration == MAX_NOTE_ROW )
 			{
 				int iRow = begin->first;
 				LOG->UserLog( "", "", "While loading .sm/.ssc note data, there was an unmatched 2 at beat %f", NoteRowToBeat(iRow) );
-				out.RemoveTapNote( t, begin );
+				begin = out.RemoveTapNote( t, begin );
 			}
-
-			begin = next;
+			else
+				++begin;
 		}
 	}
 	out.RevalidateATIs(vector<int>(), false);
@@ -321,14 +319,17 @@ void NoteDataUtil::InsertHoldTails( NoteData &inout )
 {
 	for( int t=0; t < inout.GetNumTracks(); t++ )
 	{
-		NoteData::iterator begin = inout.begin(t), end = inout.end(t);
+		NoteData::iterator begin = inout.begin(t);
 
-		for( ; begin != end; ++begin )
+		while( begin != inout.end(t) )
 		{
 			int iRow = begin->first;
 			const TapNote &tn = begin->second;
 			if( tn.type != TapNoteType_HoldHead )
+			{
+				++begin;
 				continue;
+			}
 
 			TapNote tail = tn;
 			tail.type = TapNoteType_HoldTail;
@@ -338,6 +339,8 @@ void NoteDataUtil::InsertHoldTails( NoteData &inout )
 			ASSERT( tn.iDuration != 0 );
 
 			inout.SetTapNote( t, iRow + tn.iDuration, tail );
+			// Adding the tail may move the notes around; find our place again.
+			begin = inout.upper_bound( t, iRow );
 		}
 	}
 }
@@ -1333,7 +1336,7 @@ void NoteDataUtil::RemoveAllButPlayer( NoteData &inout, PlayerNumber pn )
 		while( i != inout.end(track) )
 		{
 			if( i->second.pn != pn && i->second.pn != PLAYER_INVALID )
-				inout.RemoveTapNote( track, i++ );
+				i = inout.RemoveTapNote( track, i );
 			else
 				++i;
 		}
@@ -2902,16 +2905,16 @@ void NoteDataUtil::DeleteRows( NoteData &nd, int iStartIndex, int iRowsToDelete
 
 void NoteDataUtil::RemoveAllTapsOfType( NoteData& ndInOut, TapNoteType typeToRemove )
 {
-	/* Be very careful when deleting the tap notes. Erasing elements from maps using
-	 * iterators invalidates only the iterator that is being erased. To that end,
-	 * increment the iterator before deleting the elment of the map.
+	/* Be very careful when deleting the tap notes. Depending on the TrackMap,
+	 * erasing a note may invalidate every iterator after it, so carry on from
+	 * the iterator RemoveTapNote returns.
 	 */
 	for( int t=0; t<ndInOut.GetNumTracks(); t++ )
 	{
 		for( NoteData::iterator iter = ndInOut.begin(t); iter != ndInOut.end(t); )
 		{
 			if( iter->second.type == typeToRemove )
-				ndInOut.RemoveTapNote( t, iter++ );
+				iter = ndInOut.RemoveTapNote( t, iter );
 			else
 				++iter;
 		}
@@ -2927,7 +2930,7 @@ void NoteDataUtil::RemoveAllTapsExceptForType( NoteData& ndInOut, TapNoteType ty
 		for( NoteData::iterator iter = ndInOut.begin(t); iter != ndInOut.end(t); )
 		{
 			if( iter->second.type != typeToKeep )
-				ndInOut.RemoveTapNote( t, iter++ );
+				iter = ndInOut.RemoveTapNote( t, iter );
 			else
 				++iter;
 		}
@@ -370,7 +370,7 @@ void SMLoader::ProcessBGChanges( Song &out, const RString &sValueName, const RSt
 
 void SMLoader::ProcessAttackString( vector<RString> & attacks, MsdFile::value_t params )
 {
-	for( unsigned s=1; s < params.params.size(); ++s )
+	for( unsigned s=1; s < params.GetNumParams(); ++s )
 	{
 		RString tmp = params[s];
 		Trim(tmp);
@@ -384,7 +384,7 @@ void SMLoader::ProcessAttacks( AttackArray &attacks, MsdFile::value_t params )
 	Attack attack;
 	float end = -9999;
 	
-	for( unsigned j=1; j < params.params.size(); ++j )
+	for( unsigned j=1; j < params.GetNumParams(); ++j )
 	{
 		vector<RString> sBits;
 		split( params[j], "=", sBits, false );
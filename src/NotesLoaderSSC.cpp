@@ -7,6 +7,7 @@
 #include "NotesLoaderSM.h" // For programming shortcuts.
 #include "RageFileManager.h"
 #include "RageLog.h"
+#include "RageThreads.h"
 #include "RageUtil.h"
 #include "Song.h"
 #include "SongManager.h"
@@ -14,6 +15,12 @@
 #include "Attack.h"
 #include "PrefsManager.h"
 
+/* Number of threads used to decode the note data of large simfiles.  1
+ * leaves it to be decoded on demand, as before. */
+static Preference<int> g_iNoteDataDecodeThreads( "NoteDataDecodeThreads", 4 );
+/* Simfiles with less note data than this aren't worth starting threads for. */
+static const size_t PARALLEL_NOTE_DATA_MIN_SIZE = 256*1024;
+
 // Everything from this line to the creation of parser_helper exists to
 // speed up parsing by allowing the use of std::map.  All these functions
 // are put into a map of function pointers which is used when loading.
@@ -946,6 +953,57 @@ bool SSCLoader::LoadNoteDataFromSimfile( const RString & cachePath, Steps &out )
 	return false;
 }
 
+/* Steps whose note data is decoded by the decode threads.  Each thread claims
+ * the next unclaimed Steps; nothing else touches them until every thread has
+ * finished. */
+struct NoteDataDecodeQueue
+{
+	NoteDataDecodeQueue(): m_Lock("NoteDataDecodeQueue"), m_iNext(0) { }
+
+	vector<Steps *> m_vpSteps;
+	RageMutex m_Lock;
+	size_t m_iNext;
+
+	static int DecodeThread_start( void *p ) { ((NoteDataDecodeQueue *) p)->DecodeThread(); return 0; }
+	void DecodeThread()
+	{
+		for(;;)
+		{
+			m_Lock.Lock();
+			const size_t i = m_iNext++;
+			m_Lock.Unlock();
+			if( i >= m_vpSteps.size() )
+				return;
+
+			m_vpSteps[i]->Decompress();
+		}
+	}
+};
+
+/* Decode the note data of every Steps in vpSteps now, across several threads,
+ * rather than one at a time when the song calculates radar values. */
+static void DecodeNoteDataInParallel( const vector<Steps *> &vpSteps )
+{
+	const int iNumThreads = min( g_iNoteDataDecodeThreads.Get(), (int) vpSteps.size() );
+	if( iNumThreads <= 1 )
+		return;
+
+	NoteDataDecodeQueue queue;
+	queue.m_vpSteps = vpSteps;
+
+	/* This thread decodes too, so start one fewer. */
+	vector<RageThread> threads( iNumThreads - 1 );
+	for( unsigned i = 0; i < threads.size(); ++i )
+	{
+		threads[i].SetName( ssprintf("Note data decode thread %u", i) );
+		threads[i].Create( NoteDataDecodeQueue::DecodeThread_start, &queue );
+	}
+	queue.DecodeThread();
+
+	for (RageThread &thread : threads)
+		thread.Wait();
+}
+
 bool SSCLoader::LoadFromSimfile( const RString &sPath, Song &out, bool bFromCache )
 {
 	//LOG->Trace( "Song::LoadFromSSCFile(%s)", sPath.c_str() );
@@ -968,6 +1026,10 @@ bool SSCLoader::LoadFromSimfile( const RString &sPath, Song &out, bool bFromCach
 	SongTagInfo reused_song_info(&*this, &out, sPath, bFromCache);
 	StepsTagInfo reused_steps_info(&*this, &out, sPath, bFromCache);
 
+	/* Steps with note data in this file, to be decoded up front. */
+	vector<Steps *> vpDecodeSteps;
+	size_t iNoteDataSize = 0;
+
 	for( unsigned i = 0; i < values; i++ )
 	{
 		const MsdFile::value_t &sParams = msd.GetValue(i);
@@ -1024,6 +1086,11 @@ bool SSCLoader::LoadFromSimfile( const RString &sPath, Song &out, bool bFromCach
 					pNewNotes->TidyUpData();
 					pNewNotes->SetFilename(sPath);
 					out.AddSteps(pNewNotes);
+					if( pNewNotes->m_StepsType != StepsType_Invalid )
+					{
+						vpDecodeSteps.push_back( pNewNotes );
+						iNoteDataSize += sParams.GetParamView(1).GetRawSize();
+					}
 				}
 				else if(sValueName=="STEPFILENAME")
 				{
@@ -1043,6 +1110,13 @@ bool SSCLoader::LoadFromSimfile( const RString &sPath, Song &out, bool bFromCach
 		}
 	}
 	out.m_fVersion = STEPFILE_VERSION_NUMBER;
+
+	/* Radar values are calculated from the note data of every chart when a
+	 * song isn't loaded from the cache.  For big files, get that done in
+	 * parallel. */
+	if( !bFromCache && iNoteDataSize >= PARALLEL_NOTE_DATA_MIN_SIZE )
+		DecodeNoteDataInParallel( vpDecodeSteps );
+
 	TidyUpData(out, bFromCache);
 	return true;
 }
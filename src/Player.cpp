@@ -2550,7 +2550,7 @@ void Player::UpdateTapNotesMissedOlderThan( float fMissIfOlderThanSeconds )
 	{
 		TimingData::GetBeatArgs beat_info;
 		beat_info.elapsed_time= fEarliestTime;
-		m_Timing->GetBeatAndBPSFromElapsedTime(beat_info);
+		m_Timing->GetBeatAndBPSFromElapsedTime(beat_info, m_MissedCursor);
 
 		iMissIfOlderThanThisRow = BeatToNoteRow(beat_info.beat);
 		if(beat_info.freeze_out || beat_info.delay_out )
@@ -2596,7 +2596,7 @@ void Player::UpdateTapNotesMissedOlderThan( float fMissIfOlderThanSeconds )
 void Player::UpdateJudgedRows()
 {
 	// Look ahead far enough to catch any rows judged early.
-	const int iEndRow = BeatToNoteRow( m_Timing->GetBeatFromElapsedTime( m_pPlayerState->m_Position.m_fMusicSeconds + GetMaxStepDistanceSeconds() ) );
+	const int iEndRow = BeatToNoteRow( m_Timing->GetBeatFromElapsedTime( m_pPlayerState->m_Position.m_fMusicSeconds + GetMaxStepDistanceSeconds(), m_JudgedRowsCursor ) );
 	bool bAllJudged = true;
 	const bool bSeparately = GAMESTATE->GetCurrentGame()->m_bCountNotesSeparately;
 
@@ -184,6 +184,9 @@ protected:
 	/** @brief The player's present stage stats. */
 	PlayerStageStats	*m_pPlayerStageStats;
 	TimingData      *m_Timing;
+	/** @brief Cursors for the lookups into m_Timing made every update. */
+	TimingData::Cursor	m_MissedCursor;
+	TimingData::Cursor	m_JudgedRowsCursor;
 	float			m_fNoteFieldHeight;
 
 	bool			m_bPaused;
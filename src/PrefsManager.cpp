@@ -306,6 +306,7 @@ PrefsManager::PrefsManager() :
 	m_bForceLogFlush		( "ForceLogFlush",	false ),
 	m_bShowLogOutput		( "ShowLogOutput",	false ),
 #endif
+	m_bLogTraces			( "LogTraces",		true ),
 	m_bLogSkips			( "LogSkips",		false ),
 	m_bLogCheckpoints		( "LogCheckpoints",	false ),
 	m_bShowLoadingWindow		( "ShowLoadingWindow",	true ),
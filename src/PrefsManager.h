@@ -317,6 +317,7 @@ public:
 	Preference<bool>	m_bLogToDisk;
 	Preference<bool>	m_bForceLogFlush;
 	Preference<bool>	m_bShowLogOutput;
+	Preference<bool>	m_bLogTraces;
 	Preference<bool>	m_bLogSkips;
 	Preference<bool>	m_bLogCheckpoints;
 	Preference<bool>	m_bShowLoadingWindow;
@@ -30,6 +30,10 @@
 
 const RString STATS_XML            = "Stats.xml";
 const RString STATS_XML_GZ         = "Stats.xml.gz";
+/** @brief The scores saved since STATS_XML was last written; see SaveStatsJournalToDir. */
+const RString STATS_JOURNAL        = "Stats.journal";
+/** @brief The next STATS_JOURNAL while it's being signed; see SaveStatsJournalToDir. */
+const RString STATS_JOURNAL_NEW    = "Stats.journal.new";
 /** @brief The filename for where one can edit their personal profile information. */
 const RString EDITABLE_INI         = "Editable.ini";
 /** @brief A tiny file containing the type and list priority. */
@@ -45,6 +49,9 @@ const RString RIVAL_SUBDIR         = "Rivals/";
 
 ThemeMetric<bool> SHOW_COIN_DATA( "Profile", "ShowCoinData" );
 static Preference<bool> g_bProfileDataCompress( "ProfileDataCompress", false );
+/* Number of saves that only append to a profile's score journal before
+ * Stats.xml is rewritten in full.  0 rewrites Stats.xml on every save. */
+static Preference<int> g_iProfileJournalEntries( "ProfileJournalEntries", 16 );
 static ThemeMetric<RString> UNLOCK_AUTH_STRING( "Profile", "UnlockAuthString" );
 #define GUID_SIZE_BYTES 8
 
@@ -601,10 +608,27 @@ Course *Profile::GetMostPopularCourse() const
 	return id.ToCourse();
 }
 
+static pair<SongID,StepsID> MakeJournalKey( const Song* pSong, const Steps* pSteps )
+{
+	pair<SongID,StepsID> key;
+	key.first.FromSong( pSong );
+	key.second.FromSteps( pSteps );
+	return key;
+}
+
+static pair<CourseID,TrailID> MakeJournalKey( const Course* pCourse, const Trail* pTrail )
+{
+	pair<CourseID,TrailID> key;
+	key.first.FromCourse( pCourse );
+	key.second.FromTrail( pTrail );
+	return key;
+}
+
 // Steps high scores
 void Profile::AddStepsHighScore( const Song* pSong, const Steps* pSteps, HighScore hs, int &iIndexOut )
 {
 	GetStepsHighScoreList(pSong,pSteps).AddHighScore( hs, iIndexOut, IsMachine() );
+	m_JournalSteps.insert( MakeJournalKey(pSong, pSteps) );
 }
 
 const HighScoreList& Profile::GetStepsHighScoreList( const Song* pSong, const Steps* pSteps ) const
@@ -679,6 +703,7 @@ void Profile::IncrementStepsPlayCount( const Song* pSong, const Steps* pSteps )
 {
 	DateTime now = DateTime::GetNowDate();
 	GetStepsHighScoreList(pSong,pSteps).IncrementPlayCount( now );
+	m_JournalSteps.insert( MakeJournalKey(pSong, pSteps) );
 }
 
 void Profile::GetGrades( const Song* pSong, StepsType st, int iCounts[NUM_Grade] ) const
@@ -710,6 +735,7 @@ void Profile::GetGrades( const Song* pSong, StepsType st, int iCounts[NUM_Grade]
 void Profile::AddCourseHighScore( const Course* pCourse, const Trail* pTrail, HighScore hs, int &iIndexOut )
 {
 	GetCourseHighScoreList(pCourse,pTrail).AddHighScore( hs, iIndexOut, IsMachine() );
+	m_JournalTrails.insert( MakeJournalKey(pCourse, pTrail) );
 }
 
 const HighScoreList& Profile::GetCourseHighScoreList( const Course* pCourse, const Trail* pTrail ) const
@@ -781,6 +807,7 @@ void Profile::IncrementCoursePlayCount( const Course* pCourse, const Trail* pTra
 {
 	DateTime now = DateTime::GetNowDate();
 	GetCourseHighScoreList(pCourse,pTrail).IncrementPlayCount( now );
+	m_JournalTrails.insert( MakeJournalKey(pCourse, pTrail) );
 }
 
 void Profile::GetAllUsedHighScoreNames(std::set<RString>& names)
@@ -822,6 +849,7 @@ void Profile::GetAllUsedHighScoreNames(std::set<RString>& names)
 void Profile::MergeScoresFromOtherProfile(Profile* other, bool skip_totals,
 	RString const& from_dir, RString const& to_dir)
 {
+	RequireStatsSnapshot();
 	if(!skip_totals)
 	{
 #define MERGE_FIELD(field_name) field_name+= other->field_name;
@@ -1007,12 +1035,15 @@ void Profile::swap(Profile& other)
 #undef SWAP_STR_MEMBER
 #undef SWAP_GENERAL
 #undef SWAP_ARRAY
+	RequireStatsSnapshot();
+	other.RequireStatsSnapshot();
 }
 
 // Category high scores
 void Profile::AddCategoryHighScore( StepsType st, RankingCategory rc, HighScore hs, int &iIndexOut )
 {
 	m_CategoryHighScores[st][rc].AddHighScore( hs, iIndexOut, IsMachine() );
+	m_JournalCategories.insert( make_pair(st, rc) );
 }
 
 const HighScoreList& Profile::GetCategoryHighScoreList( StepsType st, RankingCategory rc ) const
@@ -1037,6 +1068,7 @@ void Profile::IncrementCategoryPlayCount( StepsType st, RankingCategory rc )
 {
 	DateTime now = DateTime::GetNowDate();
 	m_CategoryHighScores[st][rc].IncrementPlayCount( now );
+	m_JournalCategories.insert( make_pair(st, rc) );
 }
 
 
@@ -1300,12 +1332,22 @@ ProfileLoadResult Profile::LoadStatsFromDir(RString dir, bool require_signature)
 	}
 
 	LOG->Trace("Loading %s", fn.c_str());
-	XNode xml;
-	if(!XmlFileUtil::LoadFromFileShowErrors(xml, *pFile.get()))
+	RString sXml;
+	if(pFile->Read(sXml) == -1)
+	{
+		LuaHelpers::ReportScriptErrorFmt("XML: LoadFromFile failed: %s", pFile->GetError().c_str());
 		return ProfileLoadResult_FailedTampered;
+	}
+	XmlFileUtil::PullParser parser(sXml);
+	ProfileLoadResult ret= LoadStatsXmlFromParser(parser);
+	if(!parser.GetError().empty())
+		LuaHelpers::ReportScriptError(ssprintf("XML: LoadFromFile failed: %s", parser.GetError().c_str()), "XML_PARSE_ERROR");
+	if(ret != ProfileLoadResult_Success)
+		return ret;
 	LOG->Trace("Done.");
 
-	return LoadStatsXmlFromNode(&xml);
+	LoadStatsJournalFromDir(dir, require_signature);
+	return ProfileLoadResult_Success;
 }
 
 void Profile::LoadTypeFromDir(RString dir)
@@ -1381,6 +1423,92 @@ ProfileLoadResult Profile::LoadStatsXmlFromNode( const XNode *xml, bool bIgnoreE
 	return ProfileLoadResult_Success;
 }
 
+/* LoadStatsXmlFromNode for a whole Stats.xml, read as it's parsed.  Each
+ * section except the song scores is still built into an XNode and loaded
+ * as before; they're small. */
+ProfileLoadResult Profile::LoadStatsXmlFromParser( XmlFileUtil::PullParser &parser )
+{
+	XmlFileUtil::PullParser::Event event = parser.Next();
+	while( event == XmlFileUtil::PullParser::Text )
+		event = parser.Next();
+	if( event != XmlFileUtil::PullParser::StartElement )
+		return ProfileLoadResult_FailedTampered;
+
+	/* The placeholder stats.xml file has an <html> tag. Don't load it,
+	 * but don't warn about it. */
+	if( parser.GetName() == "html" )
+		return ProfileLoadResult_FailedNoProfile;
+
+	if( parser.GetName() != "Stats" )
+	{
+		WARN_M( parser.GetName() );
+		return ProfileLoadResult_FailedTampered;
+	}
+
+	// These are loaded from Editable, so we want to ignore them here.
+	RString sName = m_sDisplayName;
+	RString sCharacterID = m_sCharacterID;
+	RString sLastUsedHighScoreName = m_sLastUsedHighScoreName;
+	int iWeightPounds = m_iWeightPounds;
+	float Voomax= m_Voomax;
+	int BirthYear= m_BirthYear;
+	bool IgnoreStepCountCalories= m_IgnoreStepCountCalories;
+	bool IsMale= m_IsMale;
+
+	set<RString> vsLoaded;
+	bool bDone = false;
+	while( !bDone )
+	{
+		switch( parser.Next() )
+		{
+		case XmlFileUtil::PullParser::StartElement:
+		{
+			const RString sSection = parser.GetName();
+			vsLoaded.insert( sSection );
+			if( sSection == "SongScores" )
+			{
+				if( !LoadSongScoresFromParser(parser) )
+					return ProfileLoadResult_FailedTampered;
+				break;
+			}
+
+			XNode node;
+			if( !parser.ReadElement(&node) )
+				return ProfileLoadResult_FailedTampered;
+			if( sSection == "GeneralData" )			LoadGeneralDataFromNode( &node );
+			else if( sSection == "CourseScores" )		LoadCourseScoresFromNode( &node );
+			else if( sSection == "CategoryScores" )		LoadCategoryScoresFromNode( &node );
+			else if( sSection == "ScreenshotData" )		LoadScreenshotDataFromNode( &node );
+			else if( sSection == "CalorieData" )		LoadCalorieDataFromNode( &node );
+			break;
+		}
+		case XmlFileUtil::PullParser::Text:
+			break;
+		case XmlFileUtil::PullParser::EndElement:
+			bDone = true;
+			break;
+		default:
+			return ProfileLoadResult_FailedTampered;
+		}
+	}
+
+	static const char *szSections[] = { "GeneralData", "SongScores", "CourseScores", "CategoryScores", "ScreenshotData", "CalorieData" };
+	for( unsigned i = 0; i < ARRAYLEN(szSections); ++i )
+		if( vsLoaded.find(szSections[i]) == vsLoaded.end() )
+			LOG->Warn( "Failed to read section %s", szSections[i] );
+
+	m_sDisplayName = sName;
+	m_sCharacterID = sCharacterID;
+	m_sLastUsedHighScoreName = sLastUsedHighScoreName;
+	m_iWeightPounds = iWeightPounds;
+	m_Voomax= Voomax;
+	m_BirthYear= BirthYear;
+	m_IgnoreStepCountCalories= IgnoreStepCountCalories;
+	m_IsMale= IsMale;
+
+	return ProfileLoadResult_Success;
+}
+
 bool Profile::SaveAllToDir( RString sDir, bool bSignData ) const
 {
 	m_sLastPlayedMachineGuid = PROFILEMAN->GetMachineProfile()->m_sGuid;
@@ -1443,9 +1571,12 @@ XNode *Profile::SaveStatsXmlCreateNode() const
 bool Profile::SaveStatsXmlToDir( RString sDir, bool bSignData ) const
 {
 	LOG->Trace( "SaveStatsXmlToDir: %s", sDir.c_str() );
-	unique_ptr<XNode> xml( SaveStatsXmlCreateNode() );
 
 	sDir= sDir + PROFILEMAN->GetStatsPrefix();
+	if( SaveStatsJournalToDir(sDir, bSignData) )
+		return true;
+
+	unique_ptr<XNode> xml( SaveStatsXmlCreateNode() );
 	// Save stats.xml
 	RString fn = sDir + (g_bProfileDataCompress? STATS_XML_GZ:STATS_XML);
 
@@ -1493,9 +1624,265 @@ bool Profile::SaveStatsXmlToDir( RString sDir, bool bSignData ) const
 		CryptManager::SignFileToFile(sStatsXmlSigFile, sDontShareFile);
 	}
 
+	// Everything in the journal is in the new Stats.xml.
+	const RString asJournalFiles[] = { STATS_JOURNAL, STATS_JOURNAL_NEW };
+	for( unsigned i = 0; i < ARRAYLEN(asJournalFiles); ++i )
+	{
+		if( FILEMAN->IsAFile(sDir + asJournalFiles[i]) )
+			FILEMAN->Remove( sDir + asJournalFiles[i] );
+		if( FILEMAN->IsAFile(sDir + asJournalFiles[i] + SIGNATURE_APPEND) )
+			FILEMAN->Remove( sDir + asJournalFiles[i] + SIGNATURE_APPEND );
+	}
+	ResetStatsJournal( sDir );
+
+	return true;
+}
+
+/* Write a journal file or signature, replacing the old one all at once. */
+static bool WriteJournalFile( const RString &sPath, const RString &sData )
+{
+	RageFile f;
+	if( !f.Open(sPath, RageFile::WRITE) || f.Write(sData) == -1 || f.Flush() == -1 )
+	{
+		LOG->Trace( "Couldn't write %s (%s); writing Stats.xml instead.", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+	return true;
+}
+
+/* Most saves only add a few scores, but rewriting and signing Stats.xml takes
+ * time proportional to every score the profile has.  Instead, each save
+ * appends the general data and the score lists that changed to STATS_JOURNAL,
+ * which is replayed over Stats.xml on load.  Every entry holds whole lists
+ * and totals, not differences, so replaying an entry that's already in
+ * Stats.xml does no harm.  Stats.xml is rewritten, and the journal removed,
+ * after ProfileJournalEntries saves, or when something changed that the
+ * journal doesn't track.
+ *
+ * Each entry is a line with its length and CRC, then a Stats node.  The whole
+ * journal is signed alongside Stats.xml, and an entry is only applied if its
+ * Guid matches the profile's.
+ *
+ * The journal and its signature can't be replaced together, so a save never
+ * leaves the journal without a signature that matches it:
+ *  1. Write the new journal to STATS_JOURNAL_NEW, and sign that.
+ *  2. Rewrite STATS_JOURNAL; it now matches STATS_JOURNAL_NEW's signature.
+ *  3. Rewrite STATS_JOURNAL's signature, then remove STATS_JOURNAL_NEW.
+ * Each file is written to a temporary file and renamed over the old one, so
+ * it's either old or new.  On load, STATS_JOURNAL is checked against both
+ * signatures. */
+bool Profile::SaveStatsJournalToDir( RString sDir, bool bSignData ) const
+{
+	if( g_iProfileJournalEntries <= 0 || sDir != m_sStatsJournalDir ||
+		m_iStatsJournalEntries >= g_iProfileJournalEntries )
+		return false;
+
+	// The journal is only read on top of a Stats.xml in the current format.
+	RString fn = sDir + (g_bProfileDataCompress? STATS_XML_GZ:STATS_XML);
+	if( !FILEMAN->IsAFile(fn) || (bSignData && !FILEMAN->IsAFile(fn + SIGNATURE_APPEND)) )
+		return false;
+
+	unique_ptr<XNode> xml( new XNode("Stats") );
+	xml->AppendChild( SaveGeneralDataCreateNode() );
+
+	XNode* pSongScores = xml->AppendChild( "SongScores" );
+	XNode* pSongNode = nullptr;
+	const SongID *pLastSongID = nullptr;
+	for (pair<SongID,StepsID> const &i : m_JournalSteps)
+	{
+		if( pLastSongID == nullptr || !(*pLastSongID == i.first) )
+		{
+			pSongNode = pSongScores->AppendChild( i.first.CreateNode() );
+			pLastSongID = &i.first;
+		}
+		const HighScoreList &hsl = ((Profile *)this)->m_SongHighScores[i.first].m_StepsHighScores[i.second].hsl;
+		pSongNode->AppendChild( i.second.CreateNode() )->AppendChild( hsl.CreateNode() );
+	}
+
+	XNode* pCourseScores = xml->AppendChild( "CourseScores" );
+	XNode* pCourseNode = nullptr;
+	const CourseID *pLastCourseID = nullptr;
+	for (pair<CourseID,TrailID> const &i : m_JournalTrails)
+	{
+		if( pLastCourseID == nullptr || *pLastCourseID < i.first )
+		{
+			pCourseNode = pCourseScores->AppendChild( i.first.CreateNode() );
+			pLastCourseID = &i.first;
+		}
+		const HighScoreList &hsl = ((Profile *)this)->m_CourseHighScores[i.first].m_TrailHighScores[i.second].hsl;
+		pCourseNode->AppendChild( i.second.CreateNode() )->AppendChild( hsl.CreateNode() );
+	}
+
+	XNode* pCategoryScores = xml->AppendChild( "CategoryScores" );
+	XNode* pStepsTypeNode = nullptr;
+	StepsType stLast = StepsType_Invalid;
+	for (pair<StepsType,RankingCategory> const &i : m_JournalCategories)
+	{
+		if( pStepsTypeNode == nullptr || stLast != i.first )
+		{
+			pStepsTypeNode = pCategoryScores->AppendChild( "StepsType" );
+			pStepsTypeNode->AppendAttr( "Type", GAMEMAN->GetStepsTypeInfo(i.first).szName );
+			stLast = i.first;
+		}
+		XNode* pRankingCategoryNode = pStepsTypeNode->AppendChild( "RankingCategory" );
+		pRankingCategoryNode->AppendAttr( "Type", RankingCategoryToString(i.second) );
+		pRankingCategoryNode->AppendChild( GetCategoryHighScoreList(i.first, i.second).CreateNode() );
+	}
+
+	// Screenshots aren't journaled; this only keeps the loader quiet.
+	xml->AppendChild( "ScreenshotData" );
+
+	XNode* pCalorieData = xml->AppendChild( "CalorieData" );
+	for (DateTime const &day : m_JournalDays)
+	{
+		XNode* pCaloriesBurned = pCalorieData->AppendChild( "CaloriesBurned", GetCaloriesBurnedForDay(day) );
+		pCaloriesBurned->AppendAttr( "Date", day.GetString() );
+	}
+
+	const RString sXml = XmlFileUtil::GetXML( xml.get() );
+	unsigned iCRC = 0;
+	CRC32( iCRC, sXml.data(), sXml.size() );
+	const RString sEntry = ssprintf( "%u %08x\n", unsigned(sXml.size()), iCRC ) + sXml + "\n";
+
+	const RString sJournal = sDir + STATS_JOURNAL;
+	const RString sNewJournal = sDir + STATS_JOURNAL_NEW;
+	RString sData;
+	if( FILEMAN->IsAFile(sJournal) && !GetFileContents(sJournal, sData) )
+	{
+		LOG->Trace( "Couldn't read %s; writing Stats.xml instead.", sJournal.c_str() );
+		return false;
+	}
+	sData += sEntry;
+
+	/* The full save that follows any failure removes anything left behind. */
+	if( bSignData )
+	{
+		RString sSignature;
+		if( !WriteJournalFile(sNewJournal, sData) )
+			return false;
+		CryptManager::SignFileToFile( sNewJournal, sNewJournal + SIGNATURE_APPEND );
+		if( !GetFileContents(sNewJournal + SIGNATURE_APPEND, sSignature) )
+		{
+			LOG->Trace( "Couldn't sign %s; writing Stats.xml instead.", sNewJournal.c_str() );
+			return false;
+		}
+
+		if( !WriteJournalFile(sJournal, sData) || !WriteJournalFile(sJournal + SIGNATURE_APPEND, sSignature) )
+			return false;
+		FILEMAN->Remove( sNewJournal );
+		FILEMAN->Remove( sNewJournal + SIGNATURE_APPEND );
+	}
+	else if( !WriteJournalFile(sJournal, sData) )
+	{
+		return false;
+	}
+
+	m_JournalSteps.clear();
+	m_JournalTrails.clear();
+	m_JournalCategories.clear();
+	m_JournalDays.clear();
+	++m_iStatsJournalEntries;
 	return true;
 }
 
+void Profile::LoadStatsJournalFromDir( RString sDir, bool bRequireSignature )
+{
+	ResetStatsJournal( sDir );
+
+	const RString sJournal = sDir + STATS_JOURNAL;
+	if( !FILEMAN->IsAFile(sJournal) )
+		return;
+
+	/* Whatever happens below, the next save writes Stats.xml and removes this
+	 * journal unless every entry in it was applied. */
+	RequireStatsSnapshot();
+
+	/* If a save was interrupted after the journal was rewritten, its signature
+	 * is still in STATS_JOURNAL_NEW's. */
+	if( bRequireSignature &&
+		!CryptManager::VerifyFileWithFile(sJournal, sJournal + SIGNATURE_APPEND) &&
+		!CryptManager::VerifyFileWithFile(sJournal, sDir + STATS_JOURNAL_NEW + SIGNATURE_APPEND) )
+	{
+		LuaHelpers::ReportScriptErrorFmt( "The signature check for '%s' failed.  Data will be ignored.", sJournal.c_str() );
+		return;
+	}
+
+	RageFile f;
+	if( !f.Open(sJournal) )
+	{
+		LOG->Trace( "Error opening %s: %s", sJournal.c_str(), f.GetError().c_str() );
+		return;
+	}
+	if( !IsMachine() && f.GetFileSize() > MAX_PLAYER_STATS_XML_SIZE_BYTES )
+	{
+		LuaHelpers::ReportScriptErrorFmt( "The file '%s' is unreasonably large.  It won't be loaded.", sJournal.c_str() );
+		return;
+	}
+	RString sData;
+	if( f.Read(sData, f.GetFileSize()) == -1 )
+	{
+		LOG->Trace( "Error reading %s: %s", sJournal.c_str(), f.GetError().c_str() );
+		return;
+	}
+
+	int iEntries = 0;
+	size_t iPos = 0;
+	while( iPos < sData.size() )
+	{
+		size_t iEnd = sData.find( '\n', iPos );
+		if( iEnd == RString::npos )
+			break;
+		unsigned iSize, iCRC;
+		if( sscanf(sData.c_str() + iPos, "%u %x", &iSize, &iCRC) != 2 )
+			break;
+		iPos = iEnd + 1;
+		if( sData.size() - iPos < size_t(iSize) + 1 )
+			break;
+
+		const RString sXml = sData.substr( iPos, iSize );
+		unsigned iActualCRC = 0;
+		CRC32( iActualCRC, sXml.data(), sXml.size() );
+		if( iActualCRC != iCRC )
+			break;
+
+		XNode xml;
+		RString sError;
+		XmlFileUtil::Load( &xml, sXml, sError );
+		if( !sError.empty() )
+			break;
+
+		RString sGuid;
+		const XNode *pGeneralData = xml.GetChild( "GeneralData" );
+		if( pGeneralData == nullptr || !pGeneralData->GetChildValue("Guid", sGuid) || sGuid != m_sGuid )
+			break;
+
+		if( LoadStatsXmlFromNode(&xml) != ProfileLoadResult_Success )
+			break;
+		iPos += iSize + 1;
+		++iEntries;
+	}
+
+	if( iPos < sData.size() )
+	{
+		LOG->Warn( "%s is damaged after %i entries; the rest will be ignored.", sJournal.c_str(), iEntries );
+		return;
+	}
+
+	LOG->Trace( "Applied %i entries from %s.", iEntries, sJournal.c_str() );
+	ResetStatsJournal( sDir );
+	m_iStatsJournalEntries = iEntries;
+}
+
+void Profile::ResetStatsJournal( const RString &sDir ) const
+{
+	m_JournalSteps.clear();
+	m_JournalTrails.clear();
+	m_JournalCategories.clear();
+	m_JournalDays.clear();
+	m_sStatsJournalDir = sDir;
+	m_iStatsJournalEntries = 0;
+}
+
 void Profile::SaveTypeToDir(RString dir) const
 {
 	IniFile ini;
@@ -1888,6 +2275,7 @@ void Profile::AddStepTotals( int iTotalTapsAndHolds, int iTotalJumps, int iTotal
 		m_fTotalCaloriesBurned += fCaloriesBurned;
 		DateTime date = DateTime::GetNowDate();
 		m_mapDayToCaloriesBurned[date].fCals += fCaloriesBurned;
+		m_JournalDays.insert( date );
 	}
 }
 
@@ -1902,6 +2290,7 @@ void Profile::AddCaloriesToDailyTotal(float cals)
 	m_fTotalCaloriesBurned += cals;
 	DateTime date = DateTime::GetNowDate();
 	m_mapDayToCaloriesBurned[date].fCals += cals;
+	m_JournalDays.insert( date );
 }
 
 float Profile::CalculateCaloriesFromHeartRate(float HeartRate, float Duration)
@@ -2028,29 +2417,68 @@ void Profile::LoadSongScoresFromNode( const XNode* pSongScores )
 		if( pSong->GetName() != "Song" )
 			continue;
 
-		SongID songID;
-		songID.LoadFromNode( pSong );
-		// Allow invalid songs so that scores aren't deleted for people that use
-		// AdditionalSongsFolders and change it frequently. -Kyz
-		//if( !songID.IsValid() )
-		//	continue;
+		LoadSongScoresForSongFromNode( pSong );
+	}
+}
 
-		FOREACH_CONST_Child( pSong, pSteps )
-		{
-			if( pSteps->GetName() != "Steps" )
-				continue;
+void Profile::LoadSongScoresForSongFromNode( const XNode* pSong )
+{
+	SongID songID;
+	songID.LoadFromNode( pSong );
+	// Allow invalid songs so that scores aren't deleted for people that use
+	// AdditionalSongsFolders and change it frequently. -Kyz
+	//if( !songID.IsValid() )
+	//	continue;
 
-			StepsID stepsID;
-			stepsID.LoadFromNode( pSteps );
-			if( !stepsID.IsValid() )
-				WARN_AND_CONTINUE;
+	FOREACH_CONST_Child( pSong, pSteps )
+	{
+		if( pSteps->GetName() != "Steps" )
+			continue;
 
-			const XNode *pHighScoreListNode = pSteps->GetChild("HighScoreList");
-			if( pHighScoreListNode == nullptr )
-				WARN_AND_CONTINUE;
-			
-			HighScoreList &hsl = m_SongHighScores[songID].m_StepsHighScores[stepsID].hsl;
-			hsl.LoadFromNode( pHighScoreListNode );
+		StepsID stepsID;
+		stepsID.LoadFromNode( pSteps );
+		if( !stepsID.IsValid() )
+			WARN_AND_CONTINUE;
+
+		const XNode *pHighScoreListNode = pSteps->GetChild("HighScoreList");
+		if( pHighScoreListNode == nullptr )
+			WARN_AND_CONTINUE;
+		
+		HighScoreList &hsl = m_SongHighScores[songID].m_StepsHighScores[stepsID].hsl;
+		hsl.LoadFromNode( pHighScoreListNode );
+	}
+}
+
+/* The song scores are nearly all of a machine profile, so read them one
+ * song at a time instead of building an XNode for all of them. */
+bool Profile::LoadSongScoresFromParser( XmlFileUtil::PullParser &parser )
+{
+	CHECKPOINT_M("Streaming the song scores.");
+
+	for(;;)
+	{
+		switch( parser.Next() )
+		{
+		case XmlFileUtil::PullParser::StartElement:
+			if( parser.GetName() != "Song" )
+			{
+				if( !parser.SkipElement() )
+					return false;
+				break;
+			}
+			{
+				XNode song;
+				if( !parser.ReadElement(&song) )
+					return false;
+				LoadSongScoresForSongFromNode( &song );
+			}
+			break;
+		case XmlFileUtil::PullParser::Text:
+			break;
+		case XmlFileUtil::PullParser::EndElement:
+			return true;
+		default:
+			return false;
 		}
 	}
 }
@@ -2255,6 +2683,8 @@ void Profile::SaveMachinePublicKeyToDir( RString sDir ) const
 void Profile::AddScreenshot( const Screenshot &screenshot )
 {
 	m_vScreenshots.push_back( screenshot );
+	// Screenshots are appended when loaded, so they can't be journaled.
+	RequireStatsSnapshot();
 }
 
 void Profile::LoadScreenshotDataFromNode( const XNode* pScreenshotData )
@@ -2495,6 +2925,21 @@ void Profile::MoveBackupToDir( RString sFromDir, RString sToDir )
 		FILEMAN->Move( sFromDir+STATS_XML_GZ+SIGNATURE_APPEND,	sToDir+STATS_XML+SIGNATURE_APPEND );
 	}
 
+	/* The journal goes with the Stats.xml it was written over; remove any
+	 * journal a previous backup left behind otherwise. */
+	if( FILEMAN->IsAFile(sFromDir + STATS_JOURNAL) )
+	{
+		FILEMAN->Move( sFromDir+STATS_JOURNAL,				sToDir+STATS_JOURNAL );
+		if( FILEMAN->IsAFile(sFromDir + STATS_JOURNAL + SIGNATURE_APPEND) )
+			FILEMAN->Move( sFromDir+STATS_JOURNAL+SIGNATURE_APPEND,	sToDir+STATS_JOURNAL+SIGNATURE_APPEND );
+	}
+	else if( FILEMAN->IsAFile(sToDir + STATS_JOURNAL) )
+	{
+		FILEMAN->Remove( sToDir+STATS_JOURNAL );
+		if( FILEMAN->IsAFile(sToDir + STATS_JOURNAL + SIGNATURE_APPEND) )
+			FILEMAN->Remove( sToDir+STATS_JOURNAL+SIGNATURE_APPEND );
+	}
+
 	if( FILEMAN->IsAFile(sFromDir + EDITABLE_INI) )
 		FILEMAN->Move( sFromDir+EDITABLE_INI,				sToDir+EDITABLE_INI );
 	if( FILEMAN->IsAFile(sFromDir + DONT_SHARE_SIG) )
@@ -18,6 +18,7 @@
 
 class XNode;
 struct lua_State;
+namespace XmlFileUtil { class PullParser; }
 class Character;
 
 // Current file versions
@@ -112,7 +113,7 @@ public:
 		m_LastPlayedDate(),m_iNumSongsPlayedByStyle(),
 		m_iNumTotalSongsPlayed(0), m_UserTable(), m_SongHighScores(),
 		m_CourseHighScores(), m_vScreenshots(),
-		m_mapDayToCaloriesBurned()
+		m_mapDayToCaloriesBurned(), m_iStatsJournalEntries(0)
 	{
 		m_lastSong.Unset();
 		m_lastCourse.Unset();
@@ -384,6 +385,7 @@ public:
 		InitScreenshotData(); 
 		InitCalorieData();
 		ClearSongs();
+		RequireStatsSnapshot();
 	}
 	void InitEditableData(); 
 	void InitGeneralData(); 
@@ -407,8 +409,11 @@ public:
 
 	ProfileLoadResult LoadEditableDataFromDir( RString sDir );
 	ProfileLoadResult LoadStatsXmlFromNode( const XNode* pNode, bool bIgnoreEditable = true );
+	ProfileLoadResult LoadStatsXmlFromParser( XmlFileUtil::PullParser &parser );
 	void LoadGeneralDataFromNode( const XNode* pNode );
 	void LoadSongScoresFromNode( const XNode* pNode );
+	void LoadSongScoresForSongFromNode( const XNode* pNode );
+	bool LoadSongScoresFromParser( XmlFileUtil::PullParser &parser );
 	void LoadCourseScoresFromNode( const XNode* pNode );
 	void LoadCategoryScoresFromNode( const XNode* pNode );
 	void LoadScreenshotDataFromNode( const XNode* pNode );
@@ -427,6 +432,12 @@ public:
 
 	XNode* SaveCoinDataCreateNode() const;
 
+	bool SaveStatsJournalToDir( RString sDir, bool bSignData ) const;
+	void LoadStatsJournalFromDir( RString sDir, bool bRequireSignature );
+	/* Make the next save write Stats.xml in full, for changes the journal
+	 * can't track. */
+	void RequireStatsSnapshot() const { m_sStatsJournalDir = RString(); }
+
 	void SaveStatsWebPageToDir( RString sDir ) const;
 	void SaveMachinePublicKeyToDir( RString sDir ) const;
 
@@ -440,6 +451,18 @@ public:
 private:
 	const HighScoresForASong *GetHighScoresForASong( const SongID& songID ) const;
 	const HighScoresForACourse *GetHighScoresForACourse( const CourseID& courseID ) const;
+	void ResetStatsJournal( const RString &sDir ) const;
+
+	/* Score lists and days changed since Stats.xml or the journal was last
+	 * written; these are mutable because saving is const. */
+	mutable set< pair<SongID,StepsID> > m_JournalSteps;
+	mutable set< pair<CourseID,TrailID> > m_JournalTrails;
+	mutable set< pair<StepsType,RankingCategory> > m_JournalCategories;
+	mutable set<DateTime> m_JournalDays;
+	/* The stats directory the journal continues, or empty if the next save
+	 * must write Stats.xml in full. */
+	mutable RString m_sStatsJournalDir;
+	mutable int m_iStatsJournalEntries;
 };
 
 
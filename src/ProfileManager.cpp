@@ -23,6 +23,7 @@
 #include "HighScore.h"
 #include "Character.h"
 #include "CharacterManager.h"
+#include "UnlockManager.h"
 
 
 ProfileManager*	PROFILEMAN = nullptr;	// global and accessible from anywhere in our program
@@ -681,6 +682,10 @@ void ProfileManager::LoadMachineProfile()
 	m_pMachineProfile->m_sDisplayName = PREFSMAN->m_sMachineName;
 
 	LoadMachineProfileEdits();
+
+	// Unlocks are earned by the machine profile.
+	if( UNLOCKMAN != nullptr )
+		UNLOCKMAN->UpdateLockedState();
 }
 
 void ProfileManager::LoadMachineProfileEdits()
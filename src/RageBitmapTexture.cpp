@@ -43,6 +43,16 @@ RageBitmapTexture::RageBitmapTexture( RageTextureID name ) :
 	Create();
 }
 
+RageBitmapTexture::RageBitmapTexture( RageTextureID name, const DeferCreate & ) :
+	RageTexture( name ), m_uTexHandle(0)
+{
+	/* Look like a blank 1x1 texture until Create() is called. */
+	m_iSourceWidth = m_iSourceHeight = 1;
+	m_iTextureWidth = m_iTextureHeight = 1;
+	m_iImageWidth = m_iImageHeight = 1;
+	CreateFrameRects();
+}
+
 RageBitmapTexture::~RageBitmapTexture()
 {
 	Destroy();
@@ -66,7 +76,38 @@ void RageBitmapTexture::Reload()
  */
 void RageBitmapTexture::Create()
 {
-	RageTextureID actualID = GetID();
+	DisplayCaps caps;
+	DecodedImage img;
+	Decode( GetID(), caps, img );
+	Create( img );
+}
+
+RageBitmapTexture::DisplayCaps::DisplayCaps()
+{
+	iMaxTextureSize = DISPLAY->GetMaxTextureSize();
+	bHighResolutionTextures = StepMania::GetHighResolutionTextures();
+	bWarnOddDimensions = TEXTUREMAN->GetOddDimensionWarning();
+	for( int i = 0; i < NUM_RagePixelFormat; ++i )
+		bSupportsFormat[i] = DISPLAY->SupportsTextureFormat( RagePixelFormat(i) );
+}
+
+RageBitmapTexture::DecodedImage::DecodedImage():
+	sHintString(""), sError(""), pImg(nullptr), pixfmt(RagePixelFormat_Invalid),
+	iSourceWidth(0), iSourceHeight(0), iImageWidth(0), iImageHeight(0),
+	iTextureWidth(0), iTextureHeight(0), bWarnOddDimensions(true)
+{
+}
+
+RageBitmapTexture::DecodedImage::~DecodedImage()
+{
+	delete pImg;
+}
+
+void RageBitmapTexture::Decode( const RageTextureID &ID, const DisplayCaps &caps, DecodedImage &out )
+{
+	RageTextureID &actualID = out.actualID;
+	actualID = ID;
+	out.bWarnOddDimensions = caps.bWarnOddDimensions;
 
 	ASSERT( actualID.filename != "" );
 
@@ -82,13 +123,12 @@ void RageBitmapTexture::Create()
 		pImg= RageSurfaceUtils::LoadFile(actualID.filename, error);
 	}
 
-	/* Tolerate corrupt/unknown images. */
+	/* Tolerate corrupt/unknown images.  The warning is shown by Create(), so
+	 * that this can run off the main thread. */
 	if( pImg == nullptr )
 	{
-		RString warning = ssprintf("RageBitmapTexture: Couldn't load %s: %s",
+		out.sError = ssprintf("RageBitmapTexture: Couldn't load %s: %s",
 			actualID.filename.c_str(), error.c_str());
-		LOG->Warn("%s", warning.c_str());
-		Dialog::OK(warning, "missing_texture");
 		pImg = RageSurfaceUtils::MakeDummySurface( 64, 64 );
 		ASSERT( pImg != nullptr );
 	}
@@ -107,7 +147,8 @@ void RageBitmapTexture::Create()
 	}
 
 	// look in the file name for a format hints
-	RString sHintString = GetID().filename + actualID.AdditionalTextureHints;
+	RString &sHintString = out.sHintString;
+	sHintString = ID.filename + actualID.AdditionalTextureHints;
 	sHintString.MakeLower();
 
 	if( sHintString.find("32bpp") != string::npos )			actualID.iColorDepth = 32;
@@ -133,57 +174,61 @@ void RageBitmapTexture::Create()
 		actualID.iGrayscaleBits = -1;
 
 	/* Cap the max texture size to the hardware max. */
-	actualID.iMaxSize = min( actualID.iMaxSize, DISPLAY->GetMaxTextureSize() );
+	actualID.iMaxSize = min( actualID.iMaxSize, caps.iMaxTextureSize );
 
 	/* Save information about the source. */
-	m_iSourceWidth = pImg->w;
-	m_iSourceHeight = pImg->h;
+	out.iSourceWidth = pImg->w;
+	out.iSourceHeight = pImg->h;
 
 	/* in-game image dimensions are the same as the source graphic */
-	m_iImageWidth = m_iSourceWidth;
-	m_iImageHeight = m_iSourceHeight;
+	int &iImageWidth = out.iImageWidth;
+	int &iImageHeight = out.iImageHeight;
+	iImageWidth = out.iSourceWidth;
+	iImageHeight = out.iSourceHeight;
 
 	/* if "doubleres" (high resolution) and we're not allowing high res textures, then image dimensions are half of the source */
 	if( sHintString.find("doubleres") != string::npos )
 	{
-		if( !StepMania::GetHighResolutionTextures() )
+		if( !caps.bHighResolutionTextures )
 		{
-			m_iImageWidth = m_iImageWidth / 2;
-			m_iImageHeight = m_iImageHeight / 2;
+			iImageWidth = iImageWidth / 2;
+			iImageHeight = iImageHeight / 2;
 		}
 	}
 
 	/* image size cannot exceed max size */
-	m_iImageWidth = min( m_iImageWidth, actualID.iMaxSize );
-	m_iImageHeight = min( m_iImageHeight, actualID.iMaxSize );
+	iImageWidth = min( iImageWidth, actualID.iMaxSize );
+	iImageHeight = min( iImageHeight, actualID.iMaxSize );
 
 	/* Texture dimensions need to be a power of two; jump to the next. */
-	m_iTextureWidth = power_of_two(m_iImageWidth);
-	m_iTextureHeight = power_of_two(m_iImageHeight);
+	int &iTextureWidth = out.iTextureWidth;
+	int &iTextureHeight = out.iTextureHeight;
+	iTextureWidth = power_of_two(iImageWidth);
+	iTextureHeight = power_of_two(iImageHeight);
 
 	/* If we're under 8x8, increase it, to avoid filtering problems on odd hardware. */
-	if( m_iTextureWidth < 8 || m_iTextureHeight < 8 )
+	if( iTextureWidth < 8 || iTextureHeight < 8 )
 	{
 		actualID.bStretch = true;
-		m_iTextureWidth = max( 8, m_iTextureWidth );
-		m_iTextureHeight = max( 8, m_iTextureHeight );
+		iTextureWidth = max( 8, iTextureWidth );
+		iTextureHeight = max( 8, iTextureHeight );
 	}
 
-	ASSERT_M( m_iTextureWidth <= actualID.iMaxSize, ssprintf("w %i, %i", m_iTextureWidth, actualID.iMaxSize) );
-	ASSERT_M( m_iTextureHeight <= actualID.iMaxSize, ssprintf("h %i, %i", m_iTextureHeight, actualID.iMaxSize) );
+	ASSERT_M( iTextureWidth <= actualID.iMaxSize, ssprintf("w %i, %i", iTextureWidth, actualID.iMaxSize) );
+	ASSERT_M( iTextureHeight <= actualID.iMaxSize, ssprintf("h %i, %i", iTextureHeight, actualID.iMaxSize) );
 
 	if( actualID.bStretch )
 	{
 		/* The hints asked for the image to be stretched to the texture size,
 		 * probably for tiling. */
-		m_iImageWidth = m_iTextureWidth;
-		m_iImageHeight = m_iTextureHeight;
+		iImageWidth = iTextureWidth;
+		iImageHeight = iTextureHeight;
 	}
 
-	if( pImg->w != m_iImageWidth || pImg->h != m_iImageHeight ) 
-		RageSurfaceUtils::Zoom( pImg, m_iImageWidth, m_iImageHeight );
+	if( pImg->w != iImageWidth || pImg->h != iImageHeight ) 
+		RageSurfaceUtils::Zoom( pImg, iImageWidth, iImageHeight );
 
-	if( actualID.iGrayscaleBits != -1 && DISPLAY->SupportsTextureFormat(RagePixelFormat_PAL) )
+	if( actualID.iGrayscaleBits != -1 && caps.bSupportsFormat[RagePixelFormat_PAL] )
 	{
 		RageSurface *pGrayscale = RageSurfaceUtils::PalettizeToGrayscale( pImg, actualID.iGrayscaleBits, actualID.iAlphaBits );
 
@@ -192,10 +237,10 @@ void RageBitmapTexture::Create()
 	}
 
 	// Figure out which texture format we want the renderer to use.
-	RagePixelFormat pixfmt;
+	RagePixelFormat &pixfmt = out.pixfmt;
 
 	// If the source is palleted, always load as paletted if supported.
-	if( pImg->format->BitsPerPixel == 8 && DISPLAY->SupportsTextureFormat(RagePixelFormat_PAL) )
+	if( pImg->format->BitsPerPixel == 8 && caps.bSupportsFormat[RagePixelFormat_PAL] )
 	{
 		pixfmt = RagePixelFormat_PAL;
 	}
@@ -232,10 +277,10 @@ void RageBitmapTexture::Create()
 	}
 
 	// Make we're using a supported format. Every card supports either RGBA8 or RGBA4.
-	if( !DISPLAY->SupportsTextureFormat(pixfmt) )
+	if( !caps.bSupportsFormat[pixfmt] )
 	{
 		pixfmt = RagePixelFormat_RGBA8;
-		if( !DISPLAY->SupportsTextureFormat(pixfmt) )
+		if( !caps.bSupportsFormat[pixfmt] )
 			pixfmt = RagePixelFormat_RGBA4;
 	}
 
@@ -263,10 +308,31 @@ void RageBitmapTexture::Create()
 	RageSurfaceUtils::FixHiddenAlpha( pImg );
 
 	/* Scale up to the texture size, if needed. */
-	RageSurfaceUtils::ConvertSurface( pImg, m_iTextureWidth, m_iTextureHeight,
+	RageSurfaceUtils::ConvertSurface( pImg, iTextureWidth, iTextureHeight,
 		pImg->fmt.BitsPerPixel, pImg->fmt.Mask[0], pImg->fmt.Mask[1], pImg->fmt.Mask[2], pImg->fmt.Mask[3] );
-	
-	m_uTexHandle = DISPLAY->CreateTexture( pixfmt, pImg, actualID.bMipMaps );
+
+	out.pImg = pImg;
+}
+
+void RageBitmapTexture::Create( DecodedImage &img )
+{
+	const RageTextureID &actualID = img.actualID;
+	const RString &sHintString = img.sHintString;
+
+	if( !img.sError.empty() )
+	{
+		LOG->Warn("%s", img.sError.c_str());
+		Dialog::OK(img.sError, "missing_texture");
+	}
+
+	m_iSourceWidth = img.iSourceWidth;
+	m_iSourceHeight = img.iSourceHeight;
+	m_iImageWidth = img.iImageWidth;
+	m_iImageHeight = img.iImageHeight;
+	m_iTextureWidth = img.iTextureWidth;
+	m_iTextureHeight = img.iTextureHeight;
+
+	m_uTexHandle = DISPLAY->CreateTexture( img.pixfmt, img.pImg, actualID.bMipMaps );
 
 	CreateFrameRects();
 
@@ -288,7 +354,7 @@ void RageBitmapTexture::Create()
 			bRunCheck = false;
 
 		// HACK: Don't check song graphics. Many of them are weird dimensions.
-		if( !TEXTUREMAN->GetOddDimensionWarning() )
+		if( !img.bWarnOddDimensions )
 			bRunCheck = false;
 
 		// Don't check if this is the screen texture, the theme can't do anything
@@ -325,7 +391,8 @@ void RageBitmapTexture::Create()
 	}
 
 
-	delete pImg;
+	delete img.pImg;
+	img.pImg = nullptr;
 
 	// Check for hints that override the apparent "size".
 	GetResolutionFromFileName( actualID.filename, m_iSourceWidth, m_iSourceHeight );
@@ -342,7 +409,7 @@ void RageBitmapTexture::Create()
 
 
 	RString sProperties;
-	sProperties += RagePixelFormatToString( pixfmt ) + " ";
+	sProperties += RagePixelFormatToString( img.pixfmt ) + " ";
 	if( actualID.iAlphaBits == 0 ) sProperties += "opaque ";
 	if( actualID.iAlphaBits == 1 ) sProperties += "matte ";
 	if( actualID.bStretch ) sProperties += "stretch ";
@@ -4,17 +4,63 @@
 #define RAGEBITMAPTEXTURE_H
 
 #include "RageTexture.h"
+#include "RageDisplay.h"
+
+struct RageSurface;
 
 class RageBitmapTexture : public RageTexture
 {
 public:
 	RageBitmapTexture( RageTextureID name );
+	/* Create a blank texture, and leave loading it to the caller: decode the
+	 * image with Decode(), then upload it with Create(). */
+	struct DeferCreate { };
+	RageBitmapTexture( RageTextureID name, const DeferCreate & );
 	virtual ~RageBitmapTexture();
 	/* only called by RageTextureManager::InvalidateTextures */
 	virtual void Invalidate() { m_uTexHandle = 0; /* don't Destroy() */}
 	virtual void Reload();
 	virtual uintptr_t GetTexHandle() const { return m_uTexHandle; };	// accessed by RageDisplay
 
+	/* What the display can do, as far as decoding an image is concerned.  This
+	 * must be filled in on the main thread. */
+	struct DisplayCaps
+	{
+		DisplayCaps();
+		int iMaxTextureSize;
+		bool bHighResolutionTextures;
+		bool bWarnOddDimensions;
+		bool bSupportsFormat[NUM_RagePixelFormat];
+	};
+
+	/* An image read from disk and converted to the format it'll be uploaded in. */
+	struct DecodedImage
+	{
+		DecodedImage();
+		~DecodedImage();
+
+		RageTextureID actualID;
+		RString sHintString;
+		/* Set if the image couldn't be loaded; pImg is a placeholder. */
+		RString sError;
+		RageSurface *pImg;
+		RagePixelFormat pixfmt;
+		int iSourceWidth, iSourceHeight;
+		int iImageWidth, iImageHeight;
+		int iTextureWidth, iTextureHeight;
+		bool bWarnOddDimensions;
+
+	private:
+		DecodedImage( const DecodedImage &rhs );
+		DecodedImage &operator=( const DecodedImage &rhs );
+	};
+
+	/* Load and convert an image.  This doesn't touch the display, so it can
+	 * be called from any thread, except for the screen texture. */
+	static void Decode( const RageTextureID &ID, const DisplayCaps &caps, DecodedImage &out );
+	/* Upload an image from Decode(). */
+	void Create( DecodedImage &img );
+
 private:
 	void Create();	// called by constructor and Reload
 	void Destroy();
@@ -18,15 +18,18 @@
 // Statistics stuff
 RageTimer	g_LastCheckTimer;
 int		g_iNumVerts;
-int		g_iFPS, g_iVPF, g_iCFPS;
+int		g_iFPS, g_iVPF, g_iCFPS, g_iDPF;
+int		g_iMovieFramesDropped, g_iMovieFramesLate;
 
 int RageDisplay::GetFPS() const { return g_iFPS; }
 int RageDisplay::GetVPF() const { return g_iVPF; }
 int RageDisplay::GetCumFPS() const { return g_iCFPS; }
+int RageDisplay::GetDPF() const { return g_iDPF; }
 
 static int g_iFramesRenderedSinceLastCheck,
 	   g_iFramesRenderedSinceLastReset,
 	   g_iVertsRenderedSinceLastCheck,
+	   g_iDrawCallsSinceLastCheck,
 	   g_iNumChecksSinceLastReset;
 static RageTimer g_LastFrameEndedAt( RageZeroTimer );
 
@@ -137,7 +140,9 @@ void RageDisplay::ProcessStatsOnFlip()
 		g_iCFPS = g_iFramesRenderedSinceLastReset / g_iNumChecksSinceLastReset;
 		g_iCFPS = lrintf( g_iCFPS / fActualTime );
 		g_iVPF = g_iVertsRenderedSinceLastCheck / g_iFramesRenderedSinceLastCheck;
+		g_iDPF = g_iDrawCallsSinceLastCheck / g_iFramesRenderedSinceLastCheck;
 		g_iFramesRenderedSinceLastCheck = g_iVertsRenderedSinceLastCheck = 0;
+		g_iDrawCallsSinceLastCheck = 0;
 		if( LOG_FPS )
 		{
 			RString sStats = GetStats();
@@ -149,10 +154,12 @@ void RageDisplay::ProcessStatsOnFlip()
 
 void RageDisplay::ResetStats()
 {
-	g_iFPS = g_iVPF = 0;
+	g_iFPS = g_iVPF = g_iDPF = 0;
+	g_iMovieFramesDropped = g_iMovieFramesLate = 0;
 	g_iFramesRenderedSinceLastCheck = g_iFramesRenderedSinceLastReset = 0;
 	g_iNumChecksSinceLastReset = 0;
 	g_iVertsRenderedSinceLastCheck = 0;
+	g_iDrawCallsSinceLastCheck = 0;
 	g_LastCheckTimer.GetDeltaTime();
 }
 
@@ -161,9 +168,11 @@ RString RageDisplay::GetStats() const
 	RString s;
 	// If FPS == 0, we don't have stats yet.
 	if( !GetFPS() )
-		s = "-- FPS\n-- av FPS\n-- VPF";
+		s = "-- FPS\n-- av FPS\n-- VPF\n-- DPF";
 
-	s = ssprintf( "%i FPS\n%i av FPS\n%i VPF", GetFPS(), GetCumFPS(), GetVPF() );
+	s = ssprintf( "%i FPS\n%i av FPS\n%i VPF\n%i DPF", GetFPS(), GetCumFPS(), GetVPF(), GetDPF() );
+	if( g_iMovieFramesDropped || g_iMovieFramesLate )
+		s += ssprintf( "\n%i/%i movie drops/late", g_iMovieFramesDropped, g_iMovieFramesLate );
 
 //	#if defined(_WINDOWS)
 	s += "\n"+this->GetApiDescription();
@@ -190,6 +199,12 @@ void RageDisplay::BeginConcurrentRendering()
 }
 
 void RageDisplay::StatsAddVerts( int iNumVertsRendered ) { g_iVertsRenderedSinceLastCheck += iNumVertsRendered; }
+void RageDisplay::StatsAddDrawCall() { ++g_iDrawCallsSinceLastCheck; }
+void RageDisplay::StatsAddMovieFrames( int iDropped, int iLate )
+{
+	g_iMovieFramesDropped += iDropped;
+	g_iMovieFramesLate += iLate;
+}
 
 /* Draw a line as a quad.  GL_LINES with SmoothLines off can draw line
  * ends at odd angles--they're forced to axis-alignment regardless of the
@@ -1059,6 +1074,12 @@ public:
 		return 1;
 	}
 
+	static int GetDPF( T* p, lua_State *L )
+	{
+		lua_pushnumber(L, p->GetDPF());
+		return 1;
+	}
+
 	static int GetDisplaySpecs( T* p, lua_State *L )
 	{
 		DisplaySpecs s;
@@ -1086,6 +1107,7 @@ public:
 		ADD_METHOD( GetFPS );
 		ADD_METHOD( GetVPF );
 		ADD_METHOD( GetCumFPS );
+		ADD_METHOD( GetDPF );
 		ADD_METHOD( GetDisplaySpecs );
 		ADD_METHOD( SupportsRenderToTexture );
 		ADD_METHOD( SupportsFullscreenBorderlessWindow );
@@ -394,10 +394,13 @@ public:
 	int GetFPS() const;
 	int GetVPF() const;
 	int GetCumFPS() const; // average FPS since last reset
+	int GetDPF() const; // draw calls sent to the driver per frame
 	virtual void ResetStats();
 	virtual void ProcessStatsOnFlip();
 	virtual RString GetStats() const;
 	void StatsAddVerts( int iNumVertsRendered );
+	void StatsAddDrawCall();
+	void StatsAddMovieFrames( int iDropped, int iLate ); // movie frames decoded but never shown, or shown late
 
 	// World matrix stack functions.
 	void PushMatrix();
@@ -876,6 +876,7 @@ void RageDisplay_D3D::DrawQuadsInternal( const RageSpriteVertex v[], int iNumVer
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex) // VertexStreamZeroStride
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawQuadStripInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -912,6 +913,7 @@ void RageDisplay_D3D::DrawQuadStripInternal( const RageSpriteVertex v[], int iNu
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex) // VertexStreamZeroStride
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawSymmetricQuadStripInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -954,6 +956,7 @@ void RageDisplay_D3D::DrawSymmetricQuadStripInternal( const RageSpriteVertex v[]
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex) // VertexStreamZeroStride
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawFanInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -966,6 +969,7 @@ void RageDisplay_D3D::DrawFanInternal( const RageSpriteVertex v[], int iNumVerts
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex)
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawStripInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -978,6 +982,7 @@ void RageDisplay_D3D::DrawStripInternal( const RageSpriteVertex v[], int iNumVer
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex)
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawTrianglesInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -990,6 +995,7 @@ void RageDisplay_D3D::DrawTrianglesInternal( const RageSpriteVertex v[], int iNu
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex)
 	);
+	StatsAddDrawCall();
 }
 
 void RageDisplay_D3D::DrawCompiledGeometryInternal( const RageCompiledGeometry *p, int iMeshIndex )
@@ -1010,6 +1016,7 @@ void RageDisplay_D3D::DrawCompiledGeometryInternal( const RageCompiledGeometry *
 	}
 
 	p->Draw( iMeshIndex );
+	StatsAddDrawCall();
 
 	if( !bLighting )
 	{
@@ -1033,6 +1040,7 @@ void RageDisplay_D3D::DrawLineStrip( const RageSpriteVertex v[], int iNumVerts,
 		v, // pVertexStreamZeroData,
 		sizeof(RageSpriteVertex)
 	);
+	StatsAddDrawCall();
 	StatsAddVerts( iNumVerts );
 }
 */
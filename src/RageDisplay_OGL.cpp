@@ -19,6 +19,7 @@ using namespace RageDisplay_Legacy_Helpers;
 
 #include "arch/LowLevelWindow/LowLevelWindow.h"
 
+#include <cstddef>
 #include <set>
 
 #if defined(WINDOWS)
@@ -69,6 +70,84 @@ static LowLevelWindow *g_pWind;
 
 static bool g_bInvertY = false;
 
+/* The render state we last sent, so that setting the same state again doesn't
+ * break up a quad batch.  -1 (or TEXTURE_UNKNOWN) means we don't know what
+ * OpenGL has, and the next call has to send it.  Concurrent rendering uses
+ * a second context in another thread, so all of this is per thread. */
+static const uintptr_t TEXTURE_UNKNOWN = ~uintptr_t(0);
+struct TextureUnitState
+{
+	TextureUnitState(): iWant(0), bDirty(false), iBound(TEXTURE_UNKNOWN),
+		iEnabled(-1), iMode(-1), bTexGen(false) { }
+
+	/* SetTexture is deferred until something needs the texture, since Sprites
+	 * clear every texture before setting the one they want. */
+	uintptr_t iWant;
+	bool bDirty;
+
+	uintptr_t iBound;
+	int iEnabled;
+	int iMode;
+	bool bTexGen;
+};
+static thread_local TextureUnitState g_TextureUnits[NUM_TextureUnit];
+static thread_local int g_iActiveTextureUnit = -1;
+static thread_local int g_iBlendMode = -1;
+static thread_local int g_iEffectMode = -1;
+static thread_local int g_iZWrite = -1;
+static thread_local int g_iZTestMode = -1;
+static thread_local int g_iCullMode = -1;
+static thread_local int g_iAlphaTest = -1;
+static thread_local float g_fZBias = 0;
+static thread_local bool g_bZBiasKnown = false;
+static thread_local bool g_bLighting = false;
+static thread_local int g_iCelShadedStage = 0;
+
+/* Wrapping and filtering are texture state in OpenGL, not texture unit state. */
+struct TextureParams
+{
+	TextureParams(): iWrapping(-1), iFiltering(-1) { }
+	int iWrapping;
+	int iFiltering;
+};
+static thread_local std::map<uintptr_t, TextureParams> g_TextureParams;
+
+/* Forget what we've sent, after something changed OpenGL state behind our back
+ * or switched contexts. */
+static void InvalidateRenderState()
+{
+	FOREACH_ENUM( TextureUnit, tu )
+	{
+		TextureUnitState &unit = g_TextureUnits[tu];
+		unit.iBound = TEXTURE_UNKNOWN;
+		unit.iEnabled = -1;
+		unit.iMode = -1;
+	}
+	g_iActiveTextureUnit = -1;
+	g_iBlendMode = g_iEffectMode = -1;
+	g_iZWrite = g_iZTestMode = g_iCullMode = g_iAlphaTest = -1;
+	g_bZBiasKnown = false;
+	g_TextureParams.clear();
+}
+
+/* Consecutive DrawQuads calls are collected here and drawn together.  World
+ * transforms are applied as quads are added, so only the projection, view and
+ * texture matrices need to match. */
+struct QuadBatchVertex
+{
+	float p[3];
+	float n[3];
+	float t[2];
+	GLubyte c[4];
+};
+static thread_local vector<QuadBatchVertex> g_vQuadBatch;
+static thread_local RageMatrix g_QuadBatchProjection;
+static thread_local RageMatrix g_QuadBatchView;
+static thread_local RageMatrix g_QuadBatchTexture;
+static thread_local GLuint g_iQuadBatchBuffer = 0;
+/* Don't let the stream buffer grow without bound. */
+static const size_t MAX_QUAD_BATCH_VERTS = 16384;
+
 static void InvalidateObjects();
 
 static RageDisplay::RagePixelFormatDesc PIXEL_FORMAT_DESC[NUM_RagePixelFormat] = {
@@ -562,6 +641,13 @@ RString RageDisplay_Legacy::Init( const VideoModeParams &p, bool bAllowUnacceler
 
 RageDisplay_Legacy::~RageDisplay_Legacy()
 {
+	if (g_iQuadBatchBuffer != 0)
+	{
+		glDeleteBuffersARB( 1, &g_iQuadBatchBuffer );
+		g_iQuadBatchBuffer = 0;
+	}
+	g_vQuadBatch.clear();
+
 	delete g_pWind;
 }
 
@@ -776,11 +862,15 @@ RString RageDisplay_Legacy::TryVideoMode( const VideoModeParams &p, bool &bNewDe
 {
 	//LOG->Warn( "RageDisplay_Legacy::TryVideoMode( %d, %d, %d, %d, %d, %d )", p.windowed, p.width, p.height, p.bpp, p.rate, p.vsync );
 
+	FlushQuadBatch();
+
 	RString err;
 	err = g_pWind->TryVideoMode( p, bNewDeviceOut );
 	if (err != "")
 		return err;	// failed to set video mode
 
+	InvalidateRenderState();
+
 	/* Now that we've initialized, we can search for extensions.  Do this before InvalidateObjects,
 	 * since AllocateBuffers needs it. */
 	SetupExtensions();
@@ -801,6 +891,7 @@ RString RageDisplay_Legacy::TryVideoMode( const VideoModeParams &p, bool &bNewDe
 
 		/* Recreate all vertex buffers. */
 		InvalidateObjects();
+		g_iQuadBatchBuffer = 0;
 
 		InitShaders();
 	}
@@ -829,6 +920,8 @@ int RageDisplay_Legacy::GetMaxTextureSize() const
 
 bool RageDisplay_Legacy::BeginFrame()
 {
+	FlushQuadBatch();
+
 	/* We do this in here, rather than ResolutionChanged, or we won't update the
 	 * viewport for the concurrent rendering context. */
 	int fWidth = g_pWind->GetActualVideoModeParams().windowWidth;
@@ -850,6 +943,8 @@ bool RageDisplay_Legacy::BeginFrame()
 
 void RageDisplay_Legacy::EndFrame()
 {
+	FlushQuadBatch();
+
 	if (UseOffscreenRenderTarget())
 	{
 		offscreenRenderTarget->FinishRenderingTo();
@@ -866,6 +961,7 @@ void RageDisplay_Legacy::EndFrame()
 							 static_cast<float> (GetActualVideoModeParams().height) / 2.f );
 		fullscreenSprite.Draw();
 		CameraPopMatrix();
+		FlushQuadBatch();
 	}
 
 	FrameLimitBeforeVsync( g_pWind->GetActualVideoModeParams().rate );
@@ -890,6 +986,8 @@ void RageDisplay_Legacy::EndFrame()
 
 RageSurface* RageDisplay_Legacy::CreateScreenshot()
 {
+	FlushQuadBatch();
+
 	int width = g_pWind->GetActualVideoModeParams().width;
 	int height = g_pWind->GetActualVideoModeParams().height;
 
@@ -929,7 +1027,7 @@ RageSurface *RageDisplay_Legacy::GetTexture( uintptr_t iTexture )
 
 	FlushGLErrors();
 
-	glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(iTexture) );
+	BindTextureDirectly( iTexture );
 	GLint iHeight, iWidth, iAlphaBits;
 	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &iHeight );
 	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &iWidth );
@@ -1005,17 +1103,22 @@ static void SetupVertices( const RageSpriteVertex v[], int iNumVerts )
 	glNormalPointer( GL_FLOAT, 0, Normal );
 }
 
-void RageDisplay_Legacy::SendCurrentMatrices()
+void RageDisplay_Legacy::GetCurrentProjection( RageMatrix &out ) const
 {
-	RageMatrix projection;
-	RageMatrixMultiply( &projection, GetCentering(), GetProjectionTop() );
+	RageMatrixMultiply( &out, GetCentering(), GetProjectionTop() );
 
 	if (g_bInvertY)
 	{
 		RageMatrix flip;
 		RageMatrixScale( &flip, +1, -1, +1 );
-		RageMatrixMultiply( &projection, &flip, &projection );
+		RageMatrixMultiply( &out, &flip, &out );
 	}
+}
+
+void RageDisplay_Legacy::SendCurrentMatrices()
+{
+	RageMatrix projection;
+	GetCurrentProjection( projection );
 	glMatrixMode( GL_PROJECTION );
 	glLoadMatrixf( (const float*)&projection );
 
@@ -1480,22 +1583,147 @@ void RageDisplay_Legacy::DeleteCompiledGeometry( RageCompiledGeometry* p )
 	delete p;
 }
 
-void RageDisplay_Legacy::DrawQuadsInternal( const RageSpriteVertex v[], int iNumVerts )
+bool RageDisplay_Legacy::CanBatchQuads() const
 {
+	/* Lighting and sphere mapping work in eye space, and the cel shaders use
+	 * the modelview matrix directly, so they need the real world matrix. */
+	if (g_bLighting || g_iCelShadedStage != 0)
+		return false;
+	FOREACH_ENUM( TextureUnit, tu )
+		if (g_TextureUnits[tu].bTexGen)
+			return false;
+
+	/* We only transform positions as points, so leave projective world
+	 * matrices to OpenGL. */
+	const RageMatrix &world = *GetWorldTop();
+	return world.m[0][3] == 0 && world.m[1][3] == 0 && world.m[2][3] == 0 && world.m[3][3] == 1;
+}
+
+void RageDisplay_Legacy::FlushQuadBatch()
+{
+	if (g_vQuadBatch.empty())
+		return;
+
+	glMatrixMode( GL_PROJECTION );
+	glLoadMatrixf( (const float*)&g_QuadBatchProjection );
+	glMatrixMode( GL_MODELVIEW );
+	glLoadMatrixf( (const float*)&g_QuadBatchView );
+	glMatrixMode( GL_TEXTURE );
+	glLoadMatrixf( (const float*)&g_QuadBatchTexture );
+
 	TurnOffHardwareVBO();
-	SendCurrentMatrices();
 
-	SetupVertices( v, iNumVerts );
-	glDrawArrays( GL_QUADS, 0, iNumVerts );
+	const GLsizei iStride = sizeof(QuadBatchVertex);
+	const char *pBase = (const char *) &g_vQuadBatch[0];
+	if (GLEW_ARB_vertex_buffer_object)
+	{
+		/* Respecify the whole buffer each time, so the driver can hand us new
+		 * storage instead of waiting for the last batch to finish with it. */
+		if (g_iQuadBatchBuffer == 0)
+			glGenBuffersARB( 1, &g_iQuadBatchBuffer );
+		glBindBufferARB( GL_ARRAY_BUFFER_ARB, g_iQuadBatchBuffer );
+		glBufferDataARB( GL_ARRAY_BUFFER_ARB, g_vQuadBatch.size() * iStride, pBase, GL_STREAM_DRAW_ARB );
+		pBase = nullptr;
+	}
+
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glVertexPointer( 3, GL_FLOAT, iStride, pBase + offsetof(QuadBatchVertex, p) );
+
+	glEnableClientState( GL_COLOR_ARRAY );
+	glColorPointer( 4, GL_UNSIGNED_BYTE, iStride, pBase + offsetof(QuadBatchVertex, c) );
+
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	glTexCoordPointer( 2, GL_FLOAT, iStride, pBase + offsetof(QuadBatchVertex, t) );
+
+	if (GLEW_ARB_multitexture)
+	{
+		glClientActiveTextureARB( GL_TEXTURE1_ARB );
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+		glTexCoordPointer( 2, GL_FLOAT, iStride, pBase + offsetof(QuadBatchVertex, t) );
+		glClientActiveTextureARB( GL_TEXTURE0_ARB );
+	}
+
+	glEnableClientState( GL_NORMAL_ARRAY );
+	glNormalPointer( GL_FLOAT, iStride, pBase + offsetof(QuadBatchVertex, n) );
+
+	glDrawArrays( GL_QUADS, 0, g_vQuadBatch.size() );
+	StatsAddDrawCall();
+
+	/* Everything else draws from client memory. */
+	TurnOffHardwareVBO();
+	g_vQuadBatch.clear();
+}
+
+void RageDisplay_Legacy::DrawQuadsInternal( const RageSpriteVertex v[], int iNumVerts )
+{
+	ApplyTextureBindings();
+
+	if (!CanBatchQuads())
+	{
+		FlushQuadBatch();
+		TurnOffHardwareVBO();
+		SendCurrentMatrices();
+
+		SetupVertices( v, iNumVerts );
+		glDrawArrays( GL_QUADS, 0, iNumVerts );
+		StatsAddDrawCall();
+		return;
+	}
+
+	RageMatrix projection;
+	GetCurrentProjection( projection );
+	const RageMatrix &view = *GetViewTop();
+	const RageMatrix &texture = *GetTextureTop();
+
+	if (!g_vQuadBatch.empty() &&
+		(g_vQuadBatch.size() + iNumVerts > MAX_QUAD_BATCH_VERTS ||
+		 memcmp(&projection, &g_QuadBatchProjection, sizeof(RageMatrix)) ||
+		 memcmp(&view, &g_QuadBatchView, sizeof(RageMatrix)) ||
+		 memcmp(&texture, &g_QuadBatchTexture, sizeof(RageMatrix))))
+		FlushQuadBatch();
+
+	if (g_vQuadBatch.empty())
+	{
+		memcpy( &g_QuadBatchProjection, &projection, sizeof(RageMatrix) );
+		memcpy( &g_QuadBatchView, &view, sizeof(RageMatrix) );
+		memcpy( &g_QuadBatchTexture, &texture, sizeof(RageMatrix) );
+	}
+
+	const RageMatrix &w = *GetWorldTop();
+	const size_t iStart = g_vQuadBatch.size();
+	g_vQuadBatch.resize( iStart + iNumVerts );
+	QuadBatchVertex *pOut = &g_vQuadBatch[iStart];
+	for( int i = 0; i < iNumVerts; ++i )
+	{
+		const RageSpriteVertex &in = v[i];
+		QuadBatchVertex &out = pOut[i];
+		out.p[0] = in.p.x*w.m[0][0] + in.p.y*w.m[1][0] + in.p.z*w.m[2][0] + w.m[3][0];
+		out.p[1] = in.p.x*w.m[0][1] + in.p.y*w.m[1][1] + in.p.z*w.m[2][1] + w.m[3][1];
+		out.p[2] = in.p.x*w.m[0][2] + in.p.y*w.m[1][2] + in.p.z*w.m[2][2] + w.m[3][2];
+		/* The distance field shader offsets positions along the normal, so
+		 * normals go through the same linear part. */
+		out.n[0] = in.n.x*w.m[0][0] + in.n.y*w.m[1][0] + in.n.z*w.m[2][0];
+		out.n[1] = in.n.x*w.m[0][1] + in.n.y*w.m[1][1] + in.n.z*w.m[2][1];
+		out.n[2] = in.n.x*w.m[0][2] + in.n.y*w.m[1][2] + in.n.z*w.m[2][2];
+		out.t[0] = in.t.x;
+		out.t[1] = in.t.y;
+		out.c[0] = in.c.r;
+		out.c[1] = in.c.g;
+		out.c[2] = in.c.b;
+		out.c[3] = in.c.a;
+	}
 }
 
 void RageDisplay_Legacy::DrawQuadStripInternal( const RageSpriteVertex v[], int iNumVerts )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_QUAD_STRIP, 0, iNumVerts );
+	StatsAddDrawCall();
 }
 
 void RageDisplay_Legacy::DrawSymmetricQuadStripInternal( const RageSpriteVertex v[], int iNumVerts )
@@ -1526,6 +1754,8 @@ void RageDisplay_Legacy::DrawSymmetricQuadStripInternal( const RageSpriteVertex
 		vIndices[i*12+11] = i*3+5;
 	}
 
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
@@ -1535,45 +1765,63 @@ void RageDisplay_Legacy::DrawSymmetricQuadStripInternal( const RageSpriteVertex
 		iNumIndices,
 		GL_UNSIGNED_SHORT, 
 		&vIndices[0] );
+	StatsAddDrawCall();
 }
 
 void RageDisplay_Legacy::DrawFanInternal( const RageSpriteVertex v[], int iNumVerts )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_TRIANGLE_FAN, 0, iNumVerts );
+	StatsAddDrawCall();
 }
 
 void RageDisplay_Legacy::DrawStripInternal( const RageSpriteVertex v[], int iNumVerts )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_TRIANGLE_STRIP, 0, iNumVerts );
+	StatsAddDrawCall();
 }
 
 void RageDisplay_Legacy::DrawTrianglesInternal( const RageSpriteVertex v[], int iNumVerts )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_TRIANGLES, 0, iNumVerts );
+	StatsAddDrawCall();
 }
 
 void RageDisplay_Legacy::DrawCompiledGeometryInternal( const RageCompiledGeometry *p, int iMeshIndex )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 	SendCurrentMatrices();
 
 	p->Draw( iMeshIndex );
+	StatsAddDrawCall();
+
+	/* The texture matrix shader is turned off again after drawing. */
+	g_iEffectMode = -1;
 }
 
 void RageDisplay_Legacy::DrawLineStripInternal( const RageSpriteVertex v[], int iNumVerts, float fLineWidth )
 {
+	ApplyTextureBindings();
+	FlushQuadBatch();
 	TurnOffHardwareVBO();
 
 	if (!GetActualVideoModeParams().bSmoothLines)
@@ -1618,6 +1866,7 @@ void RageDisplay_Legacy::DrawLineStripInternal( const RageSpriteVertex v[], int
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_LINE_STRIP, 0, iNumVerts );
 	StatsAddVerts(iNumVerts);
+	StatsAddDrawCall();
 
 	glDisable( GL_LINE_SMOOTH );
 
@@ -1644,6 +1893,7 @@ void RageDisplay_Legacy::DrawLineStripInternal( const RageSpriteVertex v[], int
 	SetupVertices( v, iNumVerts );
 	glDrawArrays( GL_POINTS, 0, iNumVerts );
 	StatsAddVerts(iNumVerts);
+	StatsAddDrawCall();
 
 	glDisable( GL_POINT_SMOOTH );
 }
@@ -1657,9 +1907,82 @@ static bool SetTextureUnit( TextureUnit tu )
 	if ((int) tu > g_iMaxTextureUnits)
 		return false;
 	glActiveTextureARB( enum_add2(GL_TEXTURE0_ARB, tu) );
+	g_iActiveTextureUnit = tu;
 	return true;
 }
 
+void RageDisplay_Legacy::ApplyTextureBindings()
+{
+	bool bChanged = false;
+	int iLastUnit = -1;
+	FOREACH_ENUM( TextureUnit, tu )
+	{
+		TextureUnitState &unit = g_TextureUnits[tu];
+		if (!unit.bDirty)
+			continue;
+		unit.bDirty = false;
+
+		const bool bEnable = unit.iWant != 0;
+		if (unit.iEnabled == int(bEnable) && (!bEnable || unit.iBound == unit.iWant))
+			continue;
+
+		if (!bChanged)
+		{
+			FlushQuadBatch();
+			bChanged = true;
+		}
+
+		if (GLEW_ARB_multitexture)
+			glActiveTextureARB( enum_add2(GL_TEXTURE0_ARB, tu) );
+		iLastUnit = tu;
+
+		if (bEnable)
+		{
+			glEnable( GL_TEXTURE_2D );
+			glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(unit.iWant) );
+			unit.iBound = unit.iWant;
+		}
+		else
+		{
+			glDisable( GL_TEXTURE_2D );
+		}
+		unit.iEnabled = bEnable;
+	}
+
+	/* Leave the same unit active as before. */
+	if (bChanged && GLEW_ARB_multitexture)
+	{
+		if (g_iActiveTextureUnit != -1)
+			glActiveTextureARB( enum_add2(GL_TEXTURE0_ARB, g_iActiveTextureUnit) );
+		else
+			g_iActiveTextureUnit = iLastUnit;
+	}
+}
+
+void RageDisplay_Legacy::BindTextureDirectly( uintptr_t iTexture )
+{
+	FlushQuadBatch();
+	ApplyTextureBindings();
+
+	glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(iTexture) );
+	if (g_iActiveTextureUnit != -1)
+		g_TextureUnits[g_iActiveTextureUnit].iBound = iTexture;
+	else
+		InvalidateRenderState();
+}
+
+/* The parameters of the texture bound to the active unit, or nullptr if we don't
+ * know what that is. */
+static TextureParams *GetBoundTextureParams()
+{
+	if (g_iActiveTextureUnit == -1)
+		return nullptr;
+	uintptr_t iBound = g_TextureUnits[g_iActiveTextureUnit].iBound;
+	if (iBound == TEXTURE_UNKNOWN)
+		return nullptr;
+	return &g_TextureParams[iBound];
+}
+
 void RageDisplay_Legacy::ClearAllTextures()
 {
 	FOREACH_ENUM( TextureUnit, i )
@@ -1668,7 +1991,10 @@ void RageDisplay_Legacy::ClearAllTextures()
 	// HACK:  Reset the active texture to 0.
 	// TODO:  Change all texture functions to take a stage number.
 	if (GLEW_ARB_multitexture)
+	{
 		glActiveTextureARB(GL_TEXTURE0_ARB);
+		g_iActiveTextureUnit = TextureUnit_1;
+	}
 }
 
 int RageDisplay_Legacy::GetNumTextureUnits()
@@ -1684,15 +2010,8 @@ void RageDisplay_Legacy::SetTexture( TextureUnit tu, uintptr_t iTexture )
 	if (!SetTextureUnit( tu ))
 		return;
 
-	if (iTexture)
-	{
-		glEnable( GL_TEXTURE_2D );
-		glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(iTexture) );
-	}
-	else
-	{
-		glDisable( GL_TEXTURE_2D );
-	}
+	g_TextureUnits[tu].iWant = iTexture;
+	g_TextureUnits[tu].bDirty = true;
 }
 
 void RageDisplay_Legacy::SetTextureMode( TextureUnit tu, TextureMode tm )
@@ -1700,6 +2019,10 @@ void RageDisplay_Legacy::SetTextureMode( TextureUnit tu, TextureMode tm )
 	if (!SetTextureUnit( tu ))
 		return;
 
+	if (g_TextureUnits[tu].iMode == tm)
+		return;
+	FlushQuadBatch();
+
 	switch( tm )
 	{
 		case TextureMode_Modulate:
@@ -1715,6 +2038,7 @@ void RageDisplay_Legacy::SetTextureMode( TextureUnit tu, TextureMode tm )
 				/* This is changing blend state, instead of texture state, which
 				 * isn't great, but it's better than doing nothing. */
 				glBlendFunc( GL_SRC_ALPHA, GL_ONE );
+				g_iBlendMode = -1;
 				return;
 			}
 
@@ -1734,10 +2058,17 @@ void RageDisplay_Legacy::SetTextureMode( TextureUnit tu, TextureMode tm )
 		default:
 			break;
 	}
+	g_TextureUnits[tu].iMode = tm;
 }
 
 void RageDisplay_Legacy::SetTextureFiltering( TextureUnit tu, bool b )
 {
+	ApplyTextureBindings();
+	TextureParams *pParams = GetBoundTextureParams();
+	if (pParams != nullptr && pParams->iFiltering == int(b))
+		return;
+	FlushQuadBatch();
+
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, b ? GL_LINEAR : GL_NEAREST);
 	
 	GLint iMinFilter;
@@ -1766,6 +2097,8 @@ void RageDisplay_Legacy::SetTextureFiltering( TextureUnit tu, bool b )
 	}
 
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, iMinFilter );
+	if (pParams != nullptr)
+		pParams->iFiltering = b;
 }
 
 void RageDisplay_Legacy::SetEffectMode( EffectMode effect )
@@ -1773,6 +2106,13 @@ void RageDisplay_Legacy::SetEffectMode( EffectMode effect )
 	if (!GLEW_ARB_fragment_program || !GLEW_ARB_shading_language_100 || !GLEW_ARB_shader_objects)
 		return;
 
+	/* YUYV422 needs the width of the current texture, which may have changed. */
+	if (g_iEffectMode == effect && effect != EffectMode_YUYV422)
+		return;
+	FlushQuadBatch();
+	ApplyTextureBindings();
+	g_iEffectMode = effect;
+
 	GLhandleARB hShader = 0;
 	switch (effect)
 	{
@@ -1860,6 +2200,11 @@ bool RageDisplay_Legacy::IsEffectModeSupported( EffectMode effect )
 
 void RageDisplay_Legacy::SetBlendMode( BlendMode mode )
 {
+	if (g_iBlendMode == mode)
+		return;
+	FlushQuadBatch();
+	g_iBlendMode = mode;
+
 	glEnable(GL_BLEND);
 
 	if (glBlendEquation != nullptr)
@@ -1941,6 +2286,8 @@ bool RageDisplay_Legacy::IsZTestEnabled() const
 
 void RageDisplay_Legacy::ClearZBuffer()
 {
+	FlushQuadBatch();
+
 	bool write = IsZWriteEnabled();
 	SetZWrite( true );
 	glClear( GL_DEPTH_BUFFER_BIT );
@@ -1949,11 +2296,22 @@ void RageDisplay_Legacy::ClearZBuffer()
 
 void RageDisplay_Legacy::SetZWrite( bool b )
 {
+	if (g_iZWrite == int(b))
+		return;
+	FlushQuadBatch();
+	g_iZWrite = b;
+
 	glDepthMask( b );
 }
 
 void RageDisplay_Legacy::SetZBias( float f )
 {
+	if (g_bZBiasKnown && g_fZBias == f)
+		return;
+	FlushQuadBatch();
+	g_bZBiasKnown = true;
+	g_fZBias = f;
+
 	float fNear = SCALE( f, 0.0f, 1.0f, 0.05f, 0.0f );
 	float fFar = SCALE( f, 0.0f, 1.0f, 1.0f, 0.95f );
 
@@ -1962,6 +2320,11 @@ void RageDisplay_Legacy::SetZBias( float f )
 
 void RageDisplay_Legacy::SetZTestMode( ZTestMode mode )
 {
+	if (g_iZTestMode == mode)
+		return;
+	FlushQuadBatch();
+	g_iZTestMode = mode;
+
 	glEnable( GL_DEPTH_TEST );
 	switch( mode )
 	{
@@ -1979,10 +2342,18 @@ void RageDisplay_Legacy::SetTextureWrapping( TextureUnit tu, bool b )
 	 * so we'll behave incorrectly if the same texture is used in more than one texture
 	 * unit simultaneously with different wrapping. */
 	SetTextureUnit( tu );
+	ApplyTextureBindings();
+
+	TextureParams *pParams = GetBoundTextureParams();
+	if (pParams != nullptr && pParams->iWrapping == int(b))
+		return;
+	FlushQuadBatch();
 	
 	GLenum mode = b ? GL_REPEAT : GL_CLAMP_TO_EDGE;
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, mode );
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, mode );
+	if (pParams != nullptr)
+		pParams->iWrapping = b;
 }
 
 void RageDisplay_Legacy::SetMaterial( 
@@ -1998,6 +2369,7 @@ void RageDisplay_Legacy::SetMaterial(
 	// want Models to have basic color and transparency.
 	// We can do this fake lighting by setting the vertex color.
 	// XXX: unintended: SetLighting must be called before SetMaterial
+	FlushQuadBatch();
 	GLboolean bLighting;
 	glGetBooleanv( GL_LIGHTING, &bLighting );
 
@@ -2021,6 +2393,9 @@ void RageDisplay_Legacy::SetMaterial(
 
 void RageDisplay_Legacy::SetLighting( bool b )
 {
+	FlushQuadBatch();
+	g_bLighting = b;
+
 	if (b)
 		glEnable(GL_LIGHTING);
 	else
@@ -2029,6 +2404,7 @@ void RageDisplay_Legacy::SetLighting( bool b )
 
 void RageDisplay_Legacy::SetLightOff( int index )
 {
+	FlushQuadBatch();
 	glDisable( GL_LIGHT0+index );
 }
 
@@ -2041,6 +2417,7 @@ void RageDisplay_Legacy::SetLightDirectional(
 {
 	// Light coordinates are transformed by the modelview matrix, but
 	// we are being passed in world-space coords.
+	FlushQuadBatch();
 	glPushMatrix();
 	glLoadIdentity();
 
@@ -2056,6 +2433,11 @@ void RageDisplay_Legacy::SetLightDirectional(
 
 void RageDisplay_Legacy::SetCullMode( CullMode mode )
 {
+	if (g_iCullMode == mode)
+		return;
+	FlushQuadBatch();
+	g_iCullMode = mode;
+
 	if (mode != CULL_NONE)
 		glEnable(GL_CULL_FACE);
 	switch( mode )
@@ -2087,23 +2469,33 @@ bool RageDisplay_Legacy::SupportsThreadedRendering()
 
 void RageDisplay_Legacy::BeginConcurrentRenderingMainThread()
 {
+	FlushQuadBatch();
 	g_pWind->BeginConcurrentRenderingMainThread();
 }
 
 void RageDisplay_Legacy::EndConcurrentRenderingMainThread()
 {
 	g_pWind->EndConcurrentRenderingMainThread();
+	InvalidateRenderState();
 }
 
 void RageDisplay_Legacy::BeginConcurrentRendering()
 {
 	g_pWind->BeginConcurrentRendering();
+	InvalidateRenderState();
 	RageDisplay::BeginConcurrentRendering();
 }
 
 void RageDisplay_Legacy::EndConcurrentRendering()
 {
+	FlushQuadBatch();
+	if (g_iQuadBatchBuffer != 0)
+	{
+		glDeleteBuffersARB( 1, &g_iQuadBatchBuffer );
+		g_iQuadBatchBuffer = 0;
+	}
 	g_pWind->EndConcurrentRendering();
+	InvalidateRenderState();
 }
 
 void RageDisplay_Legacy::DeleteTexture( uintptr_t iTexture )
@@ -2111,6 +2503,15 @@ void RageDisplay_Legacy::DeleteTexture( uintptr_t iTexture )
 	if (iTexture == 0)
 		return;
 
+	/* Deleting a bound texture unbinds it. */
+	FlushQuadBatch();
+	FOREACH_ENUM( TextureUnit, tu )
+	{
+		if (g_TextureUnits[tu].iBound == iTexture)
+			g_TextureUnits[tu].iBound = 0;
+	}
+	g_TextureParams.erase( iTexture );
+
 	if (g_mapRenderTargets.find(iTexture) != g_mapRenderTargets.end())
 	{
 		delete g_mapRenderTargets[iTexture];
@@ -2240,7 +2641,7 @@ uintptr_t RageDisplay_Legacy::CreateTexture(
 	glGenTextures( 1, reinterpret_cast<GLuint*>(&iTexHandle) );
 	ASSERT( iTexHandle != 0 );
 	
-	glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(iTexHandle) );
+	BindTextureDirectly( iTexHandle );
 
 	if (g_pWind->GetActualVideoModeParams().bAnisotropicFiltering &&
 		GLEW_EXT_texture_filter_anisotropic )
@@ -2324,6 +2725,10 @@ uintptr_t RageDisplay_Legacy::CreateTexture(
 	glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
 	glFlush();
 
+	/* Filtering was set before there were any mipmaps to find; check again
+	 * the next time it's set. */
+	g_TextureParams.erase( iTexHandle );
+
 	if (bFreeImg)
 		delete pImg;
 	return iTexHandle;
@@ -2414,7 +2819,7 @@ void RageDisplay_Legacy::UpdateTexture(
 	RageSurface* pImg,
 	int iXOffset, int iYOffset, int iWidth, int iHeight )
 {
-	glBindTexture( GL_TEXTURE_2D, static_cast<GLuint>(iTexHandle) );
+	BindTextureDirectly( iTexHandle );
 
 	bool bFreeImg;
 	RagePixelFormat SurfacePixFmt = GetImgPixelFormat( pImg, bFreeImg, iWidth, iHeight, false );
@@ -2592,7 +2997,10 @@ uintptr_t RageDisplay_Legacy::CreateRenderTarget( const RenderTargetParam &param
 	else
 		pTarget = g_pWind->CreateRenderTarget();
 
+	FlushQuadBatch();
+	ApplyTextureBindings();
 	pTarget->Create( param, iTextureWidthOut, iTextureHeightOut );
+	InvalidateRenderState();
 
 	uintptr_t iTexture = pTarget->GetTexture();
 
@@ -2611,6 +3019,8 @@ uintptr_t RageDisplay_Legacy::GetRenderTarget()
 
 void RageDisplay_Legacy::SetRenderTarget( uintptr_t iTexture, bool bPreserveTexture )
 {
+	FlushQuadBatch();
+
 	if (iTexture == 0)
 	{
 		g_bInvertY = false;
@@ -2627,6 +3037,7 @@ void RageDisplay_Legacy::SetRenderTarget( uintptr_t iTexture, bool bPreserveText
 		if (g_pCurrentRenderTarget)
 			g_pCurrentRenderTarget->FinishRenderingTo();
 		g_pCurrentRenderTarget = nullptr;
+		InvalidateRenderState();
 		return;
 	}
 
@@ -2651,6 +3062,7 @@ void RageDisplay_Legacy::SetRenderTarget( uintptr_t iTexture, bool bPreserveText
 
 	/* The render target may be in a different OpenGL context, so re-send
 	 * state.  Push matrixes affected by SetDefaultRenderStates. */
+	InvalidateRenderState();
 	DISPLAY->CameraPushMatrix();
 	SetDefaultRenderStates();
 
@@ -2672,6 +3084,8 @@ void RageDisplay_Legacy::SetRenderTarget( uintptr_t iTexture, bool bPreserveText
 
 void RageDisplay_Legacy::SetPolygonMode(PolygonMode pm)
 {
+	FlushQuadBatch();
+
 	GLenum m;
 	switch (pm)
 	{
@@ -2685,6 +3099,7 @@ void RageDisplay_Legacy::SetPolygonMode(PolygonMode pm)
 
 void RageDisplay_Legacy::SetLineWidth(float fWidth)
 {
+	FlushQuadBatch();
 	glLineWidth(fWidth);
 }
 
@@ -2727,6 +3142,11 @@ RString RageDisplay_Legacy::GetTextureDiagnostics(unsigned iTexture) const
  */
 void RageDisplay_Legacy::SetAlphaTest(bool b)
 {
+	if (g_iAlphaTest == int(b))
+		return;
+	FlushQuadBatch();
+	g_iAlphaTest = b;
+
 	// Previously this was 0.01, rather than 0x01.
 	glAlphaFunc(GL_GREATER, 0.00390625 /* 1/256 */);
 	if (b)
@@ -2794,6 +3214,9 @@ void RageDisplay_Legacy::SetSphereEnvironmentMapping(TextureUnit tu, bool b)
 	if (!SetTextureUnit(tu))
 		return;
 
+	FlushQuadBatch();
+	g_TextureUnits[tu].bTexGen = b;
+
 	if (b)
 	{
 		glTexGeni(GL_S, GL_TEXTURE_GEN_MODE, GL_SPHERE_MAP);
@@ -2815,6 +3238,10 @@ void RageDisplay_Legacy::SetCelShaded( int stage )
 	if (!GLEW_ARB_fragment_program && !GL_ARB_shading_language_100)
 		return; // not supported
 
+	FlushQuadBatch();
+	g_iCelShadedStage = stage;
+	g_iEffectMode = -1;
+
 	switch (stage)
 	{
 	case 1:
@@ -135,6 +135,12 @@ protected:
 	void SendCurrentMatrices();
 
 private:
+	void GetCurrentProjection( RageMatrix &out ) const;
+	bool CanBatchQuads() const;
+	void FlushQuadBatch();
+	void ApplyTextureBindings();
+	void BindTextureDirectly( uintptr_t iTexture );
+
 	RageTextureRenderTarget *offscreenRenderTarget;
 };
 
@@ -65,6 +65,12 @@ bool RageFile::Open( const RString& path, int mode )
 		return false;
 	}
 
+	if( (m_Mode&APPEND) && !(m_Mode&WRITE) )
+	{
+		SetError( "Appending requires writing" );
+		return false;
+	}
+
 	int error;
 	m_File = FILEMAN->Open( path, mode, error );
 
@@ -24,7 +24,11 @@ public:
 
 		/* Flush the file to disk on close.  Combined with not streaming, this results
 		 * in very safe writes, but is slow. */
-		SLOW_FLUSH	= 0x8
+		SLOW_FLUSH	= 0x8,
+
+		/* Add to the end of the file instead of replacing it.  Like STREAMED, the
+		 * destination is written directly.  Only directory mounts support this. */
+		APPEND		= 0x10
 	};
 
 	RageFile();
@@ -21,6 +21,36 @@
 #include <zlib.h>
 #endif
 
+bool RageFileInflateIndex::GetPoint( int iOut, Point &out ) const
+{
+	LockMut( m_Mutex );
+	for( int i = int(m_Points.size()) - 1; i >= 0; --i )
+	{
+		if( m_Points[i].iOut <= iOut )
+		{
+			out = m_Points[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RageFileInflateIndex::WantPoint( int iOut ) const
+{
+	LockMut( m_Mutex );
+	const int iLast = m_Points.empty()? 0:m_Points.back().iOut;
+	return iOut >= iLast + SPAN;
+}
+
+void RageFileInflateIndex::AddPoint( const Point &pt )
+{
+	LockMut( m_Mutex );
+	/* Another file may have added a point here first. */
+	const int iLast = m_Points.empty()? 0:m_Points.back().iOut;
+	if( pt.iOut >= iLast + SPAN )
+		m_Points.push_back( pt );
+}
+
 RageFileObjInflate::RageFileObjInflate( RageFileBasic *pFile, int iUncompressedSize )
 {
 	m_bFileOwned = false;
@@ -56,6 +86,7 @@ RageFileObjInflate::RageFileObjInflate( const RageFileObjInflate &cpy ):
 	decomp_buf_ptr = decomp_buf + (cpy.decomp_buf_ptr - cpy.decomp_buf);
 	decomp_buf_avail = cpy.decomp_buf_avail;
 	memcpy( decomp_buf, cpy.decomp_buf, decomp_buf_avail );
+	m_pIndex = cpy.m_pIndex;
 }
 
 RageFileObjInflate *RageFileObjInflate::Copy() const
@@ -108,7 +139,9 @@ int RageFileObjInflate::ReadInternal( void *buf, size_t bytes )
 		m_pInflate->avail_out = bytes;
 
 
-		int err = inflate( m_pInflate, Z_SYNC_FLUSH );
+		/* With an index, stop at the end of each block, so access points can
+		 * be recorded there. */
+		int err = inflate( m_pInflate, m_pIndex? Z_BLOCK:Z_SYNC_FLUSH );
 		switch( err )
 		{
 		case Z_DATA_ERROR:
@@ -138,11 +171,59 @@ int RageFileObjInflate::ReadInternal( void *buf, size_t bytes )
 		ret += got;
 		buf = (char *)buf + got;
 		bytes -= got;
+
+		/* Bit 128 of data_type is set at the end of a block, and bit 64 if
+		 * it was the last block. */
+		const int iDataType = m_pInflate->data_type;
+		if( m_pIndex && (iDataType & 128) && !(iDataType & 64) && m_pIndex->WantPoint(m_iFilePos) )
+		{
+			RageFileInflateIndex::Point pt;
+			pt.iOut = m_iFilePos;
+			pt.iIn = m_pFile->Tell() - decomp_buf_avail;
+			pt.iBits = iDataType & 7;
+
+			char window[32768];
+			uInt iWindowSize = sizeof(window);
+			if( inflateGetDictionary(m_pInflate, (Bytef *) window, &iWindowSize) == Z_OK )
+			{
+				pt.sWindow.assign( window, iWindowSize );
+				m_pIndex->AddPoint( pt );
+			}
+		}
 	}
 
 	return ret;
 }
 
+void RageFileObjInflate::ResetStream()
+{
+	inflateReset( m_pInflate );
+	decomp_buf_ptr = decomp_buf;
+	decomp_buf_avail = 0;
+}
+
+/* Resume inflating at an access point. */
+bool RageFileObjInflate::RestorePoint( const RageFileInflateIndex::Point &pt )
+{
+	ResetStream();
+
+	/* If the block starts partway through a byte, feed inflate the rest of
+	 * that byte first. */
+	if( m_pFile->Seek(pt.iIn - (pt.iBits? 1:0)) == -1 )
+		return false;
+	if( pt.iBits )
+	{
+		unsigned char c;
+		if( m_pFile->Read(&c, 1) != 1 )
+			return false;
+		inflatePrime( m_pInflate, pt.iBits, c >> (8 - pt.iBits) );
+	}
+	inflateSetDictionary( m_pInflate, (const Bytef *) pt.sWindow.data(), pt.sWindow.size() );
+
+	m_iFilePos = pt.iOut;
+	return true;
+}
+
 int RageFileObjInflate::SeekInternal( int iPos )
 {
 	/* Optimization: if offset is the end of the file, it's a lseek(0,SEEK_END).  Don't
@@ -151,17 +232,19 @@ int RageFileObjInflate::SeekInternal( int iPos )
 	{
 		m_iFilePos = m_iUncompressedSize;
 		m_pFile->Seek( m_pFile->GetFileSize() );
-		decomp_buf_ptr = decomp_buf;
-		decomp_buf_avail = 0;
-		inflateReset( m_pInflate );
+		ResetStream();
 		return m_iUncompressedSize;
 	}
 
-	if( iPos < m_iFilePos )
+	/* Jump to the closest access point, if it's closer than where we are. */
+	RageFileInflateIndex::Point pt;
+	bool bRestart = iPos < m_iFilePos;
+	if( m_pIndex && m_pIndex->GetPoint(iPos, pt) && (iPos < m_iFilePos || pt.iOut > m_iFilePos) )
+		bRestart = !RestorePoint( pt );
+
+	if( bRestart )
 	{
-		inflateReset( m_pInflate );
-		decomp_buf_ptr = decomp_buf;
-		decomp_buf_avail = 0;
+		ResetStream();
 
 		m_pFile->Seek( 0 );
 		m_iFilePos = 0;
@@ -169,7 +252,7 @@ int RageFileObjInflate::SeekInternal( int iPos )
 
 	int iOffset = iPos - m_iFilePos;
 
-	/* Can this be optimized? */
+	/* Decompress up to the position. */
 	char buf[1024*4];
 	while( iOffset )
 	{
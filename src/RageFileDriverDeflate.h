@@ -4,9 +4,47 @@
 #define RAGE_FILE_DRIVER_DEFLATE_H
 
 #include "RageFileBasic.h"
+#include "RageThreads.h"
+#include <memory>
 
 typedef struct z_stream_s z_stream;
 
+/**
+ * @brief Access points into a raw deflate stream.
+ *
+ * Inflating can only go forward, so seeking backwards used to mean starting
+ * over, and seeking far ahead meant decompressing everything in between.
+ * Each point records where a deflate block starts in both streams, and the
+ * 32k window needed to resume inflating there.  Points are added about every
+ * SPAN bytes of output, as the stream is read for the first time.
+ *
+ * One index can be shared by every RageFileObjInflate reading the same stream. */
+class RageFileInflateIndex
+{
+public:
+	RageFileInflateIndex(): m_Mutex( "RageFileInflateIndex" ) { }
+
+	enum { SPAN = 1024*1024 };
+	struct Point
+	{
+		Point(): iOut(0), iIn(0), iBits(0) { }
+		int iOut;	// uncompressed offset
+		int iIn;	// compressed offset of the first full byte
+		int iBits;	// bits of the byte before iIn that belong to this block
+		RString sWindow;
+	};
+
+	/* Find the last point at or before iOut.  Returns false if there isn't one. */
+	bool GetPoint( int iOut, Point &out ) const;
+	/* Returns true if a point at iOut would be far enough past the last one. */
+	bool WantPoint( int iOut ) const;
+	void AddPoint( const Point &pt );
+
+private:
+	mutable RageMutex m_Mutex;
+	vector<Point> m_Points;
+};
+
 class RageFileObjInflate: public RageFileObj
 {
 public:
@@ -24,11 +62,19 @@ public:
 
 	void DeleteFileWhenFinished() { m_bFileOwned = true; }
 
+	/* Record and use access points in pIndex, so seeks don't have to
+	 * decompress from the start of the stream. */
+	void SetIndex( const std::shared_ptr<RageFileInflateIndex> &pIndex ) { m_pIndex = pIndex; }
+
 private:
+	bool RestorePoint( const RageFileInflateIndex::Point &pt );
+	void ResetStream();
+
 	int m_iUncompressedSize;
 	RageFileBasic *m_pFile;
 	int m_iFilePos;
 	bool m_bFileOwned;
+	std::shared_ptr<RageFileInflateIndex> m_pIndex;
 
 	z_stream *m_pInflate;
 	enum { INBUFSIZE = 1024*4 };
@@ -69,13 +69,16 @@ static RageFileObjDirect *MakeFileObjDirect( RString sPath, int iMode, int &iErr
 	else
 	{
 		RString sOut;
-		if( iMode & RageFile::STREAMED )
+		if( iMode & (RageFile::STREAMED|RageFile::APPEND) )
 			sOut = sPath;
 		else
 			sOut = MakeTempFilename(sPath);
 
 		/* Open a temporary file for writing. */
-		iFD = DoOpen( sOut, O_BINARY|O_WRONLY|O_CREAT|O_TRUNC, 0666 );
+		if( iMode & RageFile::APPEND )
+			iFD = DoOpen( sOut, O_BINARY|O_WRONLY|O_CREAT|O_APPEND, 0666 );
+		else
+			iFD = DoOpen( sOut, O_BINARY|O_WRONLY|O_CREAT|O_TRUNC, 0666 );
 	}
 
 	if( iFD == -1 )
@@ -330,7 +333,7 @@ RageFileObjDirect::~RageFileObjDirect()
 		}
 	}
 
-	if( !(m_iMode & RageFile::WRITE) || (m_iMode & RageFile::STREAMED) )
+	if( !(m_iMode & RageFile::WRITE) || (m_iMode & (RageFile::STREAMED|RageFile::APPEND)) )
 		return;
 
 	/* We now have path written to MakeTempFilename(m_sPath).
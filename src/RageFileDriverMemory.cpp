@@ -130,6 +130,12 @@ RageFileBasic *RageFileDriverMem::Open( const RString &sPath, int mode, int &err
 {
 	LockMut(m_Mutex);
 
+	if( mode & RageFile::APPEND )
+	{
+		err = EINVAL;
+		return nullptr;
+	}
+
 	if( mode == RageFile::WRITE )
 	{
 		/* If the file exists, delete it. */
@@ -10,6 +10,7 @@
 #include "RageLog.h"
 #include "RageUtil.h"
 #include "RageUtil_FileDB.h"
+#include "RageUtil_MappedFile.h"
 #include <cerrno>
 
 static struct FileDriverEntry_ZIP: public FileDriverEntry
@@ -55,6 +56,10 @@ bool RageFileDriverZip::Load( const RString &sPath )
 
 	m_pZip = pFile;
 
+	m_pMapping = std::make_shared<RageFileMapping>();
+	if( !m_pMapping->Map(sPath) )
+		m_pMapping.reset();
+
 	return ParseZipfile();
 }
 
@@ -286,6 +291,37 @@ RageFileDriverZip::~RageFileDriverZip()
 		delete m_pZip;
 }
 
+/* A stored file, or the compressed data of a deflated one, read straight out
+ * of the mapped zip. */
+class RageFileObjZipMapped: public RageFileObj
+{
+public:
+	RageFileObjZipMapped( const std::shared_ptr<RageFileMapping> &pMapping, int iOffset, int iFileSize ):
+		m_pMapping( pMapping ), m_pData( pMapping->GetData() + iOffset ),
+		m_iFilePos( 0 ), m_iFileSize( iFileSize ) { }
+	RageFileObjZipMapped *Copy() const { return new RageFileObjZipMapped( *this ); }
+
+	int ReadInternal( void *pBuffer, size_t iBytes )
+	{
+		iBytes = min( iBytes, size_t(m_iFileSize - m_iFilePos) );
+		memcpy( pBuffer, m_pData + m_iFilePos, iBytes );
+		m_iFilePos += iBytes;
+		return iBytes;
+	}
+	int WriteInternal( const void * /* pBuffer */, size_t /* iBytes */ ) { SetError( "Not implemented" ); return -1; }
+	int SeekInternal( int iOffset )
+	{
+		m_iFilePos = clamp( iOffset, 0, m_iFileSize );
+		return m_iFilePos;
+	}
+	int GetFileSize() const { return m_iFileSize; }
+
+private:
+	std::shared_ptr<RageFileMapping> m_pMapping;
+	const char *m_pData;
+	int m_iFilePos, m_iFileSize;
+};
+
 const RageFileDriverZip::FileInfo *RageFileDriverZip::GetFileInfo( const RString &sPath ) const
 {
 	return (const FileInfo *) FDB->GetFilePriv( sPath );
@@ -318,25 +354,51 @@ RageFileBasic *RageFileDriverZip::Open( const RString &sPath, int iMode, int &iE
 		}
 	}
 
+	/* Large deflated files get an index of access points, so seeking in them
+	 * (eg. music in a song pack) doesn't decompress from the start each time.
+	 * The open files own it; once the last one closes, it's freed. */
+	std::shared_ptr<RageFileInflateIndex> pIndex;
+	if( info->m_iCompressionMethod == DEFLATED && info->m_iUncompressedSize > RageFileInflateIndex::SPAN )
+	{
+		pIndex = info->m_pInflateIndex.lock();
+		if( !pIndex )
+		{
+			pIndex = std::make_shared<RageFileInflateIndex>();
+			info->m_pInflateIndex = pIndex;
+		}
+	}
+
 	/* We won't do any further access to zip, except to copy it (which is
 	 * threadsafe), so we can unlock now. */
 	m_Mutex.Unlock();
 
-	RageFileDriverSlice *pSlice = new RageFileDriverSlice( m_pZip->Copy(), info->m_iDataOffset, info->m_iCompressedSize );
-	pSlice->DeleteFileWhenFinished();
+	RageFileBasic *pData;
+	if( m_pMapping && size_t(info->m_iDataOffset) + info->m_iCompressedSize <= m_pMapping->GetSize() )
+	{
+		pData = new RageFileObjZipMapped( m_pMapping, info->m_iDataOffset, info->m_iCompressedSize );
+	}
+	else
+	{
+		RageFileDriverSlice *pSlice = new RageFileDriverSlice( m_pZip->Copy(), info->m_iDataOffset, info->m_iCompressedSize );
+		pSlice->DeleteFileWhenFinished();
+		pData = pSlice;
+	}
 	
 	switch( info->m_iCompressionMethod )
 	{
 	case STORED:
-		return pSlice;
+		return pData;
 	case DEFLATED:
 	{
-		RageFileObjInflate *pInflate = new RageFileObjInflate( pSlice, info->m_iUncompressedSize );
+		RageFileObjInflate *pInflate = new RageFileObjInflate( pData, info->m_iUncompressedSize );
 		pInflate->DeleteFileWhenFinished();
+		if( pIndex )
+			pInflate->SetIndex( pIndex );
 		return pInflate;
 	}
 	default:
 		/* unknown compression method */
+		delete pData;
 		iErr = ENOSYS;
 		return nullptr;
 	}
@@ -3,6 +3,10 @@
 
 #include "RageFileDriver.h"
 #include "RageThreads.h"
+#include <memory>
+
+class RageFileInflateIndex;
+class RageFileMapping;
 /** @brief A read-only file driver for ZIPs. */
 class RageFileDriverZip: public RageFileDriver
 {
@@ -33,6 +37,11 @@ public:
 
 		/* If 0, unknown. */
 		int m_iFilePermissions;
+
+		/* Access points for seeking in large deflated files, shared by every
+		 * open copy of the file.  Created on open, and only lives as long as
+		 * some copy is open, so it doesn't pile up for every file read. */
+		std::weak_ptr<RageFileInflateIndex> m_pInflateIndex;
 	};
 	const FileInfo *GetFileInfo( const RString &sPath ) const;
 
@@ -44,6 +53,13 @@ private:
 	RageFileBasic *m_pZip;
 	vector<FileInfo *> m_pFiles;
 
+	/* The zip, if it's a real file on a local disk that can be memory-mapped
+	 * (see RageFileMapping::Map; zips on network shares or removable media
+	 * aren't, since a failed read there would crash).  Files are read
+	 * straight out of the mapping instead of through copies of m_pZip.  Open
+	 * files hold a reference, so the mapping outlives the driver if needed. */
+	std::shared_ptr<RageFileMapping> m_pMapping;
+
 	RString m_sPath;
 	RString m_sComment;
 
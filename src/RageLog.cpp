@@ -10,6 +10,7 @@
 #include <windows.h>
 #endif
 #include <map>
+#include <atomic>
 
 RageLog* LOG;		// global and accessible from anywhere in the program
 
@@ -60,10 +61,46 @@ static map<RString, RString> LogMaps;
 
 static RageFile *g_fileLog, *g_fileInfo, *g_fileUserLog, *g_fileTimeLog;
 
-/* Mutex writes to the files.  Writing to files is not thread-aware, and this is the
- * only place we write to the same file from multiple threads. */
+/* Mutex writes to the files.  Only the log writer thread writes to them while
+ * it's running, but the files are also opened, closed and flushed from other
+ * threads. */
 static RageMutex *g_Mutex;
 
+/* Lines are queued here by the threads that log them, and the log writer
+ * thread writes them out in batches, so a Trace never waits for the disk.
+ *
+ * This is a bounded multi-producer queue.  Each slot's sequence number says
+ * whether it's free for position n of the queue (n), or holds the line at
+ * position n (n+1).  A message is claimed as a run of consecutive slots by
+ * advancing g_iRingHead past them, filled, then published one slot at a
+ * time.  Only the writer thread advances g_iRingTail.
+ *
+ * Slots are plain character buffers, so the crash handler can read lines
+ * that were never written out; see GetRecentLog. */
+static const unsigned LOG_RING_SIZE = 2048;	// must be a power of two
+static const unsigned LOG_SLOT_SIZE = 256;
+struct LogSlot
+{
+	std::atomic<unsigned> iSequence;
+	int iWhere;
+	unsigned iSize;
+	float fTime;
+	char szText[LOG_SLOT_SIZE];
+};
+static LogSlot g_Ring[LOG_RING_SIZE];
+static std::atomic<unsigned> g_iRingHead( 0 );
+static std::atomic<unsigned> g_iRingTail( 0 );
+static std::atomic<unsigned> g_iDroppedLines( 0 );
+static std::atomic<bool> g_bWriterRunning( false );
+static std::atomic<bool> g_bWriterShutdown( false );
+/* Posted when lines are published, to wake the writer. */
+static RageSemaphore *g_pRingData;
+/* Broadcast by the writer when it frees slots, for threads waiting on Flush
+ * or for room in the ring. */
+static RageEvent *g_pRingEvent;
+static RageThread g_WriterThread;
+static std::atomic<uint64_t> g_iWriterThreadID;
+
 /* staticlog gets info.txt
  * crashlog gets log.txt */
 enum
@@ -76,11 +113,15 @@ enum
 
 	/* Whether this line should be loud when written to log.txt (warnings). */
 	WRITE_LOUD = 0x04,
-	WRITE_TO_TIME= 0x08
+	WRITE_TO_TIME= 0x08,
+
+	/* Set on every slot of a queued message but the last. */
+	WRITE_CONTINUED = 0x10
 };
 
 RageLog::RageLog(): m_bLogToDisk(false), m_bInfoToDisk(false),
-m_bUserLogToDisk(false), m_bFlush(false), m_bShowLogOutput(false)
+m_bUserLogToDisk(false), m_bFlush(false), m_bShowLogOutput(false),
+m_bLogTraces(true)
 {
 	g_fileLog = new RageFile;
 	g_fileInfo = new RageFile;
@@ -91,6 +132,20 @@ m_bUserLogToDisk(false), m_bFlush(false), m_bShowLogOutput(false)
 	{ fprintf(stderr, "Couldn't open %s: %s\n", TIME_PATH, g_fileTimeLog->GetError().c_str()); }
 	
 	g_Mutex = new RageMutex( "Log" );
+
+	g_iRingTail = g_iRingHead.load();
+	for( unsigned i = 0; i < LOG_RING_SIZE; ++i )
+	{
+		const unsigned iPos = g_iRingHead + i;
+		g_Ring[iPos % LOG_RING_SIZE].iSequence.store( iPos );
+	}
+	g_iWriterThreadID = RageThread::GetInvalidThreadID();
+	g_pRingData = new RageSemaphore( "Log ring data" );
+	g_pRingEvent = new RageEvent( "Log ring" );
+	g_bWriterShutdown = false;
+	g_WriterThread.SetName( "Log writer" );
+	g_WriterThread.Create( WriterThread_start, this );
+	g_bWriterRunning = true;
 }
 
 RageLog::~RageLog()
@@ -106,6 +161,14 @@ RageLog::~RageLog()
 	}
 
 	Flush();
+
+	g_bWriterShutdown = true;
+	g_pRingData->Post();
+	g_WriterThread.Wait();
+	g_bWriterRunning = false;
+	SAFE_DELETE( g_pRingData );
+	SAFE_DELETE( g_pRingEvent );
+
 	SetShowLogOutput( false );
 	g_fileLog->Close();
 	g_fileInfo->Close();
@@ -118,57 +181,60 @@ RageLog::~RageLog()
 	SAFE_DELETE( g_fileUserLog );
 }
 
-void RageLog::SetLogToDisk( bool b )
+/* Replace one of the log files with a new one, opened on sPath if bOpen is
+ * set, and close the old one.  The writer thread needs g_Mutex to drain the
+ * ring, so opening or closing a file (which can log, or wait on the disk)
+ * while holding it could deadlock against a line waiting for room in the
+ * ring.  Only the swap itself is done under the lock. */
+static void ReplaceLogFile( RageFile *&pFile, const char *szPath, bool bOpen )
 {
-	if( m_bLogToDisk == b )
-		return;
+	RageFile *pNewFile = new RageFile;
+	if( bOpen && !pNewFile->Open(szPath, RageFile::WRITE|RageFile::STREAMED) )
+		fprintf( stderr, "Couldn't open %s: %s\n", szPath, pNewFile->GetError().c_str() );
 
-	m_bLogToDisk = b;
-
-	if( !m_bLogToDisk )
 	{
-		if( g_fileLog->IsOpen() )
-			g_fileLog->Close();
-		return;
+		LockMut( *g_Mutex );
+		swap( pFile, pNewFile );
 	}
 
-	if( !g_fileLog->Open( LOG_PATH, RageFile::WRITE|RageFile::STREAMED ) )
-		fprintf( stderr, "Couldn't open %s: %s\n", LOG_PATH, g_fileLog->GetError().c_str() );
+	/* Closes the old file. */
+	delete pNewFile;
 }
 
-void RageLog::SetInfoToDisk( bool b )
+void RageLog::SetLogToDisk( bool b )
 {
-	if( m_bInfoToDisk == b )
-		return;
+	{
+		LockMut( *g_Mutex );
+		if( m_bLogToDisk == b )
+			return;
+		m_bLogToDisk = b;
+	}
 
-	m_bInfoToDisk = b;
+	ReplaceLogFile( g_fileLog, LOG_PATH, b );
+}
 
-	if( !m_bInfoToDisk )
+void RageLog::SetInfoToDisk( bool b )
+{
 	{
-		if( g_fileInfo->IsOpen() )
-			g_fileInfo->Close();
-		return;
+		LockMut( *g_Mutex );
+		if( m_bInfoToDisk == b )
+			return;
+		m_bInfoToDisk = b;
 	}
 
-	if( !g_fileInfo->Open( INFO_PATH, RageFile::WRITE|RageFile::STREAMED ) )
-		fprintf( stderr, "Couldn't open %s: %s\n", INFO_PATH, g_fileInfo->GetError().c_str() );
+	ReplaceLogFile( g_fileInfo, INFO_PATH, b );
 }
 
 void RageLog::SetUserLogToDisk( bool b )
 {
-	if( m_bUserLogToDisk == b )
-		return;
-	
-	m_bUserLogToDisk = b;
-	
-	if( !m_bUserLogToDisk )
 	{
-		if( g_fileUserLog->IsOpen() )
-			g_fileUserLog->Close();
-		return;
+		LockMut( *g_Mutex );
+		if( m_bUserLogToDisk == b )
+			return;
+		m_bUserLogToDisk = b;
 	}
-	if( !g_fileUserLog->Open(USER_PATH, RageFile::WRITE|RageFile::STREAMED) )
-		fprintf( stderr, "Couldn't open %s: %s\n", USER_PATH, g_fileUserLog->GetError().c_str() );
+
+	ReplaceLogFile( g_fileUserLog, USER_PATH, b );
 }
 
 void RageLog::SetFlushing( bool b )
@@ -176,6 +242,11 @@ void RageLog::SetFlushing( bool b )
 	m_bFlush = b;
 }
 
+void RageLog::SetLogTraces( bool b )
+{
+	m_bLogTraces = b;
+}
+
 /* Enable or disable display of output to stdout, or a console window in Windows. */
 void RageLog::SetShowLogOutput( bool show )
 {
@@ -198,6 +269,9 @@ void RageLog::SetShowLogOutput( bool show )
 
 void RageLog::Trace( const char *fmt, ... )
 {
+	if( !m_bLogTraces )
+		return;
+
 	va_list	va;
 	va_start( va, fmt );
 	RString sBuff = vssprintf( fmt, va );
@@ -253,7 +327,133 @@ void RageLog::UserLog( const RString &sType, const RString &sElement, const char
 
 void RageLog::Write( int where, const RString &sLine )
 {
-	LockMut( *g_Mutex );
+	const float fTime = RageTimer::GetTimeSinceStart();
+
+	/* Write directly if there's no writer thread to queue for, or if this is
+	 * the writer thread, which can't wait on itself for room in the ring. */
+	if( !g_bWriterRunning || RageThread::GetCurrentThreadID() == g_iWriterThreadID )
+	{
+		LockMut( *g_Mutex );
+		WriteNow( where, sLine, fTime );
+		if( m_bFlush || (where & WRITE_TO_INFO) )
+			FlushFiles();
+		return;
+	}
+
+	/* Very long messages are cut short rather than taking over the ring. */
+	const unsigned iChunkSize = LOG_SLOT_SIZE - 1;
+	const unsigned iMaxSlots = LOG_RING_SIZE / 4;
+	unsigned iSize = min( (unsigned) sLine.size(), iChunkSize * iMaxSlots );
+	unsigned iSlots = max( 1u, (iSize + iChunkSize - 1) / iChunkSize );
+
+	unsigned iPos;
+	for(;;)
+	{
+		iPos = g_iRingHead.load( std::memory_order_relaxed );
+		const unsigned iLast = iPos + iSlots - 1;
+		const int iDiff = int( g_Ring[iLast % LOG_RING_SIZE].iSequence.load(std::memory_order_acquire) - iLast );
+		if( iDiff == 0 )
+		{
+			if( g_iRingHead.compare_exchange_weak(iPos, iPos + iSlots, std::memory_order_relaxed) )
+				break;
+			continue;
+		}
+		if( iDiff > 0 )
+			continue;	// another thread claimed these slots first
+
+		/* The ring is full.  Traces are dropped and counted; everything
+		 * else waits for the writer, since it goes to info.txt or userlog.txt
+		 * and shouldn't be lost. */
+		if( where == 0 )
+		{
+			++g_iDroppedLines;
+			return;
+		}
+
+		g_pRingData->Post();
+		g_pRingEvent->Lock();
+		while( int(g_Ring[iLast % LOG_RING_SIZE].iSequence.load(std::memory_order_acquire) - iLast) < 0 )
+			g_pRingEvent->Wait();
+		g_pRingEvent->Unlock();
+	}
+
+	for( unsigned i = 0; i < iSlots; ++i )
+	{
+		LogSlot &slot = g_Ring[(iPos + i) % LOG_RING_SIZE];
+		const unsigned iOffset = i * iChunkSize;
+		slot.iSize = min( iChunkSize, iSize - iOffset );
+		memcpy( slot.szText, sLine.data() + iOffset, slot.iSize );
+		slot.szText[slot.iSize] = 0;
+		slot.iWhere = where | (i+1 < iSlots? WRITE_CONTINUED:0);
+		slot.fTime = fTime;
+		slot.iSequence.store( iPos + i + 1, std::memory_order_release );
+	}
+
+	g_pRingData->Post();
+}
+
+int RageLog::WriterThread_start( void *p )
+{
+	((RageLog *) p)->WriterThread();
+	return 0;
+}
+
+void RageLog::WriterThread()
+{
+	g_iWriterThreadID = RageThread::GetCurrentThreadID();
+
+	/* A message whose slots haven't all been published yet. */
+	RString sMessage;
+	for(;;)
+	{
+		g_pRingData->Wait( false );
+		while( g_pRingData->TryWait() )
+			;
+
+		{
+			LockMut( *g_Mutex );
+			bool bFlush = m_bFlush;
+			unsigned iTail = g_iRingTail.load( std::memory_order_relaxed );
+			for(;;)
+			{
+				LogSlot &slot = g_Ring[iTail % LOG_RING_SIZE];
+				if( slot.iSequence.load(std::memory_order_acquire) != iTail + 1 )
+					break;
+
+				const int where = slot.iWhere;
+				const float fTime = slot.fTime;
+				sMessage.append( slot.szText, slot.iSize );
+				slot.iSequence.store( iTail + LOG_RING_SIZE, std::memory_order_release );
+				++iTail;
+				g_iRingTail.store( iTail, std::memory_order_release );
+
+				if( where & WRITE_CONTINUED )
+					continue;
+				WriteNow( where, sMessage, fTime );
+				sMessage.clear();
+				if( where & WRITE_TO_INFO )
+					bFlush = true;
+			}
+
+			const unsigned iDropped = g_iDroppedLines.exchange( 0 );
+			if( iDropped != 0 )
+				WriteNow( WRITE_TO_INFO, ssprintf("The log fell behind; %u lines were dropped.", iDropped), RageTimer::GetTimeSinceStart() );
+
+			if( bFlush )
+				FlushFiles();
+		}
+
+		g_pRingEvent->Lock();
+		g_pRingEvent->Broadcast();
+		g_pRingEvent->Unlock();
+
+		if( g_bWriterShutdown && g_iRingTail.load() == g_iRingHead.load() )
+			break;
+	}
+}
+
+void RageLog::WriteNow( int where, const RString &sLine, float fTime )
+{
 
 	const char *const sWarningSeparator = "/////////////////////////////////////////";
 	vector<RString> asLines;
@@ -265,7 +465,7 @@ void RageLog::Write( int where, const RString &sLine )
 		puts( sWarningSeparator );
 	}
 
-	RString sTimestamp = SecondsToMMSSMsMsMs( RageTimer::GetTimeSinceStart() ) + ": ";
+	RString sTimestamp = SecondsToMMSSMsMsMs( fTime ) + ": ";
 	RString sWarning;
 	if( where & WRITE_LOUD )
 		sWarning = "WARNING: ";
@@ -305,12 +505,27 @@ void RageLog::Write( int where, const RString &sLine )
 			g_fileLog->PutLine( sWarningSeparator );
 		puts( sWarningSeparator );
 	}
-	if( m_bFlush || (where & WRITE_TO_INFO) )
-		Flush();
 }
 
 
+/* Wait for everything logged so far to be written, and flush the files. */
 void RageLog::Flush()
+{
+	if( g_bWriterRunning && RageThread::GetCurrentThreadID() != g_iWriterThreadID )
+	{
+		const unsigned iHead = g_iRingHead.load();
+		g_pRingData->Post();
+		g_pRingEvent->Lock();
+		while( int(g_iRingTail.load() - iHead) < 0 )
+			g_pRingEvent->Wait();
+		g_pRingEvent->Unlock();
+	}
+
+	LockMut( *g_Mutex );
+	FlushFiles();
+}
+
+void RageLog::FlushFiles()
 {
 	g_fileLog->Flush();
 	g_fileInfo->Flush();
@@ -370,10 +585,23 @@ void RageLog::AddToRecentLogs( const RString &str )
 	backlog_start %= BACKLOG_LINES;
 }
 
+/* After the lines that have been written, this returns the lines still
+ * queued for the writer thread, so a crash report includes the lines that
+ * never made it to log.txt.  This only reads static buffers, so it's safe to
+ * call from the crash handler. */
 const char *RageLog::GetRecentLog( int n )
 {
-	if( n >= BACKLOG_LINES || n >= backlog_cnt )
-		return nullptr;
+	if( n >= backlog_cnt )
+	{
+		const unsigned iPos = g_iRingTail.load() + unsigned(n - backlog_cnt);
+		if( int(iPos - g_iRingHead.load()) >= 0 )
+			return nullptr;
+		LogSlot &slot = g_Ring[iPos % LOG_RING_SIZE];
+		if( slot.iSequence.load() != iPos + 1 )
+			return nullptr;
+		slot.szText[LOG_SLOT_SIZE-1] = 0;
+		return slot.szText;
+	}
 
 	if( backlog_cnt == BACKLOG_LINES )
 	{
@@ -30,6 +30,7 @@ public:
 	void SetInfoToDisk( bool b );	// enable or disable logging info.txt to file
 	void SetUserLogToDisk( bool b);	// enable or disable logging user.txt to file
 	void SetFlushing( bool b );	// enable or disable flushing
+	void SetLogTraces( bool b );	// enable or disable Trace, before it formats anything
 
 private:
 	bool m_bLogToDisk;
@@ -37,7 +38,12 @@ private:
 	bool m_bUserLogToDisk;
 	bool m_bFlush;
 	bool m_bShowLogOutput;
+	bool m_bLogTraces;
 	void Write( int, const RString &str );
+	void WriteNow( int where, const RString &str, float fTime );
+	void FlushFiles();
+	static int WriterThread_start( void *p );
+	void WriterThread();
 	void UpdateMappedLog();
 	void AddToInfo( const RString &buf );
 	void AddToRecentLogs( const RString &buf );
@@ -176,6 +176,21 @@ bool RageSound::Load( RString sSoundFilePath, bool bPrecache, const RageSoundLoa
 	 * of that.  Since RageSoundReader_Preload is refcounted, this is cheap. */
 	RageSoundReader *pSound = SOUNDMAN->GetLoadedSound( sSoundFilePath );
 	bool bNeedBuffer = true;
+
+	/* If it was prefetched, it's already open, with its start in memory. */
+	if( pSound == nullptr )
+	{
+		pSound = SOUNDMAN->GetPrefetchedSound( sSoundFilePath );
+		if( pSound != nullptr )
+			LOG->Trace( "RageSound: using prefetched \"%s\"", sSoundFilePath.c_str() );
+	}
+	else
+	{
+		/* The sound we were given from SOUNDMAN is already preloaded. */
+		bPrecache = false;
+		bNeedBuffer = false;
+	}
+
 	if( pSound == nullptr )
 	{
 		RString error;
@@ -193,12 +208,6 @@ bool RageSound::Load( RString sSoundFilePath, bool bPrecache, const RageSoundLoa
 		if( bPrebuffer )
 			bNeedBuffer = false;
 	}
-	else
-	{
-		/* The sound we were given from SOUNDMAN is already preloaded. */
-		bPrecache = false;
-		bNeedBuffer = false;
-	}
 
 	LoadSoundReader( pSound );
 
@@ -15,6 +15,7 @@
 #include "RageLog.h"
 #include "RageTimer.h"
 #include "RageSoundReader_Preload.h"
+#include "RageSoundReader_Prefetch.h"
 #include "LocalizedString.h"
 #include "Preference.h"
 #include "RageSoundReader_PostBuffering.h"
@@ -53,6 +54,9 @@ RageSoundManager::~RageSoundManager()
 	for (std::pair<RString const &, RageSoundReader_Preload *> s : m_mapPreloadedSounds)
 		delete s.second;
 	m_mapPreloadedSounds.clear();
+	for (std::pair<RString const &, RageSoundReader_Prefetch *> s : m_mapPrefetchedSounds)
+		delete s.second;
+	m_mapPrefetchedSounds.clear();
 }
 
 
@@ -183,6 +187,59 @@ void RageSoundManager::AddLoadedSound( const RString &sPath_, RageSoundReader_Pr
 	m_mapPreloadedSounds[sPath] = pSound->Copy();
 }
 
+/* Hold on to a prefetched sound until it's loaded.  If the path is already
+ * prefetched, the old one is replaced. */
+void RageSoundManager::AddPrefetchedSound( const RString &sPath_, RageSoundReader_Prefetch *pSound )
+{
+	LockMut(g_SoundManMutex); /* lock for access to m_mapPrefetchedSounds */
+
+	RString sPath(sPath_);
+	sPath.MakeLower();
+	RageSoundReader_Prefetch *&pEntry = m_mapPrefetchedSounds[sPath];
+	delete pEntry;
+	pEntry = pSound;
+}
+
+/* If the given path is prefetched, return it and forget about it; otherwise
+ * return nullptr.  It's the caller's responsibility to delete the result. */
+RageSoundReader *RageSoundManager::GetPrefetchedSound( const RString &sPath_ )
+{
+	LockMut(g_SoundManMutex); /* lock for access to m_mapPrefetchedSounds */
+
+	RString sPath(sPath_);
+	sPath.MakeLower();
+	map<RString, RageSoundReader_Prefetch *>::iterator it = m_mapPrefetchedSounds.find( sPath );
+	if( it == m_mapPrefetchedSounds.end() )
+		return nullptr;
+
+	RageSoundReader *pRet = it->second;
+	m_mapPrefetchedSounds.erase( it );
+	return pRet;
+}
+
+bool RageSoundManager::IsSoundPrefetched( const RString &sPath_ ) const
+{
+	LockMut(g_SoundManMutex); /* lock for access to m_mapPrefetchedSounds */
+
+	RString sPath(sPath_);
+	sPath.MakeLower();
+	return m_mapPrefetchedSounds.find( sPath ) != m_mapPrefetchedSounds.end();
+}
+
+void RageSoundManager::DeletePrefetchedSound( const RString &sPath_ )
+{
+	LockMut(g_SoundManMutex); /* lock for access to m_mapPrefetchedSounds */
+
+	RString sPath(sPath_);
+	sPath.MakeLower();
+	map<RString, RageSoundReader_Prefetch *>::iterator it = m_mapPrefetchedSounds.find( sPath );
+	if( it == m_mapPrefetchedSounds.end() )
+		return;
+
+	delete it->second;
+	m_mapPrefetchedSounds.erase( it );
+}
+
 static Preference<float> g_fSoundVolume( "SoundVolume", 1.0f );
 
 void RageSoundManager::SetMixVolume()
@@ -13,6 +13,7 @@ class RageSoundDriver;
 struct RageSoundParams;
 class RageSoundReader;
 class RageSoundReader_Preload;
+class RageSoundReader_Prefetch;
 class RageTimer;
 
 class RageSoundManager
@@ -44,11 +45,19 @@ public:
 	RageSoundReader *GetLoadedSound( const RString &sPath );
 	void AddLoadedSound( const RString &sPath, RageSoundReader_Preload *pSound );
 
+	/* Sounds opened ahead of time.  Unlike loaded sounds, each one is handed
+	 * out only once, by GetPrefetchedSound. */
+	void AddPrefetchedSound( const RString &sPath, RageSoundReader_Prefetch *pSound );
+	RageSoundReader *GetPrefetchedSound( const RString &sPath );
+	bool IsSoundPrefetched( const RString &sPath ) const;
+	void DeletePrefetchedSound( const RString &sPath );
+
 	void fix_bogus_sound_driver_pref(RString const& valid_setting);
 	void low_sample_count_workaround();
 
 private:
 	map<RString, RageSoundReader_Preload *> m_mapPreloadedSounds;
+	map<RString, RageSoundReader_Prefetch *> m_mapPrefetchedSounds;
 
 	RageSoundDriver *m_pDriver;
 
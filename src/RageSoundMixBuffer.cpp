@@ -1,13 +1,7 @@
 #include "global.h"
 #include "RageSoundMixBuffer.h"
 #include "RageUtil.h"
-
-#if defined(MACOSX)
-#include "archutils/Darwin/VectorHelper.h"
-#ifdef USE_VEC
-static bool g_bVector = Vector::CheckForVector();
-#endif
-#endif
+#include "RageSoundMixKernels.h"
 
 RageSoundMixBuffer::RageSoundMixBuffer()
 {
@@ -56,13 +50,11 @@ void RageSoundMixBuffer::write( const float *pBuf, unsigned iSize, int iSourceSt
 	/* Scale volume and add. */
 	float *pDestBuf = m_pMixbuf+m_iOffset;
 
-#ifdef USE_VEC
-	if( g_bVector && iSourceStride == 1 && iDestStride == 1 )
+	if( iSourceStride == 1 && iDestStride == 1 )
 	{
-		Vector::FastSoundWrite( pDestBuf, pBuf, iSize );
+		RageSoundMixKernels::Get().Accumulate( pDestBuf, pBuf, iSize );
 		return;
 	}
-#endif
 
 	while( iSize )
 	{
@@ -75,12 +67,7 @@ void RageSoundMixBuffer::write( const float *pBuf, unsigned iSize, int iSourceSt
 
 void RageSoundMixBuffer::read( int16_t *pBuf )
 {
-	for( unsigned iPos = 0; iPos < m_iBufUsed; ++iPos )
-	{
-		float iOut = m_pMixbuf[iPos];
-		iOut = clamp( iOut, -1.0f, +1.0f );
-		pBuf[iPos] = lrintf(iOut * 32767);
-	}
+	RageSoundMixKernels::Get().ConvertToInt16( pBuf, m_pMixbuf, m_iBufUsed );
 	m_iBufUsed = 0;
 }
 
@@ -92,9 +79,7 @@ void RageSoundMixBuffer::read( float *pBuf )
 
 void RageSoundMixBuffer::read_deinterlace( float **pBufs, int channels )
 {
-	for( unsigned i = 0; i < m_iBufUsed / channels; ++i )
-		for( int ch = 0; ch < channels; ++ch )
-			pBufs[ch][i] = m_pMixbuf[channels * i + ch];
+	RageSoundMixKernels::Get().Deinterlace( pBufs, m_pMixbuf, m_iBufUsed / channels, channels );
 	m_iBufUsed = 0;
 }
 
@@ -0,0 +1,418 @@
+#include "global.h"
+#include "RageSoundMixKernels.h"
+#include "RageUtil.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define MIX_KERNELS_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define MIX_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/* GCC and Clang only allow intrinsics for instruction sets the function is
+ * compiled for, so the SIMD kernels are built for their own targets and only
+ * called once the CPU is known to support them.  MSVC allows them anywhere. */
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+using namespace RageSoundMixKernels;
+
+static void AccumulateScalar( float *pDest, const float *pSrc, unsigned iSamples )
+{
+	for( unsigned i = 0; i < iSamples; ++i )
+		pDest[i] += pSrc[i];
+}
+
+static void ConvertToInt16Scalar( int16_t *pDest, const float *pSrc, unsigned iSamples )
+{
+	for( unsigned i = 0; i < iSamples; ++i )
+	{
+		float fOut = clamp( pSrc[i], -1.0f, +1.0f );
+		pDest[i] = int16_t( lrintf(fOut * 32767) );
+	}
+}
+
+/* Deinterlace frames [iStart,iFrames); the SIMD kernels finish with this. */
+static void DeinterlaceScalarFrom( float **pDest, const float *pSrc, unsigned iStart, unsigned iFrames, int iChannels )
+{
+	for( unsigned i = iStart; i < iFrames; ++i )
+		for( int ch = 0; ch < iChannels; ++ch )
+			pDest[ch][i] = pSrc[iChannels * i + ch];
+}
+
+static void DeinterlaceScalar( float **pDest, const float *pSrc, unsigned iFrames, int iChannels )
+{
+	DeinterlaceScalarFrom( pDest, pSrc, 0, iFrames, iChannels );
+}
+
+/* Every kernel adds the taps up as two interleaved halves, then pairwise:
+ * s[k] = x[k]*f[k] + x[k+4]*f[k+4], and (s[0]+s[2]) + (s[1]+s[3]).  That's
+ * the order a 4-wide vector gets them in. */
+static void PolyphaseFrameScalar( float *pOut, const float *pHistory, const float *pFilter, int iChannels )
+{
+	for( int ch = 0; ch < iChannels; ++ch )
+	{
+		const float *pIn = pHistory + ch;
+		float s[4];
+		for( int k = 0; k < 4; ++k )
+			s[k] = pIn[k*iChannels]*pFilter[k] + pIn[(k+4)*iChannels]*pFilter[k+4];
+		pOut[ch] = (s[0]+s[2]) + (s[1]+s[3]);
+	}
+}
+
+static const Kernels g_Scalar = { "scalar", AccumulateScalar, ConvertToInt16Scalar, DeinterlaceScalar, PolyphaseFrameScalar };
+
+#if defined(MIX_KERNELS_X86)
+TARGET_SSE2 static void AccumulateSSE2( float *pDest, const float *pSrc, unsigned iSamples )
+{
+	unsigned i = 0;
+	for( ; i + 8 <= iSamples; i += 8 )
+	{
+		__m128 a = _mm_add_ps( _mm_loadu_ps(pDest + i), _mm_loadu_ps(pSrc + i) );
+		__m128 b = _mm_add_ps( _mm_loadu_ps(pDest + i + 4), _mm_loadu_ps(pSrc + i + 4) );
+		_mm_storeu_ps( pDest + i, a );
+		_mm_storeu_ps( pDest + i + 4, b );
+	}
+	AccumulateScalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+TARGET_SSE2 static void ConvertToInt16SSE2( int16_t *pDest, const float *pSrc, unsigned iSamples )
+{
+	const __m128 fLow = _mm_set1_ps( -1.0f );
+	const __m128 fHigh = _mm_set1_ps( +1.0f );
+	const __m128 fScale = _mm_set1_ps( 32767 );
+	unsigned i = 0;
+	for( ; i + 8 <= iSamples; i += 8 )
+	{
+		/* The operands are in the same order as clamp() compares them, so
+		 * NaNs come out the same way, too. */
+		__m128 a = _mm_max_ps( _mm_min_ps(fHigh, _mm_loadu_ps(pSrc + i)), fLow );
+		__m128 b = _mm_max_ps( _mm_min_ps(fHigh, _mm_loadu_ps(pSrc + i + 4)), fLow );
+		/* Like lrintf, this rounds with the current rounding mode. */
+		__m128i ia = _mm_cvtps_epi32( _mm_mul_ps(a, fScale) );
+		__m128i ib = _mm_cvtps_epi32( _mm_mul_ps(b, fScale) );
+		_mm_storeu_si128( (__m128i *) (pDest + i), _mm_packs_epi32(ia, ib) );
+	}
+	ConvertToInt16Scalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+TARGET_SSE2 static void DeinterlaceSSE2( float **pDest, const float *pSrc, unsigned iFrames, int iChannels )
+{
+	unsigned i = 0;
+	if( iChannels == 2 )
+	{
+		float *pLeft = pDest[0], *pRight = pDest[1];
+		for( ; i + 4 <= iFrames; i += 4 )
+		{
+			__m128 a = _mm_loadu_ps( pSrc + i*2 );
+			__m128 b = _mm_loadu_ps( pSrc + i*2 + 4 );
+			_mm_storeu_ps( pLeft + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)) );
+			_mm_storeu_ps( pRight + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)) );
+		}
+	}
+	DeinterlaceScalarFrom( pDest, pSrc, i, iFrames, iChannels );
+}
+
+/* Add the two halves of s together, in the order PolyphaseFrameScalar does. */
+TARGET_SSE2 static inline __m128 SumHalvesSSE2( __m128 s )
+{
+	__m128 t = _mm_add_ps( s, _mm_movehl_ps(s, s) );
+	return _mm_add_ss( t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1,1,1,1)) );
+}
+
+TARGET_SSE2 static void PolyphaseFrameSSE2( float *pOut, const float *pHistory, const float *pFilter, int iChannels )
+{
+	const __m128 f0 = _mm_loadu_ps( pFilter );
+	const __m128 f1 = _mm_loadu_ps( pFilter + 4 );
+	if( iChannels == 1 )
+	{
+		__m128 s = _mm_add_ps( _mm_mul_ps(_mm_loadu_ps(pHistory), f0), _mm_mul_ps(_mm_loadu_ps(pHistory + 4), f1) );
+		_mm_store_ss( pOut, SumHalvesSSE2(s) );
+	}
+	else if( iChannels == 2 )
+	{
+		/* Both channels at once: duplicate each tap to line up with LRLR. */
+		__m128 a = _mm_add_ps( _mm_mul_ps(_mm_loadu_ps(pHistory), _mm_unpacklo_ps(f0, f0)),
+			_mm_mul_ps(_mm_loadu_ps(pHistory + 8), _mm_unpacklo_ps(f1, f1)) );
+		__m128 b = _mm_add_ps( _mm_mul_ps(_mm_loadu_ps(pHistory + 4), _mm_unpackhi_ps(f0, f0)),
+			_mm_mul_ps(_mm_loadu_ps(pHistory + 12), _mm_unpackhi_ps(f1, f1)) );
+		/* a+b is s[0]+s[2] and s[1]+s[3] for each channel, as LRLR. */
+		__m128 t = _mm_add_ps( a, b );
+		_mm_storel_pi( (__m64 *) pOut, _mm_add_ps(t, _mm_movehl_ps(t, t)) );
+	}
+	else
+	{
+		PolyphaseFrameScalar( pOut, pHistory, pFilter, iChannels );
+	}
+}
+
+static const Kernels g_SSE2 = { "SSE2", AccumulateSSE2, ConvertToInt16SSE2, DeinterlaceSSE2, PolyphaseFrameSSE2 };
+
+TARGET_AVX2 static void AccumulateAVX2( float *pDest, const float *pSrc, unsigned iSamples )
+{
+	unsigned i = 0;
+	for( ; i + 16 <= iSamples; i += 16 )
+	{
+		__m256 a = _mm256_add_ps( _mm256_loadu_ps(pDest + i), _mm256_loadu_ps(pSrc + i) );
+		__m256 b = _mm256_add_ps( _mm256_loadu_ps(pDest + i + 8), _mm256_loadu_ps(pSrc + i + 8) );
+		_mm256_storeu_ps( pDest + i, a );
+		_mm256_storeu_ps( pDest + i + 8, b );
+	}
+	AccumulateScalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+TARGET_AVX2 static void ConvertToInt16AVX2( int16_t *pDest, const float *pSrc, unsigned iSamples )
+{
+	const __m256 fLow = _mm256_set1_ps( -1.0f );
+	const __m256 fHigh = _mm256_set1_ps( +1.0f );
+	const __m256 fScale = _mm256_set1_ps( 32767 );
+	unsigned i = 0;
+	for( ; i + 16 <= iSamples; i += 16 )
+	{
+		__m256 a = _mm256_max_ps( _mm256_min_ps(fHigh, _mm256_loadu_ps(pSrc + i)), fLow );
+		__m256 b = _mm256_max_ps( _mm256_min_ps(fHigh, _mm256_loadu_ps(pSrc + i + 8)), fLow );
+		__m256i ia = _mm256_cvtps_epi32( _mm256_mul_ps(a, fScale) );
+		__m256i ib = _mm256_cvtps_epi32( _mm256_mul_ps(b, fScale) );
+		/* packs works within each 128-bit lane; put the quarters back in order. */
+		__m256i packed = _mm256_packs_epi32( ia, ib );
+		packed = _mm256_permute4x64_epi64( packed, _MM_SHUFFLE(3,1,2,0) );
+		_mm256_storeu_si256( (__m256i *) (pDest + i), packed );
+	}
+	ConvertToInt16Scalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+TARGET_AVX2 static void DeinterlaceAVX2( float **pDest, const float *pSrc, unsigned iFrames, int iChannels )
+{
+	unsigned i = 0;
+	if( iChannels == 2 )
+	{
+		float *pLeft = pDest[0], *pRight = pDest[1];
+		for( ; i + 8 <= iFrames; i += 8 )
+		{
+			__m256 a = _mm256_loadu_ps( pSrc + i*2 );
+			__m256 b = _mm256_loadu_ps( pSrc + i*2 + 8 );
+			/* Within each lane; the lanes are swapped back below. */
+			__m256 l = _mm256_shuffle_ps( a, b, _MM_SHUFFLE(2,0,2,0) );
+			__m256 r = _mm256_shuffle_ps( a, b, _MM_SHUFFLE(3,1,3,1) );
+			l = _mm256_castpd_ps( _mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3,1,2,0)) );
+			r = _mm256_castpd_ps( _mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3,1,2,0)) );
+			_mm256_storeu_ps( pLeft + i, l );
+			_mm256_storeu_ps( pRight + i, r );
+		}
+	}
+	DeinterlaceScalarFrom( pDest, pSrc, i, iFrames, iChannels );
+}
+
+TARGET_AVX2 static void PolyphaseFrameAVX2( float *pOut, const float *pHistory, const float *pFilter, int iChannels )
+{
+	if( iChannels == 2 )
+	{
+		const __m256 f = _mm256_loadu_ps( pFilter );
+		const __m256 fLow = _mm256_permutevar8x32_ps( f, _mm256_setr_epi32(0,0,1,1,2,2,3,3) );
+		const __m256 fHigh = _mm256_permutevar8x32_ps( f, _mm256_setr_epi32(4,4,5,5,6,6,7,7) );
+		/* s[k] for each channel, as LRLRLRLR. */
+		__m256 s = _mm256_add_ps( _mm256_mul_ps(_mm256_loadu_ps(pHistory), fLow),
+			_mm256_mul_ps(_mm256_loadu_ps(pHistory + 8), fHigh) );
+		__m128 t = _mm_add_ps( _mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1) );
+		_mm_storel_pi( (__m64 *) pOut, _mm_add_ps(t, _mm_movehl_ps(t, t)) );
+	}
+	else
+	{
+		/* A single channel is only 8 taps; there's nothing to gain over SSE2. */
+		PolyphaseFrameSSE2( pOut, pHistory, pFilter, iChannels );
+	}
+}
+
+static const Kernels g_AVX2 = { "AVX2", AccumulateAVX2, ConvertToInt16AVX2, DeinterlaceAVX2, PolyphaseFrameAVX2 };
+
+static bool CPUHasSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_cpu_supports( "sse2" );
+#else
+	int info[4];
+	__cpuid( info, 1 );
+	return (info[3] & (1<<26)) != 0;
+#endif
+}
+
+static bool CPUHasAVX2()
+{
+#if defined(__GNUC__) || defined(__clang__)
+	/* This also checks that the OS saves the AVX registers. */
+	return __builtin_cpu_supports( "avx2" );
+#else
+	int info[4];
+	__cpuid( info, 0 );
+	if( info[0] < 7 )
+		return false;
+	__cpuid( info, 1 );
+	const bool bOSXSAVE = (info[2] & (1<<27)) != 0;
+	const bool bAVX = (info[2] & (1<<28)) != 0;
+	if( !bOSXSAVE || !bAVX || (_xgetbv(0) & 6) != 6 )
+		return false;
+	__cpuidex( info, 7, 0 );
+	return (info[1] & (1<<5)) != 0;
+#endif
+}
+#endif
+
+#if defined(MIX_KERNELS_NEON)
+static void AccumulateNEON( float *pDest, const float *pSrc, unsigned iSamples )
+{
+	unsigned i = 0;
+	for( ; i + 8 <= iSamples; i += 8 )
+	{
+		float32x4_t a = vaddq_f32( vld1q_f32(pDest + i), vld1q_f32(pSrc + i) );
+		float32x4_t b = vaddq_f32( vld1q_f32(pDest + i + 4), vld1q_f32(pSrc + i + 4) );
+		vst1q_f32( pDest + i, a );
+		vst1q_f32( pDest + i + 4, b );
+	}
+	AccumulateScalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+/* vminq/vmaxq propagate NaNs, unlike clamp(), so compare and select instead. */
+static inline float32x4_t ClampNEON( float32x4_t v, float32x4_t fLow, float32x4_t fHigh )
+{
+	v = vbslq_f32( vcltq_f32(fHigh, v), fHigh, v );
+	return vbslq_f32( vcgtq_f32(v, fLow), v, fLow );
+}
+
+static void ConvertToInt16NEON( int16_t *pDest, const float *pSrc, unsigned iSamples )
+{
+	const float32x4_t fLow = vdupq_n_f32( -1.0f );
+	const float32x4_t fHigh = vdupq_n_f32( +1.0f );
+	const float32x4_t fScale = vdupq_n_f32( 32767 );
+	unsigned i = 0;
+	for( ; i + 8 <= iSamples; i += 8 )
+	{
+		float32x4_t a = ClampNEON( vld1q_f32(pSrc + i), fLow, fHigh );
+		float32x4_t b = ClampNEON( vld1q_f32(pSrc + i + 4), fLow, fHigh );
+		/* Round to nearest even, as lrintf does in the default rounding mode. */
+		int32x4_t ia = vcvtnq_s32_f32( vmulq_f32(a, fScale) );
+		int32x4_t ib = vcvtnq_s32_f32( vmulq_f32(b, fScale) );
+		vst1q_s16( pDest + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)) );
+	}
+	ConvertToInt16Scalar( pDest + i, pSrc + i, iSamples - i );
+}
+
+static void DeinterlaceNEON( float **pDest, const float *pSrc, unsigned iFrames, int iChannels )
+{
+	unsigned i = 0;
+	if( iChannels == 2 )
+	{
+		float *pLeft = pDest[0], *pRight = pDest[1];
+		for( ; i + 4 <= iFrames; i += 4 )
+		{
+			float32x4x2_t lr = vld2q_f32( pSrc + i*2 );
+			vst1q_f32( pLeft + i, lr.val[0] );
+			vst1q_f32( pRight + i, lr.val[1] );
+		}
+	}
+	DeinterlaceScalarFrom( pDest, pSrc, i, iFrames, iChannels );
+}
+
+static inline float32x2_t SumHalvesNEON( float32x4_t s )
+{
+	float32x2_t t = vadd_f32( vget_low_f32(s), vget_high_f32(s) );
+	return vpadd_f32( t, t );
+}
+
+static void PolyphaseFrameNEON( float *pOut, const float *pHistory, const float *pFilter, int iChannels )
+{
+	const float32x4_t f0 = vld1q_f32( pFilter );
+	const float32x4_t f1 = vld1q_f32( pFilter + 4 );
+	if( iChannels == 1 )
+	{
+		float32x4_t s = vaddq_f32( vmulq_f32(vld1q_f32(pHistory), f0), vmulq_f32(vld1q_f32(pHistory + 4), f1) );
+		vst1_lane_f32( pOut, SumHalvesNEON(s), 0 );
+	}
+	else if( iChannels == 2 )
+	{
+		float32x4x2_t lr0 = vld2q_f32( pHistory );
+		float32x4x2_t lr1 = vld2q_f32( pHistory + 8 );
+		float32x4_t sL = vaddq_f32( vmulq_f32(lr0.val[0], f0), vmulq_f32(lr1.val[0], f1) );
+		float32x4_t sR = vaddq_f32( vmulq_f32(lr0.val[1], f0), vmulq_f32(lr1.val[1], f1) );
+		vst1_lane_f32( pOut, SumHalvesNEON(sL), 0 );
+		vst1_lane_f32( pOut + 1, SumHalvesNEON(sR), 0 );
+	}
+	else
+	{
+		PolyphaseFrameScalar( pOut, pHistory, pFilter, iChannels );
+	}
+}
+
+static const Kernels g_NEON = { "NEON", AccumulateNEON, ConvertToInt16NEON, DeinterlaceNEON, PolyphaseFrameNEON };
+#endif
+
+void RageSoundMixKernels::GetSupported( vector<const Kernels *> &vOut )
+{
+	vOut.clear();
+	vOut.push_back( &g_Scalar );
+#if defined(MIX_KERNELS_X86)
+	if( CPUHasSSE2() )
+		vOut.push_back( &g_SSE2 );
+	if( CPUHasAVX2() )
+		vOut.push_back( &g_AVX2 );
+#endif
+#if defined(MIX_KERNELS_NEON)
+	vOut.push_back( &g_NEON );
+#endif
+}
+
+static const Kernels *ChooseKernels()
+{
+	vector<const Kernels *> vKernels;
+	GetSupported( vKernels );
+	return vKernels.back();
+}
+
+const Kernels &RageSoundMixKernels::Get()
+{
+	static const Kernels *pKernels = ChooseKernels();
+	return *pKernels;
+}
+
+const Kernels &RageSoundMixKernels::GetScalar()
+{
+	return g_Scalar;
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
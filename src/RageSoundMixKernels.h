@@ -0,0 +1,66 @@
+/* RageSoundMixKernels - Vectorized inner loops for RageSoundMixBuffer. */
+
+#ifndef RAGE_SOUND_MIX_KERNELS_H
+#define RAGE_SOUND_MIX_KERNELS_H
+
+/**
+ * @brief The loops that mix sounds together and convert the result.
+ *
+ * Every set of kernels produces output that is bit-identical to the scalar
+ * set, so which one is picked only changes how fast mixing is. */
+namespace RageSoundMixKernels
+{
+	/** @brief The number of input frames each polyphase filter phase looks at. */
+	const int POLYPHASE_TAPS = 8;
+
+	struct Kernels
+	{
+		const char *szName;
+		/** @brief pDest[i] += pSrc[i]. */
+		void (*Accumulate)( float *pDest, const float *pSrc, unsigned iSamples );
+		/** @brief Clamp to [-1,+1], scale to 16 bits and round to nearest. */
+		void (*ConvertToInt16)( int16_t *pDest, const float *pSrc, unsigned iSamples );
+		/** @brief Split interleaved frames into one buffer per channel. */
+		void (*Deinterlace)( float **pDest, const float *pSrc, unsigned iFrames, int iChannels );
+		/**
+		 * @brief Filter one output frame of interleaved samples.
+		 *
+		 * pOut[ch] is the sum of pHistory[j*iChannels+ch]*pFilter[j] over the
+		 * POLYPHASE_TAPS input frames.  The products are always added up in the
+		 * same order, so this is bit-identical across kernels, too. */
+		void (*PolyphaseFrame)( float *pOut, const float *pHistory, const float *pFilter, int iChannels );
+	};
+
+	/** @brief The fastest kernels this CPU supports. */
+	const Kernels &Get();
+	const Kernels &GetScalar();
+	/** @brief Every set of kernels this CPU supports, scalar first. */
+	void GetSupported( vector<const Kernels *> &vOut );
+}
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
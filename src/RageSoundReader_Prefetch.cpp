@@ -0,0 +1,157 @@
+#include "global.h"
+#include "RageSoundReader_Prefetch.h"
+#include "RageSoundReader_FileReader.h"
+#include "RageSoundUtil.h"
+#include "RageUtil.h"
+
+#define framesize (sizeof(int16_t) * GetNumChannels())
+
+RageSoundReader_Prefetch *RageSoundReader_Prefetch::Prefetch( const RString &sPath, float fStartSeconds, float fSeconds, RString &sError )
+{
+	RageSoundReader *pSource = RageSoundReader_FileReader::OpenFile( sPath, sError );
+	if( pSource == nullptr )
+		return nullptr;
+
+	const int iStartFrame = max( lrintf(fStartSeconds * pSource->GetSampleRate()), 0L );
+	if( iStartFrame != 0 && pSource->SetPosition(iStartFrame) <= 0 )
+	{
+		sError = ssprintf( "couldn't seek to %.3f", fStartSeconds );
+		delete pSource;
+		return nullptr;
+	}
+
+	RageSoundReader_Prefetch *pRet = new RageSoundReader_Prefetch( pSource, iStartFrame );
+	const unsigned iChannels = pSource->GetNumChannels();
+	int iFramesLeft = lrintf( fSeconds * pSource->GetSampleRate() );
+	pRet->m_Buffer.Get()->reserve( iFramesLeft * sizeof(int16_t) * iChannels );
+	while( iFramesLeft > 0 )
+	{
+		float buffer[1024];
+		int iGot = pSource->Read( buffer, min(iFramesLeft, int(ARRAYLEN(buffer) / iChannels)) );
+		if( iGot == END_OF_FILE )
+			break;
+		if( iGot < 0 )
+		{
+			sError = pSource->GetError();
+			delete pRet;
+			return nullptr;
+		}
+
+		int16_t buffer16[1024];
+		RageSoundUtil::ConvertFloatToNativeInt16( buffer, buffer16, iGot * iChannels );
+		pRet->m_Buffer.Get()->append( (char *) buffer16, (char *) (buffer16 + iGot * iChannels) );
+		iFramesLeft -= iGot;
+	}
+
+	if( pRet->m_Buffer->empty() )
+	{
+		sError = "nothing to prefetch";
+		delete pRet;
+		return nullptr;
+	}
+
+	return pRet;
+}
+
+RageSoundReader_Prefetch::RageSoundReader_Prefetch( RageSoundReader *pSource, int iStartFrame ):
+	RageSoundReader_Filter( pSource ),
+	m_Buffer( new RString ),
+	m_iStartFrame( iStartFrame ),
+	m_bInWindow( true ),
+	m_iPosition( iStartFrame ),
+	m_bSourceAtWindowEnd( true )
+{
+}
+
+RageSoundReader_Prefetch *RageSoundReader_Prefetch::Copy() const
+{
+	RageSoundReader_Prefetch *pRet = new RageSoundReader_Prefetch( *this );
+
+	/* The copy has its own source, which isn't where ours is. */
+	pRet->m_bSourceAtWindowEnd = false;
+	if( !pRet->m_bInWindow )
+		pRet->m_pSource->SetPosition( GetNextSourceFrame() );
+	return pRet;
+}
+
+int RageSoundReader_Prefetch::GetWindowFrames() const
+{
+	return m_Buffer->size() / framesize;
+}
+
+int RageSoundReader_Prefetch::SetPosition( int iFrame )
+{
+	const int iEndFrame = m_iStartFrame + GetWindowFrames();
+	if( iFrame >= m_iStartFrame && iFrame < iEndFrame )
+	{
+		m_bInWindow = true;
+		m_iPosition = iFrame;
+		return 1;
+	}
+
+	m_bInWindow = false;
+	if( iFrame == iEndFrame && m_bSourceAtWindowEnd )
+		return 1;
+
+	m_bSourceAtWindowEnd = false;
+	return m_pSource->SetPosition( iFrame );
+}
+
+int RageSoundReader_Prefetch::Read( float *pBuffer, int iFrames )
+{
+	if( !m_bInWindow )
+	{
+		m_bSourceAtWindowEnd = false;
+		return m_pSource->Read( pBuffer, iFrames );
+	}
+
+	const int iEndFrame = m_iStartFrame + GetWindowFrames();
+	iFrames = min( iFrames, iEndFrame - m_iPosition );
+	const int16_t *pIn = (const int16_t *) (m_Buffer->data() + (m_iPosition - m_iStartFrame) * framesize);
+	RageSoundUtil::ConvertNativeInt16ToFloat( pIn, pBuffer, iFrames * GetNumChannels() );
+	m_iPosition += iFrames;
+
+	if( m_iPosition == iEndFrame )
+	{
+		/* Carry on from the file.  If the window ran to the end of the
+		 * file, the next read will return END_OF_FILE. */
+		m_bInWindow = false;
+		if( !m_bSourceAtWindowEnd )
+			m_pSource->SetPosition( iEndFrame );
+		m_bSourceAtWindowEnd = true;
+	}
+
+	return iFrames;
+}
+
+int RageSoundReader_Prefetch::GetNextSourceFrame() const
+{
+	if( m_bInWindow )
+		return m_iPosition;
+	return m_pSource->GetNextSourceFrame();
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
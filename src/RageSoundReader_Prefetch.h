@@ -0,0 +1,78 @@
+/* RageSoundReader_Prefetch - Hold a window of a sound in memory, ahead of time. */
+
+#ifndef RAGE_SOUND_READER_PREFETCH_H
+#define RAGE_SOUND_READER_PREFETCH_H
+
+#include "RageSoundReader_Filter.h"
+
+/**
+ * @brief A file reader with a stretch of it already decoded.
+ *
+ * Prefetch() opens a file, seeks it and decodes a few seconds into memory,
+ * which is the slow part of starting a sound.  Reads inside that window are
+ * served from memory; once they run past it, they continue from the file,
+ * which was left positioned at the end of the window.  Seeking anywhere
+ * else just seeks the file.
+ *
+ * The reader starts out positioned at the start of the window.
+ */
+class RageSoundReader_Prefetch: public RageSoundReader_Filter
+{
+public:
+	/* Return nullptr and set sError on failure. */
+	static RageSoundReader_Prefetch *Prefetch( const RString &sPath, float fStartSeconds, float fSeconds, RString &sError );
+
+	virtual int SetPosition( int iFrame );
+	virtual int Read( float *pBuffer, int iFrames );
+	virtual int GetNextSourceFrame() const;
+
+	/* Bytes held in memory. */
+	size_t GetMemoryUsage() const { return m_Buffer->size(); }
+
+	RageSoundReader_Prefetch *Copy() const;
+	~RageSoundReader_Prefetch() { }
+
+private:
+	RageSoundReader_Prefetch( RageSoundReader *pSource, int iStartFrame );
+
+	int GetWindowFrames() const;
+
+	/* int16 samples. */
+	AutoPtrCopyOnWrite<RString> m_Buffer;
+	int m_iStartFrame;
+
+	/* If true, we're reading from m_Buffer, and m_iPosition is the next frame. */
+	bool m_bInWindow;
+	int m_iPosition;
+
+	/* If true, the source hasn't been touched since the window was read, so
+	 * reading on from the end of the window doesn't need a seek. */
+	bool m_bSourceAtWindowEnd;
+};
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -4,6 +4,9 @@
  *
  * Each conversion ratio uses some memory, but the resulting table is
  * shared, so the memory overhead per stream is negligible.
+ *
+ * All channels are filtered together, a frame at a time, by the
+ * RageSoundMixKernels picked for this CPU.
  */
 #include "global.h"
 #include "RageSoundReader_Resample_Good.h"
@@ -11,11 +14,13 @@
 #include "RageUtil.h"
 #include "RageMath.h"
 #include "RageThreads.h"
+#include "RageSoundMixKernels.h"
 
 #include <numeric>
 
 /* Filter length.  This must be a power of 2. */
 #define L 8
+static_assert( L == RageSoundMixKernels::POLYPHASE_TAPS, "the mix kernels filter L taps" );
 
 namespace
 {
@@ -177,20 +182,23 @@ struct PolyphaseFilter
 {
 	struct State
 	{
-		State( int iUpFactor ):
-			m_fBuf( L * 2 )
+		State( int iUpFactor, int iChannels ):
+			m_fBuf( L * 2 * iChannels )
 		{
 			m_iPolyIndex = iUpFactor-1;
 			m_iFilled = 0;
 			m_iBufNext = 0;
+			m_iChannels = iChannels;
 		}
 
 		int m_iPolyIndex;
 		int m_iFilled;
+		int m_iChannels;
 
-		/* This buffer is duplicated.  If the circular buffer is size L, the actual buffer
-		 * is size L*2, and data at buf[N] is also at buf[N+L].  That way, we can access
-		 * up to buf[N*2-1] without having to wrap. */
+		/* This buffer holds interleaved frames, and is duplicated.  If the circular
+		 * buffer is L frames, the actual buffer is L*2 frames, and the frame at buf[N]
+		 * is also at buf[N+L].  That way, we can access up to buf[N*2-1] without
+		 * having to wrap. */
 		AlignedBuffer<float> m_fBuf;
 		int m_iBufNext;
 	};
@@ -203,8 +211,8 @@ struct PolyphaseFilter
 	}
 
 	void Generate( const float *pFIR );
-	int RunPolyphaseFilter( State &State, const float *pIn, int iSamplesIn, int iDownFactor,
-			float *pOut, int iSamplesOut, int iSampleStride ) const;
+	int RunPolyphaseFilter( State &State, const float *pIn, int iFramesIn, int iDownFactor,
+			float *pOut, int iFramesOut ) const;
 	int GetLatency() const { return L/2; }
 
 	int NumInputsForOutputSamples( const State &State, int iOut, int iDownFactor ) const;
@@ -292,15 +300,17 @@ void PolyphaseFilter::Generate( const float *pFIR )
  */
 int PolyphaseFilter::RunPolyphaseFilter(
 		State &State,
-		const float *pIn, int iSamplesIn, int iDownFactor,
-		float *pOut, int iSamplesOut,
-		int iSampleStride ) const
+		const float *pIn, int iFramesIn, int iDownFactor,
+		float *pOut, int iFramesOut ) const
 {
-	ASSERT( iSamplesIn >= 0 );
+	ASSERT( iFramesIn >= 0 );
 
+	const int iChannels = State.m_iChannels;
+	const RageSoundMixKernels::Kernels &Kernels = RageSoundMixKernels::Get();
 	float *pOutOrig = pOut;
-	const float *pInEnd = pIn + iSamplesIn*iSampleStride;
-	const float *pOutEnd = pOut + iSamplesOut*iSampleStride;
+	const float *pInEnd = pIn + iFramesIn*iChannels;
+	const float *pOutEnd = pOut + iFramesOut*iChannels;
+	float *pBuf = State.m_fBuf;
 	
 	int iFilled = State.m_iFilled;
 	int iPolyIndex = State.m_iPolyIndex;
@@ -311,26 +321,26 @@ int PolyphaseFilter::RunPolyphaseFilter(
 			if( pIn == pInEnd )
 				break;
 
-			State.m_fBuf[State.m_iBufNext] = *pIn;
-			State.m_fBuf[State.m_iBufNext + L] = *pIn;
+			float *pFrame = &pBuf[State.m_iBufNext*iChannels];
+			for( int ch = 0; ch < iChannels; ++ch )
+			{
+				pFrame[ch] = pIn[ch];
+				pFrame[L*iChannels + ch] = pIn[ch];
+			}
 			++State.m_iBufNext;
 			State.m_iBufNext &= L-1;
 
-			pIn += iSampleStride;
+			pIn += iChannels;
 			++iFilled;
 			continue;
 		}
 
+		const float *pInData = &pBuf[State.m_iBufNext*iChannels];
 		while( pOut != pOutEnd )
 		{
 			const float *pCurPoly = &m_pPolyphase[iPolyIndex*L];
-			const float *pInData = &State.m_fBuf[State.m_iBufNext];
-
-			float fTot = 0;
-			for( int j = 0; j < L; ++j )
-				fTot += pInData[j]*pCurPoly[j];
-			*pOut = fTot;
-			pOut += iSampleStride;
+			Kernels.PolyphaseFrame( pOut, pInData, pCurPoly, iChannels );
+			pOut += iChannels;
 
 			iPolyIndex += iDownFactor;
 			if( iPolyIndex >= m_iUpFactor )
@@ -344,7 +354,7 @@ int PolyphaseFilter::RunPolyphaseFilter(
 	State.m_iPolyIndex = iPolyIndex;
 
 	int iRetSamples = pOut - pOutOrig;
-	int iRetFrames = iRetSamples / iSampleStride;
+	int iRetFrames = iRetSamples / iChannels;
 	return iRetFrames;
 }
 
@@ -453,7 +463,8 @@ namespace PolyphaseFilterCache
 
 /*
  * Interface to PolyphaseFilter, providing a simple resampling interface.  This handles
- * reuse of PolyphaseFilters.  This does not handle delay, flushing, or multiple channels.
+ * reuse of PolyphaseFilters, and runs every channel of interleaved data.  This does not
+ * handle delay or flushing.
  */
 class RageSoundResampler_Polyphase
 {
@@ -461,7 +472,7 @@ public:
 	/* Note that going outside of [iMinDownFactor,iMaxDownFactor] while resampling isn't
 	 * fatal.  It'll only cause aliasing, by not having a LPF that's low enough, or cause
 	 * too much filtering, by not having a LPF that's high enough. */
-	RageSoundResampler_Polyphase( int iUpFactor, int iMinDownFactor, int iMaxDownFactor )
+	RageSoundResampler_Polyphase( int iUpFactor, int iMinDownFactor, int iMaxDownFactor, int iChannels )
 	{
 		/* Cache filters between iMinDownFactor and iMaxDownFactor.  Do them in 
 		 * iFilterIncrement increments; we'll round down to the closest match
@@ -479,7 +490,7 @@ public:
 
 		SetDownFactor( iUpFactor );
 
-		m_pState = new PolyphaseFilter::State( iUpFactor );
+		m_pState = new PolyphaseFilter::State( iUpFactor, iChannels );
 	}
 
 	~RageSoundResampler_Polyphase()
@@ -493,15 +504,16 @@ public:
 		m_pPolyphase = GetFilter( m_iDownFactor );
 	}
 
-	int Run( const float *pIn, int iSamplesIn, float *pOut, int iSamplesOut, int iSampleStride ) const
+	int Run( const float *pIn, int iFramesIn, float *pOut, int iFramesOut ) const
 	{
-		return m_pPolyphase->RunPolyphaseFilter( *m_pState, pIn, iSamplesIn, m_iDownFactor, pOut, iSamplesOut, iSampleStride );
+		return m_pPolyphase->RunPolyphaseFilter( *m_pState, pIn, iFramesIn, m_iDownFactor, pOut, iFramesOut );
 	}
 
 	void Reset()
 	{
+		int iChannels = m_pState->m_iChannels;
 		delete m_pState;
-		m_pState = new PolyphaseFilter::State( m_iUpFactor );
+		m_pState = new PolyphaseFilter::State( m_iUpFactor, iChannels );
 	}
 
 	int NumInputsForOutputSamples( int iOut ) const { return m_pPolyphase->NumInputsForOutputSamples(*m_pState, iOut, m_iDownFactor); }
@@ -548,7 +560,7 @@ private:
 int RageSoundReader_Resample_Good::GetNextSourceFrame() const
 {
 	int64_t iPosition = m_pSource->GetNextSourceFrame();
-	iPosition -= m_apResamplers[0]->GetFilled();
+	iPosition -= m_pResampler->GetFilled();
 
 	iPosition *= m_iSampleRate;
 	iPosition /= m_pSource->GetSampleRate();
@@ -579,14 +591,14 @@ RageSoundReader_Resample_Good::RageSoundReader_Resample_Good( RageSoundReader *p
 {
 	m_iSampleRate = iSampleRate;
 	m_fRate = -1;
+	m_pResampler = nullptr;
 	ReopenResampler();
 }
 
 /* Call this if the input position is changed or reset. */
 void RageSoundReader_Resample_Good::Reset()
 {
-	for( size_t iChannel = 0; iChannel < m_pSource->GetNumChannels(); ++iChannel )
-		m_apResamplers[iChannel]->Reset();
+	m_pResampler->Reset();
 }
 
 
@@ -612,35 +624,27 @@ void RageSoundReader_Resample_Good::GetFactors( int &iDownFactor, int &iUpFactor
 /* Call this if the sample factor changes. */
 void RageSoundReader_Resample_Good::ReopenResampler()
 {
-	for( size_t iChannel = 0; iChannel < m_apResamplers.size(); ++iChannel )
-		delete m_apResamplers[iChannel];
-	m_apResamplers.clear();
+	delete m_pResampler;
 
 	int iDownFactor, iUpFactor;
 	GetFactors( iDownFactor, iUpFactor );
 
-	for( size_t iChannel = 0; iChannel < m_pSource->GetNumChannels(); ++iChannel )
-	{
-		int iMinDownFactor = iDownFactor;
-		int iMaxDownFactor = iDownFactor;
-		if( m_fRate != -1 )
-			iMaxDownFactor *= 5;
+	int iMinDownFactor = iDownFactor;
+	int iMaxDownFactor = iDownFactor;
+	if( m_fRate != -1 )
+		iMaxDownFactor *= 5;
 
-		RageSoundResampler_Polyphase *p = new RageSoundResampler_Polyphase( iUpFactor, iMinDownFactor, iMaxDownFactor );
-		m_apResamplers.push_back( p );
-	}
+	m_pResampler = new RageSoundResampler_Polyphase( iUpFactor, iMinDownFactor, iMaxDownFactor, m_pSource->GetNumChannels() );
 
 	if( m_fRate != -1 )
 		iDownFactor = lrintf( m_fRate * iDownFactor );
 
-	for( size_t iChannel = 0; iChannel < m_apResamplers.size(); ++iChannel )
-		m_apResamplers[iChannel]->SetDownFactor( iDownFactor );
+	m_pResampler->SetDownFactor( iDownFactor );
 }
 
 RageSoundReader_Resample_Good::~RageSoundReader_Resample_Good()
 {
-	for( size_t iChannel = 0; iChannel < m_apResamplers.size(); ++iChannel )
-		delete m_apResamplers[iChannel];
+	delete m_pResampler;
 }
 
 /* iFrame is in the destination rate.  Seek the source in its own sample rate. */
@@ -653,35 +657,24 @@ int RageSoundReader_Resample_Good::SetPosition( int iFrame )
 
 int RageSoundReader_Resample_Good::Read( float *pBuf, int iFrames )
 {
-	int iChannels = m_apResamplers.size();
-
-	int iFramesRead = 0;
+	int iChannels = m_pSource->GetNumChannels();
 
 	/* If the ratio is 1:1, then we're effectively disabled, and we can read
 	 * directly into the buffer. */
 	int iDownFactor, iUpFactor;
 	GetFactors( iDownFactor, iUpFactor );
 
-	if( m_apResamplers[0]->GetFilled() == 0 && iDownFactor == iUpFactor && GetRate() == 1.0f )
+	if( m_pResampler->GetFilled() == 0 && iDownFactor == iUpFactor && GetRate() == 1.0f )
 		return m_pSource->Read( pBuf, iFrames );
 
-	{
-		int iFramesNeeded = m_apResamplers[0]->NumInputsForOutputSamples(iFrames);
-		float *pTmpBuf = (float *) alloca( iFramesNeeded * sizeof(float) * iChannels );
-		int iFramesIn = m_pSource->Read( pTmpBuf, iFramesNeeded );
-		if( iFramesIn < 0 )
-			return iFramesIn;
-
-		for( int iChannel = 0; iChannel < iChannels; ++iChannel )
-		{
-			int iGotFrames = m_apResamplers[iChannel]->Run( pTmpBuf + iChannel, iFramesIn, pBuf + iChannel, iFrames, iChannels );
-			ASSERT( iGotFrames <= iFrames );
-
-			if( iChannel == 0 )
-				iFramesRead += iGotFrames;
-		}
-	}
+	int iFramesNeeded = m_pResampler->NumInputsForOutputSamples(iFrames);
+	float *pTmpBuf = (float *) alloca( iFramesNeeded * sizeof(float) * iChannels );
+	int iFramesIn = m_pSource->Read( pTmpBuf, iFramesNeeded );
+	if( iFramesIn < 0 )
+		return iFramesIn;
 
+	int iFramesRead = m_pResampler->Run( pTmpBuf, iFramesIn, pBuf, iFrames );
+	ASSERT( iFramesRead <= iFrames );
 	return iFramesRead;
 }
 
@@ -712,8 +705,7 @@ void RageSoundReader_Resample_Good::SetRate( float fRatio )
 	/* Set m_fRate to the actual rate, after quantization by iUpFactor. */
 	m_fRate = float(iDownFactor) / iUpFactor;
 
-	for( size_t iChannel = 0; iChannel < m_apResamplers.size(); ++iChannel )
-		m_apResamplers[iChannel]->SetDownFactor( iDownFactor );
+	m_pResampler->SetDownFactor( iDownFactor );
 }
 
 float RageSoundReader_Resample_Good::GetRate() const
@@ -727,8 +719,7 @@ float RageSoundReader_Resample_Good::GetRate() const
 RageSoundReader_Resample_Good::RageSoundReader_Resample_Good( const RageSoundReader_Resample_Good &cpy ):
 	RageSoundReader_Filter(cpy)
 {
-	for( size_t i = 0; i < cpy.m_apResamplers.size(); ++i )
-		this->m_apResamplers.push_back( new RageSoundResampler_Polyphase(*cpy.m_apResamplers[i]) );
+	this->m_pResampler = new RageSoundResampler_Polyphase( *cpy.m_pResampler );
 	this->m_iSampleRate = cpy.m_iSampleRate;
 	this->m_fRate = cpy.m_fRate;
 }
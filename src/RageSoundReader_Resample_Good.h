@@ -39,7 +39,7 @@ private:
 	void ReopenResampler();
 	void GetFactors( int &iDownFactor, int &iUpFactor ) const;
 
-	vector<RageSoundResampler_Polyphase *> m_apResamplers; /* one per channel */
+	RageSoundResampler_Polyphase *m_pResampler; /* all channels, interleaved */
 
 	int m_iSampleRate;
 	float m_fRate;
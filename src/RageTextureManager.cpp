@@ -25,8 +25,12 @@
 #include "RageUtil.h"
 #include "RageLog.h"
 #include "RageDisplay.h"
+#include "RageThreads.h"
+#include "RageTimer.h"
 #include "ActorUtil.h"
+#include "Preference.h"
 
+#include <deque>
 #include <map>
 
 RageTextureManager*		TEXTUREMAN		= nullptr; // global and accessible from anywhere in our program
@@ -38,12 +42,173 @@ namespace
 	map<RageTexture*, RageTextureID> m_texture_ids_by_pointer;
 };
 
+/* Textures loaded with LoadTextureAsync are decoded on TextureLoadThreads
+ * threads, and uploaded in Update(), spending at most
+ * TextureUploadMillisecondsPerFrame on it each frame (but always uploading at
+ * least one).  With no threads, LoadTextureAsync loads right away. */
+static Preference<int> g_iTextureLoadThreads( "TextureLoadThreads", 2 );
+static Preference<float> g_fTextureUploadMilliseconds( "TextureUploadMillisecondsPerFrame", 4.0f );
+
+namespace
+{
+	struct PendingTexture
+	{
+		PendingTexture(): pTexture(nullptr), bDecoded(false) { }
+
+		/* Set to nullptr if the texture is deleted before it's finished.  This
+		 * is only touched on the main thread. */
+		RageBitmapTexture *pTexture;
+		RageTextureID ID;
+		RageBitmapTexture::DisplayCaps caps;
+		RageBitmapTexture::DecodedImage img;
+		bool bDecoded;
+	};
+
+	class TextureLoadQueue
+	{
+	public:
+		TextureLoadQueue(): m_Event("TextureLoadQueue"), m_bShutdown(false) { }
+		~TextureLoadQueue() { Shutdown(); }
+
+		void Add( PendingTexture *p )
+		{
+			StartThreads();
+			m_Event.Lock();
+			m_Queue.push_back( p );
+			m_Event.Signal();
+			m_Event.Unlock();
+		}
+
+		/* Make sure p is decoded: take it off the queue and decode it here if
+		 * no thread has started on it, or wait for the thread that has. */
+		void Finish( PendingTexture *p )
+		{
+			m_Event.Lock();
+			deque<PendingTexture *>::iterator it = find( m_Queue.begin(), m_Queue.end(), p );
+			if( it != m_Queue.end() )
+			{
+				m_Queue.erase( it );
+				m_Event.Unlock();
+				RageBitmapTexture::Decode( p->ID, p->caps, p->img );
+				p->bDecoded = true;
+				return;
+			}
+
+			while( !p->bDecoded )
+				m_Event.Wait();
+			m_Decoded.erase( find(m_Decoded.begin(), m_Decoded.end(), p) );
+			m_Event.Unlock();
+		}
+
+		/* Forget about p.  Returns true if it was still queued, and can be
+		 * deleted; otherwise it'll come back from PopDecoded. */
+		bool Cancel( PendingTexture *p )
+		{
+			LockMut( m_Event );
+			deque<PendingTexture *>::iterator it = find( m_Queue.begin(), m_Queue.end(), p );
+			if( it == m_Queue.end() )
+				return false;
+			m_Queue.erase( it );
+			return true;
+		}
+
+		PendingTexture *PopDecoded()
+		{
+			LockMut( m_Event );
+			if( m_Decoded.empty() )
+				return nullptr;
+			PendingTexture *p = m_Decoded.front();
+			m_Decoded.pop_front();
+			return p;
+		}
+
+		void Shutdown()
+		{
+			m_Event.Lock();
+			m_bShutdown = true;
+			m_Event.Broadcast();
+			m_Event.Unlock();
+			for (RageThread *pThread : m_apThreads)
+			{
+				pThread->Wait();
+				delete pThread;
+			}
+			m_apThreads.clear();
+
+			for (PendingTexture *p : m_Queue)
+				delete p;
+			m_Queue.clear();
+			for (PendingTexture *p : m_Decoded)
+				delete p;
+			m_Decoded.clear();
+		}
+
+	private:
+		void StartThreads()
+		{
+			while( (int) m_apThreads.size() < g_iTextureLoadThreads.Get() )
+			{
+				RageThread *pThread = new RageThread;
+				pThread->SetName( ssprintf("Texture load thread %u", unsigned(m_apThreads.size())) );
+				pThread->Create( LoadThread_start, this );
+				m_apThreads.push_back( pThread );
+			}
+		}
+
+		static int LoadThread_start( void *p ) { ((TextureLoadQueue *) p)->LoadThread(); return 0; }
+		void LoadThread()
+		{
+			m_Event.Lock();
+			for(;;)
+			{
+				while( m_Queue.empty() && !m_bShutdown )
+					m_Event.Wait();
+				if( m_bShutdown )
+					break;
+
+				/* Newest first: when the music wheel is moving, the most recent
+				 * request is the one on the screen. */
+				PendingTexture *p = m_Queue.back();
+				m_Queue.pop_back();
+				m_Event.Unlock();
+
+				RageBitmapTexture::Decode( p->ID, p->caps, p->img );
+
+				m_Event.Lock();
+				p->bDecoded = true;
+				m_Decoded.push_back( p );
+				m_Event.Broadcast();
+			}
+			m_Event.Unlock();
+		}
+
+		RageEvent m_Event;
+		deque<PendingTexture *> m_Queue;
+		deque<PendingTexture *> m_Decoded;
+		vector<RageThread *> m_apThreads;
+		bool m_bShutdown;
+	};
+
+	TextureLoadQueue *g_pTextureLoadQueue = nullptr;
+	/* Textures that haven't been uploaded yet.  This is only touched on the
+	 * main thread. */
+	map<RageTexture*, PendingTexture*> g_PendingTextures;
+};
+
 RageTextureManager::RageTextureManager():
 	m_iNoWarnAboutOddDimensions(0),
 	m_TexturePolicy(RageTextureID::TEX_DEFAULT) {}
 
 RageTextureManager::~RageTextureManager()
 {
+	if( g_pTextureLoadQueue != nullptr )
+	{
+		for (auto const &p : g_PendingTextures)
+			p.second->pTexture = nullptr;
+		g_PendingTextures.clear();
+		SAFE_DELETE( g_pTextureLoadQueue );
+	}
+
 	for (std::pair<RageTextureID const &, RageTexture *> i : m_mapPathToTexture)
 	{
 		RageTexture* pTexture = i.second;
@@ -57,6 +222,8 @@ RageTextureManager::~RageTextureManager()
 
 void RageTextureManager::Update( float fDeltaTime )
 {
+	UploadPendingTextures();
+
 	for(std::pair<RageTextureID const &, RageTexture *> i : m_textures_to_update)
 	{
 		RageTexture* pTexture = i.second;
@@ -153,6 +320,9 @@ RageTexture* RageTextureManager::LoadTextureInternal( RageTextureID ID )
 		/* Found the texture.  Just increase the refcount and return it. */
 		RageTexture* pTexture = p->second;
 		pTexture->m_iRefCount++;
+
+		/* If it's still loading in the background, the caller can't wait. */
+		FinishPendingTexture( pTexture );
 		return pTexture;
 	}
 
@@ -187,6 +357,101 @@ RageTexture* RageTextureManager::LoadTexture( RageTextureID ID )
 	return pTexture;
 }
 
+RageTexture* RageTextureManager::LoadTextureAsync( RageTextureID ID )
+{
+	AdjustTextureID( ID );
+
+	/* If it's already loading, share it without waiting for it. */
+	std::map<RageTextureID, RageTexture*>::iterator p = m_mapPathToTexture.find( ID );
+	if( p != m_mapPathToTexture.end() && !IsTextureReady(p->second) )
+	{
+		p->second->m_iRefCount++;
+		return p->second;
+	}
+
+	/* Movies, and the special textures, are always loaded right away. */
+	if( g_iTextureLoadThreads.Get() <= 0 ||
+		p != m_mapPathToTexture.end() ||
+		ID.filename == g_sDefaultTextureName ||
+		ID.filename == g_ScreenTextureName ||
+		ActorUtil::GetFileType(ID.filename) == FT_Movie )
+	{
+		return LoadTexture( ID );
+	}
+
+	if( g_pTextureLoadQueue == nullptr )
+		g_pTextureLoadQueue = new TextureLoadQueue;
+
+	RageBitmapTexture *pTexture = new RageBitmapTexture( ID, RageBitmapTexture::DeferCreate() );
+	pTexture->m_bWasUsed = true;
+	m_mapPathToTexture[ID] = pTexture;
+	m_texture_ids_by_pointer[pTexture]= ID;
+
+	PendingTexture *pPending = new PendingTexture;
+	pPending->pTexture = pTexture;
+	pPending->ID = ID;
+	g_PendingTextures[pTexture] = pPending;
+	g_pTextureLoadQueue->Add( pPending );
+
+	return pTexture;
+}
+
+bool RageTextureManager::IsTextureReady( const RageTexture *pTexture ) const
+{
+	return g_PendingTextures.find( const_cast<RageTexture *>(pTexture) ) == g_PendingTextures.end();
+}
+
+bool RageTextureManager::IsTextureLoading( RageTextureID ID ) const
+{
+	AdjustTextureID( ID );
+	std::map<RageTextureID, RageTexture*>::const_iterator p = m_mapPathToTexture.find( ID );
+	return p != m_mapPathToTexture.end() && !IsTextureReady( p->second );
+}
+
+void RageTextureManager::FinishPendingTexture( RageTexture *pTexture )
+{
+	map<RageTexture*, PendingTexture*>::iterator it = g_PendingTextures.find( pTexture );
+	if( it == g_PendingTextures.end() )
+		return;
+
+	PendingTexture *p = it->second;
+	g_PendingTextures.erase( it );
+	g_pTextureLoadQueue->Finish( p );
+	p->pTexture->Create( p->img );
+	delete p;
+}
+
+void RageTextureManager::FinishAllPendingTextures()
+{
+	while( !g_PendingTextures.empty() )
+		FinishPendingTexture( g_PendingTextures.begin()->first );
+}
+
+void RageTextureManager::UploadPendingTextures()
+{
+	if( g_pTextureLoadQueue == nullptr )
+		return;
+
+	RageTimer start;
+	PendingTexture *p;
+	while( (p = g_pTextureLoadQueue->PopDecoded()) != nullptr )
+	{
+		/* The texture was deleted while it was being decoded. */
+		if( p->pTexture == nullptr )
+		{
+			delete p;
+			continue;
+		}
+
+		g_PendingTextures.erase( p->pTexture );
+		p->pTexture->Create( p->img );
+		delete p;
+
+		if( start.Ago() * 1000 >= g_fTextureUploadMilliseconds.Get() )
+			break;
+	}
+}
+
 RageTexture* RageTextureManager::CopyTexture( RageTexture *pCopy )
 {
 	++pCopy->m_iRefCount;
@@ -234,6 +499,17 @@ void RageTextureManager::DeleteTexture( RageTexture *t )
 	ASSERT( t->m_iRefCount == 0 );
 	//LOG->Trace( "RageTextureManager: deleting '%s'.", t->GetID().filename.c_str() );
 
+	map<RageTexture*, PendingTexture*>::iterator pending = g_PendingTextures.find( t );
+	if( pending != g_PendingTextures.end() )
+	{
+		PendingTexture *p = pending->second;
+		g_PendingTextures.erase( pending );
+		if( g_pTextureLoadQueue->Cancel(p) )
+			delete p;
+		else
+			p->pTexture = nullptr;
+	}
+
 	map<RageTexture*, RageTextureID>::iterator id_entry=
 		m_texture_ids_by_pointer.find(t);
 	if(id_entry != m_texture_ids_by_pointer.end())
@@ -333,6 +609,10 @@ void RageTextureManager::ReloadAll()
 	 * ton of cached data that we're not necessarily going to use. */
 	DoDelayedDelete();
 
+	/* Textures still loading in the background were decoded with the old
+	 * settings. */
+	FinishAllPendingTextures();
+
 	for (auto const & i : m_mapPathToTexture)
 	{
 		i.second->Reload();
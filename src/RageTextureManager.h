@@ -53,6 +53,15 @@ public:
 	void Update( float fDeltaTime );
 
 	RageTexture* LoadTexture( RageTextureID ID );
+	/* Start loading a texture in the background, and return it right away.
+	 * Until IsTextureReady() is true, it's a blank 1x1 placeholder.  Release
+	 * it with UnloadTexture, like any other texture.  Loading the same texture
+	 * with LoadTexture before it's ready finishes it immediately; loading it
+	 * with LoadTextureAsync doesn't. */
+	RageTexture* LoadTextureAsync( RageTextureID ID );
+	bool IsTextureReady( const RageTexture *pTexture ) const;
+	/* Return true if the texture is registered, but not ready yet. */
+	bool IsTextureLoading( RageTextureID ID ) const;
 	RageTexture* CopyTexture( RageTexture *pCopy ); // returns a ref to the same texture, not a deep copy
 	bool IsTextureRegistered( RageTextureID ID ) const;
 	void RegisterTexture( RageTextureID ID, RageTexture *p );
@@ -92,6 +101,9 @@ private:
 	enum GCType { screen_changed, delayed_delete };
 	void GarbageCollect( GCType type );
 	RageTexture* LoadTextureInternal( RageTextureID ID );
+	void FinishPendingTexture( RageTexture *pTexture );
+	void FinishAllPendingTextures();
+	void UploadPendingTextures();
 
 	RageTextureManagerPrefs m_Prefs;
 	int m_iNoWarnAboutOddDimensions;
@@ -33,6 +33,24 @@ void RageTexturePreloader::Load( const RageTextureID &ID )
 	m_apTextures.push_back( pTexture );
 }
 
+void RageTexturePreloader::LoadAsync( const RageTextureID &ID )
+{
+	ASSERT( TEXTUREMAN != nullptr );
+
+	RageTexture *pTexture = TEXTUREMAN->LoadTextureAsync( ID );
+	m_apTextures.push_back( pTexture );
+}
+
+bool RageTexturePreloader::IsReady() const
+{
+	for( unsigned i = 0; i < m_apTextures.size(); ++i )
+	{
+		if( !TEXTUREMAN->IsTextureReady(m_apTextures[i]) )
+			return false;
+	}
+	return true;
+}
+
 void RageTexturePreloader::UnloadAll()
 {
 	if( TEXTUREMAN == nullptr )
@@ -13,7 +13,12 @@ public:
 	RageTexturePreloader &operator=( const RageTexturePreloader &rhs );
 	~RageTexturePreloader();
 	void Load( const RageTextureID &ID );
+	/** @brief Like Load, but decode the texture in the background. */
+	void LoadAsync( const RageTextureID &ID );
 	void UnloadAll();
+	/** @brief Return true once every texture from LoadAsync can be used. */
+	bool IsReady() const;
+	bool IsEmpty() const { return m_apTextures.empty(); }
 	void Swap( RageTexturePreloader &rhs ) { swap( m_apTextures, rhs.m_apTextures ); }
 
 private:
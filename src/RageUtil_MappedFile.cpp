@@ -0,0 +1,221 @@
+#include "global.h"
+#include "RageUtil_MappedFile.h"
+#include "RageFile.h"
+#include "RageFileManager.h"
+#include "RageFileDriverDirectHelpers.h"
+#include "RageUtil.h"
+
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#if defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#if defined(LINUX)
+#include <sys/vfs.h>
+#elif defined(MACOSX)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+#endif
+
+RageFileMapping::RageFileMapping():
+	m_pData(nullptr), m_iSize(0), m_pMapping(nullptr)
+#if defined(WIN32)
+	, m_hMapping(nullptr)
+#endif
+{
+}
+
+RageFileMapping::~RageFileMapping()
+{
+	Close();
+}
+
+bool RageFileMapping::Open( const RString &sPath, RString &sError )
+{
+	Close();
+
+	/* ResolvePath hands back the path unchanged if it isn't on a directory
+	 * mount; there's nothing to map in that case. */
+	const RString sRealPath = FILEMAN->ResolvePath( sPath );
+	if( sRealPath != sPath && MapRealFile(sRealPath) )
+		return true;
+
+	RageFile f;
+	if( !f.Open(sPath, RageFile::READ) )
+	{
+		sError = f.GetError();
+		return false;
+	}
+	if( f.Read(m_sBuffer, f.GetFileSize()) == -1 )
+	{
+		sError = f.GetError();
+		m_sBuffer = RString();
+		return false;
+	}
+
+	/* An empty file still counts as open. */
+	static const char cEmpty = 0;
+	m_pData = m_sBuffer.empty()? &cEmpty: m_sBuffer.data();
+	m_iSize = m_sBuffer.size();
+	return true;
+}
+
+bool RageFileMapping::Map( const RString &sPath )
+{
+	Close();
+
+	const RString sRealPath = FILEMAN->ResolvePath( sPath );
+	return sRealPath != sPath && MapRealFile( sRealPath );
+}
+
+/* A read error in a mapping isn't an error return; it's SIGBUS (or an
+ * in-page exception on Windows) wherever the data happens to be touched.
+ * Only map files on fixed, local disks, where that's as unlikely as a crash
+ * reading the file normally.  Network shares and the filesystems removable
+ * media usually carry are read through RageFile instead. */
+static bool IsOnLocalDisk( int fd, const RString &sRealPath )
+{
+#if defined(WIN32)
+	/* UNC paths are network shares. */
+	if( sRealPath.size() < 3 || sRealPath[1] != ':' )
+		return false;
+	const UINT iType = GetDriveType( sRealPath.substr(0, 2) + "\\" );
+	return iType == DRIVE_FIXED || iType == DRIVE_RAMDISK;
+#elif defined(LINUX)
+	struct statfs fs;
+	if( fstatfs(fd, &fs) == -1 )
+		return false;
+	switch( (unsigned long) fs.f_type )
+	{
+	case 0x6969:		/* NFS */
+	case 0x517B:		/* SMB */
+	case 0xFE534D42:	/* SMB2 */
+	case 0xFF534D42:	/* CIFS */
+	case 0x65735546:	/* FUSE (sshfs, ntfs-3g, exfat-fuse, ...) */
+	case 0x01021997:	/* 9P */
+	case 0x00C36400:	/* Ceph */
+	case 0x4D44:		/* FAT */
+	case 0x2011BAB0:	/* exFAT */
+	case 0x9660:		/* ISO 9660 */
+	case 0x15013346:	/* UDF */
+		return false;
+	default:
+		return true;
+	}
+#elif defined(MACOSX)
+	struct statfs fs;
+	if( fstatfs(fd, &fs) == -1 )
+		return false;
+	if( !(fs.f_flags & MNT_LOCAL) )
+		return false;
+#if defined(MNT_REMOVABLE)
+	if( fs.f_flags & MNT_REMOVABLE )
+		return false;
+#endif
+	return true;
+#else
+	return true;
+#endif
+}
+
+bool RageFileMapping::MapRealFile( const RString &sRealPath )
+{
+	int fd = DoOpen( sRealPath, O_RDONLY|O_BINARY, 0 );
+	if( fd == -1 )
+		return false;
+
+	if( !IsOnLocalDisk(fd, sRealPath) )
+	{
+		close( fd );
+		return false;
+	}
+
+	struct stat st;
+	if( fstat(fd, &st) == -1 || st.st_size <= 0 )
+	{
+		/* Empty files can't be mapped; let the caller read them normally. */
+		close( fd );
+		return false;
+	}
+	const size_t iSize = size_t(st.st_size);
+
+#if defined(WIN32)
+	HANDLE hFile = (HANDLE) _get_osfhandle( fd );
+	HANDLE hMapping = CreateFileMapping( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	void *pMapping = nullptr;
+	if( hMapping != nullptr )
+	{
+		pMapping = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+		if( pMapping == nullptr )
+			CloseHandle( hMapping );
+	}
+	/* The mapping keeps its own reference to the file. */
+	close( fd );
+	if( pMapping == nullptr )
+		return false;
+	m_hMapping = hMapping;
+#else
+	void *pMapping = mmap( nullptr, iSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if( pMapping == MAP_FAILED )
+		return false;
+#endif
+
+	m_pMapping = pMapping;
+	m_pData = (const char *) pMapping;
+	m_iSize = iSize;
+	return true;
+}
+
+void RageFileMapping::Close()
+{
+	if( m_pMapping != nullptr )
+	{
+#if defined(WIN32)
+		UnmapViewOfFile( m_pMapping );
+		CloseHandle( (HANDLE) m_hMapping );
+		m_hMapping = nullptr;
+#else
+		munmap( m_pMapping, m_iSize );
+#endif
+		m_pMapping = nullptr;
+	}
+
+	/* Be careful; clear() doesn't always free the allocated memory. */
+	m_sBuffer = RString();
+	m_pData = nullptr;
+	m_iSize = 0;
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -0,0 +1,73 @@
+/* RageFileMapping - read-only view of a whole file, memory-mapped when possible. */
+
+#ifndef RAGE_UTIL_MAPPED_FILE_H
+#define RAGE_UTIL_MAPPED_FILE_H
+
+/* Files that live in a plain directory mount on a local disk are mapped
+ * directly; anything else (zips, memory files, network shares, removable
+ * media, etc.) is read into a single buffer through RageFile, so callers
+ * always see one contiguous block either way. */
+class RageFileMapping
+{
+public:
+	RageFileMapping();
+	~RageFileMapping();
+
+	/* sPath is a RageFileManager path.  Returns false and sets sError if the
+	 * file can't be opened. */
+	bool Open( const RString &sPath, RString &sError );
+	/* Like Open, but only succeeds if the file can be mapped; the file is
+	 * never read into memory.  Files on network shares or removable media
+	 * aren't mapped, since a read error there would be a crash. */
+	bool Map( const RString &sPath );
+	void Close();
+
+	bool IsOpen() const { return m_pData != nullptr; }
+	bool IsMapped() const { return m_pMapping != nullptr; }
+	const char *GetData() const { return m_pData; }
+	size_t GetSize() const { return m_iSize; }
+
+private:
+	bool MapRealFile( const RString &sRealPath );
+
+	const char *m_pData;
+	size_t m_iSize;
+
+	/* Set if the file is mapped, otherwise m_sBuffer holds the contents. */
+	void *m_pMapping;
+#if defined(WIN32)
+	void *m_hMapping;
+#endif
+	RString m_sBuffer;
+
+	// Swallow up warnings. If they must be used, define them.
+	RageFileMapping& operator=(const RageFileMapping& rhs);
+	RageFileMapping(const RageFileMapping& rhs);
+};
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -334,6 +334,11 @@ void ScreenSelectMusic::CheckBackgroundRequests( bool bForce )
 		if( m_Banner.GetTweenTimeLeft() > 0 )
 			return;
 
+		/* If the banner was prefetched and is still being decoded, it'll be
+		 * ready in a moment; don't stall loading it here. */
+		if( !bForce && TEXTUREMAN->IsTextureLoading( Sprite::SongBannerTexture(g_sBannerPath) ) )
+			return;
+
 		RString sPath;
 		bool bFreeCache = false;
 		if( TEXTUREMAN->IsTextureRegistered( Sprite::SongBannerTexture(g_sBannerPath) ) )
@@ -48,7 +48,7 @@
  * @brief The internal version of the cache for StepMania.
  *
  * Increment this value to invalidate the current cache. */
-const int FILE_CACHE_VERSION = 227;
+const int FILE_CACHE_VERSION = 229;
 
 /** @brief How long does a song sample last by default? */
 const float DEFAULT_MUSIC_SAMPLE_LENGTH = 12.f;
@@ -255,11 +255,6 @@ const BackgroundChange &Song::GetBackgroundAtBeat( BackgroundLayer iLayer, float
 }
 
 
-RString Song::GetCacheFilePath() const
-{
-	return SongCacheIndex::GetCacheFilePath( "Songs", m_sSongDir );
-}
-
 // Get a path to the SM containing data for this song. It might be a cache file.
 const RString &Song::GetSongFilePath() const
 {
@@ -269,10 +264,6 @@ const RString &Song::GetSongFilePath() const
 	return m_sSongFileName;
 }
 
-/* Hack: This should be a parameter to TidyUpData, but I don't want to pull in
- * <set> into Song.h, which is heavily used. */
-static set<RString> BlacklistedImages;
-
 /* If PREFSMAN->m_bFastLoad is true, always load from cache if possible.
  * Don't read the contents of sDir if we can avoid it. That means we can't call
  * HasMusic(), HasBanner() or GetHashForDirectory().
@@ -290,6 +281,9 @@ bool Song::LoadFromSongDir(RString sDir, bool load_autosave, ProfileSlot from_pr
 	// save song dir
 	m_sSongDir = sDir;
 
+	/* Songs are loaded on several threads at once, so this is per load. */
+	set<RString> BlacklistedImages;
+
 	bool use_cache = true;
 
 	// save group name
@@ -308,43 +302,38 @@ bool Song::LoadFromSongDir(RString sDir, bool load_autosave, ProfileSlot from_pr
 		use_cache= false;
 	}
 
-	RString cache_file_path;
-	if(m_LoadedFromProfile == ProfileSlot_Invalid)
+	if(use_cache && load_autosave)
+	{ use_cache= false; }
+
+	if(use_cache)
 	{
 		// First, look in the cache for this song (without loading NoteData)
 		unsigned uCacheHash = SONGINDEX->GetCacheHash(m_sSongDir);
-		cache_file_path = GetCacheFilePath();
-
-		if( !DoesFileExist(cache_file_path) )
+		if(uCacheHash == 0)
 		{ use_cache = false; }
-		else if(!PREFSMAN->m_bFastLoad && GetHashForDirectory(m_sSongDir) != uCacheHash)
+		else if(!PREFSMAN->m_bFastLoad && !SONGINDEX->IsCacheCurrent(m_sSongDir) &&
+			GetHashForDirectory(m_sSongDir) != uCacheHash)
 		{ use_cache = false; } // this cache is out of date
-		else if(load_autosave)
-		{ use_cache= false; }
+		else if(!SONGINDEX->LoadSongFromCache(*this, uCacheHash))
+		{
+			// A partially read entry may have left steps behind.
+			const RString sGroupName = m_sGroupName;
+			Reset();
+			m_sSongDir = sDir;
+			m_sGroupName = sGroupName;
+			use_cache = false;
+		}
 	}
 
 	if(use_cache)
 	{
-		/*
-		LOG->Trace("Loading '%s' from cache file '%s'.",
-				   m_sSongDir.c_str(),
-				   GetCacheFilePath().c_str());
-		*/
-		SSCLoader loaderSSC;
-		bool bLoadedFromSSC = loaderSSC.LoadFromSimfile( cache_file_path, *this, true );
-		if( !bLoadedFromSSC )
-		{
-			// load from .sm
-			SMLoader loaderSM;
-			loaderSM.LoadFromSimfile( cache_file_path, *this, true );
-			loaderSM.TidyUpData( *this, true );
-		}
+		TidyUpData(true, true, &BlacklistedImages);
 		if(m_sMainTitle == "" || (m_sMusicFile == "" && m_vsKeysoundFile.empty()))
 		{
 			LOG->Warn("Main title or music file for '%s' came up blank, forced to fall back on TidyUpData to fix title and paths.  Do not use # or ; in a song title.", m_sSongDir.c_str());
 			// Tell TidyUpData that it's not loaded from the cache because it needs
 			// to hit the song folder to find the files that weren't found. -Kyz
-			TidyUpData(false, false);
+			TidyUpData(false, false, &BlacklistedImages);
 		}
 	}
 	else
@@ -377,7 +366,7 @@ bool Song::LoadFromSongDir(RString sDir, bool load_autosave, ProfileSlot from_pr
 		// loading time. -Kyz
 		LoadEditsFromSongDir(sDir);
 
-		TidyUpData(false, true);
+		TidyUpData(false, true, &BlacklistedImages);
 
 		// Don't save a cache file if the autosave is being loaded, because the
 		// cache file would contain the autosave filename. -Kyz
@@ -387,8 +376,7 @@ bool Song::LoadFromSongDir(RString sDir, bool load_autosave, ProfileSlot from_pr
 		if(!load_autosave && m_LoadedFromProfile == ProfileSlot_Invalid)
 		{
 			// save a cache file so we don't have to parse it all over again next time
-			if(!SaveToCacheFile())
-			{ cache_file_path = RString(); }
+			SaveToCacheFile();
 		}
 	}
 
@@ -459,7 +447,7 @@ bool Song::ReloadFromSongDir( RString sDir )
 {
 	// Remove the cache file to force the song to reload from its dir instead
 	// of loading from the cache. -Kyz
-	FILEMAN->Remove(GetCacheFilePath());
+	SONGINDEX->RemoveSongFromCache(*this);
 
 	RemoveAutoGenNotes();
 	vector<Steps*> vOldSteps = m_vpSteps;
@@ -620,8 +608,8 @@ void FixupPath( RString &path, const RString &sSongPath )
 	Trim( path );
 }
 
-// Songs in BlacklistImages will never be autodetected as song images.
-void Song::TidyUpData( bool from_cache, bool /* duringCache */ )
+// Songs in pBlacklistedImages will never be autodetected as song images.
+void Song::TidyUpData( bool from_cache, bool /* duringCache */, const set<RString> *pBlacklistedImages )
 {
 	// We need to do this before calling any of HasMusic, HasHasCDTitle, etc.
 	ASSERT_M(m_sSongDir.Left(3) != "../", m_sSongDir); // meaningless
@@ -962,7 +950,7 @@ void Song::TidyUpData( bool from_cache, bool /* duringCache */ )
 				// ignore DWI "-char" graphics
 				RString lower = image_list[i];
 				lower.MakeLower();
-				if(BlacklistedImages.find(lower) != BlacklistedImages.end())
+				if(pBlacklistedImages != nullptr && pBlacklistedImages->find(lower) != pBlacklistedImages->end())
 				continue;	// skip
 
 				// Skip any image that we've already classified
@@ -1367,9 +1355,23 @@ bool Song::SaveToCacheFile()
 	{
 		return true;
 	}
-	SONGINDEX->AddCacheIndex(m_sSongDir, GetHashForDirectory(m_sSongDir));
-	const RString sPath = GetCacheFilePath();
-	return SaveToSSCFile(sPath, true);
+	const unsigned uHash = GetHashForDirectory(m_sSongDir);
+
+	// Everything the cache entry was built from, so that the next load can
+	// check just these instead of hashing the directory again.
+	vector<RString> vsSourceFiles;
+	vsSourceFiles.push_back(m_sSongFileName);
+	if(HasMusic())
+	{ vsSourceFiles.push_back(GetMusicPath()); }
+	for (Steps const *pSteps : m_vpSteps)
+	{
+		const RString &sFile = pSteps->GetFilename();
+		if(!sFile.empty() && find(vsSourceFiles.begin(), vsSourceFiles.end(), sFile) == vsSourceFiles.end())
+		{ vsSourceFiles.push_back(sFile); }
+	}
+	SONGINDEX->AddCacheIndex(m_sSongDir, uHash, vsSourceFiles);
+	SONGINDEX->SaveSongToCache(*this, uHash);
+	return true;
 }
 
 bool Song::SaveToDWIFile()
@@ -101,8 +101,10 @@ public:
 	/**
 	 * @brief Call this after loading a song to clean up invalid data.
 	 * @param fromCache was this data loaded from the cache file?
-	 * @param duringCache was this data loaded during the cache process? */
-	void TidyUpData( bool fromCache = false, bool duringCache = false );
+	 * @param duringCache was this data loaded during the cache process?
+	 * @param pBlacklistedImages images that are never used as the banner,
+	 * background or CD title. */
+	void TidyUpData( bool fromCache = false, bool duringCache = false, const set<RString> *pBlacklistedImages = nullptr );
 
 	/**
 	 * @brief Get the new radar values, and determine the last second at the same time.
@@ -145,7 +147,6 @@ public:
 	{ return m_loaded_from_autosave; }
 
 	const RString &GetSongFilePath() const;
-	RString GetCacheFilePath() const;
 
 	void AddAutoGenNotes();
 	/**
@@ -418,6 +419,7 @@ public:
 	// TODO: Allow for a non const version.
 	const vector<Steps*>& GetAllSteps() const { return m_vpSteps; }
 	const vector<Steps*>& GetStepsByStepsType( StepsType st ) const { return m_vpStepsByType[st]; }
+	const vector<Steps*>& GetUnknownStyleSteps() const { return m_UnknownStyleSteps; }
 	bool IsEasy( StepsType st ) const;
 	bool IsTutorial() const;
 	bool HasEdits( StepsType st ) const;
@@ -5,27 +5,49 @@
 #include "RageUtil.h"
 #include "RageFileManager.h"
 #include "Song.h"
+#include "SongCachePack.h"
+#include "RageFile.h"
+#include "RageUtil_MappedFile.h"
+#include "RageFileDriverDirectHelpers.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
 #include "SpecialFiles.h"
 #include "CommonMetrics.h"
 
 /*
- * A quick explanation of song cache hashes: Each song has two hashes; a hash of the
- * song path, and a hash of the song directory.  The former is Song::GetCacheFilePath;
- * it stays the same if the contents of the directory change.  The latter is 
- * GetHashForDirectory(m_sSongDir), and changes on each modification.
- *
- * The file hash is used as the cache filename.  We don't want to use the directory
- * hash: if we do that, then we'll write a new cache file every time the song changes,
- * and they'll accumulate or we'll have to be careful to delete them.
+ * A quick explanation of song cache hashes: each song's directory hash,
+ * GetHashForDirectory(m_sSongDir), changes on each modification.  It is stored
+ * in here, indexed by the song path, and used to determine if a song has
+ * changed.
  *
- * The directory hash is stored in here, indexed by the song path, and used to determine
- * if a song has changed.
+ * The cached songs themselves live in one SongCachePack per group, keyed by
+ * song path.  Each entry also records the directory hash it was written with,
+ * so an entry that's older than the index is never used.
  *
  * Another advantage of this system is that we can load songs from cache given only their
  * path; we don't have to actually look in the directory (to find out the directory hash)
- * in order to find the cache file.
+ * in order to find the cache entry.
+ *
+ * The index file is a journal: a header, then one record per AddCacheIndex
+ * call (song path, directory hash, and a CRC of both).  New records are
+ * appended, so saving after adding a group only writes that group's songs.
+ * The last record for a path wins.  A record cut short by a crash fails its
+ * CRC and is dropped along with everything after it, and the file is rewritten
+ * in full (through a temporary file, so the old one stays intact until the new
+ * one is complete).  The file is also rewritten once most of its records have
+ * been superseded.
+ *
+ * Hashing a directory stats every file in it.  To avoid that on every boot
+ * with FastLoad off, each record can also carry a stamp: the directory's own
+ * hash from its parent's listing (which the song scan has already read; it
+ * changes when files are added, removed or renamed), plus the mtime and size
+ * of each file the song was actually loaded from, which catches files edited
+ * in place.  IsCacheCurrent checks those few files directly instead of
+ * listing the directory.
  */
-#define CACHE_INDEX SpecialFiles::CACHE_DIR + "index.cache"
+#define CACHE_INDEX SpecialFiles::CACHE_DIR + "index.db"
+static const char INDEX_MAGIC[4] = { 'S', 'M', 'C', 'I' };
 
 
 SongCacheIndex *SONGINDEX; // global and accessible from anywhere in our program
@@ -54,14 +76,16 @@ RString SongCacheIndex::GetCacheFilePath( const RString &sGroup, const RString &
 	return ssprintf( "%s%s/%s", SpecialFiles::CACHE_DIR.c_str(), sGroup.c_str(), s.c_str() );
 }
 
-SongCacheIndex::SongCacheIndex()
+SongCacheIndex::SongCacheIndex():
+	m_iPendingRecords(0), m_iRecordsOnDisk(0), m_bRewriteIndex(false),
+	m_Mutex("SongCacheIndex"), delay_save_cache(false)
 {
 	ReadCacheIndex();
 }
 
 SongCacheIndex::~SongCacheIndex()
 {
-
+	ClearPacks();
 }
 
 void SongCacheIndex::ReadFromDisk()
@@ -82,26 +106,116 @@ static void EmptyDir( RString dir )
 	}
 }
 
+static void AppendU32( RString &sOut, uint32_t i )
+{
+	i = Swap32LE( i );
+	sOut.append( (const char *) &i, sizeof(i) );
+}
+
+static uint32_t ReadU32( const char *p )
+{
+	uint32_t i;
+	memcpy( &i, p, sizeof(i) );
+	return Swap32LE( i );
+}
+
+static void AppendRecord( RString &sOut, const RString &sPath, unsigned iHash, const RString &sStamp )
+{
+	const size_t iStart = sOut.size();
+	AppendU32( sOut, sPath.size() );
+	sOut.append( sPath );
+	AppendU32( sOut, iHash );
+	AppendU32( sOut, sStamp.size() );
+	sOut.append( sStamp );
+
+	unsigned iCRC = 0;
+	CRC32( iCRC, sOut.data() + iStart, sOut.size() - iStart );
+	AppendU32( sOut, iCRC );
+}
+
+/* Returns false if there's no usable index, in which case the whole cache is
+ * out of date. */
+bool SongCacheIndex::LoadIndexFile()
+{
+	RageFileMapping file;
+	RString sError;
+	if( !file.Open(CACHE_INDEX, sError) )
+		return false;
+
+	const char *p = file.GetData();
+	const char *pEnd = p + file.GetSize();
+	if( pEnd - p < 8 || memcmp(p, INDEX_MAGIC, sizeof(INDEX_MAGIC)) ||
+		int(ReadU32(p + 4)) != FILE_CACHE_VERSION )
+		return false;
+	p += 8;
+
+	while( p != pEnd )
+	{
+		const char *pRecord = p;
+		if( pEnd - p < 4 )
+			break;
+		const uint32_t iLen = ReadU32( p );
+		p += 4;
+		if( size_t(pEnd - p) < size_t(iLen) + 12 )
+			break;
+		RString sPath( p, iLen );
+		p += iLen;
+		const uint32_t iHash = ReadU32( p );
+		p += 4;
+		const uint32_t iStampLen = ReadU32( p );
+		p += 4;
+		if( size_t(pEnd - p) < size_t(iStampLen) + 4 )
+			break;
+		RString sStamp( p, iStampLen );
+		p += iStampLen;
+
+		unsigned iCRC = 0;
+		CRC32( iCRC, pRecord, p - pRecord );
+		if( iCRC != ReadU32(p) )
+			break;
+		p += 4;
+
+		CacheEntry &entry = m_Hashes[sPath];
+		entry.iHash = iHash;
+		entry.sStamp = sStamp;
+		++m_iRecordsOnDisk;
+	}
+
+	if( p != pEnd )
+	{
+		LOG->Warn( "Song cache index is damaged after %u entries; the rest will be rebuilt.", m_iRecordsOnDisk );
+		m_bRewriteIndex = true;
+	}
+	return true;
+}
+
 void SongCacheIndex::ReadCacheIndex()
 {
-	CacheIndex.ReadFile( CACHE_INDEX );	// don't care if this fails
+	LockMut( m_Mutex );
+	m_Hashes.clear();
+	m_sPendingRecords = RString();
+	m_iPendingRecords = 0;
+	m_iRecordsOnDisk = 0;
+	m_bRewriteIndex = false;
 
-	int iCacheVersion = -1;
-	CacheIndex.GetValue( "Cache", "CacheVersion", iCacheVersion );
-	if( iCacheVersion == FILE_CACHE_VERSION )
+	if( LoadIndexFile() )
 		return; // OK
 
 	LOG->Trace( "Cache format is out of date.  Deleting all cache files." );
 	EmptyDir( SpecialFiles::CACHE_DIR );
 	EmptyDir( SpecialFiles::CACHE_DIR+"Songs/" );
 	EmptyDir( SpecialFiles::CACHE_DIR+"Courses/" );
-	
+	EmptyDir( SpecialFiles::CACHE_DIR+"Packs/" );
+	ClearPacks();
+
 	vector<RString> ImageDir;
 	split( CommonMetrics::IMAGES_TO_CACHE, ",", ImageDir );
 	for( unsigned c=0; c<ImageDir.size(); c++ )
 		EmptyDir( SpecialFiles::CACHE_DIR+ImageDir[c]+"/" );
 
-	CacheIndex.Clear();
+	m_Hashes.clear();
+	m_iRecordsOnDisk = 0;
+	m_bRewriteIndex = true;
 	/* This is right now in place because our song file paths are apparently being
 	 * cached in two distinct areas, and songs were loading from paths in FILEMAN.
 	 * This is admittedly a hack for now, but this does bring up a good question on
@@ -110,39 +224,228 @@ void SongCacheIndex::ReadCacheIndex()
 	FILEMAN->FlushDirCache();
 }
 
+void SongCacheIndex::WriteIndexFile()
+{
+	/* Compact the file once most of it is superseded records. */
+	if( m_iRecordsOnDisk > 1024 && m_iRecordsOnDisk + m_iPendingRecords > 2 * m_Hashes.size() )
+		m_bRewriteIndex = true;
+
+	if( !m_bRewriteIndex )
+	{
+		if( m_iPendingRecords == 0 )
+			return;
+
+		RageFile f;
+		if( f.Open(CACHE_INDEX, RageFile::WRITE|RageFile::APPEND) &&
+			f.Write(m_sPendingRecords) != -1 && f.Flush() != -1 )
+		{
+			m_iRecordsOnDisk += m_iPendingRecords;
+			m_sPendingRecords = RString();
+			m_iPendingRecords = 0;
+			return;
+		}
+
+		/* The append may have left part of a record behind; start over. */
+		LOG->Trace( "Couldn't append to the song cache index (%s); rewriting it.", f.GetError().c_str() );
+		m_bRewriteIndex = true;
+	}
+
+	RString sOut;
+	sOut.append( INDEX_MAGIC, sizeof(INDEX_MAGIC) );
+	AppendU32( sOut, FILE_CACHE_VERSION );
+	for (auto const &h : m_Hashes)
+		AppendRecord( sOut, h.first, h.second.iHash, h.second.sStamp );
+
+	RageFile f;
+	if( !f.Open(CACHE_INDEX, RageFile::WRITE) || f.Write(sOut) == -1 || f.Flush() == -1 )
+	{
+		LOG->Warn( "Couldn't write the song cache index: %s", f.GetError().c_str() );
+		return;
+	}
+
+	m_iRecordsOnDisk = m_Hashes.size();
+	m_sPendingRecords = RString();
+	m_iPendingRecords = 0;
+	m_bRewriteIndex = false;
+}
+
 void SongCacheIndex::SaveCacheIndex()
 {
-	CacheIndex.WriteFile(CACHE_INDEX);
+	LockMut( m_Mutex );
+	WriteIndexFile();
+	for (auto const &p : m_Packs)
+		p.second->WriteToDisk();
 }
 
-void SongCacheIndex::AddCacheIndex(const RString &path, unsigned hash)
+/* Stat a file directly, bypassing FILEMAN's directory cache, so the directory
+ * it's in doesn't get listed.  Returns false if the file isn't on a directory
+ * mount or doesn't exist. */
+static bool StatRealFile( const RString &sRealPath, uint64_t &iTime, uint64_t &iSize )
+{
+	struct stat st;
+	if( DoStat(sRealPath, &st) == -1 )
+		return false;
+	iTime = uint64_t( st.st_mtime );
+	iSize = uint64_t( st.st_size );
+	return true;
+}
+
+static void AppendU64( RString &sOut, uint64_t i )
+{
+	AppendU32( sOut, uint32_t(i) );
+	AppendU32( sOut, uint32_t(i >> 32) );
+}
+
+static uint64_t ReadU64( const char *p )
+{
+	return uint64_t( ReadU32(p) ) | (uint64_t( ReadU32(p + 4) ) << 32);
+}
+
+static RString MakeStamp( const RString &sDir, const vector<RString> &vsSourceFiles )
+{
+	const int iDirHash = FILEMAN->GetFileHash( sDir );
+	if( iDirHash == -1 || vsSourceFiles.empty() )
+		return RString();
+
+	RString sStamp;
+	AppendU32( sStamp, iDirHash );
+	AppendU32( sStamp, vsSourceFiles.size() );
+	for (RString const &sFile : vsSourceFiles)
+	{
+		const RString sRealPath = FILEMAN->ResolvePath( sFile );
+		uint64_t iTime, iSize;
+		if( sRealPath == sFile || !StatRealFile(sRealPath, iTime, iSize) )
+			return RString();
+
+		AppendU32( sStamp, sRealPath.size() );
+		sStamp.append( sRealPath );
+		AppendU64( sStamp, iTime );
+		AppendU64( sStamp, iSize );
+	}
+	return sStamp;
+}
+
+void SongCacheIndex::AddCacheIndex(const RString &path, unsigned hash, const vector<RString> &vsSourceFiles)
 {
 	if( hash == 0 )
 		++hash; /* no 0 hash values */
-	CacheIndex.SetValue( "Cache", "CacheVersion", FILE_CACHE_VERSION );
-	CacheIndex.SetValue( "Cache", MangleName(path), hash );
+	const RString sStamp = MakeStamp( path, vsSourceFiles );
+	LockMut( m_Mutex );
+	CacheEntry &entry = m_Hashes[path];
+	if( entry.iHash == hash && entry.sStamp == sStamp )
+		return;
+	entry.iHash = hash;
+	entry.sStamp = sStamp;
+	AppendRecord( m_sPendingRecords, path, hash, sStamp );
+	++m_iPendingRecords;
 	if(!delay_save_cache)
 	{
-		CacheIndex.WriteFile(CACHE_INDEX);
+		WriteIndexFile();
 	}
 }
 
 unsigned SongCacheIndex::GetCacheHash( const RString &path ) const
 {
-	unsigned iDirHash = 0;
-	if( !CacheIndex.GetValue( "Cache", MangleName(path), iDirHash ) )
+	LockMut( m_Mutex );
+	map<RString, CacheEntry>::const_iterator it = m_Hashes.find( path );
+	if( it == m_Hashes.end() )
 		return 0;
-	if( iDirHash == 0 )
-		++iDirHash; /* no 0 hash values */
-	return iDirHash;
+	return it->second.iHash;
+}
+
+bool SongCacheIndex::IsCacheCurrent( const RString &path ) const
+{
+	RString sStamp;
+	{
+		LockMut( m_Mutex );
+		map<RString, CacheEntry>::const_iterator it = m_Hashes.find( path );
+		if( it == m_Hashes.end() )
+			return false;
+		sStamp = it->second.sStamp;
+	}
+
+	/* The stamp was written by MakeStamp, and its record passed its CRC. */
+	if( sStamp.size() < 8 )
+		return false;
+	const char *p = sStamp.data();
+	const char *pEnd = p + sStamp.size();
+	if( int(ReadU32(p)) != FILEMAN->GetFileHash(path) )
+		return false;
+	const uint32_t iCount = ReadU32( p + 4 );
+	p += 8;
+
+	for( uint32_t i = 0; i < iCount; ++i )
+	{
+		if( pEnd - p < 4 )
+			return false;
+		const uint32_t iLen = ReadU32( p );
+		p += 4;
+		if( size_t(pEnd - p) < size_t(iLen) + 16 )
+			return false;
+		const RString sRealPath( p, iLen );
+		p += iLen;
+
+		uint64_t iTime, iSize;
+		if( !StatRealFile(sRealPath, iTime, iSize) )
+			return false;
+		if( iTime != ReadU64(p) || iSize != ReadU64(p + 8) )
+			return false;
+		p += 16;
+	}
+	return true;
+}
+
+SongCachePack *SongCacheIndex::GetPack( const RString &sGroup )
+{
+	SongCachePack *&pPack = m_Packs[sGroup];
+	if( pPack == nullptr )
+		pPack = new SongCachePack( sGroup );
+	return pPack;
+}
+
+void SongCacheIndex::ClearPacks()
+{
+	for (auto const &p : m_Packs)
+		delete p.second;
+	m_Packs.clear();
+}
+
+bool SongCacheIndex::LoadSongFromCache( Song &out, unsigned hash )
+{
+	if( hash == 0 )
+		++hash; /* no 0 hash values */
+	LockMut( m_Mutex );
+	return GetPack( out.m_sGroupName )->LoadSong( out, hash );
+}
+
+bool SongCacheIndex::LoadNoteDataFromCache( const Song &song, unsigned hash, unsigned iOffset, unsigned iSize, RString &sOut )
+{
+	LockMut( m_Mutex );
+	return GetPack( song.m_sGroupName )->LoadNoteData( song.GetSongDir(), hash, iOffset, iSize, sOut );
 }
 
-RString SongCacheIndex::MangleName( const RString &Name )
+void SongCacheIndex::SaveSongToCache( const Song &song, unsigned hash )
 {
-	/* We store paths in an INI.  We can't store '='. */
-	RString ret = Name;
-	ret.Replace( "=", "");
-	return ret;
+	if( hash == 0 )
+		++hash; /* no 0 hash values */
+	LockMut( m_Mutex );
+	SongCachePack *pPack = GetPack( song.m_sGroupName );
+	pPack->SaveSong( song, hash );
+	if(!delay_save_cache)
+	{
+		pPack->WriteToDisk();
+	}
+}
+
+void SongCacheIndex::RemoveSongFromCache( const Song &song )
+{
+	LockMut( m_Mutex );
+	SongCachePack *pPack = GetPack( song.m_sGroupName );
+	pPack->RemoveSong( song.GetSongDir() );
+	if(!delay_save_cache)
+	{
+		pPack->WriteToDisk();
+	}
 }
 
 /*
@@ -1,12 +1,42 @@
 #ifndef SONG_CACHE_INDEX_H
 #define SONG_CACHE_INDEX_H
 
-#include "IniFile.h"
+#include "RageThreads.h"
+
+#include <map>
+
+class Song;
+class SongCachePack;
 
 class SongCacheIndex
 {
-	IniFile CacheIndex;
-	static RString MangleName( const RString &Name );
+	struct CacheEntry
+	{
+		CacheEntry(): iHash(0) { }
+		unsigned iHash;
+		/* Modification stamps of the files the entry was built from; see
+		 * IsCacheCurrent. */
+		RString sStamp;
+	};
+	/* Directory hashes, indexed by song path. */
+	map<RString, CacheEntry> m_Hashes;
+	/* Records added since the index file was last written, and how many. */
+	RString m_sPendingRecords;
+	unsigned m_iPendingRecords;
+	/* Records in the index file, including ones that have been superseded. */
+	unsigned m_iRecordsOnDisk;
+	/* If true, the index file is replaced on the next write instead of
+	 * appended to. */
+	bool m_bRewriteIndex;
+	/* Cached songs, one pack per group. */
+	map<RString, SongCachePack *> m_Packs;
+	/* Songs may be loaded on several threads at once; this protects
+	 * everything above. */
+	mutable RageMutex m_Mutex;
+	bool LoadIndexFile();
+	void WriteIndexFile();
+	SongCachePack *GetPack( const RString &sGroup );
+	void ClearPacks();
 
 public:
 	SongCacheIndex();
@@ -16,8 +46,24 @@ public:
 
 	void ReadCacheIndex();
 	void SaveCacheIndex();
-	void AddCacheIndex( const RString &path, unsigned hash );
+	/* vsSourceFiles are the files the cached data was read from; if they're
+	 * given, IsCacheCurrent can vouch for the entry later without hashing
+	 * the whole directory. */
+	void AddCacheIndex( const RString &path, unsigned hash, const vector<RString> &vsSourceFiles = vector<RString>() );
 	unsigned GetCacheHash( const RString &path ) const;
+	/* Return true if neither the directory listing nor any of the source
+	 * files of the entry for path have changed since it was added. */
+	bool IsCacheCurrent( const RString &path ) const;
+
+	/* Load a song from its group's cache pack.  The song's directory and group
+	 * must already be set.  Returns false if the song isn't cached, or was
+	 * cached with a different directory hash. */
+	bool LoadSongFromCache( Song &out, unsigned hash );
+	/* Read the note data of one chart of a song loaded by LoadSongFromCache,
+	 * as recorded with Steps::SetCachedNoteDataLocation. */
+	bool LoadNoteDataFromCache( const Song &song, unsigned hash, unsigned iOffset, unsigned iSize, RString &sOut );
+	void SaveSongToCache( const Song &song, unsigned hash );
+	void RemoveSongFromCache( const Song &song );
 	bool delay_save_cache;
 };
 
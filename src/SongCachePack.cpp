@@ -0,0 +1,688 @@
+#include "global.h"
+#include "SongCachePack.h"
+#include "BackgroundUtil.h"
+#include "GameManager.h"
+#include "RageFile.h"
+#include "RageFileDriverDeflate.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+#include "Song.h"
+#include "SongCacheIndex.h"
+#include "Steps.h"
+
+/* Pack layout, all integers little-endian:
+ *
+ * "SMCP", version, song count
+ * for each song: song dir, directory hash, offset, size
+ * song data
+ *
+ * Strings are a 32-bit length followed by the bytes.  Bump PACK_VERSION
+ * whenever the layout of the header or of a song changes. */
+static const char PACK_MAGIC[4] = { 'S', 'M', 'C', 'P' };
+static const uint32_t PACK_VERSION = 1;
+
+namespace
+{
+	class CacheWriter
+	{
+	public:
+		CacheWriter( RString &sOut ): m_sOut(sOut) { }
+
+		void U32( uint32_t i ) { i = Swap32LE( i ); m_sOut.append( (const char *) &i, sizeof(i) ); }
+		void I32( int i ) { U32( uint32_t(i) ); }
+		void Bool( bool b ) { m_sOut.append( 1, b? '\1':'\0' ); }
+		void Float( float f ) { uint32_t i; memcpy( &i, &f, sizeof(i) ); U32( i ); }
+		void String( const RString &s ) { U32( s.size() ); m_sOut.append( s ); }
+		void Strings( const vector<RString> &v )
+		{
+			U32( v.size() );
+			for (RString const &s : v)
+				String( s );
+		}
+
+	private:
+		RString &m_sOut;
+	};
+
+	class CacheReader
+	{
+	public:
+		CacheReader( const char *pData, size_t iSize ):
+			m_pData(pData), m_iSize(iSize), m_iPos(0), m_bError(false) { }
+
+		bool Error() const { return m_bError; }
+		size_t Tell() const { return m_iPos; }
+
+		uint32_t U32()
+		{
+			uint32_t i = 0;
+			if( Need(sizeof(i)) )
+			{
+				memcpy( &i, m_pData + m_iPos, sizeof(i) );
+				m_iPos += sizeof(i);
+			}
+			return Swap32LE( i );
+		}
+		int I32() { return int( U32() ); }
+		bool Bool()
+		{
+			if( !Need(1) )
+				return false;
+			return m_pData[m_iPos++] != 0;
+		}
+		float Float() { uint32_t i = U32(); float f; memcpy( &f, &i, sizeof(f) ); return f; }
+		RString String() { return String( U32() ); }
+		RString String( uint32_t iLen )
+		{
+			if( !Need(iLen) )
+				return RString();
+			RString s( m_pData + m_iPos, iLen );
+			m_iPos += iLen;
+			return s;
+		}
+		void Strings( vector<RString> &v )
+		{
+			const uint32_t iCount = U32();
+			v.clear();
+			for( uint32_t i = 0; i < iCount && !m_bError; ++i )
+				v.push_back( String() );
+		}
+		void Skip( size_t iBytes )
+		{
+			if( Need(iBytes) )
+				m_iPos += iBytes;
+		}
+
+	private:
+		bool Need( size_t iBytes )
+		{
+			if( m_bError || iBytes > m_iSize - m_iPos )
+			{
+				m_bError = true;
+				return false;
+			}
+			return true;
+		}
+
+		const char *m_pData;
+		size_t m_iSize;
+		size_t m_iPos;
+		bool m_bError;
+	};
+}
+
+static void WriteTiming( CacheWriter &w, const TimingData &timing )
+{
+	w.Float( timing.m_fBeat0OffsetInSeconds );
+	FOREACH_TimingSegmentType( tst )
+	{
+		const vector<TimingSegment *> &segs = timing.GetTimingSegments( tst );
+		w.U32( segs.size() );
+		for (TimingSegment const *seg : segs)
+		{
+			w.I32( seg->GetRow() );
+			switch( tst )
+			{
+			case SEGMENT_BPM:	w.Float( ToBPM(seg)->GetBPM() ); break;
+			case SEGMENT_STOP:	w.Float( ToStop(seg)->GetPause() ); break;
+			case SEGMENT_DELAY:	w.Float( ToDelay(seg)->GetPause() ); break;
+			case SEGMENT_TIME_SIG:
+				w.I32( ToTimeSignature(seg)->GetNum() );
+				w.I32( ToTimeSignature(seg)->GetDen() );
+				break;
+			case SEGMENT_WARP:	w.I32( ToWarp(seg)->GetLengthRows() ); break;
+			case SEGMENT_LABEL:	w.String( ToLabel(seg)->GetLabel() ); break;
+			case SEGMENT_TICKCOUNT:	w.I32( ToTickcount(seg)->GetTicks() ); break;
+			case SEGMENT_COMBO:
+				w.I32( ToCombo(seg)->GetCombo() );
+				w.I32( ToCombo(seg)->GetMissCombo() );
+				break;
+			case SEGMENT_SPEED:
+				w.Float( ToSpeed(seg)->GetRatio() );
+				w.Float( ToSpeed(seg)->GetDelay() );
+				w.U32( ToSpeed(seg)->GetUnit() );
+				break;
+			case SEGMENT_SCROLL:	w.Float( ToScroll(seg)->GetRatio() ); break;
+			case SEGMENT_FAKE:	w.I32( ToFake(seg)->GetLengthRows() ); break;
+			default: FAIL_M( ssprintf("Invalid timing segment type: %i", tst) );
+			}
+		}
+	}
+}
+
+static void ReadTiming( CacheReader &r, TimingData &timing )
+{
+	timing.Clear();
+	timing.m_fBeat0OffsetInSeconds = r.Float();
+	FOREACH_TimingSegmentType( tst )
+	{
+		const uint32_t iCount = r.U32();
+		for( uint32_t i = 0; i < iCount && !r.Error(); ++i )
+		{
+			const int iRow = r.I32();
+			switch( tst )
+			{
+			case SEGMENT_BPM:	timing.AddSegment( BPMSegment(iRow, r.Float()) ); break;
+			case SEGMENT_STOP:	timing.AddSegment( StopSegment(iRow, r.Float()) ); break;
+			case SEGMENT_DELAY:	timing.AddSegment( DelaySegment(iRow, r.Float()) ); break;
+			case SEGMENT_TIME_SIG:
+			{
+				const int iNum = r.I32();
+				const int iDen = r.I32();
+				timing.AddSegment( TimeSignatureSegment(iRow, iNum, iDen) );
+				break;
+			}
+			case SEGMENT_WARP:	timing.AddSegment( WarpSegment(iRow, r.I32()) ); break;
+			case SEGMENT_LABEL:	timing.AddSegment( LabelSegment(iRow, r.String()) ); break;
+			case SEGMENT_TICKCOUNT:	timing.AddSegment( TickcountSegment(iRow, r.I32()) ); break;
+			case SEGMENT_COMBO:
+			{
+				const int iCombo = r.I32();
+				const int iMissCombo = r.I32();
+				timing.AddSegment( ComboSegment(iRow, iCombo, iMissCombo) );
+				break;
+			}
+			case SEGMENT_SPEED:
+			{
+				const float fRatio = r.Float();
+				const float fDelay = r.Float();
+				const SpeedSegment::BaseUnit unit = SpeedSegment::BaseUnit( r.U32() );
+				timing.AddSegment( SpeedSegment(iRow, fRatio, fDelay, unit) );
+				break;
+			}
+			case SEGMENT_SCROLL:	timing.AddSegment( ScrollSegment(iRow, r.Float()) ); break;
+			case SEGMENT_FAKE:	timing.AddSegment( FakeSegment(iRow, r.I32()) ); break;
+			default: FAIL_M( ssprintf("Invalid timing segment type: %i", tst) );
+			}
+		}
+	}
+}
+
+static void WriteBackgroundChanges( CacheWriter &w, const vector<BackgroundChange> &changes )
+{
+	w.U32( changes.size() );
+	for (BackgroundChange const &bgc : changes)
+	{
+		w.Float( bgc.m_fStartBeat );
+		w.Float( bgc.m_fRate );
+		w.String( bgc.m_sTransition );
+		w.String( bgc.m_def.m_sEffect );
+		w.String( bgc.m_def.m_sFile1 );
+		w.String( bgc.m_def.m_sFile2 );
+		w.String( bgc.m_def.m_sColor1 );
+		w.String( bgc.m_def.m_sColor2 );
+	}
+}
+
+static void ReadBackgroundChanges( CacheReader &r, vector<BackgroundChange> &changes )
+{
+	const uint32_t iCount = r.U32();
+	changes.clear();
+	for( uint32_t i = 0; i < iCount && !r.Error(); ++i )
+	{
+		BackgroundChange bgc;
+		bgc.m_fStartBeat = r.Float();
+		bgc.m_fRate = r.Float();
+		bgc.m_sTransition = r.String();
+		bgc.m_def.m_sEffect = r.String();
+		bgc.m_def.m_sFile1 = r.String();
+		bgc.m_def.m_sFile2 = r.String();
+		bgc.m_def.m_sColor1 = r.String();
+		bgc.m_def.m_sColor2 = r.String();
+		changes.push_back( bgc );
+	}
+}
+
+static void WriteAttacks( CacheWriter &w, const vector<RString> &vsAttackString, const AttackArray &attacks )
+{
+	w.Strings( vsAttackString );
+	w.U32( attacks.size() );
+	for (Attack const &a : attacks)
+	{
+		w.U32( a.level );
+		w.Float( a.fStartSecond );
+		w.Float( a.fSecsRemaining );
+		w.String( a.sModifiers );
+		w.Bool( a.bGlobal );
+		w.Bool( a.bShowInAttackList );
+	}
+}
+
+static void ReadAttacks( CacheReader &r, vector<RString> &vsAttackString, AttackArray &attacks )
+{
+	r.Strings( vsAttackString );
+	const uint32_t iCount = r.U32();
+	attacks.clear();
+	for( uint32_t i = 0; i < iCount && !r.Error(); ++i )
+	{
+		Attack a;
+		a.level = AttackLevel( r.U32() );
+		a.fStartSecond = r.Float();
+		a.fSecsRemaining = r.Float();
+		a.sModifiers = r.String();
+		a.bGlobal = r.Bool();
+		a.bShowInAttackList = r.Bool();
+		attacks.push_back( a );
+	}
+}
+
+static void WriteSteps( CacheWriter &w, const Steps &steps )
+{
+	w.String( steps.m_StepsTypeStr );
+	w.String( steps.GetChartName() );
+	w.String( steps.GetDescription() );
+	w.String( steps.GetChartStyle() );
+	w.U32( steps.GetDifficulty() );
+	w.I32( steps.GetMeter() );
+	w.String( steps.GetMusicFile() );
+	w.String( steps.GetCredit() );
+	FOREACH_PlayerNumber( pn )
+	{
+		const RadarValues &rv = steps.GetRadarValues( pn );
+		FOREACH_ENUM( RadarCategory, rc )
+			w.Float( rv[rc] );
+	}
+
+	w.Bool( !steps.m_Timing.empty() );
+	if( !steps.m_Timing.empty() )
+		WriteTiming( w, steps.m_Timing );
+
+	WriteAttacks( w, steps.m_sAttackString, steps.m_Attacks );
+	w.U32( steps.GetDisplayBPM() );
+	w.Float( steps.GetMinBPM() );
+	w.Float( steps.GetMaxBPM() );
+	w.String( steps.GetFilename() );
+
+	/* The note data goes last, compressed, so that a reader that only wants
+	 * the metadata can skip over it. */
+	RString sNoteData, sCompressed;
+	steps.GetSMNoteData( sNoteData );
+	if( !sNoteData.empty() )
+		GzipString( sNoteData, sCompressed );
+	w.String( sCompressed );
+}
+
+static void ReadSteps( CacheReader &r, Song &song, unsigned iHash )
+{
+	Steps *pSteps = song.CreateSteps();
+	pSteps->m_StepsTypeStr = r.String();
+	pSteps->m_StepsType = GAMEMAN->StringToStepsType( pSteps->m_StepsTypeStr );
+	pSteps->SetChartName( r.String() );
+	const RString sDescription = r.String();
+	pSteps->SetChartStyle( r.String() );
+	pSteps->SetDifficultyAndDescription( Difficulty(r.U32()), sDescription );
+	pSteps->SetMeter( r.I32() );
+	pSteps->SetMusicFile( r.String() );
+	pSteps->SetCredit( r.String() );
+
+	RadarValues rv[NUM_PLAYERS];
+	FOREACH_PlayerNumber( pn )
+	{
+		FOREACH_ENUM( RadarCategory, rc )
+			rv[pn][rc] = r.Float();
+	}
+	pSteps->SetCachedRadarValues( rv );
+
+	if( r.Bool() )
+		ReadTiming( r, pSteps->m_Timing );
+
+	ReadAttacks( r, pSteps->m_sAttackString, pSteps->m_Attacks );
+	pSteps->SetDisplayBPM( DisplayBPM(r.U32()) );
+	pSteps->SetMinBPM( r.Float() );
+	pSteps->SetMaxBPM( r.Float() );
+	pSteps->SetFilename( r.String() );
+
+	/* Note data is read from here when it's needed; remember where it is. */
+	const size_t iNoteDataOffset = r.Tell();
+	const uint32_t iNoteDataSize = r.U32();
+	r.Skip( iNoteDataSize );
+
+	if( r.Error() )
+	{
+		delete pSteps;
+		return;
+	}
+	pSteps->SetCachedNoteDataLocation( iHash, iNoteDataOffset, iNoteDataSize );
+	song.AddSteps( pSteps );
+}
+
+static void WriteSong( RString &sOut, const Song &song )
+{
+	CacheWriter w( sOut );
+	w.String( song.m_sMainTitle );
+	w.String( song.m_sSubTitle );
+	w.String( song.m_sArtist );
+	w.String( song.m_sMainTitleTranslit );
+	w.String( song.m_sSubTitleTranslit );
+	w.String( song.m_sArtistTranslit );
+	w.String( song.m_sGenre );
+	w.String( song.m_sOrigin );
+	w.String( song.m_sCredit );
+	w.String( song.m_sBannerFile );
+	w.String( song.m_sBackgroundFile );
+	w.String( song.m_sPreviewVidFile );
+	w.String( song.m_sJacketFile );
+	w.String( song.m_sCDFile );
+	w.String( song.m_sDiscFile );
+	w.String( song.m_sLyricsFile );
+	w.String( song.m_sCDTitleFile );
+	w.String( song.m_sMusicFile );
+	w.String( song.m_PreviewFile );
+	FOREACH_ENUM( InstrumentTrack, it )
+		w.String( song.m_sInstrumentTrackFile[it] );
+	w.Float( song.m_fMusicSampleStartSeconds );
+	w.Float( song.m_fMusicSampleLengthSeconds );
+	w.U32( song.m_SelectionDisplay );
+	w.U32( song.m_DisplayBPMType );
+	w.Float( song.m_fSpecifiedBPMMin );
+	w.Float( song.m_fSpecifiedBPMMax );
+	WriteTiming( w, song.m_SongTiming );
+	w.Float( song.GetSpecifiedLastSecond() );
+
+	FOREACH_BackgroundLayer( bl )
+		WriteBackgroundChanges( w, song.GetBackgroundChanges(bl) );
+	WriteBackgroundChanges( w, song.GetForegroundChanges() );
+	w.Strings( song.m_vsKeysoundFile );
+	WriteAttacks( w, song.m_sAttackString, song.m_Attacks );
+
+	// These are only ever filled in from the cache.
+	w.Float( song.GetFirstSecond() );
+	w.Float( song.GetLastSecond() );
+	w.String( song.m_sSongFileName );
+	w.Bool( song.m_bHasMusic );
+	w.Bool( song.m_bHasBanner );
+	w.Float( song.m_fMusicLengthSeconds );
+
+	/* Steps are saved the same way SaveToSSCFile picks them. */
+	vector<const Steps *> vpStepsToSave;
+	for (Steps const *pSteps : song.GetAllSteps())
+	{
+		if( pSteps->IsAutogen() || pSteps->WasLoadedFromProfile() )
+			continue;
+		vpStepsToSave.push_back( pSteps );
+	}
+	for (Steps const *pSteps : song.GetUnknownStyleSteps())
+		vpStepsToSave.push_back( pSteps );
+
+	w.U32( vpStepsToSave.size() );
+	for (Steps const *pSteps : vpStepsToSave)
+		WriteSteps( w, *pSteps );
+}
+
+static bool ReadSong( CacheReader &r, Song &song, unsigned iHash )
+{
+	song.m_fVersion = STEPFILE_VERSION_NUMBER;
+	song.m_sMainTitle = r.String();
+	song.m_sSubTitle = r.String();
+	song.m_sArtist = r.String();
+	song.m_sMainTitleTranslit = r.String();
+	song.m_sSubTitleTranslit = r.String();
+	song.m_sArtistTranslit = r.String();
+	song.m_sGenre = r.String();
+	song.m_sOrigin = r.String();
+	song.m_sCredit = r.String();
+	song.m_sBannerFile = r.String();
+	song.m_sBackgroundFile = r.String();
+	song.m_sPreviewVidFile = r.String();
+	song.m_sJacketFile = r.String();
+	song.m_sCDFile = r.String();
+	song.m_sDiscFile = r.String();
+	song.m_sLyricsFile = r.String();
+	song.m_sCDTitleFile = r.String();
+	song.m_sMusicFile = r.String();
+	song.m_PreviewFile = r.String();
+	FOREACH_ENUM( InstrumentTrack, it )
+		song.m_sInstrumentTrackFile[it] = r.String();
+	song.m_fMusicSampleStartSeconds = r.Float();
+	song.m_fMusicSampleLengthSeconds = r.Float();
+	song.m_SelectionDisplay = Song::SelectionDisplay( r.U32() );
+	song.m_DisplayBPMType = DisplayBPM( r.U32() );
+	song.m_fSpecifiedBPMMin = r.Float();
+	song.m_fSpecifiedBPMMax = r.Float();
+	ReadTiming( r, song.m_SongTiming );
+	song.SetSpecifiedLastSecond( r.Float() );
+
+	FOREACH_BackgroundLayer( bl )
+		ReadBackgroundChanges( r, song.GetBackgroundChanges(bl) );
+	ReadBackgroundChanges( r, song.GetForegroundChanges() );
+	r.Strings( song.m_vsKeysoundFile );
+	ReadAttacks( r, song.m_sAttackString, song.m_Attacks );
+
+	song.SetFirstSecond( r.Float() );
+	song.SetLastSecond( r.Float() );
+	song.m_sSongFileName = r.String();
+	song.m_bHasMusic = r.Bool();
+	song.m_bHasBanner = r.Bool();
+	song.m_fMusicLengthSeconds = r.Float();
+
+	const uint32_t iNumSteps = r.U32();
+	for( uint32_t i = 0; i < iNumSteps && !r.Error(); ++i )
+		ReadSteps( r, song, iHash );
+
+	return !r.Error();
+}
+
+SongCachePack::SongCachePack( const RString &sGroup ):
+	m_sGroup(sGroup), m_sPath(GetPackPath(sGroup)),
+	m_bOpened(false), m_bDirty(false)
+{
+}
+
+RString SongCachePack::GetPackPath( const RString &sGroup )
+{
+	return SongCacheIndex::GetCacheFilePath( "Packs", sGroup ) + ".pack";
+}
+
+void SongCachePack::OpenFile()
+{
+	if( m_bOpened )
+		return;
+	m_bOpened = true;
+
+	RString sError;
+	if( !m_File.Open(m_sPath, sError) )
+		return; // no pack for this group yet
+
+	CacheReader r( m_File.GetData(), m_File.GetSize() );
+	r.Skip( sizeof(PACK_MAGIC) );
+	const uint32_t iVersion = r.U32();
+	if( r.Error() || memcmp(m_File.GetData(), PACK_MAGIC, sizeof(PACK_MAGIC)) || iVersion != PACK_VERSION )
+	{
+		LOG->Trace( "Song cache pack \"%s\" is out of date; ignored.", m_sPath.c_str() );
+		m_File.Close();
+		return;
+	}
+
+	const uint32_t iCount = r.U32();
+	map<RString, Entry> entries;
+	for( uint32_t i = 0; i < iCount && !r.Error(); ++i )
+	{
+		const RString sSongDir = r.String();
+		Entry e;
+		e.iHash = r.U32();
+		e.iOffset = r.U32();
+		e.iSize = r.U32();
+		if( e.iOffset > m_File.GetSize() || e.iSize > m_File.GetSize() - e.iOffset )
+			break;
+		entries[sSongDir] = e;
+	}
+	if( r.Error() || entries.size() != iCount )
+	{
+		LOG->Warn( "Song cache pack \"%s\" is corrupt; ignored.", m_sPath.c_str() );
+		m_File.Close();
+		return;
+	}
+
+	/* Songs saved before the pack was opened take precedence. */
+	for (auto const &e : m_Entries)
+		entries[e.first] = e.second;
+	m_Entries.swap( entries );
+}
+
+bool SongCachePack::LoadSong( Song &out, unsigned iHash )
+{
+	OpenFile();
+
+	map<RString, Entry>::const_iterator it = m_Entries.find( out.GetSongDir() );
+	if( it == m_Entries.end() || it->second.iHash != iHash )
+		return false;
+
+	const Entry &e = it->second;
+	const char *pData = e.bPending? e.sPending.data(): m_File.GetData() + e.iOffset;
+	const size_t iSize = e.bPending? e.sPending.size(): e.iSize;
+	CacheReader r( pData, iSize );
+
+	out.m_SongTiming.m_sFile = m_sPath;
+	if( !ReadSong(r, out, iHash) )
+	{
+		LOG->Warn( "Cache entry for \"%s\" in \"%s\" is corrupt.", out.GetSongDir().c_str(), m_sPath.c_str() );
+		return false;
+	}
+	return true;
+}
+
+bool SongCachePack::LoadNoteData( const RString &sSongDir, unsigned iHash, size_t iOffset, size_t iSize, RString &sOut )
+{
+	OpenFile();
+
+	map<RString, Entry>::const_iterator it = m_Entries.find( sSongDir );
+	if( it == m_Entries.end() || it->second.iHash != iHash )
+		return false;
+
+	const Entry &e = it->second;
+	const char *pData = e.bPending? e.sPending.data(): m_File.GetData() + e.iOffset;
+	const size_t iEntrySize = e.bPending? e.sPending.size(): e.iSize;
+	if( iOffset > iEntrySize )
+		return false;
+
+	/* The note data is a length-prefixed string; make sure it's the one we
+	 * were told about. */
+	CacheReader r( pData + iOffset, iEntrySize - iOffset );
+	if( r.U32() != iSize || r.Error() )
+		return false;
+	const RString sCompressed = r.String( iSize );
+	if( r.Error() )
+		return false;
+
+	sOut = RString();
+	if( sCompressed.empty() )
+		return true;
+
+	RString sError;
+	if( !GunzipString(sCompressed, sOut, sError) )
+	{
+		LOG->Warn( "Cached note data for \"%s\" in \"%s\" is corrupt: %s", sSongDir.c_str(), m_sPath.c_str(), sError.c_str() );
+		return false;
+	}
+	return true;
+}
+
+void SongCachePack::SaveSong( const Song &song, unsigned iHash )
+{
+	OpenFile();
+
+	Entry &e = m_Entries[song.GetSongDir()];
+	e.iHash = iHash;
+	e.bPending = true;
+	e.sPending = RString();
+	WriteSong( e.sPending, song );
+	m_bDirty = true;
+}
+
+void SongCachePack::RemoveSong( const RString &sSongDir )
+{
+	OpenFile();
+
+	if( m_Entries.erase(sSongDir) )
+		m_bDirty = true;
+}
+
+bool SongCachePack::WriteToDisk()
+{
+	if( !m_bDirty )
+		return true;
+
+	/* Build the whole file in memory first: the songs that aren't pending
+	 * still live in the old mapping, which has to be closed before the file
+	 * is replaced. */
+	RString sHeader;
+	CacheWriter w( sHeader );
+	sHeader.append( PACK_MAGIC, sizeof(PACK_MAGIC) );
+	w.U32( PACK_VERSION );
+	w.U32( m_Entries.size() );
+
+	size_t iHeaderSize = sHeader.size();
+	for (auto const &e : m_Entries)
+		iHeaderSize += sizeof(uint32_t) + e.first.size() + 3*sizeof(uint32_t);
+
+	RString sSongs;
+	for (auto &e : m_Entries)
+	{
+		Entry &entry = e.second;
+		const size_t iOffset = iHeaderSize + sSongs.size();
+		if( entry.bPending )
+			sSongs.append( entry.sPending );
+		else
+			sSongs.append( m_File.GetData() + entry.iOffset, entry.iSize );
+		entry.iSize = entry.bPending? entry.sPending.size(): entry.iSize;
+		entry.iOffset = iOffset;
+		entry.bPending = false;
+		entry.sPending = RString();
+
+		w.String( e.first );
+		w.U32( entry.iHash );
+		w.U32( entry.iOffset );
+		w.U32( entry.iSize );
+	}
+	ASSERT( sHeader.size() == iHeaderSize );
+
+	m_File.Close();
+	m_bDirty = false;
+
+	RageFile f;
+	if( !f.Open(m_sPath, RageFile::WRITE) )
+	{
+		LOG->Warn( "Couldn't write song cache pack \"%s\": %s", m_sPath.c_str(), f.GetError().c_str() );
+		m_Entries.clear();
+		return false;
+	}
+	if( f.Write(sHeader) == -1 || f.Write(sSongs) == -1 || f.Flush() == -1 )
+	{
+		LOG->Warn( "Couldn't write song cache pack \"%s\": %s", m_sPath.c_str(), f.GetError().c_str() );
+		f.Close();
+		m_Entries.clear();
+		return false;
+	}
+	f.Close();
+
+	/* Map the new file, so the songs we just wrote can be loaded again. */
+	RString sError;
+	if( !m_File.Open(m_sPath, sError) )
+		m_Entries.clear();
+	return true;
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
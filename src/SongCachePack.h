@@ -0,0 +1,99 @@
+/* SongCachePack - binary cache of every song in one group. */
+
+#ifndef SONG_CACHE_PACK_H
+#define SONG_CACHE_PACK_H
+
+#include "RageUtil_MappedFile.h"
+
+#include <map>
+
+class Song;
+
+/**
+ * @brief One cache file holding every cached song in a group.
+ *
+ * This replaces the per-song SSC cache files.  The pack is mapped when the
+ * first song of the group is looked up, and only the index is read at that
+ * point; each song is deserialized when it's asked for.  New and changed
+ * songs are kept in memory until WriteToDisk() rewrites the pack.
+ *
+ * Entries are keyed by song directory, and record the directory hash from
+ * SongCacheIndex at the time they were written, so a stale entry is never
+ * used even if the pack and the index get out of sync.
+ */
+class SongCachePack
+{
+public:
+	SongCachePack( const RString &sGroup );
+
+	static RString GetPackPath( const RString &sGroup );
+
+	/**
+	 * @brief Fill in a song from its cache entry.
+	 * @param out the song, with its song directory already set.
+	 * @param iHash the directory hash the entry must have been written with.
+	 * @return true if the song was loaded. */
+	bool LoadSong( Song &out, unsigned iHash );
+	/**
+	 * @brief Read one chart's note data, in SM format.
+	 * @param sSongDir the song's directory.
+	 * @param iHash the directory hash the song was loaded with.
+	 * @param iOffset where the note data is within the song's entry.
+	 * @param iSize the size of the compressed note data.
+	 * @return true if the note data was read. */
+	bool LoadNoteData( const RString &sSongDir, unsigned iHash, size_t iOffset, size_t iSize, RString &sOut );
+	void SaveSong( const Song &song, unsigned iHash );
+	void RemoveSong( const RString &sSongDir );
+
+	bool IsDirty() const { return m_bDirty; }
+	bool WriteToDisk();
+
+private:
+	void OpenFile();
+
+	struct Entry
+	{
+		Entry(): iHash(0), iOffset(0), iSize(0), bPending(false) { }
+		unsigned iHash;
+		/* Where the song is in m_File, if it isn't pending. */
+		size_t iOffset;
+		size_t iSize;
+		/* Songs saved since the pack was last written. */
+		bool bPending;
+		RString sPending;
+	};
+
+	RString m_sGroup;
+	RString m_sPath;
+	map<RString, Entry> m_Entries;
+	RageFileMapping m_File;
+	bool m_bOpened;
+	bool m_bDirty;
+};
+
+#endif
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -56,6 +56,9 @@ static const ThemeMetric<int>		EXTRA_STAGE2_DIFFICULTY_MAX	( "SongManager", "Ext
 
 static Preference<RString> g_sDisabledSongs( "DisabledSongs", "" );
 static Preference<bool> g_bHideIncompleteCourses( "HideIncompleteCourses", false );
+/* Number of threads used to parse song directories at startup.  1 loads
+ * every song on the main thread, as before. */
+static Preference<int> g_iSongLoadingThreads( "SongLoadingThreads", 1 );
 
 RString SONG_GROUP_COLOR_NAME( size_t i )   { return ssprintf( "SongGroupColor%i", (int) i+1 ); }
 RString COURSE_GROUP_COLOR_NAME( size_t i ) { return ssprintf( "CourseGroupColor%i", (int) i+1 ); }
@@ -63,7 +66,7 @@ RString profile_song_group_color_name(size_t i) { return ssprintf("ProfileSongGr
 
 static const float next_loading_window_update= 0.02f;
 
-SongManager::SongManager()
+SongManager::SongManager(): m_iSongListRevision(0)
 {
 	// Register with Lua.
 	{
@@ -233,6 +236,8 @@ void SongManager::InitSongsFromDisk( LoadingWindow *ld, bool onlyAdditions )
 	IMAGECACHE->WriteToDisk();
 	IMAGECACHE->delay_save_cache = false;
 
+	++m_iSongListRevision;
+
 	LOG->Trace( "Found %d songs in %f seconds.", (int)m_pSongs.size(), tm.GetDeltaTime() );
 }
 
@@ -328,6 +333,61 @@ void SongManager::AddGroup( RString sDir, RString sGroupDirName )
 	//m_sSongGroupBackgroundPaths.push_back( sBackgroundPath );
 }
 
+/* Song directories handed out to the song loading threads.  Each thread
+ * claims the next unclaimed directory, so songs finish out of order; the main
+ * thread waits for them in order, so the song list, group index and caches are
+ * only ever touched from the main thread, in the same order as a serial load. */
+struct SongLoadQueue
+{
+	SongLoadQueue(): m_Lock("SongLoadQueue"), m_Finished("SongLoadFinished"), m_iNextSong(0) { }
+
+	vector<RString> m_sSongDirs;
+	vector<Song *> m_pSongs;
+	vector<bool> m_bDone;
+	RageMutex m_Lock;
+	RageSemaphore m_Finished;
+	size_t m_iNextSong;
+
+	static int LoadThread_start( void *p ) { ((SongLoadQueue *) p)->LoadThread(); return 0; }
+	void LoadThread()
+	{
+		for(;;)
+		{
+			m_Lock.Lock();
+			const size_t i = m_iNextSong++;
+			m_Lock.Unlock();
+			if( i >= m_sSongDirs.size() )
+				return;
+
+			Song *pNewSong = new Song;
+			if( !pNewSong->LoadFromSongDir( m_sSongDirs[i] ) )
+				SAFE_DELETE( pNewSong ); // The song failed to load.
+
+			m_Lock.Lock();
+			m_pSongs[i] = pNewSong;
+			m_bDone[i] = true;
+			m_Lock.Unlock();
+			m_Finished.Post();
+		}
+	}
+
+	// Block until the song at index i has been loaded.  Returns nullptr if it failed.
+	Song *WaitForSong( size_t i )
+	{
+		for(;;)
+		{
+			m_Lock.Lock();
+			const bool bDone = m_bDone[i];
+			m_Lock.Unlock();
+			if( bDone )
+				return m_pSongs[i];
+			// Loading a song that isn't cached can take a long time; don't
+			// treat that as a deadlock.
+			m_Finished.Wait( false );
+		}
+	}
+};
+
 static LocalizedString LOADING_SONGS ( "SongManager", "Loading songs..." );
 void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditions )
 {
@@ -381,6 +441,20 @@ void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditio
 		StripMacResourceForks( arraySongDirs );
 		SortRStringArray( arraySongDirs );
 
+		// Skip already loaded songs if onlyAdditions is set.
+		if( onlyAdditions )
+		{
+			vector<RString> arrayNewSongDirs;
+			for (RString const &sSongDirName : arraySongDirs)
+			{
+				SongID songID;
+				songID.FromString(sSongDirName);
+				if (songID.ToSong() == nullptr)
+					arrayNewSongDirs.push_back(sSongDirName);
+			}
+			arraySongDirs.swap(arrayNewSongDirs);
+		}
+
 		arrayGroupSongDirs.push_back(arraySongDirs);
 		songCount += arraySongDirs.size();
 
@@ -393,8 +467,30 @@ void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditio
 		ld->SetTotalWork( songCount );
 	}
 
+	// Parse the song directories on worker threads, if enabled.  The results
+	// are still added below, in order, on this thread.
+	const int iNumThreads = min( g_iSongLoadingThreads.Get(), songCount );
+	SongLoadQueue queue;
+	vector<RageThread> threads;
+	if( iNumThreads > 1 )
+	{
+		for (vector<RString> const &arraySongDirs : arrayGroupSongDirs)
+			queue.m_sSongDirs.insert( queue.m_sSongDirs.end(), arraySongDirs.begin(), arraySongDirs.end() );
+		queue.m_pSongs.resize( queue.m_sSongDirs.size(), nullptr );
+		queue.m_bDone.resize( queue.m_sSongDirs.size(), false );
+
+		LOG->Trace( "Loading %i songs on %i threads", songCount, iNumThreads );
+		threads.resize( iNumThreads );
+		for( int i = 0; i < iNumThreads; ++i )
+		{
+			threads[i].SetName( ssprintf("Song loading thread %i", i) );
+			threads[i].Create( SongLoadQueue::LoadThread_start, &queue );
+		}
+	}
+
 	groupIndex = 0;
 	songIndex = 0;
+	size_t queueIndex = 0;
 	for (RString const &sGroupDirName : arrayGroupDirs)	// foreach dir in /Songs/
 	{
 		vector<RString> &arraySongDirs = arrayGroupSongDirs[groupIndex++];
@@ -409,15 +505,6 @@ void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditio
 		{
 			RString sSongDirName = arraySongDirs[j];
 
-			// Skip already loaded songs if onlyAdditions is set.
-			if (onlyAdditions)
-			{
-				SongID songID;
-				songID.FromString(sSongDirName);
-				if (songID.ToSong() != nullptr)
-					continue;
-			}
-
 			// this is a song directory. Load a new song.
 			if(ld && loading_window_last_update_time.Ago() > next_loading_window_update)
 			{
@@ -431,12 +518,22 @@ void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditio
 				);
 			}
 
-			Song* pNewSong = new Song;
-			if( !pNewSong->LoadFromSongDir( sSongDirName ) )
+			Song* pNewSong;
+			if( !threads.empty() )
 			{
-				// The song failed to load.
-				delete pNewSong;
-				continue;
+				pNewSong = queue.WaitForSong( queueIndex++ );
+				if( pNewSong == nullptr )
+					continue; // The song failed to load.
+			}
+			else
+			{
+				pNewSong = new Song;
+				if( !pNewSong->LoadFromSongDir( sSongDirName ) )
+				{
+					// The song failed to load.
+					delete pNewSong;
+					continue;
+				}
 			}
 			AddSongToList(pNewSong);
 
@@ -460,6 +557,9 @@ void SongManager::LoadSongDir( RString sDir, LoadingWindow *ld, bool onlyAdditio
 		LoadGroupSymLinks(sDir, sGroupDirName);
 	}
 
+	for (RageThread &thread : threads)
+		thread.Wait();
+
 	if( ld ) {
 		ld->SetIndeterminate( true );
 	}
@@ -507,7 +607,8 @@ void SongManager::PreloadSongImages()
 		return;
 
 	/* Load textures before unloading old ones, so we don't reload textures
-	 * that we don't need to. */
+	 * that we don't need to.  They're decoded in the background and uploaded
+	 * a few per frame, rather than all at once here. */
 	RageTexturePreloader preload;
 
 	const vector<Song*> &songs = GetAllSongs();
@@ -517,7 +618,7 @@ void SongManager::PreloadSongImages()
 			continue;
 
 		const RageTextureID ID = Sprite::SongBannerTexture( songs[i]->GetBannerPath() );
-		preload.Load( ID );
+		preload.LoadAsync( ID );
 	}
 
 	vector<Course*> courses;
@@ -528,7 +629,7 @@ void SongManager::PreloadSongImages()
 			continue;
 
 		const RageTextureID ID = Sprite::SongBannerTexture( courses[i]->GetBannerPath() );
-		preload.Load( ID );
+		preload.LoadAsync( ID );
 	}
 
 	preload.Swap( m_TexturePreload );
@@ -546,6 +647,7 @@ void SongManager::FreeSongs()
 	}
 	m_pSongs.clear();
 	m_SongsByDir.clear();
+	++m_iSongListRevision;
 
 	// also free the songs that have been deleted from disk
 	for ( unsigned i=0; i<m_pDeletedSongs.size(); ++i ) 
@@ -564,6 +666,7 @@ void SongManager::UnlistSong(Song *song)
 	// cannot immediately free song data, as it is needed temporarily for smooth audio transitions, etc.
 	// Instead, remove it from the m_pSongs list and store it in a special place where it can safely be deleted later.
 	m_pDeletedSongs.push_back(song);
+	++m_iSongListRevision;
 
 	// remove all occurences of the song in each of our song vectors
 	vector<Song*>* songVectors[3] = { &m_pSongs, &m_pPopularSongs, &m_pShuffledSongs };
@@ -1146,6 +1249,9 @@ void SongManager::DeleteCourse( Course *pCourse )
 
 void SongManager::InvalidateCachedTrails()
 {
+	// This is called when unlocks change, which affects sorting by meter.
+	++m_iSongListRevision;
+
 	for (Course *pCourse : m_pCourses)
 	{
 		if( pCourse->IsAnEdit() )
@@ -1176,6 +1282,8 @@ void SongManager::Cleanup()
  * Courses and Songs is in Edit Mode, which updates the other pointers it needs. */
 void SongManager::Invalidate( const Song *pStaleSong )
 {
+	++m_iSongListRevision;
+
 	// TODO: This is unnecessarily expensive.
 	// Can we regenerate only the autogen courses that are affected?
 	DeleteAutogenCourses();
@@ -1206,6 +1314,7 @@ void SongManager::SetPreferences()
 		m_pSongs[i]->RemoveAutoGenNotes();
 		m_pSongs[i]->AddAutoGenNotes();
 	}
+	++m_iSongListRevision;
 }
 
 void SongManager::SaveEnabledSongsToPref()
@@ -1252,6 +1361,7 @@ void SongManager::GetStepsLoadedFromProfile( vector<Steps*> &AddTo, ProfileSlot
 void SongManager::DeleteSteps( Steps *pSteps )
 {
 	pSteps->m_pSong->DeleteSteps( pSteps );
+	++m_iSongListRevision;
 }
 
 void SongManager::GetAllCourses( vector<Course*> &AddTo, bool bIncludeAutogen ) const
@@ -1778,6 +1888,7 @@ void SongManager::UpdatePreferredSort(RString sPreferredSongs, RString sPreferre
 void SongManager::SortSongs()
 {
 	SongUtil::SortSongPointerArrayByTitle( m_pSongs );
+	++m_iSongListRevision;
 }
 
 void SongManager::UpdateRankingCourses()
@@ -1810,6 +1921,8 @@ void SongManager::RefreshCourseGroupInfo()
 
 void SongManager::LoadStepEditsFromProfileDir( const RString &sProfileDir, ProfileSlot slot )
 {
+	++m_iSongListRevision;
+
 	// Load all edit steps
 	RString sDir = sProfileDir + EDIT_STEPS_SUBDIR;
 	SSCLoader loaderSSC;
@@ -1933,10 +2046,13 @@ void SongManager::AddSongToList(Song* new_song)
 	RString dir= new_song->GetSongDir();
 	dir.MakeLower();
 	m_SongsByDir.insert(make_pair(dir, new_song));
+	++m_iSongListRevision;
 }
 
 void SongManager::FreeAllLoadedFromProfile( ProfileSlot slot )
 {
+	++m_iSongListRevision;
+
 	// Profile courses may refer to profile steps, so free profile courses first.
 	vector<Course*> apToDelete;
 	for (Course *pCourse : m_pCourses)
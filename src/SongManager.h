@@ -118,6 +118,13 @@ public:
 	 * @brief Retrieve all of the songs in the game.
 	 * @return all of the songs. */
 	const vector<Song*> &GetAllSongs() const { return GetSongs(GROUP_ALL); }
+	/**
+	 * @brief Retrieve a number that changes whenever the song list, or
+	 * anything songs are sorted by, may have changed.
+	 *
+	 * This includes steps being edited, and songs or steps being unlocked.
+	 * @return the current revision. */
+	int GetSongListRevision() const { return m_iSongListRevision; }
 	/**
 	 * @brief Retrieve all of the popular songs.
 	 *
@@ -205,6 +212,7 @@ protected:
 	void AddSongToList(Song* new_song);
 	/** @brief All of the songs that can be played. */
 	vector<Song*>		m_pSongs;
+	int			m_iSongListRevision;
 	map<RString, Song*> m_SongsByDir;
 	set<RString> m_GroupsToNeverCache;
 
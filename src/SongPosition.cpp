@@ -13,7 +13,7 @@ void SongPosition::UpdateSongPosition( float fPositionSeconds, const TimingData
 
 	TimingData::GetBeatArgs beat_info;
 	beat_info.elapsed_time= fPositionSeconds;
-	timing.GetBeatAndBPSFromElapsedTime(beat_info);
+	timing.GetBeatAndBPSFromElapsedTime(beat_info, m_BeatCursor);
 	m_fSongBeat= beat_info.beat;
 	m_fCurBPS= beat_info.bps_out;
 	m_bFreeze= beat_info.freeze_out;
@@ -27,13 +27,13 @@ void SongPosition::UpdateSongPosition( float fPositionSeconds, const TimingData
 
 	m_fMusicSeconds = fPositionSeconds;
 
-	m_fLightSongBeat = timing.GetBeatFromElapsedTime( fPositionSeconds + g_fLightsAheadSeconds );
+	m_fLightSongBeat = timing.GetBeatFromElapsedTime( fPositionSeconds + g_fLightsAheadSeconds, m_LightBeatCursor );
 
-	m_fSongBeatNoOffset = timing.GetBeatFromElapsedTimeNoOffset( fPositionSeconds );
+	m_fSongBeatNoOffset = timing.GetBeatFromElapsedTimeNoOffset( fPositionSeconds, m_BeatNoOffsetCursor );
 	
 	m_fMusicSecondsVisible = fPositionSeconds - g_fVisualDelaySeconds.Get() - fAdditionalVisualDelay;
 	beat_info.elapsed_time= m_fMusicSecondsVisible;
-	timing.GetBeatAndBPSFromElapsedTime(beat_info);
+	timing.GetBeatAndBPSFromElapsedTime(beat_info, m_BeatVisibleCursor);
 	m_fSongBeatVisible= beat_info.beat;
 }
 
@@ -54,6 +54,11 @@ void SongPosition::Reset()
 	m_iWarpBeginRow = -1; // Set to -1 because some song may want to warp to row 0. -aj
 	m_fWarpDestination = -1; // Set when a warp is encountered. also see above. -aj
 
+	m_BeatCursor.Reset();
+	m_LightBeatCursor.Reset();
+	m_BeatNoOffsetCursor.Reset();
+	m_BeatVisibleCursor.Reset();
+
 }
 
 //lua start
@@ -33,6 +33,14 @@ public:
 	float		m_fMusicSecondsVisible;
 	float		m_fSongBeatVisible;
 
+	/** @brief Where each of the lookups in UpdateSongPosition left off.
+	 *
+	 * Each one looks at a different time, so each gets its own cursor. */
+	TimingData::Cursor	m_BeatCursor;
+	TimingData::Cursor	m_LightBeatCursor;
+	TimingData::Cursor	m_BeatNoOffsetCursor;
+	TimingData::Cursor	m_BeatVisibleCursor;
+
 	void Reset();
 	void UpdateSongPosition( float fPositionSeconds, const TimingData &timing, const RageTimer &timestamp = RageZeroTimer, float fAdditionalVisualDelay = 0.0f );
 
@@ -344,20 +344,6 @@ void SongUtil::DeleteDuplicateSteps( Song *pSong, vector<Steps*> &vSteps )
 static LocalizedString SORT_NOT_AVAILABLE( "Sort", "NotAvailable" );
 static LocalizedString SORT_OTHER        ( "Sort", "Other" );
 
-/* Just calculating GetNumTimesPlayed within the sort is pretty slow, so let's precompute
- * it.  (This could be generalized with a template.) */
-static map<const Song*, RString> g_mapSongSortVal;
-
-static bool CompareSongPointersBySortValueAscending( const Song *pSong1, const Song *pSong2 )
-{
-	return g_mapSongSortVal[pSong1] < g_mapSongSortVal[pSong2];
-}
-
-static bool CompareSongPointersBySortValueDescending( const Song *pSong1, const Song *pSong2 )
-{
-	return g_mapSongSortVal[pSong1] > g_mapSongSortVal[pSong2];
-}
-
 
 RString SongUtil::MakeSortString( RString s )
 {
@@ -375,32 +361,47 @@ RString SongUtil::MakeSortString( RString s )
 	return s;
 }
 
-static bool CompareSongPointersByTitle( const Song *pSong1, const Song *pSong2 )
+/* Calling MakeSortString and GetSongFilePath inside the sort is slow on large
+ * libraries, so precompute everything the title comparison needs. */
+struct TitleSortKey
+{
+	TitleSortKey( Song *p ):
+		pSong(p),
+		sMainTitle( p->GetTranslitMainTitle() ),
+		sSortMainTitle( SongUtil::MakeSortString(sMainTitle) ),
+		sSortSubTitle( SongUtil::MakeSortString(p->GetTranslitSubTitle()) ),
+		sSongFilePath( p->GetSongFilePath() ) { }
+
+	Song *pSong;
+	RString sMainTitle;
+	RString sSortMainTitle;
+	RString sSortSubTitle;
+	RString sSongFilePath;
+};
+
+static bool CompareTitleSortKeys( const TitleSortKey &k1, const TitleSortKey &k2 )
 {
 	// Prefer transliterations to full titles
-	RString s1 = pSong1->GetTranslitMainTitle();
-	RString s2 = pSong2->GetTranslitMainTitle();
-	if( s1 == s2 )
-	{
-		s1 = pSong1->GetTranslitSubTitle();
-		s2 = pSong2->GetTranslitSubTitle();
-	}
-
-	s1 = SongUtil::MakeSortString(s1);
-	s2 = SongUtil::MakeSortString(s2);
-
-	int ret = strcmp( s1, s2 );
+	int ret;
+	if( k1.sMainTitle == k2.sMainTitle )
+		ret = strcmp( k1.sSortSubTitle, k2.sSortSubTitle );
+	else
+		ret = strcmp( k1.sSortMainTitle, k2.sSortMainTitle );
 	if(ret < 0) return true;
 	if(ret > 0) return false;
 
 	/* The titles are the same.  Ensure we get a consistent ordering
 	 * by comparing the unique SongFilePaths. */
-	return pSong1->GetSongFilePath().CompareNoCase(pSong2->GetSongFilePath()) < 0;
+	return k1.sSongFilePath.CompareNoCase(k2.sSongFilePath) < 0;
 }
 
 void SongUtil::SortSongPointerArrayByTitle( vector<Song*> &vpSongsInOut )
 {
-	sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersByTitle );
+	vector<TitleSortKey> vKeys( vpSongsInOut.begin(), vpSongsInOut.end() );
+	sort( vKeys.begin(), vKeys.end(), CompareTitleSortKeys );
+
+	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
+		vpSongsInOut[i] = vKeys[i].pSong;
 }
 
 static bool CompareSongPointersByBPM( const Song *pSong1, const Song *pSong2 )
@@ -460,6 +461,24 @@ static bool CompAscending( const pair<Song *, RString> &a, const pair<Song *, RS
 	return a.second < b.second;
 }
 
+/* Sort by a precomputed value for each song, keeping songs with equal values
+ * in their original order.  vsSortValues is consumed. */
+static void StableSortBySortValue( vector<Song*> &vpSongsInOut, vector<RString> &vsSortValues, bool bDescending )
+{
+	ASSERT( vpSongsInOut.size() == vsSortValues.size() );
+	vector< pair<Song *, RString> > vals( vpSongsInOut.size() );
+	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
+	{
+		vals[i].first = vpSongsInOut[i];
+		vals[i].second.swap( vsSortValues[i] );
+	}
+
+	stable_sort( vals.begin(), vals.end(), bDescending ? CompDescending : CompAscending );
+
+	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
+		vpSongsInOut[i] = vals[i].first;
+}
+
 void SongUtil::SortSongPointerArrayByGrades( vector<Song*> &vpSongsInOut, bool bDescending )
 {
 	/* Optimize by pre-writing a string to compare, since doing
@@ -493,18 +512,20 @@ void SongUtil::SortSongPointerArrayByGrades( vector<Song*> &vpSongsInOut, bool b
 
 void SongUtil::SortSongPointerArrayByArtist( vector<Song*> &vpSongsInOut )
 {
+	vector<RString> vsSortValues( vpSongsInOut.size() );
 	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
-		g_mapSongSortVal[vpSongsInOut[i]] = MakeSortString( vpSongsInOut[i]->GetTranslitArtist() );
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersBySortValueAscending );
+		vsSortValues[i] = MakeSortString( vpSongsInOut[i]->GetTranslitArtist() );
+	StableSortBySortValue( vpSongsInOut, vsSortValues, false );
 }
 
 /* This is for internal use, not display; sorting by Unicode codepoints isn't very
  * interesting for display. */
 void SongUtil::SortSongPointerArrayByDisplayArtist( vector<Song*> &vpSongsInOut )
 {
+	vector<RString> vsSortValues( vpSongsInOut.size() );
 	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
-		g_mapSongSortVal[vpSongsInOut[i]] = MakeSortString( vpSongsInOut[i]->GetDisplayArtist() );
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersBySortValueAscending );
+		vsSortValues[i] = MakeSortString( vpSongsInOut[i]->GetDisplayArtist() );
+	StableSortBySortValue( vpSongsInOut, vsSortValues, false );
 }
 
 static int CompareSongPointersByGenre(const Song *pSong1, const Song *pSong2)
@@ -522,10 +543,10 @@ int SongUtil::CompareSongPointersByGroup(const Song *pSong1, const Song *pSong2)
 	return pSong1->m_sGroupName < pSong2->m_sGroupName;
 }
 
-static int CompareSongPointersByGroupAndTitle( const Song *pSong1, const Song *pSong2 )
+static bool CompareTitleSortKeysByGroupAndTitle( const TitleSortKey &k1, const TitleSortKey &k2 )
 {
-	const RString &sGroup1 = pSong1->m_sGroupName;
-	const RString &sGroup2 = pSong2->m_sGroupName;
+	const RString &sGroup1 = k1.pSong->m_sGroupName;
+	const RString &sGroup2 = k2.pSong->m_sGroupName;
 
 	if( sGroup1 < sGroup2 )
 		return true;
@@ -533,12 +554,16 @@ static int CompareSongPointersByGroupAndTitle( const Song *pSong1, const Song *p
 		return false;
 
 	/* Same group; compare by name. */
-	return CompareSongPointersByTitle( pSong1, pSong2 );
+	return CompareTitleSortKeys( k1, k2 );
 }
 
 void SongUtil::SortSongPointerArrayByGroupAndTitle( vector<Song*> &vpSongsInOut )
 {
-	sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersByGroupAndTitle );
+	vector<TitleSortKey> vKeys( vpSongsInOut.begin(), vpSongsInOut.end() );
+	sort( vKeys.begin(), vKeys.end(), CompareTitleSortKeysByGroupAndTitle );
+
+	for( unsigned i = 0; i < vpSongsInOut.size(); ++i )
+		vpSongsInOut[i] = vKeys[i].pSong;
 }
 
 void SongUtil::SortSongPointerArrayByNumPlays( vector<Song*> &vpSongsInOut, ProfileSlot slot, bool bDescending )
@@ -552,10 +577,10 @@ void SongUtil::SortSongPointerArrayByNumPlays( vector<Song*> &vpSongsInOut, Prof
 void SongUtil::SortSongPointerArrayByNumPlays( vector<Song*> &vpSongsInOut, const Profile* pProfile, bool bDescending )
 {
 	ASSERT( pProfile != nullptr );
+	vector<RString> vsSortValues( vpSongsInOut.size() );
 	for(unsigned i = 0; i < vpSongsInOut.size(); ++i)
-		g_mapSongSortVal[vpSongsInOut[i]] = ssprintf("%9i", pProfile->GetSongNumTimesPlayed(vpSongsInOut[i]));
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), bDescending ? CompareSongPointersBySortValueDescending : CompareSongPointersBySortValueAscending );
-	g_mapSongSortVal.clear();
+		vsSortValues[i] = ssprintf("%9i", pProfile->GetSongNumTimesPlayed(vpSongsInOut[i]));
+	StableSortBySortValue( vpSongsInOut, vsSortValues, bDescending );
 }
 
 RString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so )
@@ -671,31 +696,54 @@ RString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 
 void SongUtil::SortSongPointerArrayBySectionName( vector<Song*> &vpSongsInOut, SortOrder so )
 {
+	vector<RString> vsSortValues( vpSongsInOut.size() );
+	for(unsigned i = 0; i < vpSongsInOut.size(); ++i)
+		vsSortValues[i] = GetSectionNameFromSongAndSort( vpSongsInOut[i], so );
+	SortSongPointerArrayBySectionName( vpSongsInOut, vsSortValues );
+}
+
+void SongUtil::SortSongPointerArrayBySectionName( vector<Song*> &vpSongsInOut, vector<RString> &vsSectionNamesInOut )
+{
+	ASSERT( vpSongsInOut.size() == vsSectionNamesInOut.size() );
 	RString sOther = SORT_OTHER.GetValue();
+
+	/* Sort the section names along with the songs. */
+	typedef pair< pair<RString, unsigned>, RString > val;
+	vector<val> vals( vpSongsInOut.size() );
 	for(unsigned i = 0; i < vpSongsInOut.size(); ++i)
 	{
-		RString val = GetSectionNameFromSongAndSort( vpSongsInOut[i], so );
+		const RString &sSection = vsSectionNamesInOut[i];
 
 		// Make sure 0-9 comes first and OTHER comes last.
-		if( val == "0-9" )			val = "0";
-		else if( val == sOther )	val = "2";
-		else						val = "1" + MakeSortString(val);
-
-		g_mapSongSortVal[vpSongsInOut[i]] = val;
+		RString &sSortValue = vals[i].first.first;
+		if( sSection == "0-9" )			sSortValue = "0";
+		else if( sSection == sOther )	sSortValue = "2";
+		else						sSortValue = "1" + MakeSortString(sSection);
+
+		/* Tie-break on the original position, so this is a stable sort. */
+		vals[i].first.second = i;
+		vals[i].second.swap( vsSectionNamesInOut[i] );
 	}
 
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersBySortValueAscending );
-	g_mapSongSortVal.clear();
+	sort( vals.begin(), vals.end() );
+
+	vector<Song*> vpSongs( vpSongsInOut.size() );
+	for(unsigned i = 0; i < vals.size(); ++i)
+	{
+		vpSongs[i] = vpSongsInOut[vals[i].first.second];
+		vsSectionNamesInOut[i].swap( vals[i].second );
+	}
+	vpSongsInOut.swap( vpSongs );
 }
 
 void SongUtil::SortSongPointerArrayByStepsTypeAndMeter( vector<Song*> &vpSongsInOut, StepsType st, Difficulty dc )
 {
-	g_mapSongSortVal.clear();
+	vector<RString> vsSortValues( vpSongsInOut.size() );
 	for(unsigned i = 0; i < vpSongsInOut.size(); ++i)
 	{
 		// Ignore locked steps.
 		const Steps* pSteps = GetClosestNotes( vpSongsInOut[i], st, dc, true );
-		RString &s = g_mapSongSortVal[vpSongsInOut[i]];
+		RString &s = vsSortValues[i];
 		s = ssprintf("%03d", pSteps ? pSteps->GetMeter() : 0);
 
 		/* pSteps may not be exactly the difficulty we want; for example, we
@@ -710,22 +758,22 @@ void SongUtil::SortSongPointerArrayByStepsTypeAndMeter( vector<Song*> &vpSongsIn
 		if( PREFSMAN->m_bSubSortByNumSteps )
 			s += ssprintf("%06.0f",pSteps ? pSteps->GetRadarValues(PLAYER_1)[RadarCategory_TapsAndHolds] : 0);
 	}
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersBySortValueAscending );
+	StableSortBySortValue( vpSongsInOut, vsSortValues, false );
 }
 
 void SongUtil::SortByMostRecentlyPlayedForMachine( vector<Song*> &vpSongsInOut )
 {
 	Profile *pProfile = PROFILEMAN->GetMachineProfile();
 
-	for (Song const *s : vpSongsInOut)
+	vector<RString> vsSortValues( vpSongsInOut.size() );
+	for(unsigned i = 0; i < vpSongsInOut.size(); ++i)
 	{
+		const Song *s = vpSongsInOut[i];
 		int iNumTimesPlayed = pProfile->GetSongNumTimesPlayed( s );
-		RString val = iNumTimesPlayed ? pProfile->GetSongLastPlayedDateTime(s).GetString() : "0";
-		g_mapSongSortVal[s] = val;
+		vsSortValues[i] = iNumTimesPlayed ? pProfile->GetSongLastPlayedDateTime(s).GetString() : "0";
 	}
 
-	stable_sort( vpSongsInOut.begin(), vpSongsInOut.end(), CompareSongPointersBySortValueDescending );
-	g_mapSongSortVal.clear();
+	StableSortBySortValue( vpSongsInOut, vsSortValues, true );
 }
 
 bool SongUtil::IsEditDescriptionUnique( const Song* pSong, StepsType st, const RString &sPreferredDescription, const Steps *pExclude )
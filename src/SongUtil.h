@@ -144,6 +144,9 @@ namespace SongUtil
 	void SortSongPointerArrayByStepsTypeAndMeter( vector<Song*> &vpSongsInOut, StepsType st, Difficulty dc );
 	RString GetSectionNameFromSongAndSort( const Song *pSong, SortOrder so );
 	void SortSongPointerArrayBySectionName( vector<Song*> &vpSongsInOut, SortOrder so );
+	/* As above, with each song's section name already known.  The names
+	 * are sorted along with the songs. */
+	void SortSongPointerArrayBySectionName( vector<Song*> &vpSongsInOut, vector<RString> &vsSectionNamesInOut );
 	void SortByMostRecentlyPlayedForMachine( vector<Song*> &vpSongsInOut );
 	void SortSongPointerArrayByLength( vector<Song*> &vpSongsInOut );
 
@@ -977,6 +977,7 @@ static void ApplyLogPreferences()
 	LOG->SetInfoToDisk( true );
 	LOG->SetUserLogToDisk( true );
 	LOG->SetFlushing( PREFSMAN->m_bForceLogFlush );
+	LOG->SetLogTraces( PREFSMAN->m_bLogTraces );
 	Checkpoints::LogCheckpoints( PREFSMAN->m_bLogCheckpoints );
 }
 
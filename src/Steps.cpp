@@ -28,7 +28,11 @@
 #include "NotesLoaderDWI.h"
 #include "NotesLoaderKSF.h"
 #include "NotesLoaderBMS.h"
+#include "Preference.h"
+#include "RageThreads.h"
+#include "SongCacheIndex.h"
 #include <algorithm>
+#include <list>
 
 /* register DisplayBPM with StringConversion */
 #include "EnumHelper.h"
@@ -45,9 +49,63 @@ static const char *DisplayBPMNames[] =
 XToString( DisplayBPM );
 LuaXType( DisplayBPM );
 
+/* Charts whose NoteData was read from disk on demand by the main thread, most
+ * recently used first.  Once there are more of them than
+ * ResidentNoteDataCharts, the coldest ones are compressed again; they can
+ * always be read back.
+ *
+ * The song loading threads also read charts from disk, to calculate radar
+ * values for the song they're loading.  Those aren't tracked, and never evict
+ * anything: the evicted chart could belong to a song in use on another
+ * thread.  The song compresses them itself when it finishes loading. */
+static Preference<int> g_iResidentNoteDataCharts( "ResidentNoteDataCharts", 32 );
+static RageMutex g_ResidentNoteDataLock( "ResidentNoteData" );
+static list<const Steps *> g_ResidentNoteData;
+static map<const Steps *, list<const Steps *>::iterator> g_ResidentNoteDataPos;
+
+/* Static initialization runs on the main thread. */
+static const uint64_t g_iMainThreadID = RageThread::GetCurrentThreadID();
+
+/* Mark pSteps as the most recently used chart, and return the charts that no
+ * longer fit. */
+static void TouchResidentNoteData( const Steps *pSteps, vector<const Steps *> &vpEvict )
+{
+	LockMut( g_ResidentNoteDataLock );
+	map<const Steps *, list<const Steps *>::iterator>::iterator it = g_ResidentNoteDataPos.find( pSteps );
+	if( it != g_ResidentNoteDataPos.end() )
+	{
+		g_ResidentNoteData.splice( g_ResidentNoteData.begin(), g_ResidentNoteData, it->second );
+		return;
+	}
+
+	g_ResidentNoteData.push_front( pSteps );
+	g_ResidentNoteDataPos[pSteps] = g_ResidentNoteData.begin();
+
+	const size_t iMax = max( g_iResidentNoteDataCharts.Get(), 1 );
+	while( g_ResidentNoteData.size() > iMax )
+	{
+		const Steps *pCold = g_ResidentNoteData.back();
+		g_ResidentNoteData.pop_back();
+		g_ResidentNoteDataPos.erase( pCold );
+		vpEvict.push_back( pCold );
+	}
+}
+
+static void ForgetResidentNoteData( const Steps *pSteps )
+{
+	LockMut( g_ResidentNoteDataLock );
+	map<const Steps *, list<const Steps *>::iterator>::iterator it = g_ResidentNoteDataPos.find( pSteps );
+	if( it == g_ResidentNoteDataPos.end() )
+		return;
+	g_ResidentNoteData.erase( it->second );
+	g_ResidentNoteDataPos.erase( it );
+}
+
 Steps::Steps(Song *song): m_StepsType(StepsType_Invalid), m_pSong(song),
 	parent(nullptr), m_pNoteData(new NoteData), m_bNoteDataIsFilled(false), 
-	m_sNoteDataCompressed(""), m_sFilename(""), m_bSavedToDisk(false), 
+	m_sNoteDataCompressed(""), m_bNoteDataIsPagedIn(false),
+	m_iCacheHash(0), m_iCacheNoteDataOffset(0), m_iCacheNoteDataSize(0),
+	m_sFilename(""), m_bSavedToDisk(false), 
 	m_LoadedFromProfile(ProfileSlot_Invalid), m_iHash(0),
 	m_sDescription(""), m_sChartStyle(""), 
 	m_Difficulty(Difficulty_Invalid), m_iMeter(0),
@@ -57,6 +115,8 @@ Steps::Steps(Song *song): m_StepsType(StepsType_Invalid), m_pSong(song),
 
 Steps::~Steps()
 {
+	if( m_bNoteDataIsPagedIn )
+		ForgetResidentNoteData( this );
 }
 
 void Steps::GetDisplayBpms( DisplayBpms &AddTo ) const
@@ -170,6 +230,30 @@ bool Steps::GetNoteDataFromSimfile()
 	return false;
 }
 
+void Steps::SetCachedNoteDataLocation( unsigned iHash, unsigned iOffset, unsigned iSize )
+{
+	m_iCacheHash = iHash;
+	m_iCacheNoteDataOffset = iOffset;
+	m_iCacheNoteDataSize = iSize;
+}
+
+bool Steps::GetNoteDataFromCache()
+{
+	if( m_iCacheHash == 0 || m_pSong == nullptr || SONGINDEX == nullptr )
+		return false;
+
+	RString sNoteData;
+	if( !SONGINDEX->LoadNoteDataFromCache(*m_pSong, m_iCacheHash, m_iCacheNoteDataOffset, m_iCacheNoteDataSize, sNoteData) )
+	{
+		/* Don't try again; the simfile is still there. */
+		m_iCacheHash = 0;
+		return false;
+	}
+
+	SetSMNoteData( sNoteData );
+	return true;
+}
+
 void Steps::SetNoteData( const NoteData& noteDataNew )
 {
 	ASSERT( noteDataNew.GetNumTracks() == GAMEMAN->GetStepsTypeInfo(m_StepsType).iNumTracks );
@@ -181,6 +265,14 @@ void Steps::SetNoteData( const NoteData& noteDataNew )
 	
 	m_sNoteDataCompressed = RString();
 	m_iHash = 0;
+
+	/* The cached copy is out of date, and this data can't be thrown away. */
+	m_iCacheHash = 0;
+	if( m_bNoteDataIsPagedIn )
+	{
+		ForgetResidentNoteData( this );
+		m_bNoteDataIsPagedIn = false;
+	}
 }
 
 void Steps::GetNoteData( NoteData& noteDataOut ) const
@@ -374,7 +466,15 @@ bool stepstype_is_kickbox(StepsType st)
 void Steps::Decompress()
 {
 	if( m_bNoteDataIsFilled )
-		return;	// already decompressed
+	{
+		// already decompressed
+		if( m_bNoteDataIsPagedIn )
+		{
+			vector<const Steps *> vpEvict;
+			TouchResidentNoteData( this, vpEvict );
+		}
+		return;
+	}
 
 	if( parent )
 	{
@@ -414,10 +514,13 @@ void Steps::Decompress()
 		return;
 	}
 
+	bool bPagedIn = false;
 	if( !m_sFilename.empty() && m_sNoteDataCompressed.empty() )
 	{
-		// We have NoteData on disk and not in memory. Load it.
-		if (!this->GetNoteDataFromSimfile())
+		/* We have NoteData on disk and not in memory. Load it, from the song
+		 * cache if it's there, since that doesn't mean parsing the whole
+		 * simfile. */
+		if( !this->GetNoteDataFromCache() && !this->GetNoteDataFromSimfile() )
 		{
 			LOG->Warn("Couldn't load the %s chart's NoteData from \"%s\"",
 					  DifficultyToString(m_Difficulty).c_str(), m_sFilename.c_str());
@@ -425,6 +528,8 @@ void Steps::Decompress()
 		}
 
 		this->GetSMNoteData( m_sNoteDataCompressed );
+		bPagedIn = m_LoadedFromProfile == ProfileSlot_Invalid &&
+			RageThread::GetCurrentThreadID() == g_iMainThreadID;
 	}
 
 	if( m_sNoteDataCompressed.empty() )
@@ -440,10 +545,27 @@ void Steps::Decompress()
 
 		NoteDataUtil::LoadFromSMNoteDataString( *m_pNoteData, m_sNoteDataCompressed, bComposite );
 	}
+
+	/* Keep track of what the main thread has read from disk, and let go of
+	 * whatever hasn't been used for the longest. */
+	if( bPagedIn && m_bNoteDataIsFilled )
+	{
+		m_bNoteDataIsPagedIn = true;
+		vector<const Steps *> vpEvict;
+		TouchResidentNoteData( this, vpEvict );
+		for (Steps const *pCold : vpEvict)
+			pCold->Compress();
+	}
 }
 
 void Steps::Compress() const
 {
+	if( m_bNoteDataIsPagedIn )
+	{
+		ForgetResidentNoteData( this );
+		m_bNoteDataIsPagedIn = false;
+	}
+
 	// Always leave lights data uncompressed.
 	if( this->m_StepsType == StepsType_lights_cabinet && m_bNoteDataIsFilled )
 	{
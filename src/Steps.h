@@ -150,6 +150,20 @@ public:
 	 * @return true if successful, false for failure. */
 	bool GetNoteDataFromSimfile();
 
+	/**
+	 * @brief Record where the NoteData is kept in the song cache.
+	 *
+	 * Once this is set, Decompress() reads the NoteData from the cache pack
+	 * instead of parsing the simfile again.
+	 * @param iHash the directory hash of the song's cache entry.
+	 * @param iOffset where the NoteData is within the song's cache entry.
+	 * @param iSize the size of the compressed NoteData. */
+	void SetCachedNoteDataLocation( unsigned iHash, unsigned iOffset, unsigned iSize );
+	/**
+	 * @brief Retrieve the NoteData from the song cache.
+	 * @return true if successful, false for failure. */
+	bool GetNoteDataFromCache();
+
 	/**
 	 * @brief Determine if we are missing any note data.
 	 *
@@ -225,6 +239,17 @@ private:
 	mutable HiddenPtr<NoteData>	m_pNoteData;
 	mutable bool			m_bNoteDataIsFilled;
 	mutable RString			m_sNoteDataCompressed;
+	/** @brief true if the NoteData was read from disk on demand, and may be
+	 * compressed again once it hasn't been used for a while. */
+	mutable bool			m_bNoteDataIsPagedIn;
+
+	/** @brief The cache entry hash the NoteData location was recorded with,
+	 * or 0 if the NoteData isn't in the song cache. */
+	unsigned			m_iCacheHash;
+	/** @brief Where the compressed NoteData is within the song's cache entry. */
+	unsigned			m_iCacheNoteDataOffset;
+	/** @brief The size of the compressed NoteData in the song cache. */
+	unsigned			m_iCacheNoteDataSize;
 
 	/** @brief The name of the file where these steps are stored. */
 	RString				m_sFilename;
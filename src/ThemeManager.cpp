@@ -27,6 +27,7 @@
 #include "PrefsManager.h"
 #include "XmlFileUtil.h"
 #include <deque>
+#include <unordered_map>
 
 ThemeManager*	THEME = nullptr;	// global object accessible from anywhere in the program
 
@@ -116,14 +117,60 @@ void ThemeManager::Unsubscribe( IThemeMetric *p )
 }
 
 
+struct RStringHash
+{
+	size_t operator()( const RString &s ) const { return hash<string>()( s ); }
+};
+struct RStringPairHash
+{
+	size_t operator()( const pair<RString,RString> &p ) const
+	{
+		return hash<string>()( p.first ) * 31 + hash<string>()( p.second );
+	}
+};
+
 // We spend a lot of time doing redundant theme path lookups. Cache results.
-static map<RString, ThemeManager::PathInfo> g_ThemePathCache[NUM_ElementCategory];
+static unordered_map<RString, ThemeManager::PathInfo, RStringHash> g_ThemePathCache[NUM_ElementCategory];
 void ThemeManager::ClearThemePathCache()
 {
 	for( int i = 0; i < NUM_ElementCategory; ++i )
 		g_ThemePathCache[i].clear();
 }
 
+/* Metric lookups walk the group's fallbacks, and each fallback is a Lua
+ * expression.  Screens read hundreds of metrics when they load, mostly the
+ * same ones every time, so cache what each (group, name) lookup resolved to,
+ * including lookups that found nothing.  Cleared whenever the metrics or the
+ * Lua globals that fallbacks may use are reloaded. */
+struct CachedMetric
+{
+	bool bFound;
+	RString sValue;
+};
+typedef unordered_map<pair<RString,RString>, CachedMetric, RStringPairHash> MetricCache;
+static MetricCache g_MetricCache;
+static MetricCache g_StringCache;
+/* Fallbacks that are string literals; see GetMetricsGroupFallback. */
+static unordered_map<RString, RString, RStringHash> g_MetricsGroupFallbackCache;
+
+static void ClearMetricCache()
+{
+	g_MetricCache.clear();
+	g_StringCache.clear();
+	g_MetricsGroupFallbackCache.clear();
+}
+
+static MetricCache *GetMetricCache( const IniFile &ini )
+{
+	if( g_pLoadedThemeData == nullptr )
+		return nullptr;
+	if( &ini == &g_pLoadedThemeData->iniMetrics )
+		return &g_MetricCache;
+	if( &ini == &g_pLoadedThemeData->iniStrings )
+		return &g_StringCache;
+	return nullptr;
+}
+
 static void FileNameToMetricsGroupAndElement( const RString &sFileName, RString &sMetricsGroupOut, RString &sElementOut )
 {
 	// split into class name and file name
@@ -368,6 +415,7 @@ void ThemeManager::LoadThemeMetrics( const RString &sThemeName_, const RString &
 
 		g_pLoadedThemeData->iniMetrics.SetValue( sBits[0], sBits[1], sBits[2] );
 	}
+	ClearMetricCache();
 
 	LOG->MapLog( "theme", "Theme: %s", m_sCurThemeName.c_str() );
 	LOG->MapLog( "language", "Language: %s", m_sCurLanguage.c_str() );
@@ -558,6 +606,9 @@ void ThemeManager::UpdateLuaGlobals()
 	RunLuaScripts( "*.lua" );
 	// run theme scripts
 	RunLuaScripts( "*.lua", true );
+
+	// Fallbacks may have been evaluated before the scripts they use were run.
+	ClearMetricCache();
 #endif
 }
 
@@ -772,9 +823,10 @@ bool ThemeManager::GetPathInfoToRaw( PathInfo &out, const RString &sThemeName_,
 	}
 }
 
-bool ThemeManager::GetPathInfoToAndFallback( PathInfo &out, ElementCategory category, const RString &sMetricsGroup_, const RString &sElement ) 
+bool ThemeManager::GetPathInfoToAndFallback( PathInfo &out, ElementCategory category, const RString &sMetricsGroup_, const RString &sElement, bool &bCacheable ) 
 {
 	RString sMetricsGroup( sMetricsGroup_ );
+	bCacheable = true;
 
 	int n = 100;
 	while( n-- )
@@ -790,7 +842,7 @@ bool ThemeManager::GetPathInfoToAndFallback( PathInfo &out, ElementCategory cate
 			return false;
 
 		// search fallback name (if any)
-		sMetricsGroup = GetMetricsGroupFallback( sMetricsGroup );
+		sMetricsGroup = GetMetricsGroupFallback( sMetricsGroup, &bCacheable );
 		if( sMetricsGroup.empty() )
 			return false;
 	}
@@ -809,9 +861,9 @@ bool ThemeManager::GetPathInfo( PathInfo &out, ElementCategory category, const R
 
 	RString sFileName = MetricsGroupAndElementToFileName( sMetricsGroup, sElement );
 
-	map<RString, PathInfo> &Cache = g_ThemePathCache[category];
+	unordered_map<RString, PathInfo, RStringHash> &Cache = g_ThemePathCache[category];
 	{
-		map<RString, PathInfo>::const_iterator i;
+		unordered_map<RString, PathInfo, RStringHash>::const_iterator i;
 
 		i = Cache.find( sFileName );
 		if( i != Cache.end() )
@@ -824,15 +876,18 @@ bool ThemeManager::GetPathInfo( PathInfo &out, ElementCategory category, const R
 try_element_again:
 
 	// search the current theme
-	if( GetPathInfoToAndFallback( out, category, sMetricsGroup, sElement ) )	// we found something
+	bool bCacheable;
+	if( GetPathInfoToAndFallback( out, category, sMetricsGroup, sElement, bCacheable ) )	// we found something
 	{
-		Cache[sFileName] = out;
+		if( bCacheable )
+			Cache[sFileName] = out;
 		return true;
 	}
 
 	if( bOptional )
 	{
-		Cache[sFileName] = PathInfo();	// clear cache entry
+		if( bCacheable )
+			Cache[sFileName] = PathInfo();	// clear cache entry
 		return false;
 	}
 
@@ -939,45 +994,97 @@ void ThemeManager::ReloadMetrics()
 }
 
 
-RString ThemeManager::GetMetricsGroupFallback( const RString &sMetricsGroup )
+RString ThemeManager::GetMetricsGroupFallback( const RString &sMetricsGroup, bool *pLiteral )
 {
 	ASSERT( g_pLoadedThemeData != nullptr );
 
+	unordered_map<RString, RString, RStringHash>::const_iterator it = g_MetricsGroupFallbackCache.find( sMetricsGroup );
+	if( it != g_MetricsGroupFallbackCache.end() )
+		return it->second;
+
 	// always look in iniMetrics for "Fallback"
 	RString sFallback;
-	if( !GetMetricRawRecursive(g_pLoadedThemeData->iniMetrics,sMetricsGroup,"Fallback",sFallback) )
-		return RString();
-
-	Lua *L = LUA->Get();
-	LuaHelpers::RunExpression( L, sFallback );
 	RString sRet;
-	LuaHelpers::Pop( L, sRet );
-	LUA->Release( L );
+	if( GetMetricRawRecursive(g_pLoadedThemeData->iniMetrics,sMetricsGroup,"Fallback",sFallback) )
+	{
+		/* Almost every fallback is a plain string literal, which can't change
+		 * until the metrics are reloaded.  Anything else is a Lua expression
+		 * that may depend on the game state, so it's run every time, and the
+		 * metrics and paths found through it aren't cached either. */
+		RString sLiteral = sFallback;
+		Trim( sLiteral );
+		const size_t iLen = sLiteral.size();
+		if( iLen >= 2 && (sLiteral[0] == '"' || sLiteral[0] == '\'') && sLiteral[iLen-1] == sLiteral[0] &&
+			sLiteral.find_first_of("\"'\\", 1) == iLen-1 )
+		{
+			sRet = sLiteral.substr( 1, iLen-2 );
+		}
+		else
+		{
+			Lua *L = LUA->Get();
+			LuaHelpers::RunExpression( L, sFallback );
+			LuaHelpers::Pop( L, sRet );
+			LUA->Release( L );
+			if( pLiteral != nullptr )
+				*pLiteral = false;
+			return sRet;
+		}
+	}
 
+	g_MetricsGroupFallbackCache[sMetricsGroup] = sRet;
 	return sRet;
 }
 
 bool ThemeManager::GetMetricRawRecursive( const IniFile &ini, const RString &sMetricsGroup_, const RString &sValueName, RString &sOut )
 {
 	ASSERT( sValueName != "" );
+
+	MetricCache *pCache = GetMetricCache( ini );
+	pair<RString,RString> key( sMetricsGroup_, sValueName );
+	if( pCache != nullptr )
+	{
+		MetricCache::const_iterator it = pCache->find( key );
+		if( it != pCache->end() )
+		{
+			if( it->second.bFound )
+				sOut = it->second.sValue;
+			return it->second.bFound;
+		}
+	}
+
 	RString sMetricsGroup( sMetricsGroup_ );
+	bool bFound = false;
+	bool bCacheable = true;
 
 	int n = 100;
-	while( n-- )
+	for( ; n > 0; --n )
 	{
 		if( ini.GetValue(sMetricsGroup,sValueName,sOut) )
-			return true;
+		{
+			bFound = true;
+			break;
+		}
 
 		if( !sValueName.compare("Fallback") )
-			return false;
+			break;
 
-		sMetricsGroup = GetMetricsGroupFallback( sMetricsGroup );
+		sMetricsGroup = GetMetricsGroupFallback( sMetricsGroup, &bCacheable );
 		if( sMetricsGroup.empty() )
-			return false;
+			break;
 	}
 
-	LuaHelpers::ReportScriptErrorFmt("Infinite recursion looking up theme metric \"%s::%s\".", sMetricsGroup.c_str(), sValueName.c_str());
-	return false;
+	if( n == 0 )
+		LuaHelpers::ReportScriptErrorFmt("Infinite recursion looking up theme metric \"%s::%s\".", sMetricsGroup.c_str(), sValueName.c_str());
+
+	// Don't cache anything found through a fallback that was a Lua expression.
+	if( pCache != nullptr && bCacheable )
+	{
+		CachedMetric &cached = (*pCache)[key];
+		cached.bFound = bFound;
+		if( bFound )
+			cached.sValue = sOut;
+	}
+	return bFound;
 }
 
 RString ThemeManager::GetMetricRaw( const IniFile &ini, const RString &sMetricsGroup_, const RString &sValueName_ )
@@ -95,7 +95,9 @@ public:
 
 	void GetMetricsThatBeginWith( const RString &sMetricsGroup, const RString &sValueName, set<RString> &vsValueNamesOut );
 
-	RString GetMetricsGroupFallback( const RString &sMetricsGroup );
+	/* If pLiteral is set, it's cleared if the fallback was a Lua expression,
+	 * whose result can change, so anything found through it mustn't be cached. */
+	RString GetMetricsGroupFallback( const RString &sMetricsGroup, bool *pLiteral = nullptr );
 
 	static RString GetBlankGraphicPath();
 
@@ -114,7 +116,7 @@ protected:
 	RString GetMetricRaw( const IniFile &ini, const RString &sMetricsGroup, const RString &sValueName );
 	bool GetMetricRawRecursive( const IniFile &ini, const RString &sMetricsGroup, const RString &sValueName, RString &sRet );
 
-	bool GetPathInfoToAndFallback( PathInfo &out, ElementCategory category, const RString &sMetricsGroup, const RString &sFile );
+	bool GetPathInfoToAndFallback( PathInfo &out, ElementCategory category, const RString &sMetricsGroup, const RString &sFile, bool &bCacheable );
 	bool GetPathInfoToRaw( PathInfo &out, const RString &sThemeName, ElementCategory category, const RString &sMetricsGroup, const RString &sFile );
 	static RString GetThemeDirFromName( const RString &sThemeName );
 	RString GetElementDir( const RString &sThemeName );
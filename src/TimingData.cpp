@@ -7,13 +7,15 @@
 #include "ThemeManager.h"
 #include "NoteTypes.h"
 #include <float.h>
+#include <atomic>
 
 static void EraseSegment(vector<TimingSegment*> &vSegs, int index, TimingSegment *cur);
 static const int INVALID_INDEX = -1;
 
 TimingSegment* GetSegmentAtRow( int iNoteRow, TimingSegmentType tst );
 
-TimingData::TimingData(float fOffset) : m_fBeat0OffsetInSeconds(fOffset)
+TimingData::TimingData(float fOffset) : m_lookup_generation(0),
+	m_lookup_prepared(false), m_fBeat0OffsetInSeconds(fOffset)
 {
 }
 
@@ -36,6 +38,7 @@ void TimingData::Copy( const TimingData& cpy )
 
 void TimingData::Clear()
 {
+	m_lookup_prepared= false;
 	/* Delete all pointers owned by this TimingData. */
 	FOREACH_TimingSegmentType( tst )
 	{
@@ -115,6 +118,7 @@ void TimingData::PrepareLookup()
 	{
 		ReleaseLookup();
 	}
+	m_lookup_prepared= true;
 	// DumpLookupTables();
 }
 
@@ -132,6 +136,12 @@ void TimingData::ReleaseLookup()
 	CLEAR_LOOKUP(m_beat_start_lookup);
 	CLEAR_LOOKUP(m_time_start_lookup);
 #undef CLEAR_LOOKUP
+	// Generations are unique across all TimingData, so a cursor can't be
+	// fooled by another TimingData allocated at the same address.  Songs
+	// load on several threads, so this is atomic.
+	static std::atomic<unsigned int> next_generation(0);
+	m_lookup_generation= ++next_generation;
+	m_lookup_prepared= false;
 }
 
 RString SegInfoStr(const vector<TimingSegment*>& segs, unsigned int index, const RString& name)
@@ -807,6 +817,20 @@ void FindEvent(int& event_row, int& event_type,
 	}
 }
 
+float TimingData::GetBPSAtStart(const GetBeatStarts& start) const
+{
+	// The last bpm segment passed is the one in effect, unless the next one
+	// is on the same row and hasn't been reached yet.  Checking that is
+	// cheaper than searching for the segment at the row.
+	const vector<TimingSegment*>& bpms= m_avpTimingSegments[SEGMENT_BPM];
+	if(start.bpm > 0 &&
+		(start.bpm == bpms.size() || bpms[start.bpm]->GetRow() > start.last_row))
+	{
+		return ToBPM(bpms[start.bpm-1])->GetBPS();
+	}
+	return GetBPMAtRow(start.last_row) / 60.0f;
+}
+
 void TimingData::GetBeatInternal(GetBeatStarts& start, GetBeatArgs& args,
 	unsigned int max_segment) const
 {
@@ -816,7 +840,7 @@ void TimingData::GetBeatInternal(GetBeatStarts& start, GetBeatArgs& args,
 	const vector<TimingSegment*>& delays= m_avpTimingSegments[SEGMENT_DELAY];
 	unsigned int curr_segment= start.bpm+start.warp+start.stop+start.delay;
 
-	float bps= GetBPMAtRow(start.last_row) / 60.0f;
+	float bps= GetBPSAtStart(start);
 #define INC_INDEX(index) ++curr_segment; ++index;
 
 	while(curr_segment < max_segment)
@@ -858,6 +882,8 @@ void TimingData::GetBeatInternal(GetBeatStarts& start, GetBeatArgs& args,
 						args.delay_out= true;
 						args.beat= ss->GetBeat();
 						args.bps_out= bps;
+						// Leave start at the delay so a cursor can resume from it.
+						start.last_row= event_row;
 						return;
 					}
 					start.last_time= next_event_time;
@@ -878,6 +904,7 @@ void TimingData::GetBeatInternal(GetBeatStarts& start, GetBeatArgs& args,
 						args.delay_out= false;
 						args.beat= ss->GetBeat();
 						args.bps_out= bps;
+						start.last_row= event_row;
 						return;
 					}
 					start.last_time= next_event_time;
@@ -911,6 +938,52 @@ void TimingData::GetBeatInternal(GetBeatStarts& start, GetBeatArgs& args,
 	args.bps_out= bps;
 }
 
+void TimingData::GetBeatAndBPSFromElapsedTime(GetBeatArgs& args, Cursor& cursor) const
+{
+	args.elapsed_time += GAMESTATE->m_SongOptions.GetCurrent().m_fMusicRate * PREFSMAN->m_fGlobalOffsetSeconds;
+	GetBeatAndBPSFromElapsedTimeNoOffset(args, cursor);
+}
+
+void TimingData::GetBeatAndBPSFromElapsedTimeNoOffset(GetBeatArgs& args, Cursor& cursor) const
+{
+	if(!CanResumeCursor(cursor, true) ||
+		args.elapsed_time < cursor.start.last_time)
+	{
+		SeekCursor(cursor, true, args.elapsed_time);
+	}
+	args.warp_begin_out= cursor.warp_begin;
+	args.warp_dest_out= cursor.warp_dest;
+	GetBeatInternal(cursor.start, args, INT_MAX);
+	cursor.warp_begin= args.warp_begin_out;
+	cursor.warp_dest= args.warp_dest_out;
+}
+
+bool TimingData::CanResumeCursor(const Cursor& cursor, bool beat_from_time) const
+{
+	return m_lookup_prepared && cursor.timing == this &&
+		cursor.generation == m_lookup_generation &&
+		cursor.beat_from_time == beat_from_time;
+}
+
+void TimingData::SeekCursor(Cursor& cursor, bool beat_from_time, float entry) const
+{
+	const beat_start_lookup_t& lookup= beat_from_time ?
+		m_beat_start_lookup : m_time_start_lookup;
+	cursor.timing= this;
+	cursor.generation= m_lookup_generation;
+	cursor.beat_from_time= beat_from_time;
+	cursor.start= GetBeatStarts();
+	cursor.start.last_time= -m_fBeat0OffsetInSeconds;
+	beat_start_lookup_t::const_iterator looked_up_start=
+		FindEntryInLookup(lookup, entry);
+	if(looked_up_start != lookup.end())
+	{
+		cursor.start= looked_up_start->second;
+	}
+	cursor.warp_begin= -1;
+	cursor.warp_dest= 0;
+}
+
 void TimingData::GetBeatAndBPSFromElapsedTimeNoOffset(GetBeatArgs& args) const
 {
 	GetBeatStarts start;
@@ -933,7 +1006,7 @@ float TimingData::GetElapsedTimeInternal(GetBeatStarts& start, float beat,
 	const vector<TimingSegment*>& delays= m_avpTimingSegments[SEGMENT_DELAY];
 	unsigned int curr_segment= start.bpm+start.warp+start.stop+start.delay;
 
-	float bps= GetBPMAtRow(start.last_row) / 60.0f;
+	float bps= GetBPSAtStart(start);
 #define INC_INDEX(index) ++curr_segment; ++index;
 	bool find_marker= beat < FLT_MAX;
 
@@ -946,6 +1019,12 @@ float TimingData::GetElapsedTimeInternal(GetBeatStarts& start, float beat,
 		float time_to_next_event= start.is_warping ? 0 :
 			NoteRowToBeat(event_row - start.last_row) / bps;
 		float next_event_time= start.last_time + time_to_next_event;
+		if(event_type == FOUND_MARKER)
+		{
+			// The marker isn't an event, so start is left at the last real one
+			// for a cursor to resume from.
+			return next_event_time;
+		}
 		start.last_time= next_event_time;
 		switch(event_type)
 		{
@@ -969,8 +1048,6 @@ float TimingData::GetElapsedTimeInternal(GetBeatStarts& start, float beat,
 				start.last_time= next_event_time;
 				INC_INDEX(start.delay);
 				break;
-			case FOUND_MARKER:
-				return start.last_time;
 			case FOUND_WARP:
 				{
 					start.is_warping= true;
@@ -1006,8 +1083,25 @@ float TimingData::GetElapsedTimeFromBeatNoOffset( float fBeat ) const
 	{
 		start= looked_up_start->second;
 	}
-	GetElapsedTimeInternal(start, fBeat, INT_MAX);
-	return start.last_time;
+	return GetElapsedTimeInternal(start, fBeat, INT_MAX);
+}
+
+float TimingData::GetElapsedTimeFromBeat( float fBeat, Cursor& cursor ) const
+{
+	return TimingData::GetElapsedTimeFromBeatNoOffset( fBeat, cursor )
+		- GAMESTATE->m_SongOptions.GetCurrent().m_fMusicRate * PREFSMAN->m_fGlobalOffsetSeconds;
+}
+
+float TimingData::GetElapsedTimeFromBeatNoOffset( float fBeat, Cursor& cursor ) const
+{
+	// Every event at or before the cursor's row may already have been
+	// passed, so only a beat past that row can continue from it.
+	if(!CanResumeCursor(cursor, false) ||
+		BeatToNoteRow(fBeat) <= cursor.start.last_row)
+	{
+		SeekCursor(cursor, false, fBeat);
+	}
+	return GetElapsedTimeInternal(cursor.start, fBeat, INT_MAX);
 }
 
 float TimingData::GetDisplayedBeat( float fBeat ) const
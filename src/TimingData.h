@@ -70,7 +70,8 @@ public:
 	void Clear();
 	bool IsSafeFullTiming();
 
-	TimingData( const TimingData &cpy ) { Copy(cpy); }
+	TimingData( const TimingData &cpy ) :m_lookup_generation(0),
+		m_lookup_prepared(false) { Copy(cpy); }
 	TimingData& operator=( const TimingData &cpy ) { Copy(cpy); return *this; }
 
 	// GetBeatArgs, GetBeatStarts, m_beat_start_lookup, m_time_start_lookup,
@@ -125,6 +126,36 @@ public:
 	typedef vector<lookup_item_t> beat_start_lookup_t;
 	beat_start_lookup_t m_beat_start_lookup;
 	beat_start_lookup_t m_time_start_lookup;
+	// Changes every time the lookup tables are prepared or released, so that
+	// cursors made against an older version of the timing data aren't used.
+	unsigned int m_lookup_generation;
+	bool m_lookup_prepared;
+
+	// A cursor remembers where the last lookup through it left off, so a
+	// caller asking about steadily increasing times or beats (once a frame
+	// during gameplay) only walks the segments passed since its last call,
+	// instead of starting over from the lookup tables each time.  Asking
+	// about an earlier time or beat seeks the same way the plain functions
+	// do.
+	// Nothing tells a cursor when segments are edited, so cursors are only
+	// resumed while the lookup tables from PrepareLookup are in place.  At
+	// other times they behave exactly like the plain functions.
+	// Use a separate cursor for each series of lookups.  A cursor shared by
+	// two series that don't move together will seek on every call.
+	struct Cursor
+	{
+		const TimingData* timing;
+		unsigned int generation;
+		bool beat_from_time;
+		GetBeatStarts start;
+		// The last warp passed, so that GetBeatArgs::warp_begin_out and
+		// warp_dest_out don't depend on which segments this call walked.
+		int warp_begin;
+		float warp_dest;
+		Cursor() :timing(nullptr), generation(0), beat_from_time(false),
+			warp_begin(-1), warp_dest(0) {}
+		void Reset() { timing= nullptr; }
+	};
 
 	void PrepareLookup();
 	void ReleaseLookup();
@@ -356,7 +387,11 @@ public:
 		unsigned int max_segment) const;
 	float GetElapsedTimeInternal(GetBeatStarts& start, float beat,
 		unsigned int max_segment) const;
+	float GetBPSAtStart(const GetBeatStarts& start) const;
+	bool CanResumeCursor(const Cursor& cursor, bool beat_from_time) const;
+	void SeekCursor(Cursor& cursor, bool beat_from_time, float entry) const;
 	void GetBeatAndBPSFromElapsedTime(GetBeatArgs& args) const;
+	void GetBeatAndBPSFromElapsedTime(GetBeatArgs& args, Cursor& cursor) const;
 	float GetBeatFromElapsedTime(float elapsed_time) const	// shortcut for places that care only about the beat
 	{
 		GetBeatArgs args;
@@ -364,9 +399,18 @@ public:
 		GetBeatAndBPSFromElapsedTime(args);
 		return args.beat;
 	}
+	float GetBeatFromElapsedTime(float elapsed_time, Cursor& cursor) const
+	{
+		GetBeatArgs args;
+		args.elapsed_time= elapsed_time;
+		GetBeatAndBPSFromElapsedTime(args, cursor);
+		return args.beat;
+	}
 	float GetElapsedTimeFromBeat( float fBeat ) const;
+	float GetElapsedTimeFromBeat( float fBeat, Cursor& cursor ) const;
 
 	void GetBeatAndBPSFromElapsedTimeNoOffset(GetBeatArgs& args) const;
+	void GetBeatAndBPSFromElapsedTimeNoOffset(GetBeatArgs& args, Cursor& cursor) const;
 	float GetBeatFromElapsedTimeNoOffset(float elapsed_time) const	// shortcut for places that care only about the beat
 	{
 		GetBeatArgs args;
@@ -374,7 +418,15 @@ public:
 		GetBeatAndBPSFromElapsedTimeNoOffset(args);
 		return args.beat;
 	}
+	float GetBeatFromElapsedTimeNoOffset(float elapsed_time, Cursor& cursor) const
+	{
+		GetBeatArgs args;
+		args.elapsed_time= elapsed_time;
+		GetBeatAndBPSFromElapsedTimeNoOffset(args, cursor);
+		return args.beat;
+	}
 	float GetElapsedTimeFromBeatNoOffset( float fBeat ) const;
+	float GetElapsedTimeFromBeatNoOffset( float fBeat, Cursor& cursor ) const;
 	float GetDisplayedBeat( float fBeat ) const;
 
 	bool HasBpmChanges() const { return GetTimingSegments(SEGMENT_BPM).size() > 1; }
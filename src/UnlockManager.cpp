@@ -654,8 +654,9 @@ void UnlockManager::Load()
 			str += ( " (found course)" );
 		LOG->Trace( "%s", str.c_str() );
 	}
-	
-	return;
+
+	m_vbLocked.clear();
+	UpdateLockedState();
 }
 
 
@@ -688,6 +689,7 @@ void UnlockManager::UnlockEntryID( RString sEntryID )
 {
 	PROFILEMAN->GetMachineProfile()->m_UnlockedEntryIDs.insert( sEntryID );
 	SONGMAN->InvalidateCachedTrails();
+	UpdateLockedState();
 }
 
 void UnlockManager::UnlockEntryIndex( int iEntryIndex )
@@ -700,6 +702,7 @@ void UnlockManager::LockEntryID( RString entryID )
 {
 	PROFILEMAN->GetMachineProfile()->m_UnlockedEntryIDs.erase( entryID );
 	SONGMAN->InvalidateCachedTrails();
+	UpdateLockedState();
 }
 
 void UnlockManager::LockEntryIndex( int entryIndex )
@@ -708,6 +711,23 @@ void UnlockManager::LockEntryIndex( int entryIndex )
 	LockEntryID( entryID );
 }
 
+void UnlockManager::UpdateLockedState()
+{
+	vector<bool> vbLocked;
+	vbLocked.reserve( m_UnlockEntries.size() );
+	for (UnlockEntry const &e : m_UnlockEntries)
+		vbLocked.push_back( e.IsLocked() );
+
+	if( vbLocked == m_vbLocked )
+		return;
+	m_vbLocked.swap( vbLocked );
+
+	/* SONGMAN may not exist yet on the first load; it starts with a fresh
+	 * song list anyway. */
+	if( SONGMAN != nullptr )
+		SONGMAN->InvalidateCachedTrails();
+}
+
 void UnlockManager::PreferUnlockEntryID( RString sUnlockEntryID )
 {
 	for( unsigned i = 0; i < m_UnlockEntries.size(); ++i )
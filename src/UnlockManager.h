@@ -144,6 +144,11 @@ public:
 	void LockEntryID( RString entryID );
 	void LockEntryIndex( int entryIndex );
 
+	/* Entries also unlock as the machine profile earns points or passes
+	 * steps.  Call this when that may have changed; if any entry did, the
+	 * song list revision is bumped so cached song lists are rebuilt. */
+	void UpdateLockedState();
+
 	/*
 	 * If a code is associated with at least one song or course, set the preferred song
 	 * and/or course in GAMESTATE to them.
@@ -177,6 +182,9 @@ private:
 	void Load();
 	
 	set<RString> m_RouletteCodes; // "codes" which are available in roulette and which unlock if rouletted
+
+	// The IsLocked() of each entry as of the last UpdateLockedState.
+	vector<bool> m_vbLocked;
 };
 
 extern UnlockManager*	UNLOCKMAN;  // global and accessible from anywhere in program
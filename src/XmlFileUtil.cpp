@@ -479,6 +479,273 @@ void XmlFileUtil::Load( XNode *pNode, const RString &sXml, RString &sErrorOut )
 	LoadInternal( pNode, sXml, sErrorOut, 0 );
 }
 
+XmlFileUtil::PullParser::PullParser( const RString &sXml ):
+	m_sXml(sXml), m_iPos(0), m_bEmptyElement(false)
+{
+	InitEntities();
+}
+
+XmlFileUtil::PullParser::Event XmlFileUtil::PullParser::SetError( const RString &sError )
+{
+	if( m_sError.empty() )
+		m_sError = sError;
+	m_iPos = RString::npos;
+	return Error;
+}
+
+bool XmlFileUtil::PullParser::GetAttrValue( const RString &sName, RString &sOut ) const
+{
+	for( unsigned i = 0; i < m_vAttrs.size(); ++i )
+	{
+		if( m_vAttrs[i].first == sName )
+		{
+			sOut = m_vAttrs[i].second;
+			return true;
+		}
+	}
+	return false;
+}
+
+// attr1="value1" attr2='value2' attr3=value3 />
+// Leaves m_iPos at the '>', '/' or '?' that ends the tag.
+bool XmlFileUtil::PullParser::ParseAttributes()
+{
+	const RString &xml = m_sXml;
+	for(;;)
+	{
+		tcsskip( xml, m_iPos );
+		if( m_iPos == RString::npos )
+			return false;
+
+		// close tag
+		if( xml[m_iPos] == chXMLTagClose || xml[m_iPos] == chXMLTagPre || xml[m_iPos] == chXMLQuestion || xml[m_iPos] == chXMLDash )
+			return true;
+
+		RString::size_type iEnd = xml.find_first_of( " =", m_iPos );
+		if( iEnd == RString::npos )
+		{
+			SetError( ssprintf("<%s> attribute has error ", m_sName.c_str()) );
+			return false;
+		}
+
+		m_vAttrs.push_back( make_pair(RString(), RString()) );
+		SetString( xml, m_iPos, iEnd, &m_vAttrs.back().first );
+		m_iPos = iEnd;
+
+		tcsskip( xml, m_iPos );
+		if( m_iPos == RString::npos || xml[m_iPos] != '=' )
+			continue;
+		++m_iPos;
+		tcsskip( xml, m_iPos );
+		if( m_iPos == RString::npos )
+			return false;
+
+		char quote = xml[m_iPos];
+		if( quote == '"' || quote == '\'' )
+		{
+			++m_iPos;
+			iEnd = xml.find( quote, m_iPos );
+		}
+		else
+		{
+			// none quote mode, as Load accepts
+			iEnd = xml.find_first_of( " >", m_iPos );
+		}
+		if( iEnd == RString::npos )
+		{
+			SetError( ssprintf("<%s> attribute text: couldn't find matching quote", m_vAttrs.back().first.c_str()) );
+			return false;
+		}
+
+		RString &sValue = m_vAttrs.back().second;
+		SetString( xml, m_iPos, iEnd, &sValue, true );
+		ReplaceEntityText( sValue, g_mapEntitiesToChars );
+		m_iPos = iEnd;
+		if( quote == '"' || quote == '\'' )
+			++m_iPos;
+	}
+}
+
+XmlFileUtil::PullParser::Event XmlFileUtil::PullParser::Next()
+{
+	if( m_iPos == RString::npos )
+		return m_sError.empty()? EndDocument:Error;
+
+	if( m_bEmptyElement )
+	{
+		m_bEmptyElement = false;
+		m_sName = m_vsOpen.back();
+		m_vsOpen.pop_back();
+		return EndElement;
+	}
+
+	const RString &xml = m_sXml;
+	for(;;)
+	{
+		RString::size_type iTag = xml.find( chXMLTagOpen, m_iPos );
+
+		// Text between tags.  Only whitespace is allowed outside of elements.
+		if( !m_vsOpen.empty() )
+		{
+			RString::size_type iEnd = iTag == RString::npos? xml.size():iTag;
+			RString::size_type iFirst = xml.find_first_not_of( " \t\r\n", m_iPos );
+			if( iFirst != RString::npos && iFirst < iEnd )
+			{
+				if( iTag == RString::npos )
+					return SetError( ssprintf("%s must be closed with </%s>", m_vsOpen.back().c_str(), m_vsOpen.back().c_str()) );
+				m_sText = RString();
+				SetString( xml, m_iPos, iEnd, &m_sText, true );
+				ReplaceEntityText( m_sText, g_mapEntitiesToChars );
+				m_iPos = iEnd;
+				return Text;
+			}
+		}
+
+		if( iTag == RString::npos )
+		{
+			m_iPos = RString::npos;
+			if( !m_vsOpen.empty() )
+				return SetError( ssprintf("%s must be closed with </%s>", m_vsOpen.back().c_str(), m_vsOpen.back().c_str()) );
+			return EndDocument;
+		}
+		m_iPos = iTag;
+
+		// <!-- comment -->
+		if( !xml.compare(m_iPos+1, 3, "!--") )
+		{
+			RString::size_type iEnd = xml.find( "-->", m_iPos+4 );
+			if( iEnd == RString::npos )
+				return SetError( "Unterminated comment" );
+			m_iPos = iEnd + 3;
+			continue;
+		}
+
+		// <?xml ... ?> and <!DOCTYPE ...>: meta tags are ignored.
+		if( m_iPos+1 < xml.size() && (xml[m_iPos+1] == chXMLQuestion || xml[m_iPos+1] == chXMLExclamation) )
+		{
+			RString::size_type iEnd = xml.find( chXMLTagClose, m_iPos );
+			if( iEnd == RString::npos )
+				return SetError( "Element must be closed." );
+			m_iPos = iEnd + 1;
+			continue;
+		}
+
+		// </TAG>
+		if( m_iPos+1 < xml.size() && xml[m_iPos+1] == chXMLTagPre )
+		{
+			m_iPos += 2;
+			tcsskip( xml, m_iPos );
+			RString::size_type iEnd = m_iPos == RString::npos? RString::npos:xml.find_first_of( " >", m_iPos );
+			if( m_vsOpen.empty() )
+				return SetError( "Unexpected close tag" );
+			if( iEnd == RString::npos )
+				return SetError( ssprintf("it must be closed with </%s>", m_vsOpen.back().c_str()) );
+
+			m_sName = RString();
+			SetString( xml, m_iPos, iEnd, &m_sName );
+			if( m_sName != m_vsOpen.back() )
+				return SetError( ssprintf("'<%s> ... </%s>' is not well-formed.", m_vsOpen.back().c_str(), m_sName.c_str()) );
+			iEnd = xml.find( chXMLTagClose, iEnd );
+			m_iPos = iEnd == RString::npos? xml.size():iEnd + 1;
+			m_vsOpen.pop_back();
+			return EndElement;
+		}
+
+		// <TAG attr="value" ...> or <TAG ... />
+		++m_iPos;
+		RString::size_type iNameEnd = xml.find_first_of( " \t\r\n/>", m_iPos );
+		if( iNameEnd == RString::npos )
+			return SetError( "Element must be closed." );
+		m_sName = RString();
+		SetString( xml, m_iPos, iNameEnd, &m_sName );
+		m_iPos = iNameEnd;
+
+		m_vAttrs.clear();
+		if( !ParseAttributes() )
+			return SetError( "Element must be closed." );
+
+		if( xml[m_iPos] != chXMLTagClose )
+		{
+			++m_iPos;
+			if( m_iPos == xml.size() || xml[m_iPos] != chXMLTagClose )
+				return SetError( "Element must be closed." );
+			m_bEmptyElement = true;
+		}
+		++m_iPos;
+
+		m_vsOpen.push_back( m_sName );
+		return StartElement;
+	}
+}
+
+bool XmlFileUtil::PullParser::ReadElement( XNode *pNode )
+{
+	pNode->Clear();
+	pNode->SetName( m_sName );
+	for( unsigned i = 0; i < m_vAttrs.size(); ++i )
+		pNode->AppendAttr( m_vAttrs[i].first, m_vAttrs[i].second );
+
+	/* Like Load, <TAG>text</TAG> and <TAG></TAG> both get a text value,
+	 * which is the text before the first child; <TAG/> doesn't. */
+	bool bHasText = false;
+	if( !m_bEmptyElement )
+	{
+		pNode->AppendAttr( XNode::TEXT_ATTRIBUTE, RString() );
+		bHasText = true;
+	}
+	bool bAnyChildren = false;
+
+	for(;;)
+	{
+		switch( Next() )
+		{
+		case StartElement:
+		{
+			XNode *pChild = new XNode;
+			if( !ReadElement(pChild) )
+			{
+				delete pChild;
+				return false;
+			}
+			pNode->AppendChild( pChild );
+			bAnyChildren = true;
+			break;
+		}
+		case Text:
+			if( bHasText && !bAnyChildren )
+				pNode->GetAttr( XNode::TEXT_ATTRIBUTE )->SetValue( m_sText );
+			break;
+		case EndElement:
+			return true;
+		case EndDocument:
+			SetError( ssprintf("%s must be closed with </%s>", pNode->GetName().c_str(), pNode->GetName().c_str()) );
+			return false;
+		case Error:
+			return false;
+		}
+	}
+}
+
+bool XmlFileUtil::PullParser::SkipElement()
+{
+	const int iDepth = GetDepth();
+	for(;;)
+	{
+		switch( Next() )
+		{
+		case EndElement:
+			if( GetDepth() < iDepth )
+				return true;
+			break;
+		case EndDocument:
+		case Error:
+			return false;
+		default:
+			break;
+		}
+	}
+}
+
 bool XmlFileUtil::GetXML( const XNode *pNode, RageFileBasic &f, bool bWriteTabs )
 {
 	int iTabBase = 0;
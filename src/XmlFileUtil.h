@@ -26,6 +26,62 @@ namespace XmlFileUtil
 	XNode *XNodeFromTable( lua_State *L );
 
 	void MergeIniUnder( XNode *pFrom, XNode *pTo );
+
+	/**
+	 * @brief Read an XML document one tag at a time.
+	 *
+	 * Load builds an XNode for every element in the document before any of
+	 * it can be used.  This reports elements as they're reached instead, so a
+	 * large document can be loaded a piece at a time: ReadElement builds the
+	 * XNode for just the element it's at.  Text and attributes are handled
+	 * the same way Load handles them.  The document must outlive the parser. */
+	class PullParser
+	{
+	public:
+		enum Event
+		{
+			StartElement,	/**< An element started; GetName and GetAttrValue apply. */
+			EndElement,	/**< The innermost open element ended. */
+			Text,		/**< Text inside an element; see GetText. */
+			EndDocument,	/**< Every element has been read. */
+			Error		/**< The document is malformed; see GetError. */
+		};
+
+		PullParser( const RString &sXml );
+
+		Event Next();
+
+		const RString &GetName() const { return m_sName; }
+		bool GetAttrValue( const RString &sName, RString &sOut ) const;
+		const RString &GetText() const { return m_sText; }
+		const RString &GetError() const { return m_sError; }
+		/** @brief The number of elements open, including one just started. */
+		int GetDepth() const { return m_vsOpen.size(); }
+
+		/**
+		 * @brief Build the element that just started, and everything in it.
+		 *
+		 * Call this right after Next returns StartElement.  Afterwards, the
+		 * parser is past the element's end tag.
+		 * @return true if the element was read. */
+		bool ReadElement( XNode *pNode );
+		/** @brief Like ReadElement, but throw the element away. */
+		bool SkipElement();
+
+	private:
+		Event SetError( const RString &sError );
+		bool ParseAttributes();
+
+		const RString &m_sXml;
+		RString::size_type m_iPos;
+		vector<RString> m_vsOpen;
+		RString m_sName;
+		vector< pair<RString,RString> > m_vAttrs;
+		RString m_sText;
+		RString m_sError;
+		/* The element that just started was <TAG/>; its end comes next. */
+		bool m_bEmptyElement;
+	};
 }
 
 #endif
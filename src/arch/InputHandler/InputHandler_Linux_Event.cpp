@@ -14,8 +14,10 @@
 #endif
 
 #include <errno.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
 #include <linux/input.h>
 
 REGISTER_INPUT_HANDLER_CLASS2( LinuxEvent, Linux_Event );
@@ -61,6 +63,22 @@ struct EventDevice
 	RString m_sName;
 	InputDevice m_Dev;
 
+	/* The clock the kernel stamps this device's events with. */
+	clockid_t m_iClock;
+	/* Set after SYN_DROPPED, until the next SYN_REPORT. */
+	bool m_bDropping;
+
+	/* The key and axis states we last reported, to resync against after
+	 * SYN_DROPPED.  Only touched by the input thread once it's running. */
+	uint8_t m_aKeyState[KEY_MAX/8 + 1];
+	uint8_t m_aABSMask[ABS_MAX/8 + 1];
+	int m_aiAbsValue[ABS_MAX];
+
+	/* Written by the input thread; guarded by g_StatsLock. */
+	uint64_t m_iEvents, m_iReads;
+	int m_iMaxQueueDepth, m_iDropped;
+	int64_t m_iTotalLatencyUs, m_iMaxLatencyUs;
+
 	int aiAbsMin[ABS_MAX];
 	int aiAbsMax[ABS_MAX];
 	DeviceButton aiAbsMappingHigh[ABS_MAX];
@@ -68,6 +86,7 @@ struct EventDevice
 };
 
 static vector<EventDevice *> g_apEventDevices;
+static RageMutex g_StatsLock( "InputHandler_Linux_Event stats" );
 
 static bool BitIsSet( const uint8_t *pArray, uint32_t iBit )
 {
@@ -77,19 +96,35 @@ static bool BitIsSet( const uint8_t *pArray, uint32_t iBit )
 EventDevice::EventDevice()
 {
 	m_iFD = -1;
+	m_iClock = CLOCK_REALTIME;
+	m_bDropping = false;
+	m_iEvents = m_iReads = 0;
+	m_iMaxQueueDepth = m_iDropped = 0;
+	m_iTotalLatencyUs = m_iMaxLatencyUs = 0;
+	memset( m_aKeyState, 0, sizeof(m_aKeyState) );
+	memset( m_aABSMask, 0, sizeof(m_aABSMask) );
+	memset( m_aiAbsValue, 0, sizeof(m_aiAbsValue) );
 }
 
 bool EventDevice::Open( RString sFile, InputDevice dev )
 {
 	m_sPath = sFile;
 	m_Dev = dev;
-	m_iFD = open( sFile, O_RDWR );
+	m_iFD = open( sFile, O_RDWR|O_NONBLOCK );
 	if( m_iFD == -1 )
 	{
 		// HACK: Let the caller handle errno.
 		return false;
 	}
 
+	/* Events are stamped with CLOCK_REALTIME unless we ask otherwise.  Ask for
+	 * the monotonic clock, so changes to the system clock don't skew them. */
+#if defined(EVIOCSCLOCKID)
+	int iClock = CLOCK_MONOTONIC;
+	if( ioctl(m_iFD, EVIOCSCLOCKID, &iClock) == 0 )
+		m_iClock = CLOCK_MONOTONIC;
+#endif
+
 	static bool bLogged = false;
 	if( !bLogged )
 	{
@@ -142,11 +177,16 @@ bool EventDevice::Open( RString sFile, InputDevice dev )
 		}
 	}
 
+	memcpy( m_aABSMask, iABSMask, sizeof(m_aABSMask) );
+
 	uint8_t iKeyMask[KEY_MAX/8 + 1];
 	memset( iKeyMask, 0, sizeof(iKeyMask) );
 	if( ioctl(m_iFD, EVIOCGBIT(EV_KEY, sizeof(iKeyMask)), iKeyMask) < 0 )
 		LOG->Warn( "ioctl(EVIOCGBIT(EV_KEY)): %s", strerror(errno) );
 
+	if( ioctl(m_iFD, EVIOCGKEY(sizeof(m_aKeyState)), m_aKeyState) < 0 )
+		LOG->Warn( "ioctl(EVIOCGKEY): %s", strerror(errno) );
+
 	uint8_t iEventTypes[EV_MAX/8];
 	memset( iEventTypes, 0, sizeof(iEventTypes) );
 	if( ioctl(m_iFD, EVIOCGBIT(0, EV_MAX), iEventTypes) == -1 )
@@ -197,6 +237,7 @@ bool EventDevice::Open( RString sFile, InputDevice dev )
 		//		i, absinfo.minimum, absinfo.maximum, absinfo.fuzz, absinfo.flat );
 		aiAbsMin[i] = absinfo.minimum;
 		aiAbsMax[i] = absinfo.maximum;
+		m_aiAbsValue[i] = absinfo.value;
 		aiAbsMappingHigh[i] = enum_add2(JOY_RIGHT, 2*i);
 		aiAbsMappingLow[i] = enum_add2(JOY_LEFT, 2*i);
 
@@ -278,6 +319,17 @@ InputHandler_Linux_Event::~InputHandler_Linux_Event()
 {
 	if( m_InputThread.IsCreated() ) StopThread();
 
+	vector<DeviceStats> vStats;
+	GetDeviceStats( vStats );
+	for (DeviceStats const &stats : vStats)
+	{
+		if( stats.m_iEvents == 0 )
+			continue;
+		LOG->Info( "%s: %llu events in %llu reads, max queue depth %i, %i overflows; latency avg %.2fms, max %.2fms",
+			stats.m_sName.c_str(), (unsigned long long) stats.m_iEvents, (unsigned long long) stats.m_iReads,
+			stats.m_iMaxQueueDepth, stats.m_iDropped, stats.m_fAverageLatency * 1000, stats.m_fMaxLatency * 1000 );
+	}
+
 	for( int i = 0; i < (int) g_apEventDevices.size(); ++i )
 		delete g_apEventDevices[i];
 	g_apEventDevices.clear();
@@ -332,100 +384,253 @@ int InputHandler_Linux_Event::InputThread_Start( void *p )
 	return 0;
 }
 
+/* Convert a kernel event timestamp to a RageTimer.  We know how long ago the
+ * event happened on the device's clock; back that off from the current time.
+ * This doesn't depend on RageTimer using the same clock as the device. */
+static RageTimer EventTimeToRageTimer( const timeval &tv, int64_t iClockNowUs, const RageTimer &now, int64_t &iAgeUsOut )
+{
+	int64_t iAgeUs = iClockNowUs - (int64_t(tv.tv_sec) * 1000000 + tv.tv_usec);
+	/* Clamp, in case the clock was stepped between the event and now. */
+	iAgeUs = clamp( iAgeUs, int64_t(0), int64_t(1000000) );
+	iAgeUsOut = iAgeUs;
+
+	int64_t iNowUs = int64_t(now.m_secs) * 1000000 + now.m_us - iAgeUs;
+	return RageTimer( unsigned(iNowUs / 1000000), unsigned(iNowUs % 1000000) );
+}
+
+static int64_t GetClockUs( clockid_t iClock )
+{
+	timespec ts;
+	clock_gettime( iClock, &ts );
+	return int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
 void InputHandler_Linux_Event::InputThread()
 {
-	while( !m_bShutdown )
+	int iEpollFD = epoll_create1( EPOLL_CLOEXEC );
+	if( iEpollFD == -1 )
 	{
-		fd_set fdset;
-		FD_ZERO( &fdset );
-		int iMaxFD = -1;
-		
-		for( int i = 0; i < (int) g_apEventDevices.size(); ++i )
-		{
-			int iFD = g_apEventDevices[i]->m_iFD;
-			if( !g_apEventDevices[i]->IsOpen() )
-				continue;
+		LOG->Warn( "epoll_create1: %s", strerror(errno) );
+		return;
+	}
 
-			FD_SET( iFD, &fdset );
-			iMaxFD = max( iMaxFD, iFD );
+	int iOpenDevices = 0;
+	for( int i = 0; i < (int) g_apEventDevices.size(); ++i )
+	{
+		EventDevice *pDev = g_apEventDevices[i];
+		if( !pDev->IsOpen() )
+			continue;
+
+		epoll_event ev;
+		memset( &ev, 0, sizeof(ev) );
+		ev.events = EPOLLIN;
+		ev.data.ptr = pDev;
+		if( epoll_ctl(iEpollFD, EPOLL_CTL_ADD, pDev->m_iFD, &ev) == -1 )
+		{
+			LOG->Warn( "epoll_ctl(%s): %s; disabled", pDev->m_sPath.c_str(), strerror(errno) );
+			pDev->Close();
+			continue;
 		}
+		++iOpenDevices;
+	}
 
-		if( iMaxFD == -1 )
-			break;
+	const int MAX_EVENTS = 64;
+	input_event aEvents[MAX_EVENTS];
+	epoll_event aReady[16];
 
-		struct timeval zero = {0,100000};
-		if( select(iMaxFD+1, &fdset, nullptr, nullptr, &zero) <= 0 )
+	while( !m_bShutdown && iOpenDevices > 0 )
+	{
+		/* Wake up periodically to check m_bShutdown. */
+		int iReady = epoll_wait( iEpollFD, aReady, ARRAYLEN(aReady), 100 );
+		if( iReady <= 0 )
 			continue;
-		RageTimer now;
 
-		for( int i = 0; i < (int) g_apEventDevices.size(); ++i )
+		for( int r = 0; r < iReady; ++r )
 		{
-			if( !g_apEventDevices[i]->IsOpen() )
+			EventDevice *pDev = (EventDevice *) aReady[r].data.ptr;
+			if( !pDev->IsOpen() )
 				continue;
 
-			if( !FD_ISSET(g_apEventDevices[i]->m_iFD, &fdset) )
-				continue;
-
-			input_event event;
-			int ret = read( g_apEventDevices[i]->m_iFD, &event, sizeof(event) );
-			if( ret == -1 )
+			/* Drain everything that's queued, a buffer at a time. */
+			int iQueueDepth = 0;
+			for(;;)
 			{
-				LOG->Warn( "Error reading from %s: %s; disabled", g_apEventDevices[i]->m_sPath.c_str(), strerror(errno) );
-				g_apEventDevices[i]->Close();
-				continue;
+				int ret = read( pDev->m_iFD, aEvents, sizeof(aEvents) );
+				if( ret == -1 && (errno == EAGAIN || errno == EINTR) )
+					break;
+				if( ret == -1 )
+				{
+					LOG->Warn( "Error reading from %s: %s; disabled", pDev->m_sPath.c_str(), strerror(errno) );
+					epoll_ctl( iEpollFD, EPOLL_CTL_DEL, pDev->m_iFD, nullptr );
+					pDev->Close();
+					--iOpenDevices;
+					break;
+				}
+
+				if( ret == 0 || ret % sizeof(input_event) != 0 )
+				{
+					LOG->Warn("Unexpected packet (size %i != %i) from %s; disabled", ret, (int)sizeof(input_event), pDev->m_sPath.c_str());
+					epoll_ctl( iEpollFD, EPOLL_CTL_DEL, pDev->m_iFD, nullptr );
+					pDev->Close();
+					--iOpenDevices;
+					break;
+				}
+
+				const int iEvents = ret / sizeof(input_event);
+				iQueueDepth += iEvents;
+				ProcessEvents( pDev, aEvents, iEvents );
+
+				if( iEvents < MAX_EVENTS )
+					break;
 			}
 
-			if( ret != sizeof(event) )
+			if( iQueueDepth > 0 )
 			{
-				LOG->Warn("Unexpected packet (size %i != %i) from joystick %i; disabled", ret, (int)sizeof(event), i);
-				g_apEventDevices[i]->Close();
-				continue;
+				LockMut( g_StatsLock );
+				++pDev->m_iReads;
+				pDev->m_iMaxQueueDepth = max( pDev->m_iMaxQueueDepth, iQueueDepth );
 			}
+		}
+	}
 
-			switch (event.type) {
-			case EV_KEY: {
-				int iNum;
-				if (event.code >= BTN_JOYSTICK && event.code <= BTN_JOYSTICK + 0xf) {
-					// These guys have arbitrary names, but the kernel code in hid-input.c maps exactly 0xf of them.
-					iNum = event.code - BTN_JOYSTICK;
-				} else if (event.code >= BTN_TRIGGER_HAPPY1 && event.code <= BTN_TRIGGER_HAPPY40) {
-					// Actually, we only have 32 buttons defined.
-					iNum = event.code - BTN_TRIGGER_HAPPY1 + 0x10;
-				} else {
-					// If the button number is >40+0xf, it gets mapped to a code with no #define.
-					// I don't know if this is appropriate at all, but what else to do?
-					iNum = event.code;
-				}
-				wrap( iNum, 32 );	// max number of joystick buttons.  Make this a constant?
-				ButtonPressed( DeviceInput(g_apEventDevices[i]->m_Dev, enum_add2(JOY_BUTTON_1, iNum), event.value != 0, now) );
-				break;
-			}
-				
-			case EV_ABS: {
-				ASSERT_M( event.code < ABS_MAX, ssprintf("%i", event.code) );
-				DeviceButton neg = g_apEventDevices[i]->aiAbsMappingLow[event.code];
-				DeviceButton pos = g_apEventDevices[i]->aiAbsMappingHigh[event.code];
-
-				float l = SCALE( int(event.value), (float) g_apEventDevices[i]->aiAbsMin[event.code], (float) g_apEventDevices[i]->aiAbsMax[event.code], -1.0f, 1.0f );
-				if (GamePreferences::m_AxisFix)
-				{
-				  ButtonPressed( DeviceInput(g_apEventDevices[i]->m_Dev, neg, (l < -0.5)||((l > 0.0001)&&(l < 0.5)), now) ); //Up if between 0.0001 and 0.5 or if less than -0.5
-				  ButtonPressed( DeviceInput(g_apEventDevices[i]->m_Dev, pos, (l > 0.5)||((l > 0.0001)&&(l < 0.5)) , now) ); //Down if between 0.0001 and 0.5 or if more than 0.5
-				}
-				else
-				{
-				  ButtonPressed( DeviceInput(g_apEventDevices[i]->m_Dev, neg, max(-l,0), now) );
-				  ButtonPressed( DeviceInput(g_apEventDevices[i]->m_Dev, pos, max(+l,0), now) );
-				}
-				break;
+	close( iEpollFD );
+	InputHandler::UpdateTimer();
+}
+
+void InputHandler_Linux_Event::ProcessEvents( EventDevice *pDev, const input_event *pEvents, int iEvents )
+{
+	const RageTimer now;
+	const int64_t iClockNowUs = GetClockUs( pDev->m_iClock );
+	int64_t iTotalLatencyUs = 0, iMaxLatencyUs = 0;
+	int iInputEvents = 0, iDropped = 0;
+
+	for( int e = 0; e < iEvents; ++e )
+	{
+		const input_event &event = pEvents[e];
+
+		/* After SYN_DROPPED, the kernel discarded events.  Ignore everything
+		 * up to the next report; it's an incomplete set of changes.  The
+		 * discarded events may have included releases, so at that report, ask
+		 * the device for its current state and report whatever changed. */
+		if( event.type == EV_SYN )
+		{
+			if( event.code == SYN_DROPPED )
+			{
+				pDev->m_bDropping = true;
+				++iDropped;
 			}
+			else if( event.code == SYN_REPORT && pDev->m_bDropping )
+			{
+				pDev->m_bDropping = false;
+				int64_t iAgeUs;
+				Resync( pDev, EventTimeToRageTimer(event.time, iClockNowUs, now, iAgeUs) );
 			}
+			continue;
+		}
+		if( pDev->m_bDropping )
+			continue;
 
+		int64_t iAgeUs;
+		const RageTimer ts = EventTimeToRageTimer( event.time, iClockNowUs, now, iAgeUs );
+		++iInputEvents;
+		iTotalLatencyUs += iAgeUs;
+		iMaxLatencyUs = max( iMaxLatencyUs, iAgeUs );
+
+		switch( event.type )
+		{
+		case EV_KEY:
+			ReportKey( pDev, event.code, event.value != 0, ts );
+			break;
+		case EV_ABS:
+			ReportAbs( pDev, event.code, event.value, ts );
+			break;
 		}
+	}
 
+	LockMut( g_StatsLock );
+	pDev->m_iEvents += iInputEvents;
+	pDev->m_iDropped += iDropped;
+	pDev->m_iTotalLatencyUs += iTotalLatencyUs;
+	pDev->m_iMaxLatencyUs = max( pDev->m_iMaxLatencyUs, iMaxLatencyUs );
+}
+
+void InputHandler_Linux_Event::ReportKey( EventDevice *pDev, int iCode, bool bDown, const RageTimer &ts )
+{
+	if( bDown )
+		pDev->m_aKeyState[iCode/8] |= 1 << (iCode%8);
+	else
+		pDev->m_aKeyState[iCode/8] &= ~(1 << (iCode%8));
+
+	int iNum;
+	if (iCode >= BTN_JOYSTICK && iCode <= BTN_JOYSTICK + 0xf) {
+		// These guys have arbitrary names, but the kernel code in hid-input.c maps exactly 0xf of them.
+		iNum = iCode - BTN_JOYSTICK;
+	} else if (iCode >= BTN_TRIGGER_HAPPY1 && iCode <= BTN_TRIGGER_HAPPY40) {
+		// Actually, we only have 32 buttons defined.
+		iNum = iCode - BTN_TRIGGER_HAPPY1 + 0x10;
+	} else {
+		// If the button number is >40+0xf, it gets mapped to a code with no #define.
+		// I don't know if this is appropriate at all, but what else to do?
+		iNum = iCode;
 	}
+	wrap( iNum, 32 );	// max number of joystick buttons.  Make this a constant?
+	ButtonPressed( DeviceInput(pDev->m_Dev, enum_add2(JOY_BUTTON_1, iNum), bDown, ts) );
+}
 
-	InputHandler::UpdateTimer();
+void InputHandler_Linux_Event::ReportAbs( EventDevice *pDev, int iCode, int iValue, const RageTimer &ts )
+{
+	ASSERT_M( iCode < ABS_MAX, ssprintf("%i", iCode) );
+	pDev->m_aiAbsValue[iCode] = iValue;
+
+	DeviceButton neg = pDev->aiAbsMappingLow[iCode];
+	DeviceButton pos = pDev->aiAbsMappingHigh[iCode];
+
+	float l = SCALE( iValue, (float) pDev->aiAbsMin[iCode], (float) pDev->aiAbsMax[iCode], -1.0f, 1.0f );
+	if (GamePreferences::m_AxisFix)
+	{
+	  ButtonPressed( DeviceInput(pDev->m_Dev, neg, (l < -0.5)||((l > 0.0001)&&(l < 0.5)), ts) ); //Up if between 0.0001 and 0.5 or if less than -0.5
+	  ButtonPressed( DeviceInput(pDev->m_Dev, pos, (l > 0.5)||((l > 0.0001)&&(l < 0.5)) , ts) ); //Down if between 0.0001 and 0.5 or if more than 0.5
+	}
+	else
+	{
+	  ButtonPressed( DeviceInput(pDev->m_Dev, neg, max(-l,0), ts) );
+	  ButtonPressed( DeviceInput(pDev->m_Dev, pos, max(+l,0), ts) );
+	}
+}
+
+/* Report every key and axis whose state changed while events were being
+ * dropped. */
+void InputHandler_Linux_Event::Resync( EventDevice *pDev, const RageTimer &ts )
+{
+	uint8_t aKeyState[KEY_MAX/8 + 1];
+	memset( aKeyState, 0, sizeof(aKeyState) );
+	if( ioctl(pDev->m_iFD, EVIOCGKEY(sizeof(aKeyState)), aKeyState) < 0 )
+	{
+		LOG->Warn( "ioctl(EVIOCGKEY): %s", strerror(errno) );
+	}
+	else
+	{
+		for( int i = 0; i <= KEY_MAX; ++i )
+		{
+			const bool bDown = BitIsSet( aKeyState, i );
+			if( bDown != BitIsSet(pDev->m_aKeyState, i) )
+				ReportKey( pDev, i, bDown, ts );
+		}
+	}
+
+	for( int i = 0; i < ABS_MAX; ++i )
+	{
+		if( !BitIsSet(pDev->m_aABSMask, i) )
+			continue;
+		struct input_absinfo absinfo;
+		if( ioctl(pDev->m_iFD, EVIOCGABS(i), &absinfo) < 0 )
+		{
+			LOG->Warn( "ioctl(EVIOCGABS): %s", strerror(errno) );
+			continue;
+		}
+		if( absinfo.value != pDev->m_aiAbsValue[i] )
+			ReportAbs( pDev, i, absinfo.value, ts );
+	}
 }
 
 void InputHandler_Linux_Event::GetDevicesAndDescriptions( vector<InputDeviceInfo>& vDevicesOut )
@@ -439,6 +644,25 @@ void InputHandler_Linux_Event::GetDevicesAndDescriptions( vector<InputDeviceInfo
 	m_bDevicesChanged = false;
 }
 
+void InputHandler_Linux_Event::GetDeviceStats( vector<DeviceStats> &vOut ) const
+{
+	LockMut( g_StatsLock );
+	for( unsigned i = 0; i < g_apEventDevices.size(); ++i )
+	{
+		const EventDevice *pDev = g_apEventDevices[i];
+		DeviceStats stats;
+		stats.m_Dev = pDev->m_Dev;
+		stats.m_sName = pDev->m_sName;
+		stats.m_iEvents = pDev->m_iEvents;
+		stats.m_iReads = pDev->m_iReads;
+		stats.m_iMaxQueueDepth = pDev->m_iMaxQueueDepth;
+		stats.m_iDropped = pDev->m_iDropped;
+		stats.m_fAverageLatency = pDev->m_iEvents? pDev->m_iTotalLatencyUs / (pDev->m_iEvents * 1000000.0f): 0;
+		stats.m_fMaxLatency = pDev->m_iMaxLatencyUs / 1000000.0f;
+		vOut.push_back( stats );
+	}
+}
+
 /*
  * (c) 2003-2008 Glenn Maynard
  * (c) 2013 Ben "root" Anderson
@@ -6,6 +6,8 @@
 #include "InputHandler.h"
 #include "RageThreads.h"
 
+struct EventDevice;
+struct input_event;
 
 class InputHandler_Linux_Event: public InputHandler
 {
@@ -16,11 +18,31 @@ public:
 	bool DevicesChanged() { return m_bDevicesChanged; }
 	void GetDevicesAndDescriptions( vector<InputDeviceInfo>& vDevicesOut );
 
+	/** @brief Timing statistics for one device, for diagnosing input lag. */
+	struct DeviceStats
+	{
+		InputDevice m_Dev;
+		RString m_sName;
+		/** @brief How many input events were read, and how many batched reads they took. */
+		uint64_t m_iEvents, m_iReads;
+		/** @brief The most events waiting in the kernel queue at once. */
+		int m_iMaxQueueDepth;
+		/** @brief How many times the kernel queue overflowed and events were lost. */
+		int m_iDropped;
+		/** @brief Time between the kernel stamping an event and us reading it. */
+		float m_fAverageLatency, m_fMaxLatency;
+	};
+	void GetDeviceStats( vector<DeviceStats> &vOut ) const;
+
 private:
 	void StartThread();
 	void StopThread();
 	static int InputThread_Start( void *p );
 	void InputThread();
+	void ProcessEvents( EventDevice *pDev, const input_event *pEvents, int iEvents );
+	void ReportKey( EventDevice *pDev, int iCode, bool bDown, const RageTimer &ts );
+	void ReportAbs( EventDevice *pDev, int iCode, int iValue, const RageTimer &ts );
+	void Resync( EventDevice *pDev, const RageTimer &ts );
 
 	RageThread m_InputThread;
 	InputDevice m_NextDevice;
@@ -259,13 +259,10 @@ int MovieDecoder_FFMpeg::DecodePacket( float fTargetTime )
 
 	while( m_iEOF == 1 || (m_iEOF == 0 && m_iCurrentPacketOffset < m_Packet.size) )
 	{
-		/* If we have no data on the first frame, just return EOF; passing an empty packet
-		 * to avcodec_decode_video in this case is crashing it.  However, passing an empty
-		 * packet is normal with B-frames, to flush.  This may be unnecessary in newer
-		 * versions of avcodec, but I'm waiting until a new stable release to upgrade. */
-		if( m_Packet.size == 0 && m_iFrameNumber == -1 )
-			return 0; /* eof */
-
+		/* At EOF, keep sending empty packets to flush until no frames are left.
+		 * Do this even if no frame has come out yet: frame threading holds
+		 * back a frame per thread, so a clip shorter than that has every
+		 * frame still in the decoder. */
 		bool bSkipThisFrame =
 			fTargetTime != -1 &&
 			GetTimestamp() + GetFrameDuration() < fTargetTime &&
@@ -471,6 +468,11 @@ RString MovieDecoder_FFMpeg::OpenCodec()
 	m_pStreamCodec->idct_algo         = FF_IDCT_AUTO;
 	m_pStreamCodec->error_concealment = 3;
 
+	/* Let the codec spread decoding across threads.  This adds a few frames of
+	 * latency, which the decoder thread in MovieTexture_Generic hides. */
+	m_pStreamCodec->thread_count = 0;
+	m_pStreamCodec->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	LOG->Trace("Opening codec %s", pCodec->name );
 
 	int ret = avcodec::avcodec_open2( m_pStreamCodec, pCodec, nullptr );
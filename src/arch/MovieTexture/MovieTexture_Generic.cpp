@@ -16,9 +16,11 @@
 
 
 static Preference<bool> g_bMovieTextureDirectUpdates( "MovieTextureDirectUpdates", true );
+static Preference<bool> g_bMovieTextureThreadedDecode( "MovieTextureThreadedDecode", true );
 
 MovieTexture_Generic::MovieTexture_Generic( RageTextureID ID, MovieDecoder *pDecoder ):
-	RageMovieTexture( ID )
+	RageMovieTexture( ID ),
+	m_FrameEvent( "MovieTexture_Generic frames" )
 {
 	LOG->Trace( "MovieTexture_Generic::MovieTexture_Generic(%s)", ID.filename.c_str() );
 
@@ -36,6 +38,16 @@ MovieTexture_Generic::MovieTexture_Generic( RageTextureID ID, MovieDecoder *pDec
 	m_fClock = 0;
 	m_bFrameSkipMode = false;
 	m_pSprite = new Sprite;
+
+	m_State = DECODER_QUIT;
+	m_bThreaded = false;
+	for( int i = 0; i < FRAME_BUFFER_SIZE; ++i )
+		m_Frames[i].pSurface = nullptr;
+	m_iFrameRead = m_iFramesReady = 0;
+	m_fDecodeTarget = -1;
+	m_iDecodeTargetLoop = 0;
+	m_iLoop = 0;
+	m_iFramesShown = m_iFramesDropped = m_iFramesLate = 0;
 }
 
 RString MovieTexture_Generic::Init()
@@ -65,6 +77,20 @@ RString MovieTexture_Generic::Init()
 
 	UpdateFrame();
 
+	if( g_bMovieTextureThreadedDecode )
+	{
+		/* The ring frames are converted into by the decoder, and copied
+		 * to the texture from the main thread. */
+		const RageSurfaceFormat *pFmt = m_pSurface->format;
+		for( int i = 0; i < FRAME_BUFFER_SIZE; ++i )
+		{
+			m_Frames[i].pSurface = CreateSurface( m_pSurface->w, m_pSurface->h, pFmt->BitsPerPixel,
+				pFmt->Mask[0], pFmt->Mask[1], pFmt->Mask[2], pFmt->Mask[3] );
+		}
+		m_bThreaded = true;
+		StartDecoderThread();
+	}
+
 	CHECKPOINT_M("Generic initialization completed. No errors found.");
 
 	return RString();
@@ -72,6 +98,17 @@ RString MovieTexture_Generic::Init()
 
 MovieTexture_Generic::~MovieTexture_Generic()
 {
+	StopDecoderThread();
+
+	if( m_iFramesDropped || m_iFramesLate )
+	{
+		LOG->Trace( "%s: %i frames shown, %i dropped, %i late", GetID().filename.c_str(),
+			m_iFramesShown, m_iFramesDropped, m_iFramesLate );
+	}
+
+	for( int i = 0; i < FRAME_BUFFER_SIZE; ++i )
+		delete m_Frames[i].pSurface;
+
 	if( m_pDecoder )
 		m_pDecoder->Close();
 
@@ -301,9 +338,12 @@ void MovieTexture_Generic::CreateTexture()
 }
 
 /* Handle decoding for a frame.  Return true if a frame was decoded, false if not
- * (due to quit, error, EOF, etc).  If true is returned, we'll be in FRAME_DECODED. */
-bool MovieTexture_Generic::DecodeFrame()
+ * (due to quit, error, EOF, etc).  If the movie was rewound first, fRewindDelay is
+ * set to the length of the last frame, which the clock should be set back by so
+ * it has a proper delay; otherwise it's set to -1. */
+bool MovieTexture_Generic::DecodeFrame( float fTargetTime, float &fRewindDelay )
 {
+	fRewindDelay = -1;
 	bool bTriedRewind = false;
 	do
 	{
@@ -317,21 +357,17 @@ bool MovieTexture_Generic::DecodeFrame()
 			m_bWantRewind = false;
 			bTriedRewind = true;
 
-			/* When resetting the clock, set it back by the length of the last frame,
-			 * so it has a proper delay. */
-			float fDelay = m_pDecoder->GetFrameDuration();
+			fRewindDelay = m_pDecoder->GetFrameDuration();
 
 			/* Restart. */
 			m_pDecoder->Rewind();
+			++m_iLoop;
 
-			m_fClock = -fDelay;
+			/* The target was for the last pass through the movie. */
+			fTargetTime = -1;
 		}
 
 		/* Read a frame. */
-		float fTargetTime = -1;
-		if( m_bFrameSkipMode && m_fClock > m_pDecoder->GetTimestamp() )
-			fTargetTime = m_fClock;
-
 		int ret = m_pDecoder->DecodeFrame( fTargetTime );
 		if( ret == -1 )
 			return false;
@@ -414,6 +450,12 @@ void MovieTexture_Generic::DecodeSeconds( float fSeconds )
 {
 	m_fClock += fSeconds * m_fRate;
 
+	if( m_bThreaded )
+	{
+		DecodeSecondsThreaded();
+		return;
+	}
+
 	/* We might need to decode more than one frame per update.  However, there
 	 * have been bugs in ffmpeg that cause it to not handle EOF properly, which
 	 * could make this never return, so let's play it safe. */
@@ -423,8 +465,15 @@ void MovieTexture_Generic::DecodeSeconds( float fSeconds )
 		/* If we don't have a frame decoded, decode one. */
 		if( m_ImageWaiting == FRAME_NONE )
 		{
-			if( !DecodeFrame() )
+			float fTargetTime = -1;
+			if( m_bFrameSkipMode && m_fClock > m_pDecoder->GetTimestamp() )
+				fTargetTime = m_fClock;
+
+			float fRewindDelay;
+			if( !DecodeFrame(fTargetTime, fRewindDelay) )
 				break;
+			if( fRewindDelay != -1 )
+				m_fClock = -fRewindDelay;
 
 			m_ImageWaiting = FRAME_DECODED;
 		}
@@ -442,7 +491,150 @@ void MovieTexture_Generic::DecodeSeconds( float fSeconds )
 	LOG->MapLog( "movie_looping", "MovieTexture_Generic::Update looping" );
 }
 
-void MovieTexture_Generic::UpdateFrame()
+void MovieTexture_Generic::StartDecoderThread()
+{
+	ASSERT( m_State == DECODER_QUIT );
+	m_State = DECODER_RUNNING;
+	m_DecoderThread.SetName( ssprintf("MovieTexture_Generic(%s)", Basename(GetID().filename).c_str()) );
+	m_DecoderThread.Create( DecoderThread_Start, this );
+}
+
+void MovieTexture_Generic::StopDecoderThread()
+{
+	if( !m_DecoderThread.IsCreated() )
+		return;
+
+	m_FrameEvent.Lock();
+	m_State = DECODER_QUIT;
+	m_FrameEvent.Broadcast();
+	m_FrameEvent.Unlock();
+
+	m_DecoderThread.Wait();
+}
+
+void MovieTexture_Generic::DecoderThread()
+{
+	for(;;)
+	{
+		/* Wait for a free slot. */
+		m_FrameEvent.Lock();
+		while( m_State == DECODER_RUNNING && m_iFramesReady == FRAME_BUFFER_SIZE )
+			m_FrameEvent.Wait();
+		if( m_State == DECODER_QUIT )
+		{
+			m_FrameEvent.Unlock();
+			return;
+		}
+
+		/* Only the main thread removes frames, so this slot stays ours. */
+		DecodedFrame &frame = m_Frames[(m_iFrameRead + m_iFramesReady) % FRAME_BUFFER_SIZE];
+		const float fTargetTime = m_iDecodeTargetLoop == m_iLoop? m_fDecodeTarget:-1;
+		m_FrameEvent.Unlock();
+
+		float fRewindDelay;
+		const bool bDecoded = DecodeFrame( fTargetTime, fRewindDelay );
+		if( bDecoded )
+		{
+			m_pDecoder->GetFrame( frame.pSurface );
+			frame.fTimestamp = m_pDecoder->GetTimestamp();
+			frame.fDuration = m_pDecoder->GetFrameDuration();
+			frame.fRewindDelay = fRewindDelay;
+			frame.iLoop = m_iLoop;
+		}
+
+		/* On error or EOF without looping, stop; the last frame stays up. */
+		if( !bDecoded )
+			return;
+
+		m_FrameEvent.Lock();
+		++m_iFramesReady;
+		m_FrameEvent.Signal();
+		m_FrameEvent.Unlock();
+	}
+}
+
+void MovieTexture_Generic::DecodeSecondsThreaded()
+{
+	m_FrameEvent.Lock();
+
+	/* Find the newest frame that's due.  Any older ones that are also due
+	 * were decoded but never shown. */
+	int iDue = 0;
+	float fBehind = 0;
+	for( int i = 0; i < m_iFramesReady; ++i )
+	{
+		DecodedFrame &frame = m_Frames[(m_iFrameRead + i) % FRAME_BUFFER_SIZE];
+		if( frame.fRewindDelay != -1 )
+		{
+			/* We've reached the loop point; reset the clock, as DecodeFrame
+			 * would have. */
+			m_fClock = -frame.fRewindDelay;
+			frame.fRewindDelay = -1;
+		}
+
+		if( m_fRate == 0 )
+			break;
+		const float fOffset = (frame.fTimestamp - m_fClock) / m_fRate;
+		if( fOffset > 0.00001f )
+			break;
+		iDue = i + 1;
+		fBehind = -fOffset;
+	}
+
+	if( iDue == 0 )
+	{
+		if( m_iFramesReady > 0 && m_bFrameSkipMode )
+		{
+			/* We're caught up; stop skipping frames. */
+			LOG->Trace( "stopped skipping frames" );
+			m_bFrameSkipMode = false;
+			m_fDecodeTarget = -1;
+		}
+		m_FrameEvent.Unlock();
+		return;
+	}
+
+	m_iFrameRead = (m_iFrameRead + iDue - 1) % FRAME_BUFFER_SIZE;
+	m_iFramesReady -= iDue - 1;
+	DecodedFrame &frame = m_Frames[m_iFrameRead];
+
+	/* See CheckFrameTime. */
+	const float FrameSkipThreshold = 0.5f;
+	if( fBehind >= FrameSkipThreshold && !m_bFrameSkipMode )
+	{
+		LOG->Trace( "(%s) Time is %f, and the movie is at %f.  Entering frame skip mode.",
+			GetID().filename.c_str(), m_fClock, frame.fTimestamp );
+		m_bFrameSkipMode = true;
+	}
+	if( m_bFrameSkipMode )
+	{
+		/* Have the decoder skip ahead, rather than us dropping frames. */
+		m_fDecodeTarget = m_fClock;
+		m_iDecodeTargetLoop = frame.iLoop;
+	}
+
+	const int iDropped = iDue - 1;
+	const int iLate = fBehind > frame.fDuration? 1:0;
+	m_iFramesDropped += iDropped;
+	m_iFramesLate += iLate;
+	++m_iFramesShown;
+
+	/* The decoder won't touch this slot until we release it. */
+	m_FrameEvent.Unlock();
+
+	UpdateFrame( frame.pSurface );
+	DISPLAY->StatsAddMovieFrames( iDropped, iLate );
+
+	m_FrameEvent.Lock();
+	m_iFrameRead = (m_iFrameRead + 1) % FRAME_BUFFER_SIZE;
+	--m_iFramesReady;
+	m_FrameEvent.Signal();
+	m_FrameEvent.Unlock();
+}
+
+/* Upload a frame.  If pFrame is null, the frame is fetched from the decoder;
+ * otherwise, it's a frame the decoder thread has already converted. */
+void MovieTexture_Generic::UpdateFrame( RageSurface *pFrame )
 {
 	/* Just in case we were invalidated: */
 	CreateTexture();
@@ -453,10 +645,15 @@ void MovieTexture_Generic::UpdateFrame()
 		m_pTextureLock->Lock( iHandle, m_pSurface );
 	}
 
-	m_pDecoder->GetFrame( m_pSurface );
+	if( pFrame == nullptr )
+		m_pDecoder->GetFrame( m_pSurface );
+	else if( m_pTextureLock != nullptr )
+		memcpy( m_pSurface->pixels, pFrame->pixels, pFrame->pitch * pFrame->h );
 	if( m_pTextureLock != nullptr )
 		m_pTextureLock->Unlock( m_pSurface, true );
 
+	RageSurface *pUpload = pFrame != nullptr? pFrame:m_pSurface;
+
 	if( m_pRenderTarget != nullptr )
 	{
 		CHECKPOINT_M( "About to upload the texture.");
@@ -466,9 +663,9 @@ void MovieTexture_Generic::UpdateFrame()
 		{
 			DISPLAY->UpdateTexture(
 				m_pTextureIntermediate->GetTexHandle(),
-				m_pSurface,
+				pUpload,
 				0, 0,
-				m_pSurface->w, m_pSurface->h );
+				pUpload->w, pUpload->h );
 		}
 		m_pRenderTarget->BeginRenderingTo( false );
 		m_pSprite->Draw();
@@ -480,7 +677,7 @@ void MovieTexture_Generic::UpdateFrame()
 		{
 			DISPLAY->UpdateTexture(
 				m_uTexHandle,
-				m_pSurface,
+				pUpload,
 				0, 0,
 				m_iImageWidth, m_iImageHeight );
 		}
@@ -515,7 +712,21 @@ void MovieTexture_Generic::SetPosition( float fSeconds )
 	}
 
 	LOG->Trace( "Seek to %f", fSeconds );
+
+	if( !m_bThreaded )
+	{
+		m_bWantRewind = true;
+		return;
+	}
+
+	/* Throw away everything that's been decoded, and restart from the
+	 * beginning. */
+	StopDecoderThread();
+	m_iFrameRead = m_iFramesReady = 0;
+	m_fDecodeTarget = -1;
+	m_bFrameSkipMode = false;
 	m_bWantRewind = true;
+	StartDecoderThread();
 }
 
 uintptr_t MovieTexture_Generic::GetTexHandle() const
@@ -2,6 +2,7 @@
 #define RAGE_MOVIE_TEXTURE_GENERIC_H
 
 #include "MovieTexture.h"
+#include "RageThreads.h"
 
 class FFMpeg_Helper;
 struct RageSurface;
@@ -110,6 +111,36 @@ private:
 
 	enum State { DECODER_QUIT, DECODER_RUNNING } m_State;
 
+	/* When decoding in a thread, the decoder thread keeps a ring of decoded,
+	 * converted frames ahead of the clock, and the main thread only uploads. */
+	enum { FRAME_BUFFER_SIZE = 4 };
+	struct DecodedFrame
+	{
+		RageSurface *pSurface;
+		float fTimestamp;
+		float fDuration;
+		/* If this is the first frame after a rewind, the clock is reset to
+		 * -fRewindDelay when it reaches the front; otherwise -1. */
+		float fRewindDelay;
+		/* The number of rewinds before this frame was decoded. */
+		int iLoop;
+	};
+	DecodedFrame m_Frames[FRAME_BUFFER_SIZE];
+	bool m_bThreaded;
+	RageThread m_DecoderThread;
+	/* Protects everything below, and signals when a frame is decoded or a
+	 * slot is freed. */
+	RageEvent m_FrameEvent;
+	int m_iFrameRead, m_iFramesReady;
+	/* In frame skip mode, the time the decoder should skip ahead to, as of
+	 * loop m_iDecodeTargetLoop. */
+	float m_fDecodeTarget;
+	int m_iDecodeTargetLoop;
+	/* Only used by the decoder thread. */
+	int m_iLoop;
+
+	int m_iFramesShown, m_iFramesDropped, m_iFramesLate;
+
 	uintptr_t m_uTexHandle;
 	RageTextureRenderTarget *m_pRenderTarget;
 	RageTexture *m_pTextureIntermediate;
@@ -123,13 +154,19 @@ private:
 	float m_fClock;
 	bool m_bFrameSkipMode;
 
-	void UpdateFrame();
+	void UpdateFrame( RageSurface *pFrame = nullptr );
 
 	void CreateTexture();
 	void DestroyTexture();
 
-	bool DecodeFrame();
+	bool DecodeFrame( float fTargetTime, float &fRewindDelay );
 	float CheckFrameTime();
+
+	void StartDecoderThread();
+	void StopDecoderThread();
+	static int DecoderThread_Start( void *p ) { ((MovieTexture_Generic *) p)->DecoderThread(); return 0; }
+	void DecoderThread();
+	void DecodeSecondsThreaded();
 };
 
 #endif
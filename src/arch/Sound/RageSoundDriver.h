@@ -7,6 +7,8 @@
 #include "RageTimer.h"
 #include "RageUtil_CircularBuffer.h"
 
+#include <atomic>
+
 class RageSoundBase;
 class RageTimer;
 class RageSoundMixBuffer;
@@ -101,23 +103,22 @@ protected:
 	void MixDeinterlaced( float **pBufs, int channels, int iFrames, int64_t iFrameNumber, int64_t iCurrentFrame );
 
 private:
-	/* This mutex is used for serializing with the decoder thread.  Locking this mutex
-	 * can take a while. */
+	/* This mutex serializes Update(), StopMixing() and PauseMixing() with each other.
+	 * The decoding and mixing threads never lock it, and StartMixing() doesn't either. */
 	RageMutex m_Mutex;
 
-	/* This mutex locks all sounds[] which are "available".  (Other sound may safely
-	 * be accessed, and sounds may be set to available, without locking this.) */
-	RageMutex m_SoundListMutex;
-
 	/*
 	 * Thread safety and state transitions:
 	 *
+	 * m_State is atomic, and every state change that can race with another thread is
+	 * made with a compare-and-swap, so none of the threads need a lock to change it.
+	 *
 	 * AVAILABLE: The sound is available to play a new sound. The decoding and mixing threads
-	 * will not touch a sound in this state.
+	 * will not touch a sound in this state.  StartMixing() claims a slot by swapping it
+	 * from AVAILABLE to BUFFERING, so any number of threads can start sounds at once.
 	 *
 	 * BUFFERING: The sound is stopped but StartMixing() is prebuffering. No other threads
-	 * will touch a sound that is BUFFERING. This isn't necessary if only the main thread
-	 * can call StartMixing().
+	 * will touch a sound that is BUFFERING, except StopMixing(), which may halt it.
 	 *
 	 * STOPPED: The sound is idle, but memory is still allocated for its buffer. Update()
 	 * will deallocate memory and the sound will be changed to AVAILABLE.
@@ -140,9 +141,15 @@ private:
 	 * data", some data will still be mixed.  This is OK; the data is valid, and the flush will
 	 * happen on the next iteration.
 	 * 
-	 * The only state change made by the decoding thread is on EOF: the state is changed
-	 * from PLAYING to STOPPING.  This is done while m_Mutex is held, to prevent
-	 * races with other threads.
+	 * The only state change made by the decoding thread is on EOF: the state is swapped
+	 * from PLAYING to STOPPING.  If StopMixing() halted the sound first, the swap fails
+	 * and the sound stays HALTING.
+	 *
+	 * StopMixing() promises that m_pSound won't be used once it returns.  Whoever is
+	 * reading from m_pSound (the decoding thread, or StartMixing() while prebuffering)
+	 * increments m_iDecoding first and then checks the state, and StopMixing() changes
+	 * the state first and then waits for m_iDecoding to reach zero.  That waits for at
+	 * most one block of this sound to decode, instead of a whole decoding pass.
 	 *
 	 * The only state change made by the mixing thread is from HALTING to STOPPED.
 	 * This is done with no locks; no other thread can take a sound out of the HALTING state.
@@ -166,11 +173,13 @@ private:
 		void Allocate( int iFrames );
 		void Deallocate();
 
-		RageSoundBase *m_pSound;
+		std::atomic<RageSoundBase *> m_pSound;
 		RageTimer m_StartTime;
 		CircBuf<sound_block> m_Buffer;
 
-		bool m_bPaused;
+		std::atomic<bool> m_bPaused;
+		/* The number of threads reading from m_pSound. */
+		std::atomic<int> m_iDecoding;
 
 		struct QueuedPosMap
 		{
@@ -181,7 +190,7 @@ private:
 
 		CircBuf<QueuedPosMap> m_PosMapQueue;
 
-		enum
+		enum State
 		{
 			AVAILABLE,
 			BUFFERING,
@@ -194,7 +203,11 @@ private:
 
 			HALTING,	/* stop immediately */
 			PLAYING
-		} m_State;
+		};
+		std::atomic<State> m_State;
+
+		/* Change the state from eFrom to eTo, unless another thread changed it first. */
+		bool SetState( State eFrom, State eTo ) { return m_State.compare_exchange_strong( eFrom, eTo ); }
 	};
 
 	/* List of currently playing sounds: XXX no vector */
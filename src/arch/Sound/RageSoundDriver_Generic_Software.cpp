@@ -7,6 +7,8 @@
 #include "RageSoundMixBuffer.h"
 #include "RageSoundReader.h"
 
+#include <thread>
+
 static const int channels = 2;
 
 static int frames_to_buffer;
@@ -21,6 +23,7 @@ RageSoundDriver::Sound::Sound()
 	m_pSound = nullptr;
 	m_State = AVAILABLE;
 	m_bPaused = false;
+	m_iDecoding = 0;
 }
 
 void RageSoundDriver::Sound::Allocate( int iFrames )
@@ -191,7 +194,6 @@ void RageSoundDriver::DecodeThread()
 			usleep( iUsecs );
 		}
 
-		LockMut( m_Mutex );
 //		LOG->Trace("begin mix");
 
 		for( unsigned i = 0; i < ARRAYLEN(m_Sounds); ++i )
@@ -201,8 +203,12 @@ void RageSoundDriver::DecodeThread()
 
 			Sound *pSound = &m_Sounds[i];
 
+			/* Mark the sound as in use before checking the state again, so StopMixing
+			 * either sees that we're using it or we see that it was stopped. */
+			++pSound->m_iDecoding;
+
 			CHECKPOINT_M("Processing the sound while buffers are available.");
-			while( pSound->m_Buffer.num_writable() )
+			while( pSound->m_State == Sound::PLAYING && pSound->m_Buffer.num_writable() )
 			{
 				int iWrote = GetDataForSound( *pSound );
 				if( iWrote == RageSoundReader::WOULD_BLOCK )
@@ -210,11 +216,13 @@ void RageSoundDriver::DecodeThread()
 				if( iWrote < 0 )
 				{
 					/* This sound is finishing. */
-					pSound->m_State = Sound::STOPPING;
+					pSound->SetState( Sound::PLAYING, Sound::STOPPING );
 					break;
 //					LOG->Trace("mixer: (#%i) eof (%p)", i, pSound->m_pSound );
 				}
 			}
+
+			--pSound->m_iDecoding;
 		}
 //		LOG->Trace("end mix");
 	}
@@ -233,7 +241,8 @@ int RageSoundDriver::GetDataForSound( Sound &s )
 
 	sound_block *pBlock = p[0];
 	int size = ARRAYLEN(pBlock->m_Buffer)/channels;
-	int iRet = s.m_pSound->GetDataToPlay( pBlock->m_Buffer, size, pBlock->m_iPosition, pBlock->m_FramesInBuffer );
+	RageSoundBase *pSound = s.m_pSound;
+	int iRet = pSound->GetDataToPlay( pBlock->m_Buffer, size, pBlock->m_iPosition, pBlock->m_FramesInBuffer );
 	if( iRet > 0 )
 	{
 		pBlock->m_BufferNext = pBlock->m_Buffer;
@@ -279,7 +288,8 @@ void RageSoundDriver::Update()
 
 //		LOG->Trace("finishing sound %i", i);
 
-		m_Sounds[i].m_pSound->SoundIsFinishedPlaying();
+		RageSoundBase *pSound = m_Sounds[i].m_pSound;
+		pSound->SoundIsFinishedPlaying();
 		m_Sounds[i].m_pSound = nullptr;
 
 		/* This sound is done.  Set it to HALTING, since the mixer thread might
@@ -311,26 +321,20 @@ void RageSoundDriver::Update()
 
 void RageSoundDriver::StartMixing( RageSoundBase *pSound )
 {
-	/* Lock available m_Sounds[], and reserve a slot. */
-	m_SoundListMutex.Lock();
-
+	/* Reserve a slot.  No other thread can take a slot out of AVAILABLE, so if the
+	 * swap succeeds, the slot is ours. */
 	unsigned i;
 	for( i = 0; i < ARRAYLEN(m_Sounds); ++i )
-		if( m_Sounds[i].m_State == Sound::AVAILABLE )
+		if( m_Sounds[i].SetState(Sound::AVAILABLE, Sound::BUFFERING) )
 			break;
 	if( i == ARRAYLEN(m_Sounds) )
-	{
-		m_SoundListMutex.Unlock();
 		return;
-	}
 
 	Sound &s = m_Sounds[i];
-	s.m_State = Sound::BUFFERING;
-
-	/* We've reserved our slot; we can safely unlock now.  Don't hold onto it longer
-	 * than needed, since prebuffering might take some time. */
-	m_SoundListMutex.Unlock();
 
+	/* Prebuffering reads from pSound, so StopMixing has to wait for it like it
+	 * waits for the decoding thread. */
+	++s.m_iDecoding;
 	s.m_pSound = pSound;
 	s.m_StartTime = pSound->GetStartTime();
 	s.m_Buffer.clear();
@@ -343,7 +347,7 @@ void RageSoundDriver::StartMixing( RageSoundBase *pSound )
 //	LOG->Trace("StartMixing(%s) (%p)", s.m_pSound->GetLoadedFilePath().c_str(), s.m_pSound );
 
 	/* Prebuffer some frames before changing the sound to PLAYING. */
-	while( s.m_Buffer.num_writable() )
+	while( s.m_State == Sound::BUFFERING && s.m_Buffer.num_writable() )
 	{
 //		LOG->Trace("StartMixing: (#%i) buffering %i (%i writable) (%p)", i, (int) frames_to_buffer, s.buffer.num_writable(), s.m_pSound );
 		int iWrote = GetDataForSound( s );
@@ -351,14 +355,17 @@ void RageSoundDriver::StartMixing( RageSoundBase *pSound )
 			break;
 	}
 
-	s.m_State = Sound::PLAYING;
+	/* If another thread stopped the sound while we were prebuffering, it's
+	 * HALTING; leave it that way. */
+	s.SetState( Sound::BUFFERING, Sound::PLAYING );
+	--s.m_iDecoding;
 
 //	LOG->Trace("StartMixing: (#%i) finished prebuffering(%s) (%p)", i, s.m_pSound->GetLoadedFilePath().c_str(), s.m_pSound );
 }
 
 void RageSoundDriver::StopMixing( RageSoundBase *pSound )
 {
-	/* Lock, to make sure the decoder thread isn't running on this sound while we do this. */
+	/* Lock, so Update() doesn't finish this sound while we're stopping it. */
 	m_Mutex.Lock();
 
 	/* Find the sound. */
@@ -373,23 +380,32 @@ void RageSoundDriver::StopMixing( RageSoundBase *pSound )
 		return;
 	}
 
-	/* If we're already in STOPPED, there's nothing to do. */
-	if( m_Sounds[i].m_State == Sound::STOPPED )
-	{
-		m_Mutex.Unlock();
-		LOG->Trace( "not stopping a sound because it's already in STOPPED" );
-		return;
-	}
+	Sound &s = m_Sounds[i];
+
+//	LOG->Trace("StopMixing: set %p (%s) to HALTING", s.m_pSound, s.m_pSound->GetLoadedFilePath().c_str());
 
-//	LOG->Trace("StopMixing: set %p (%s) to HALTING", m_Sounds[i].m_pSound, m_Sounds[i].m_pSound->GetLoadedFilePath().c_str());
+	/* Tell the mixing thread to flush the buffer.  The decoding thread may change
+	 * PLAYING to STOPPING at any time, so retry until the swap sticks. */
+	Sound::State eState = s.m_State;
+	do
+	{
+		/* If we're already in STOPPED, there's nothing to do. */
+		if( eState == Sound::STOPPED )
+		{
+			m_Mutex.Unlock();
+			LOG->Trace( "not stopping a sound because it's already in STOPPED" );
+			return;
+		}
+	} while( !s.m_State.compare_exchange_weak(eState, Sound::HALTING) );
 
-	/* Tell the mixing thread to flush the buffer.  We don't have to worry about
-	 * the decoding thread, since we've locked m_Mutex. */
-	m_Sounds[i].m_State = Sound::HALTING;
+	/* Now that the sound is HALTING, nobody will start reading from it again.  Wait
+	 * for anyone who already was. */
+	while( s.m_iDecoding )
+		std::this_thread::yield();
 
 	/* Invalidate the m_pSound pointer to guarantee we don't make any further references to
 	 * it.  Once this call returns, the sound may no longer exist. */
-	m_Sounds[i].m_pSound = nullptr;
+	s.m_pSound = nullptr;
 //	LOG->Trace("end StopMixing");
 
 	m_Mutex.Unlock();
@@ -443,8 +459,7 @@ void RageSoundDriver::low_sample_count_workaround()
 }
 
 RageSoundDriver::RageSoundDriver():
-	m_Mutex("RageSoundDriver"),
-	m_SoundListMutex("SoundListMutex")
+	m_Mutex("RageSoundDriver")
 {
 	m_bShutdownDecodeThread = false;
 	m_iMaxHardwareFrame = 0;
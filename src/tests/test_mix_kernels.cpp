@@ -0,0 +1,172 @@
+/* Check every set of RageSoundMixKernels this CPU supports against the
+ * scalar kernels; their output has to be bit-identical. */
+#include "global.h"
+#include "RageSoundMixKernels.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <limits>
+
+using namespace RageSoundMixKernels;
+
+static const unsigned MAX_SIZE = 1024;
+
+/* Mostly ordinary samples, with some that need clipping, some exactly halfway
+ * between two output values, and the odd infinity and NaN. */
+static void RandBuffer( float *pBuffer, unsigned iSize )
+{
+	for( unsigned i = 0; i < iSize; ++i )
+	{
+		switch( rand() % 16 )
+		{
+		case 0: pBuffer[i] = float(rand())/RAND_MAX * 4 - 2; break;
+		case 1: pBuffer[i] = (float(rand() % 65535) - 32767 + 0.5f) / 32767; break;
+		case 2: pBuffer[i] = std::numeric_limits<float>::infinity() * (rand()%2? 1:-1); break;
+		case 3: pBuffer[i] = std::numeric_limits<float>::quiet_NaN(); break;
+		default: pBuffer[i] = float(rand())/RAND_MAX * 2 - 1; break;
+		}
+	}
+}
+
+static bool Same( const void *pA, const void *pB, size_t iBytes, const Kernels &k, const char *szWhat, unsigned iOffset, unsigned iSize )
+{
+	if( !memcmp(pA, pB, iBytes) )
+		return true;
+	fprintf( stderr, "%s %s differs from scalar (offset %u, size %u)\n", k.szName, szWhat, iOffset, iSize );
+	return false;
+}
+
+static bool CheckAccumulate( const Kernels &k )
+{
+	float src[MAX_SIZE+8], dest[MAX_SIZE+8], ref[MAX_SIZE+8];
+	for( unsigned iOffset = 0; iOffset < 8; ++iOffset )
+	{
+		for( unsigned iSize = 0; iSize + iOffset <= MAX_SIZE; iSize += 1 + iSize/8 )
+		{
+			RandBuffer( src, MAX_SIZE+8 );
+			RandBuffer( dest, MAX_SIZE+8 );
+			memcpy( ref, dest, sizeof(ref) );
+			k.Accumulate( dest + iOffset, src + (7-iOffset), iSize );
+			GetScalar().Accumulate( ref + iOffset, src + (7-iOffset), iSize );
+			if( !Same(dest, ref, sizeof(ref), k, "Accumulate", iOffset, iSize) )
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool CheckConvertToInt16( const Kernels &k )
+{
+	float src[MAX_SIZE+8];
+	int16_t dest[MAX_SIZE+8], ref[MAX_SIZE+8];
+	for( unsigned iOffset = 0; iOffset < 8; ++iOffset )
+	{
+		for( unsigned iSize = 0; iSize + iOffset <= MAX_SIZE; iSize += 1 + iSize/8 )
+		{
+			RandBuffer( src, MAX_SIZE+8 );
+			memset( dest, 0, sizeof(dest) );
+			memset( ref, 0, sizeof(ref) );
+			k.ConvertToInt16( dest + iOffset, src + (7-iOffset), iSize );
+			GetScalar().ConvertToInt16( ref + iOffset, src + (7-iOffset), iSize );
+			if( !Same(dest, ref, sizeof(ref), k, "ConvertToInt16", iOffset, iSize) )
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool CheckDeinterlace( const Kernels &k )
+{
+	const int MAX_CHANNELS = 6;
+	float src[MAX_SIZE*MAX_CHANNELS];
+	float dest[MAX_CHANNELS][MAX_SIZE], ref[MAX_CHANNELS][MAX_SIZE];
+	for( int iChannels = 1; iChannels <= MAX_CHANNELS; ++iChannels )
+	{
+		for( unsigned iFrames = 0; iFrames <= MAX_SIZE; iFrames += 1 + iFrames/8 )
+		{
+			float *pDest[MAX_CHANNELS], *pRef[MAX_CHANNELS];
+			for( int ch = 0; ch < MAX_CHANNELS; ++ch )
+			{
+				pDest[ch] = dest[ch];
+				pRef[ch] = ref[ch];
+			}
+			RandBuffer( src, MAX_SIZE*MAX_CHANNELS );
+			memset( dest, 0, sizeof(dest) );
+			memset( ref, 0, sizeof(ref) );
+			k.Deinterlace( pDest, src, iFrames, iChannels );
+			GetScalar().Deinterlace( pRef, src, iFrames, iChannels );
+			if( !Same(dest, ref, sizeof(ref), k, "Deinterlace", iChannels, iFrames) )
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool CheckPolyphaseFrame( const Kernels &k )
+{
+	const int MAX_CHANNELS = 6;
+	float history[POLYPHASE_TAPS*MAX_CHANNELS + 8], filter[POLYPHASE_TAPS];
+	float dest[MAX_CHANNELS], ref[MAX_CHANNELS];
+	for( int iChannels = 1; iChannels <= MAX_CHANNELS; ++iChannels )
+	{
+		/* History frames start anywhere in the resampler's buffer. */
+		for( unsigned iOffset = 0; iOffset < 8; ++iOffset )
+		{
+			RandBuffer( history, POLYPHASE_TAPS*MAX_CHANNELS + 8 );
+			for( int j = 0; j < POLYPHASE_TAPS; ++j )
+				filter[j] = float(rand())/RAND_MAX * 2 - 1;
+			memset( dest, 0, sizeof(dest) );
+			memset( ref, 0, sizeof(ref) );
+			k.PolyphaseFrame( dest, history + iOffset, filter, iChannels );
+			GetScalar().PolyphaseFrame( ref, history + iOffset, filter, iChannels );
+			if( !Same(dest, ref, sizeof(ref), k, "PolyphaseFrame", iOffset, iChannels) )
+				return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	srand( time(nullptr) );
+
+	vector<const Kernels *> vKernels;
+	GetSupported( vKernels );
+	bool bOK = true;
+	for( unsigned i = 0; i < vKernels.size(); ++i )
+	{
+		const Kernels &k = *vKernels[i];
+		const bool bPassed = CheckAccumulate(k) && CheckConvertToInt16(k) && CheckDeinterlace(k) &&
+			CheckPolyphaseFrame(k);
+		printf( "%s: %s\n", k.szName, bPassed? "ok":"FAILED" );
+		bOK &= bPassed;
+	}
+	printf( "Using %s.\n", Get().szName );
+	return bOK? 0:1;
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -0,0 +1,136 @@
+/* Time RageSoundReader_Resample_Good on the conversions songs usually need:
+ * 44.1kHz, 48kHz and 96kHz to and from each other, in mono and stereo.  Each
+ * one also has to keep reading, and keep a tone at about the same level. */
+#include "global.h"
+#include "RageSoundReader_Resample_Good.h"
+#include "RageSoundMixKernels.h"
+#include "RageMath.h"
+#include "RageTimer.h"
+#include "RageUtil.h"
+#include <cmath>
+
+static const int SECONDS = 60;
+static const float TONE_HZ = 1000;
+
+/* An endless tone, the same in every channel.  TONE_HZ is a whole number, so
+ * one second of it repeats seamlessly; that's worked out up front, so the
+ * timing is all resampling. */
+class RageSoundReader_Tone: public RageSoundReader
+{
+public:
+	RageSoundReader_Tone( int iSampleRate, int iChannels ):
+		m_iSampleRate(iSampleRate), m_iChannels(iChannels), m_iPosition(0)
+	{
+		m_fTone.resize( iSampleRate );
+		for( int i = 0; i < iSampleRate; ++i )
+			m_fTone[i] = sinf( 2*PI*TONE_HZ*i / iSampleRate );
+	}
+	int GetLength() const { return 0; }
+	int SetPosition( int iFrame ) { m_iPosition = iFrame; return 1; }
+	int Read( float *pBuf, int iFrames )
+	{
+		for( int i = 0; i < iFrames; ++i )
+		{
+			const float fSample = m_fTone[(m_iPosition + i) % m_iSampleRate];
+			for( int ch = 0; ch < m_iChannels; ++ch )
+				*pBuf++ = fSample;
+		}
+		m_iPosition += iFrames;
+		return iFrames;
+	}
+	RageSoundReader_Tone *Copy() const { return new RageSoundReader_Tone( *this ); }
+	int GetSampleRate() const { return m_iSampleRate; }
+	unsigned GetNumChannels() const { return m_iChannels; }
+	int GetNextSourceFrame() const { return m_iPosition; }
+	float GetStreamToSourceRatio() const { return 1.0f; }
+	RString GetError() const { return RString(); }
+
+private:
+	int m_iSampleRate;
+	int m_iChannels;
+	int m_iPosition;
+	vector<float> m_fTone;
+};
+
+static bool Convert( int iFrom, int iTo, int iChannels )
+{
+	RageSoundReader_Resample_Good resampler( new RageSoundReader_Tone(iFrom, iChannels), iTo );
+
+	/* Read in blocks the size RageSoundMixBuffer asks for. */
+	const int iBlockFrames = 1024;
+	vector<float> vBuf( iBlockFrames * iChannels );
+	const int iWantFrames = iTo * SECONDS;
+	int iGotFrames = 0;
+	float fPeak = 0;
+
+	RageTimer tm;
+	while( iGotFrames < iWantFrames )
+	{
+		int iGot = resampler.Read( &vBuf[0], min(iBlockFrames, iWantFrames - iGotFrames) );
+		if( iGot <= 0 )
+		{
+			printf( "%i -> %i, %i channels: Read returned %i\n", iFrom, iTo, iChannels, iGot );
+			return false;
+		}
+
+		/* Skip the filter warming up. */
+		if( iGotFrames >= iTo / 10 )
+		{
+			for( int i = 0; i < iGot * iChannels; ++i )
+				fPeak = max( fPeak, fabsf(vBuf[i]) );
+		}
+		iGotFrames += iGot;
+	}
+	const float fSeconds = tm.GetDeltaTime();
+
+	const bool bOK = fPeak > 0.9f && fPeak < 1.1f;
+	printf( "%6i -> %6i, %i channel%s: %.3fs for %is of audio (%.0fx realtime), peak %.3f%s\n",
+		iFrom, iTo, iChannels, iChannels == 1? " ":"s", fSeconds, SECONDS,
+		SECONDS / max(fSeconds, 0.0001f), fPeak, bOK? "":" FAILED" );
+	return bOK;
+}
+
+int main()
+{
+	static const int iRates[] = { 44100, 48000, 96000 };
+
+	printf( "Using %s mix kernels.\n", RageSoundMixKernels::Get().szName );
+	bool bOK = true;
+	for( int iChannels = 1; iChannels <= 2; ++iChannels )
+	{
+		for( unsigned iFrom = 0; iFrom < ARRAYLEN(iRates); ++iFrom )
+		{
+			for( unsigned iTo = 0; iTo < ARRAYLEN(iRates); ++iTo )
+			{
+				if( iFrom != iTo )
+					bOK &= Convert( iRates[iFrom], iRates[iTo], iChannels );
+			}
+		}
+	}
+	return bOK? 0:1;
+}
+
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
@@ -0,0 +1,119 @@
+/* Time metric lookups the way screens do them when they load: the first
+ * pass resolves each metric through its group's fallbacks, and later passes
+ * should come from ThemeManager's metric cache.  Run this from the game
+ * directory, so the themes can be found. */
+#include "global.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+#include "RageTimer.h"
+#include "RageFileManager.h"
+#include "IniFile.h"
+#include "LuaManager.h"
+#include "PrefsManager.h"
+#include "ThemeManager.h"
+#include "SpecialFiles.h"
+#include "arch/ArchHooks/ArchHooks.h"
+
+/* Every screen is asked for every value name used by any screen, which
+ * covers both metrics found through fallbacks and metrics that are missing. */
+static void GetScreenMetrics( vector<RString> &vsGroupsOut, vector<RString> &vsNamesOut )
+{
+	set<RString> groups, names;
+	RString sPaths[] = {
+		THEME->GetCurThemeDir() + SpecialFiles::METRICS_FILE,
+		SpecialFiles::THEMES_DIR + SpecialFiles::BASE_THEME_NAME + "/" + SpecialFiles::METRICS_FILE
+	};
+	for( unsigned i = 0; i < ARRAYLEN(sPaths); ++i )
+	{
+		IniFile ini;
+		if( !ini.ReadFile(sPaths[i]) )
+			continue;
+		FOREACH_CONST_Child( &ini, pGroup )
+		{
+			if( !BeginsWith(pGroup->GetName(), "Screen") )
+				continue;
+			groups.insert( pGroup->GetName() );
+			FOREACH_CONST_Attr( pGroup, pAttr )
+				names.insert( pAttr->first );
+		}
+	}
+	vsGroupsOut.assign( groups.begin(), groups.end() );
+	vsNamesOut.assign( names.begin(), names.end() );
+}
+
+void run()
+{
+	vector<RString> vsGroups, vsNames;
+	GetScreenMetrics( vsGroups, vsNames );
+	LOG->Trace( "%i screens, %i metric names", int(vsGroups.size()), int(vsNames.size()) );
+
+	for( int iPass = 0; iPass < 3; ++iPass )
+	{
+		RageTimer timer;
+		int iFound = 0;
+		for( unsigned g = 0; g < vsGroups.size(); ++g )
+			for( unsigned n = 0; n < vsNames.size(); ++n )
+				if( THEME->HasMetric(vsGroups[g], vsNames[n]) )
+					++iFound;
+		LOG->Trace( "Pass %i: %i lookups, %i found, %f seconds", iPass+1,
+			int(vsGroups.size()*vsNames.size()), iFound, timer.GetDeltaTime() );
+
+		if( iPass == 1 )
+		{
+			/* Loading a screen after a theme change starts from an empty cache. */
+			timer.Touch();
+			THEME->ReloadMetrics();
+			LOG->Trace( "ReloadMetrics: %f seconds", timer.GetDeltaTime() );
+		}
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	HOOKS			= ArchHooks::Create();
+	HOOKS->Init();
+	FILEMAN			= new RageFileManager( argv[0] );
+	FILEMAN->Mount( "dir", ".", "/" );
+	LOG                     = new RageLog();
+	LOG->SetShowLogOutput( true );
+	LOG->SetFlushing( true );
+	PREFSMAN		= new PrefsManager;
+	LUA			= new LuaManager;
+	THEME			= new ThemeManager;
+	THEME->SwitchThemeAndLanguage( PREFSMAN->m_sTheme.Get(), SpecialFiles::BASE_LANGUAGE, false );
+
+	run();
+
+	delete THEME;
+	delete LUA;
+	delete PREFSMAN;
+	delete LOG;
+	delete FILEMAN;
+	delete HOOKS;
+
+	exit(0);
+}
+/*
+ * (c) 2026 ITGmania Team
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, provided that the above
+ * copyright notice(s) and this permission notice appear in all copies of
+ * the Software and that both the above copyright notice(s) and this
+ * permission notice appear in supporting documentation.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS
+ * INCLUDED IN THIS NOTICE BE LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT
+ * OR CONSEQUENTIAL DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
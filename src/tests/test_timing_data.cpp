@@ -19,87 +19,89 @@ void run()
 }
 
 	TimingData test;
-	test.AddBPMSegment( BPMSegment(0, 60) );
+	test.AddSegment( BPMSegment(0, 60) );
 
 	/* First, trivial sanity checks. */
-	CHECK( test.GetBeatFromElapsedTime(60), 60.0f );
-	CHECK( test.GetElapsedTimeFromBeat(60), 60.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(60), 60.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(60), 60.0f );
 
 	/* The first BPM segment extends backwards in time. */
-	CHECK( test.GetBeatFromElapsedTime(-60), -60.0f );
-	CHECK( test.GetElapsedTimeFromBeat(-60), -60.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(-60), -60.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(-60), -60.0f );
 
-	CHECK( test.GetBeatFromElapsedTime(100000), 100000.0f );
-	CHECK( test.GetElapsedTimeFromBeat(100000), 100000.0f );
-	CHECK( test.GetBeatFromElapsedTime(-100000), -100000.0f );
-	CHECK( test.GetElapsedTimeFromBeat(-100000), -100000.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(100000), 100000.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(100000), 100000.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(-100000), -100000.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(-100000), -100000.0f );
 
 	CHECK( test.GetBPMAtBeat(0), 60.0f );
 	CHECK( test.GetBPMAtBeat(100000), 60.0f );
 	CHECK( test.GetBPMAtBeat(-100000), 60.0f );
 
 	/* 120BPM at beat 10: */
-	test.AddBPMSegment( BPMSegment(10, 120) );
-	CHECK( test.GetBPMAtBeat(9.99), 60.0f );
+	test.AddSegment( BPMSegment(BeatToNoteRow(10), 120) );
+	CHECK( test.GetBPMAtBeat(9.9f), 60.0f );
 	CHECK( test.GetBPMAtBeat(10), 120.0f );
 
-	CHECK( test.GetBeatFromElapsedTime(9), 9.0f );
-	CHECK( test.GetBeatFromElapsedTime(10), 10.0f );
-	CHECK( test.GetBeatFromElapsedTime(10.5), 11.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(9), 9.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(10), 10.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(10.5), 11.0f );
 
-	CHECK( test.GetElapsedTimeFromBeat(9), 9.0f );
-	CHECK( test.GetElapsedTimeFromBeat(10), 10.0f );
-	CHECK( test.GetElapsedTimeFromBeat(11), 10.5f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(9), 9.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(10), 10.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(11), 10.5f );
 
 	/* Add a 5-second stop at beat 10. */
-	test.AddStopSegment( StopSegment(10, 5) );
+	test.AddSegment( StopSegment(BeatToNoteRow(10), 5) );
 
 	/* The stop shouldn't affect GetBPMAtBeat at all. */
-	CHECK( test.GetBPMAtBeat(9.99), 60.0f );
+	CHECK( test.GetBPMAtBeat(9.9f), 60.0f );
 	CHECK( test.GetBPMAtBeat(10), 120.0f );
 
-	CHECK( test.GetBeatFromElapsedTime(9), 9.0f );
-	CHECK( test.GetBeatFromElapsedTime(10), 10.0f );
-	CHECK( test.GetBeatFromElapsedTime(12), 10.0f );
-	CHECK( test.GetBeatFromElapsedTime(14), 10.0f );
-	CHECK( test.GetBeatFromElapsedTime(15), 10.0f );
-	CHECK( test.GetBeatFromElapsedTime(15.5), 11.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(9), 9.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(10), 10.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(12), 10.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(14), 10.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(15), 10.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(15.5), 11.0f );
 
-	CHECK( test.GetElapsedTimeFromBeat(9), 9.0f );
-	CHECK( test.GetElapsedTimeFromBeat(10), 10.0f );
-	CHECK( test.GetElapsedTimeFromBeat(11), 15.5f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(9), 9.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(10), 10.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(11), 15.5f );
 
 	/* Add a 2-second stop at beat 5 and a 5-second stop at beat 15. */
-	test.m_StopSegments.clear();
-	test.AddStopSegment( StopSegment(5, 2) );
-	test.AddStopSegment( StopSegment(15, 5) );
-	CHECK( test.GetBPMAtBeat(9.99), 60.0f );
+	test.Clear();
+	test.AddSegment( BPMSegment(0, 60) );
+	test.AddSegment( BPMSegment(BeatToNoteRow(10), 120) );
+	test.AddSegment( StopSegment(BeatToNoteRow(5), 2) );
+	test.AddSegment( StopSegment(BeatToNoteRow(15), 5) );
+	CHECK( test.GetBPMAtBeat(9.9f), 60.0f );
 	CHECK( test.GetBPMAtBeat(10), 120.0f );
 
-	CHECK( test.GetBeatFromElapsedTime(1), 1.0f );
-	CHECK( test.GetBeatFromElapsedTime(2), 2.0f );
-	CHECK( test.GetBeatFromElapsedTime(5), 5.0f ); // stopped
-	CHECK( test.GetBeatFromElapsedTime(6), 5.0f ); // stopped
-	CHECK( test.GetBeatFromElapsedTime(7), 5.0f ); // stop finished
-	CHECK( test.GetBeatFromElapsedTime(8), 6.0f );
-	CHECK( test.GetBeatFromElapsedTime(12), 10.0f ); // bpm changes to 120
-	CHECK( test.GetBeatFromElapsedTime(13), 12.0f );
-	CHECK( test.GetBeatFromElapsedTime(14), 14.0f );
-	CHECK( test.GetBeatFromElapsedTime(14.5f), 15.0f ); // stopped
-	CHECK( test.GetBeatFromElapsedTime(15), 15.0f ); // stopped
-	CHECK( test.GetBeatFromElapsedTime(17), 15.0f ); // stopped
-	CHECK( test.GetBeatFromElapsedTime(19.5f), 15.0f ); // stop finished
-	CHECK( test.GetBeatFromElapsedTime(20), 16.0f );
-
-	CHECK( test.GetElapsedTimeFromBeat(1), 1.0f );
-	CHECK( test.GetElapsedTimeFromBeat(2), 2.0f );
-	CHECK( test.GetElapsedTimeFromBeat(5), 5.0f ); // stopped
-	CHECK( test.GetElapsedTimeFromBeat(6), 8.0f );
-	CHECK( test.GetElapsedTimeFromBeat(10), 12.0f ); // bpm changes to 120
-	CHECK( test.GetElapsedTimeFromBeat(12), 13.0f );
-	CHECK( test.GetElapsedTimeFromBeat(14), 14.0f );
-	CHECK( test.GetElapsedTimeFromBeat(15.0f), 14.5f ); // stopped
-	CHECK( test.GetElapsedTimeFromBeat(16), 20.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(1), 1.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(2), 2.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(5), 5.0f ); // stopped
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(6), 5.0f ); // stopped
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(7), 5.0f ); // stop finished
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(8), 6.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(12), 10.0f ); // bpm changes to 120
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(13), 12.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(14), 14.0f );
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(14.5f), 15.0f ); // stopped
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(15), 15.0f ); // stopped
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(17), 15.0f ); // stopped
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(19.5f), 15.0f ); // stop finished
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(20), 16.0f );
+
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(1), 1.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(2), 2.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(5), 5.0f ); // stopped
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(6), 8.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(10), 12.0f ); // bpm changes to 120
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(12), 13.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(14), 14.0f );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(15.0f), 14.5f ); // stopped
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(16), 20.0f );
 
 	// todo: add warp tests -aj
 
@@ -111,8 +113,8 @@ int q = 0;
 	for( float f = -10; f < 250; f += 0.002 )
 	{
 		++q;
-//		const float t = test.GetElapsedTimeFromBeat( f );
-		const float b = test.GetBeatFromElapsedTime( f );
+//		const float t = test.GetElapsedTimeFromBeatNoOffset( f );
+		const float b = test.GetBeatFromElapsedTimeNoOffset( f );
 
 		/* b == f */
 
@@ -125,17 +127,87 @@ int q = 0;
 LOG->Trace("... %i in %f", q, foobar.GetDeltaTime());
 
 	TimingData test2;
-	test2.AddBPMSegment( BPMSegment(0, 60) );
-	test2.AddStopSegment( StopSegment(0, 1) );
+	test2.AddSegment( BPMSegment(0, 60) );
+	test2.AddSegment( StopSegment(0, 1) );
 	//test2.AddWarpSegment( WarpSegment() );
-	CHECK( test2.GetBeatFromElapsedTime(-1), -1.0f );
-	CHECK( test2.GetBeatFromElapsedTime(0), 0.0f );
-	CHECK( test2.GetBeatFromElapsedTime(1), 0.0f );
-	CHECK( test2.GetBeatFromElapsedTime(2), 1.0f );
-	CHECK( test2.GetElapsedTimeFromBeat(-1), -1.0f );
-	CHECK( test2.GetElapsedTimeFromBeat(0), 0.0f );
-	CHECK( test2.GetElapsedTimeFromBeat(1), 2.0f );
-	CHECK( test2.GetElapsedTimeFromBeat(2), 3.0f );
+	CHECK( test2.GetBeatFromElapsedTimeNoOffset(-1), -1.0f );
+	CHECK( test2.GetBeatFromElapsedTimeNoOffset(0), 0.0f );
+	CHECK( test2.GetBeatFromElapsedTimeNoOffset(1), 0.0f );
+	CHECK( test2.GetBeatFromElapsedTimeNoOffset(2), 1.0f );
+	CHECK( test2.GetElapsedTimeFromBeatNoOffset(-1), -1.0f );
+	CHECK( test2.GetElapsedTimeFromBeatNoOffset(0), 0.0f );
+	CHECK( test2.GetElapsedTimeFromBeatNoOffset(1), 2.0f );
+	CHECK( test2.GetElapsedTimeFromBeatNoOffset(2), 3.0f );
+}
+
+/* Gimmick charts can have thousands of segments.  Step through one a frame at
+ * a time, the way gameplay does, and make sure a cursor gets the same answers
+ * as the plain lookups, then compare how long each takes. */
+void run_cursor_benchmark()
+{
+	TimingData test;
+	const int iNumBeats = 2000;
+	for( int i = 0; i < iNumBeats*2; ++i )
+		test.AddSegment( BPMSegment(BeatToNoteRow(i*0.5f), 120.0f + (i % 7) * 30) );
+	for( int i = 0; i < iNumBeats/2; ++i )
+	{
+		test.AddSegment( StopSegment(BeatToNoteRow(i*2 + 0.25f), 0.1f) );
+		test.AddSegment( DelaySegment(BeatToNoteRow(i*2 + 1.25f), 0.05f) );
+	}
+	for( int i = 0; i < iNumBeats/4; ++i )
+		test.AddSegment( WarpSegment(BeatToNoteRow(i*4 + 3.5f), 0.25f) );
+	test.PrepareLookup();
+
+	const float fFrame = 1/60.0f;
+	const float fEndSeconds = test.GetElapsedTimeFromBeatNoOffset( float(iNumBeats) );
+
+	TimingData::Cursor BeatCursor;
+	TimingData::Cursor TimeCursor;
+	int iFrames = 0;
+	for( float f = -1; f < fEndSeconds; f += fFrame, ++iFrames )
+	{
+		TimingData::GetBeatArgs plain, cursor;
+		plain.elapsed_time = cursor.elapsed_time = f;
+		test.GetBeatAndBPSFromElapsedTimeNoOffset( plain );
+		test.GetBeatAndBPSFromElapsedTimeNoOffset( cursor, BeatCursor );
+		if( plain.beat != cursor.beat || plain.bps_out != cursor.bps_out ||
+			plain.freeze_out != cursor.freeze_out || plain.delay_out != cursor.delay_out )
+		{
+			LOG->Warn( "Line %i: at %f, got beat %f bps %f, expected beat %f bps %f",
+				__LINE__, f, cursor.beat, cursor.bps_out, plain.beat, plain.bps_out );
+			return;
+		}
+
+		const float fBeat = plain.beat + 1;
+		CHECK( test.GetElapsedTimeFromBeatNoOffset(fBeat, TimeCursor),
+			test.GetElapsedTimeFromBeatNoOffset(fBeat) );
+	}
+
+	/* Seeking backwards has to give the same answers, too. */
+	CHECK( test.GetBeatFromElapsedTimeNoOffset(10, BeatCursor), test.GetBeatFromElapsedTimeNoOffset(10) );
+	CHECK( test.GetElapsedTimeFromBeatNoOffset(10, TimeCursor), test.GetElapsedTimeFromBeatNoOffset(10) );
+
+	RageTimer timer;
+	float fSum = 0;
+	for( float f = -1; f < fEndSeconds; f += fFrame )
+	{
+		fSum += test.GetBeatFromElapsedTimeNoOffset( f );
+		fSum += test.GetElapsedTimeFromBeatNoOffset( f );
+	}
+	const float fPlainTime = timer.GetDeltaTime();
+
+	BeatCursor.Reset();
+	TimeCursor.Reset();
+	for( float f = -1; f < fEndSeconds; f += fFrame )
+	{
+		fSum -= test.GetBeatFromElapsedTimeNoOffset( f, BeatCursor );
+		fSum -= test.GetElapsedTimeFromBeatNoOffset( f, TimeCursor );
+	}
+	const float fCursorTime = timer.GetDeltaTime();
+
+	LOG->Trace( "%i frames over %i segments: %f plain, %f with cursors (%f)",
+		iFrames, iNumBeats*2 + iNumBeats + iNumBeats/4, fPlainTime, fCursorTime, fSum );
+	test.ReleaseLookup();
 }
 
 int main( int argc, char *argv[] )
@@ -148,6 +220,7 @@ int main( int argc, char *argv[] )
 	LOG->SetFlushing( true );
 
 	run();
+	run_cursor_benchmark();
 
 	delete PREFSMAN;
 	delete LOG;
@@ -0,0 +1,148 @@
+/* Load a synthetic Stats.xml with 100,000 scores both ways: into one XNode
+ * tree with XmlFileUtil::Load, and a song at a time with
+ * XmlFileUtil::PullParser, the way Profile::LoadStatsXmlFromParser does.
+ * Both have to produce the same songs. */
+#include "global.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+#include "RageTimer.h"
+#include "RageFileManager.h"
+#include "XmlFile.h"
+#include "XmlFileUtil.h"
+
+static const int NUM_SONGS = 5000;
+static const int NUM_STEPS_PER_SONG = 4;
+static const int NUM_SCORES_PER_STEPS = 5;
+
+static RString MakeStatsXml()
+{
+	static const char *szDifficulties[] = { "Beginner", "Easy", "Medium", "Hard" };
+
+	RString s = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\r\n<Stats>\r\n";
+	s += "<GeneralData>\r\n<DisplayName>Machine</DisplayName>\r\n<Guid>0123456789abcdef</Guid>\r\n</GeneralData>\r\n";
+	s += "<SongScores>\r\n";
+	for( int i = 0; i < NUM_SONGS; ++i )
+	{
+		s += ssprintf( "<Song Dir='Songs/Group %i/Song &amp; %i/'>\r\n", i/100, i );
+		for( int j = 0; j < NUM_STEPS_PER_SONG; ++j )
+		{
+			s += ssprintf( "<Steps Difficulty='%s' StepsType='dance-single'>\r\n<HighScoreList>\r\n", szDifficulties[j] );
+			s += ssprintf( "<NumTimesPlayed>%i</NumTimesPlayed>\r\n<LastPlayed>2026-01-01</LastPlayed>\r\n", i%50 + 1 );
+			for( int k = 0; k < NUM_SCORES_PER_STEPS; ++k )
+			{
+				s += "<HighScore>\r\n<Name>EVNT</Name>\r\n";
+				s += ssprintf( "<Grade>Tier%02i</Grade>\r\n<Score>%i</Score>\r\n<PercentDP>%f</PercentDP>\r\n", k+1, 1000000 - k*1000, 1.0f - k*0.01f );
+				s += "<SurviveSeconds>100.5</SurviveSeconds>\r\n<MaxCombo>500</MaxCombo>\r\n<Modifiers>1.5x, Overhead</Modifiers>\r\n";
+				s += "<DateTime>2026-01-01 12:00:00</DateTime>\r\n<PlayerGuid>fedcba9876543210</PlayerGuid>\r\n";
+				s += "<TapNoteScores>\r\n<W1>400</W1>\r\n<W2>80</W2>\r\n<W3>15</W3>\r\n<Miss>5</Miss>\r\n</TapNoteScores>\r\n";
+				s += "<HoldNoteScores>\r\n<Held>30</Held>\r\n<LetGo>1</LetGo>\r\n</HoldNoteScores>\r\n";
+				s += "<Disqualified>0</Disqualified>\r\n</HighScore>\r\n";
+			}
+			s += "</HighScoreList>\r\n</Steps>\r\n";
+		}
+		s += "</Song>\r\n";
+	}
+	s += "</SongScores>\r\n<CalorieData/>\r\n</Stats>\r\n";
+	return s;
+}
+
+static int CountNodes( const XNode *pNode )
+{
+	int iCount = 1;
+	FOREACH_CONST_Child( pNode, pChild )
+		iCount += CountNodes( pChild );
+	return iCount;
+}
+
+void run()
+{
+	const RString sXml = MakeStatsXml();
+	LOG->Trace( "%i scores, %i bytes of XML", NUM_SONGS*NUM_STEPS_PER_SONG*NUM_SCORES_PER_STEPS, int(sXml.size()) );
+
+	RageTimer timer;
+	XNode tree;
+	RString sError;
+	XmlFileUtil::Load( &tree, sXml, sError );
+	const float fTreeTime = timer.GetDeltaTime();
+	if( !sError.empty() )
+	{
+		LOG->Warn( "Load failed: %s", sError.c_str() );
+		return;
+	}
+	const int iTreeNodes = CountNodes( &tree );
+
+	timer.Touch();
+	XmlFileUtil::PullParser parser( sXml );
+	vector<XNode *> vpSongs;
+	int iMostNodes = 0;
+	bool bInSongScores = false;
+	for(;;)
+	{
+		XmlFileUtil::PullParser::Event event = parser.Next();
+		if( event == XmlFileUtil::PullParser::EndDocument || event == XmlFileUtil::PullParser::Error )
+			break;
+		if( event != XmlFileUtil::PullParser::StartElement )
+			continue;
+		if( parser.GetName() == "SongScores" )
+		{
+			bInSongScores = true;
+			continue;
+		}
+		if( !bInSongScores || parser.GetName() != "Song" )
+			continue;
+
+		/* Profile loads each song and throws it away; keep them here so they
+		 * can be checked after the timing. */
+		XNode *pSong = new XNode;
+		parser.ReadElement( pSong );
+		vpSongs.push_back( pSong );
+		iMostNodes = max( iMostNodes, CountNodes(pSong) );
+	}
+	const float fStreamTime = timer.GetDeltaTime();
+	if( !parser.GetError().empty() )
+	{
+		LOG->Warn( "PullParser failed: %s", parser.GetError().c_str() );
+		return;
+	}
+
+	LOG->Trace( "XmlFileUtil::Load: %f seconds, %i nodes at once", fTreeTime, iTreeNodes );
+	LOG->Trace( "PullParser: %f seconds, at most %i nodes at once", fStreamTime, iMostNodes );
+
+	const XNode *pSongScores = tree.GetChild( "SongScores" );
+	unsigned iSong = 0;
+	FOREACH_CONST_Child( pSongScores, pSong )
+	{
+		if( iSong >= vpSongs.size() )
+		{
+			LOG->Warn( "PullParser read only %u songs", unsigned(vpSongs.size()) );
+			return;
+		}
+		if( XmlFileUtil::GetXML(pSong) != XmlFileUtil::GetXML(vpSongs[iSong]) )
+		{
+			LOG->Warn( "Song %u differs:\n%s\n%s", iSong, XmlFileUtil::GetXML(pSong).c_str(), XmlFileUtil::GetXML(vpSongs[iSong]).c_str() );
+			return;
+		}
+		++iSong;
+	}
+	if( iSong != vpSongs.size() )
+		LOG->Warn( "PullParser read %u songs, expected %u", unsigned(vpSongs.size()), iSong );
+
+	for( unsigned i = 0; i < vpSongs.size(); ++i )
+		delete vpSongs[i];
+}
+
+int main( int argc, char *argv[] )
+{
+	FILEMAN			= new RageFileManager( argv[0] );
+	FILEMAN->Mount( "dir", ".", "" );
+	LOG                     = new RageLog();
+	LOG->SetShowLogOutput( true );
+	LOG->SetFlushing( true );
+
+	run();
+
+	delete LOG;
+	delete FILEMAN;
+
+	exit(0);
+}